@@ -1123,6 +1123,10 @@ macro(process_options)
   if(${NS3_ASSERT} OR (${build_profile} STREQUAL "debug"))
     add_definitions(-DNS3_ASSERT_ENABLE)
   endif()
+  # Compile out the trace sources if requested, in any build type
+  if(NOT ${NS3_TRACING})
+    add_definitions(-DNS3_TRACING_DISABLE)
+  endif()
 
   set(ENABLE_TAP OFF)
   if(${NS3_TAP})
@@ -21,14 +21,19 @@
 #ifndef CALLBACK_H
 #define CALLBACK_H
 
+#include "assert.h"
 #include "attribute-helper.h"
 #include "attribute.h"
 #include "fatal-error.h"
 #include "ptr.h"
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -230,6 +235,280 @@ class CallbackComponent<T, false> : public CallbackComponentBase
 /// Vector of callback components
 typedef std::vector<std::shared_ptr<CallbackComponentBase>> CallbackComponentVector;
 
+/**
+ * \ingroup callbackimpl
+ * A callable object wrapper, like std::function, which stores small
+ * callable objects inline rather than on the heap.
+ *
+ * A callable object of up to CAPACITY bytes, which can be moved without
+ * throwing, is stored in the wrapper itself; larger ones are allocated.
+ * The call goes through a plain function pointer instantiated for the
+ * type of the callable object, rather than through a virtual function.
+ *
+ * \tparam R \explicit The return type of the callable object.
+ * \tparam UArgs \explicit The types of the arguments of the callable object.
+ */
+template <typename R, typename... UArgs>
+class CallbackFunction
+{
+  public:
+    /// The size of the inline storage, in bytes
+    static constexpr std::size_t CAPACITY = 6 * sizeof(void*);
+
+    /** Create an empty wrapper. */
+    CallbackFunction()
+        : m_invoke(nullptr),
+          m_manage(nullptr)
+    {
+    }
+
+    /**
+     * Wrap a callable object.
+     *
+     * \tparam F \deduced The type of the callable object.
+     * \param [in] func The callable object.
+     */
+    template <typename F,
+              std::enable_if_t<!std::is_same_v<std::decay_t<F>, CallbackFunction>, int> = 0>
+    CallbackFunction(F&& func)
+        : m_invoke(&Invoke<std::decay_t<F>>),
+          m_manage(&Manage<std::decay_t<F>>)
+    {
+        typedef std::decay_t<F> Functor;
+        if constexpr (IS_INLINE<Functor>)
+        {
+            new (m_storage) Functor(std::forward<F>(func));
+        }
+        else
+        {
+            *reinterpret_cast<Functor**>(m_storage) = new Functor(std::forward<F>(func));
+        }
+    }
+
+    /**
+     * Copy constructor.
+     * \param [in] other The wrapper to copy.
+     */
+    CallbackFunction(const CallbackFunction& other)
+        : m_invoke(other.m_invoke),
+          m_manage(other.m_manage)
+    {
+        if (m_manage != nullptr)
+        {
+            m_manage(COPY, m_storage, other.m_storage);
+        }
+    }
+
+    /**
+     * Move constructor.
+     * \param [in] other The wrapper to move, left empty.
+     */
+    CallbackFunction(CallbackFunction&& other) noexcept
+        : m_invoke(other.m_invoke),
+          m_manage(other.m_manage)
+    {
+        if (m_manage != nullptr)
+        {
+            m_manage(MOVE, m_storage, other.m_storage);
+            other.m_invoke = nullptr;
+            other.m_manage = nullptr;
+        }
+    }
+
+    /**
+     * Copy assignment.
+     * \param [in] other The wrapper to copy.
+     * \returns This wrapper.
+     */
+    CallbackFunction& operator=(const CallbackFunction& other)
+    {
+        if (this != &other)
+        {
+            *this = CallbackFunction(other);
+        }
+        return *this;
+    }
+
+    /**
+     * Move assignment.
+     * \param [in] other The wrapper to move, left empty.
+     * \returns This wrapper.
+     */
+    CallbackFunction& operator=(CallbackFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_invoke = other.m_invoke;
+            m_manage = other.m_manage;
+            if (m_manage != nullptr)
+            {
+                m_manage(MOVE, m_storage, other.m_storage);
+                other.m_invoke = nullptr;
+                other.m_manage = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    ~CallbackFunction()
+    {
+        Reset();
+    }
+
+    /** \return \c true if a callable object is wrapped. */
+    explicit operator bool() const
+    {
+        return m_invoke != nullptr;
+    }
+
+    /** \return \c true if the callable object is stored in the wrapper itself. */
+    bool IsInline() const
+    {
+        return m_manage != nullptr && m_manage(LOCATE, nullptr, nullptr);
+    }
+
+    /**
+     * Call the callable object.  As with std::function, the call is const
+     * but the callable object is not.
+     *
+     * \param uargs The arguments.
+     * \return The value returned by the callable object.
+     */
+    R operator()(UArgs... uargs) const
+    {
+        NS_ASSERT_MSG(m_invoke != nullptr, "Empty CallbackFunction called");
+        return m_invoke(m_storage, std::forward<UArgs>(uargs)...);
+    }
+
+  private:
+    /// The operations of the manager functions
+    enum Operation
+    {
+        COPY,    //!< Copy construct the callable object of the source
+        MOVE,    //!< Move the callable object of the source, and destroy it
+        DESTROY, //!< Destroy the callable object of the destination
+        LOCATE,  //!< Do nothing, only tell where the callable object is stored
+    };
+
+    /**
+     * Whether a callable object is stored inline.
+     * \tparam Functor The type of the callable object.
+     */
+    template <typename Functor>
+    static constexpr bool IS_INLINE = sizeof(Functor) <= CAPACITY &&
+                                      alignof(Functor) <= alignof(std::max_align_t) &&
+                                      std::is_nothrow_move_constructible_v<Functor>;
+
+    /**
+     * Get the callable object out of a storage.
+     * \tparam Functor The type of the callable object.
+     * \param [in] storage The storage.
+     * \return The callable object.
+     */
+    template <typename Functor>
+    static Functor& Get(std::byte* storage)
+    {
+        if constexpr (IS_INLINE<Functor>)
+        {
+            return *std::launder(reinterpret_cast<Functor*>(storage));
+        }
+        else
+        {
+            return **reinterpret_cast<Functor**>(storage);
+        }
+    }
+
+    /**
+     * Call the callable object of a storage.
+     * \tparam Functor The type of the callable object.
+     * \param [in] storage The storage.
+     * \param uargs The arguments.
+     * \return The value returned by the callable object, if \p R is not void.
+     */
+    template <typename Functor>
+    static R Invoke(std::byte* storage, UArgs&&... uargs)
+    {
+        if constexpr (std::is_void_v<R>)
+        {
+            std::invoke(Get<Functor>(storage), std::forward<UArgs>(uargs)...);
+        }
+        else
+        {
+            return std::invoke(Get<Functor>(storage), std::forward<UArgs>(uargs)...);
+        }
+    }
+
+    /**
+     * Copy, move or destroy the callable object of a storage, and tell
+     * where it is stored.
+     * \tparam Functor The type of the callable object.
+     * \param [in] op The operation.
+     * \param [in] dst The destination storage.
+     * \param [in] src The source storage, unused by DESTROY.
+     * \return \c true if the callable object is stored inline.
+     */
+    template <typename Functor>
+    static bool Manage(Operation op, std::byte* dst, std::byte* src)
+    {
+        switch (op)
+        {
+        case COPY:
+            if constexpr (IS_INLINE<Functor>)
+            {
+                new (dst) Functor(Get<Functor>(src));
+            }
+            else
+            {
+                *reinterpret_cast<Functor**>(dst) = new Functor(Get<Functor>(src));
+            }
+            break;
+        case MOVE:
+            if constexpr (IS_INLINE<Functor>)
+            {
+                new (dst) Functor(std::move(Get<Functor>(src)));
+                Get<Functor>(src).~Functor();
+            }
+            else
+            {
+                *reinterpret_cast<Functor**>(dst) = *reinterpret_cast<Functor**>(src);
+            }
+            break;
+        case DESTROY:
+            if constexpr (IS_INLINE<Functor>)
+            {
+                Get<Functor>(dst).~Functor();
+            }
+            else
+            {
+                delete *reinterpret_cast<Functor**>(dst);
+            }
+            break;
+        case LOCATE:
+            break;
+        }
+        return IS_INLINE<Functor>;
+    }
+
+    /** Destroy the callable object, if any. */
+    void Reset()
+    {
+        if (m_manage != nullptr)
+        {
+            m_manage(DESTROY, m_storage, nullptr);
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+    }
+
+    /// The callable object, or a pointer to it if not inline
+    alignas(std::max_align_t) mutable std::byte m_storage[CAPACITY];
+    /// Calls the callable object
+    R (*m_invoke)(std::byte*, UArgs&&...);
+    /// Copies, moves and destroys the callable object
+    bool (*m_manage)(Operation, std::byte*, std::byte*);
+};
+
 /**
  * \ingroup callbackimpl
  * CallbackImpl class with varying numbers of argument types
@@ -244,12 +523,14 @@ class CallbackImpl : public CallbackImplBase
     /**
      * Constructor.
      *
+     * \tparam F \deduced The type of the callable object
      * \param func the callable object
      * \param components the callback components (callable object and bound arguments)
      */
-    CallbackImpl(std::function<R(UArgs...)> func, const CallbackComponentVector& components)
-        : m_func(func),
-          m_components(components)
+    template <typename F>
+    CallbackImpl(F&& func, CallbackComponentVector components)
+        : m_func(std::forward<F>(func)),
+          m_components(std::move(components))
     {
     }
 
@@ -257,7 +538,7 @@ class CallbackImpl : public CallbackImplBase
      * Get the stored function.
      * \return A const reference to the stored function.
      */
-    const std::function<R(UArgs...)>& GetFunction() const
+    const CallbackFunction<R, UArgs...>& GetFunction() const
     {
         return m_func;
     }
@@ -279,7 +560,7 @@ class CallbackImpl : public CallbackImplBase
      */
     R operator()(UArgs... uargs) const
     {
-        return m_func(uargs...);
+        return m_func(std::forward<UArgs>(uargs)...);
     }
 
     bool IsEqual(Ptr<const CallbackImplBase> other) const override
@@ -345,7 +626,7 @@ class CallbackImpl : public CallbackImplBase
 
   private:
     /// Stores the callable object associated with this callback (as a lambda)
-    std::function<R(UArgs...)> m_func;
+    CallbackFunction<R, UArgs...> m_func;
 
     /// Stores the original callable object and the bound arguments, if any
     std::vector<std::shared_ptr<CallbackComponentBase>> m_components;
@@ -464,17 +745,17 @@ class Callback : public CallbackBase
     template <typename... BArgs>
     Callback(const Callback<R, BArgs..., UArgs...>& cb, BArgs... bargs)
     {
-        auto f = cb.DoPeekImpl()->GetFunction();
+        Ptr<CallbackImpl<R, BArgs..., UArgs...>> impl = cb.DoPeekImpl();
 
-        CallbackComponentVector components(cb.DoPeekImpl()->GetComponents());
+        CallbackComponentVector components(impl->GetComponents());
         components.insert(components.end(),
                           {std::make_shared<CallbackComponent<std::decay_t<BArgs>>>(bargs)...});
 
         m_impl = Create<CallbackImpl<R, UArgs...>>(
-            [f, bargs...](auto&&... uargs) -> R {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
+            [impl, bargs...](auto&&... uargs) -> R {
+                return (*impl)(bargs..., std::forward<decltype(uargs)>(uargs)...);
             },
-            components);
+            std::move(components));
     }
 
     /**
@@ -494,9 +775,6 @@ class Callback : public CallbackBase
               typename... BArgs>
     Callback(T func, BArgs... bargs)
     {
-        // store the function in a std::function object
-        std::function<R(BArgs..., UArgs...)> f(func);
-
         // The original function is comparable if it is a function pointer or
         // a pointer to a member function or a pointer to a member data.
         constexpr bool isComp =
@@ -506,11 +784,27 @@ class Callback : public CallbackBase
             {std::make_shared<CallbackComponent<T, isComp>>(func),
              std::make_shared<CallbackComponent<std::decay_t<BArgs>>>(bargs)...});
 
+        // The function and the bound arguments are stored in a single lambda,
+        // which the CallbackImpl keeps inline when small enough.  The call
+        // uses copies of the bound arguments, so that a bound object outlives
+        // the call even if the call destroys this callback.
         m_impl = Create<CallbackImpl<R, UArgs...>>(
-            [f, bargs...](auto&&... uargs) -> R {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
+            [func, bargs...](auto&&... uargs) mutable -> R {
+                auto call = [&func, &uargs...](BArgs... pinned) -> R {
+                    if constexpr (std::is_void_v<R>)
+                    {
+                        std::invoke(func, pinned..., std::forward<decltype(uargs)>(uargs)...);
+                    }
+                    else
+                    {
+                        return std::invoke(func,
+                                           pinned...,
+                                           std::forward<decltype(uargs)>(uargs)...);
+                    }
+                };
+                return call(bargs...);
             },
-            components);
+            std::move(components));
     }
 
   private:
@@ -530,17 +824,17 @@ class Callback : public CallbackBase
     {
         Callback<R, std::tuple_element_t<sizeof...(bargs) + INDEX, std::tuple<UArgs...>>...> cb;
 
-        const auto f = DoPeekImpl()->GetFunction();
+        Ptr<CallbackImpl<R, UArgs...>> impl = DoPeekImpl();
 
-        CallbackComponentVector components(DoPeekImpl()->GetComponents());
+        CallbackComponentVector components(impl->GetComponents());
         components.insert(components.end(),
                           {std::make_shared<CallbackComponent<std::decay_t<BoundArgs>>>(bargs)...});
 
         cb.m_impl = Create<std::remove_pointer_t<decltype(cb.DoPeekImpl())>>(
-            [f, bargs...](auto&&... uargs) mutable {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
+            [impl, bargs...](auto&&... uargs) mutable {
+                return (*impl)(bargs..., std::forward<decltype(uargs)>(uargs)...);
             },
-            components);
+            std::move(components));
 
         return cb;
     }
@@ -585,7 +879,7 @@ class Callback : public CallbackBase
      */
     R operator()(UArgs... uargs) const
     {
-        return (*(DoPeekImpl()))(uargs...);
+        return (*(DoPeekImpl()))(std::forward<UArgs>(uargs)...);
     }
 
     /**
@@ -749,6 +1043,32 @@ MakeNullCallback()
     return Callback<R, Args...>();
 }
 
+/**
+ * \ingroup callbackimpl
+ * The type of the Callbacks of a function whose first arguments are bound.
+ *
+ * \tparam N \explicit The number of bound arguments.
+ * \tparam R \explicit The return type of the function.
+ * \tparam Args \explicit The types of the arguments of the function.
+ */
+template <std::size_t N, typename R, typename... Args>
+struct BoundCallback
+{
+  private:
+    /**
+     * Declare the Callback type of the unbound arguments.
+     * \tparam INDEX \deduced The indices of the unbound arguments, minus N.
+     * \return The Callback type.
+     */
+    template <std::size_t... INDEX>
+    static auto Declare(std::index_sequence<INDEX...>)
+        -> Callback<R, std::tuple_element_t<N + INDEX, std::tuple<Args...>>...>;
+
+  public:
+    /// The Callback type
+    typedef decltype(Declare(std::make_index_sequence<sizeof...(Args) - N>{})) Type;
+};
+
 /**
  * \ingroup makeboundcallback
  * @{
@@ -764,7 +1084,8 @@ template <typename R, typename... Args, typename... BArgs>
 auto
 MakeBoundCallback(R (*fnPtr)(Args...), BArgs&&... bargs)
 {
-    return Callback<R, Args...>(fnPtr).Bind(std::forward<BArgs>(bargs)...);
+    typedef typename BoundCallback<sizeof...(BArgs), R, Args...>::Type Bound;
+    return Bound(fnPtr, std::forward<BArgs>(bargs)...);
 }
 
 /**
@@ -785,14 +1106,16 @@ template <typename T, typename OBJ, typename R, typename... Args, typename... BA
 auto
 MakeCallback(R (T::*memPtr)(Args...), OBJ objPtr, BArgs... bargs)
 {
-    return Callback<R, Args...>(memPtr, objPtr).Bind(bargs...);
+    typedef typename BoundCallback<sizeof...(BArgs), R, Args...>::Type Bound;
+    return Bound(memPtr, objPtr, bargs...);
 }
 
 template <typename T, typename OBJ, typename R, typename... Args, typename... BArgs>
 auto
 MakeCallback(R (T::*memPtr)(Args...) const, OBJ objPtr, BArgs... bargs)
 {
-    return Callback<R, Args...>(memPtr, objPtr).Bind(bargs...);
+    typedef typename BoundCallback<sizeof...(BArgs), R, Args...>::Type Bound;
+    return Bound(memPtr, objPtr, bargs...);
 }
 
 /**@}*/
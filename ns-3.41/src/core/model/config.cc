@@ -26,7 +26,10 @@
 #include "pointer.h"
 #include "singleton.h"
 
+#include <atomic>
+#include <map>
 #include <sstream>
+#include <unordered_map>
 
 /**
  * \file
@@ -214,6 +217,13 @@ class ArrayMatcher
      * \returns \c true if the index matches the Config Path.
      */
     bool Matches(std::size_t i) const;
+    /**
+     * Test if the Config path specification is a single index.
+     *
+     * \param [out] i The index.
+     * \returns \c true if the specification matches only \pname{i}.
+     */
+    bool IsIndex(uint32_t* i) const;
 
   private:
     /**
@@ -297,6 +307,17 @@ ArrayMatcher::Matches(std::size_t i) const
     return false;
 }
 
+bool
+ArrayMatcher::IsIndex(uint32_t* i) const
+{
+    NS_LOG_FUNCTION(this << i);
+    if (m_element.empty() || m_element.find_first_not_of("0123456789") != std::string::npos)
+    {
+        return false;
+    }
+    return StringToUint32(m_element, i);
+}
+
 bool
 ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 {
@@ -307,6 +328,248 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
     return !iss.bad() && !iss.fail();
 }
 
+/**
+ * \ingroup config-impl
+ * The generation of the objects reachable from the Config paths,
+ * incremented by Config::InvalidateMatches().
+ */
+static std::atomic<uint64_t> g_matchesGeneration{0};
+
+/**
+ * \ingroup config-impl
+ * Index of the objects reached by the Config paths.
+ *
+ * The index keeps the objects matched by each path, and the objects of
+ * each container attribute walked to find them.  It holds plain pointers,
+ * so as not to keep the objects alive, and is only used as long as the
+ * generation of the objects is that of the index: the changes of the
+ * structure reached by the paths discard it, as does the deletion of an
+ * indexed Object, but not the other Objects created and deleted as the
+ * simulation runs.
+ *
+ * Models may also add objects to their containers, or replace the objects
+ * of their Pointer attributes, without telling the index.  So an indexed
+ * container is only used while it keeps its size, and the matches of a
+ * path only while each container and Pointer attribute walked to find
+ * them is unchanged.
+ */
+class MatchIndex
+{
+  public:
+    /** The objects of a container attribute, by index. */
+    typedef std::map<std::size_t, Object*> Container;
+
+    /** A container or Pointer attribute walked to find the matches of a path. */
+    struct Walk
+    {
+        const Object* object;                  //!< The object holding the attribute
+        Ptr<const AttributeAccessor> accessor; //!< The attribute accessor
+        std::size_t n;                         //!< The size of a container
+        const Object* target;                  //!< The object of a Pointer
+    };
+
+    /** The objects matched by a path. */
+    struct Matches
+    {
+        std::vector<Object*> objects;      //!< The matching objects
+        std::vector<std::string> contexts; //!< The path of each object
+        std::vector<Walk> walks;           //!< The attributes walked
+    };
+
+    MatchIndex();
+
+    /** Discard the index if the objects changed since it was filled. */
+    void Update();
+    /**
+     * Find the objects matched by a path.
+     *
+     * \param [in] path The Config path.
+     * \returns The matches, or \c nullptr if they are not indexed.
+     */
+    const Matches* FindMatches(const std::string& path) const;
+    /**
+     * Index the objects matched by a path.
+     *
+     * \param [in] path The Config path.
+     * \param [in] matches The matching objects and their contexts.
+     */
+    void AddMatches(const std::string& path, Matches matches);
+    /**
+     * Find the objects of a container attribute.
+     *
+     * \param [in] object The object holding the attribute.
+     * \param [in] name The attribute name.
+     * \param [in] accessor The attribute accessor.
+     * \returns The objects, or \c nullptr if they are not indexed or
+     *          their number changed.
+     */
+    const Container* FindContainer(const Object* object,
+                                   const std::string& name,
+                                   const ObjectPtrContainerAccessor& accessor) const;
+    /**
+     * Index the objects of a container attribute.
+     *
+     * \param [in] object The object holding the attribute.
+     * \param [in] name The attribute name.
+     * \param [in] container The objects of the attribute.
+     */
+    void AddContainer(const Object* object, const std::string& name, const Container& container);
+
+  private:
+    /** \returns \c true if no Object changed since the index was updated. */
+    bool IsValid() const;
+    /**
+     * Mark an Object as indexed, so that deleting it discards the index.
+     *
+     * \param [in] object The object.
+     */
+    static void Mark(const Object* object);
+    /**
+     * Check an attribute walked is unchanged.
+     *
+     * \param [in] walk The attribute walked.
+     * \returns \c true if the attribute still has the same size or object.
+     */
+    static bool IsCurrent(const Walk& walk);
+
+    uint64_t m_generation; //!< The generation of the indexed objects
+    /** The objects matched by each path. */
+    std::unordered_map<std::string, Matches> m_matches;
+    /** The objects of each container attribute walked. */
+    std::map<std::pair<const Object*, std::string>, Container> m_containers;
+
+}; // class MatchIndex
+
+MatchIndex::MatchIndex()
+    : m_generation(g_matchesGeneration.load(std::memory_order_relaxed))
+{
+    NS_LOG_FUNCTION(this);
+}
+
+bool
+MatchIndex::IsValid() const
+{
+    return m_generation == g_matchesGeneration.load(std::memory_order_relaxed);
+}
+
+void
+MatchIndex::Mark(const Object* object)
+{
+    const_cast<Object*>(object)->m_configIndexed = true;
+}
+
+bool
+MatchIndex::IsCurrent(const Walk& walk)
+{
+    const auto container =
+        dynamic_cast<const ObjectPtrContainerAccessor*>(PeekPointer(walk.accessor));
+    if (container != nullptr)
+    {
+        std::size_t n;
+        return container->GetN(walk.object, &n) && n == walk.n;
+    }
+    PointerValue value;
+    return walk.accessor->Get(walk.object, value) &&
+           PeekPointer(value.Get<Object>()) == walk.target;
+}
+
+void
+MatchIndex::Update()
+{
+    NS_LOG_FUNCTION(this);
+    if (!IsValid())
+    {
+        NS_LOG_LOGIC("discard " << m_matches.size() << " paths");
+        m_matches.clear();
+        m_containers.clear();
+        m_generation = g_matchesGeneration.load(std::memory_order_relaxed);
+    }
+}
+
+const MatchIndex::Matches*
+MatchIndex::FindMatches(const std::string& path) const
+{
+    NS_LOG_FUNCTION(this << path);
+    if (!IsValid())
+    {
+        return nullptr;
+    }
+    auto it = m_matches.find(path);
+    if (it == m_matches.end())
+    {
+        return nullptr;
+    }
+    for (const auto& walk : it->second.walks)
+    {
+        if (!IsCurrent(walk))
+        {
+            NS_LOG_LOGIC("path " << path << " changed");
+            return nullptr;
+        }
+    }
+    return &it->second;
+}
+
+void
+MatchIndex::AddMatches(const std::string& path, Matches matches)
+{
+    NS_LOG_FUNCTION(this << path);
+    if (IsValid())
+    {
+        for (const auto object : matches.objects)
+        {
+            Mark(object);
+        }
+        for (const auto& walk : matches.walks)
+        {
+            Mark(walk.object);
+            if (walk.target != nullptr)
+            {
+                Mark(walk.target);
+            }
+        }
+        m_matches[path] = std::move(matches);
+    }
+}
+
+const MatchIndex::Container*
+MatchIndex::FindContainer(const Object* object,
+                          const std::string& name,
+                          const ObjectPtrContainerAccessor& accessor) const
+{
+    NS_LOG_FUNCTION(this << object << name << &accessor);
+    if (!IsValid())
+    {
+        return nullptr;
+    }
+    auto it = m_containers.find({object, name});
+    std::size_t n;
+    if (it == m_containers.end() || !accessor.GetN(object, &n) || n != it->second.size())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void
+MatchIndex::AddContainer(const Object* object,
+                         const std::string& name,
+                         const Container& container)
+{
+    NS_LOG_FUNCTION(this << object << name << &container);
+    // Only a container whose size changed is overwritten, so the containers
+    // up the stack of the Resolver, found here a moment ago, are kept.
+    if (IsValid())
+    {
+        Mark(object);
+        for (const auto& [i, item] : container)
+        {
+            Mark(item);
+        }
+        m_containers.insert_or_assign(std::make_pair(object, name), container);
+    }
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
@@ -318,8 +581,9 @@ class Resolver
      * Construct from a base Config path.
      *
      * \param [in] path The Config path.
+     * \param [in] index The index of the container attributes walked.
      */
-    Resolver(std::string path);
+    Resolver(std::string path, MatchIndex* index);
     /** Destructor. */
     virtual ~Resolver();
 
@@ -331,6 +595,12 @@ class Resolver
      *                  in the Config path.
      */
     void Resolve(Ptr<Object> root);
+    /**
+     * Get the container and Pointer attributes walked so far.
+     *
+     * \returns The attributes walked.
+     */
+    const std::vector<MatchIndex::Walk>& GetWalks() const;
 
   private:
     /** Ensure the Config path starts and ends with a '/'. */
@@ -347,9 +617,9 @@ class Resolver
      * Parse an index on the Config path.
      *
      * \param [in] path The remaining Config path.
-     * \param [in,out] vector The resulting list of matching objects.
+     * \param [in] container The objects of the container attribute.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    void DoArrayResolve(std::string path, const MatchIndex::Container& container);
     /**
      * Handle one object found on the path.
      *
@@ -374,13 +644,18 @@ class Resolver
     std::vector<std::string> m_workStack;
     /** The Config path. */
     std::string m_path;
+    /** The index of the container attributes. */
+    MatchIndex* m_index;
+    /** The container and Pointer attributes walked. */
+    std::vector<MatchIndex::Walk> m_walks;
 
 }; // class Resolver
 
-Resolver::Resolver(std::string path)
-    : m_path(path)
+Resolver::Resolver(std::string path, MatchIndex* index)
+    : m_path(path),
+      m_index(index)
 {
-    NS_LOG_FUNCTION(this << path);
+    NS_LOG_FUNCTION(this << path << index);
     Canonicalize();
 }
 
@@ -417,6 +692,12 @@ Resolver::Resolve(Ptr<Object> root)
     DoResolve(m_path, root);
 }
 
+const std::vector<MatchIndex::Walk>&
+Resolver::GetWalks() const
+{
+    return m_walks;
+}
+
 std::string
 Resolver::GetResolvedPath() const
 {
@@ -557,6 +838,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
                     PointerValue pValue;
                     root->GetAttribute(info.name, pValue);
                     Ptr<Object> object = pValue.Get<Object>();
+                    m_walks.push_back({PeekPointer(root), info.accessor, 0, PeekPointer(object)});
                     if (!object)
                     {
                         NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
@@ -578,10 +860,28 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
                     NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
                                                          << GetResolvedPath() << pathLeft);
                     foundMatch = true;
+                    // The value holds the objects until the walk is done,
+                    // in case the attribute getter created them.
                     ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
+                    MatchIndex::Container objects;
+                    const auto& accessor =
+                        dynamic_cast<const ObjectPtrContainerAccessor&>(*info.accessor);
+                    const MatchIndex::Container* container =
+                        m_index->FindContainer(PeekPointer(root), info.name, accessor);
+                    if (container == nullptr)
+                    {
+                        root->GetAttribute(info.name, vector);
+                        for (auto it = vector.Begin(); it != vector.End(); ++it)
+                        {
+                            objects.emplace_hint(objects.end(), it->first, PeekPointer(it->second));
+                        }
+                        m_index->AddContainer(PeekPointer(root), info.name, objects);
+                        container = &objects;
+                    }
+                    m_walks.push_back(
+                        {PeekPointer(root), info.accessor, container->size(), nullptr});
                     m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
+                    DoArrayResolve(pathLeft, *container);
                     m_workStack.pop_back();
                 }
                 // this could be anything else and we don't know what to do with it.
@@ -601,7 +901,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::string path, const MatchIndex::Container& container)
 {
     NS_LOG_FUNCTION(this << path << &container);
     NS_ASSERT(!path.empty());
@@ -615,15 +915,24 @@ Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& contai
     std::string pathLeft = path.substr(next, path.size() - next);
 
     ArrayMatcher matcher = ArrayMatcher(item);
-    ObjectPtrContainerValue::Iterator it;
-    for (it = container.Begin(); it != container.End(); ++it)
+    uint32_t index;
+    if (matcher.IsIndex(&index))
     {
-        if (matcher.Matches((*it).first))
+        auto it = container.find(index);
+        if (it != container.end())
         {
-            std::ostringstream oss;
-            oss << (*it).first;
-            m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
+            m_workStack.push_back(std::to_string(it->first));
+            DoResolve(pathLeft, it->second);
+            m_workStack.pop_back();
+        }
+        return;
+    }
+    for (auto it = container.begin(); it != container.end(); ++it)
+    {
+        if (matcher.Matches(it->first))
+        {
+            m_workStack.push_back(std::to_string(it->first));
+            DoResolve(pathLeft, it->second);
             m_workStack.pop_back();
         }
     }
@@ -652,6 +961,16 @@ class ConfigImpl : public Singleton<ConfigImpl>
     void Disconnect(std::string path, const CallbackBase& cb);
     /** \copydoc ns3::Config::LookupMatches() */
     MatchContainer LookupMatches(std::string path);
+    /**
+     * Connect callbacks to the trace sources matching paths.
+     *
+     * \param [in] connections The paths and their callbacks.
+     * \param [in] context Whether the callbacks receive the context.
+     * \returns The first path which matched no trace source, or an
+     *          empty string.
+     */
+    std::string ConnectMany(const std::vector<std::pair<std::string, CallbackBase>>& connections,
+                            bool context);
 
     /** \copydoc ns3::Config::RegisterRootNamespaceObject() */
     void RegisterRootNamespaceObject(Ptr<Object> obj);
@@ -678,6 +997,8 @@ class ConfigImpl : public Singleton<ConfigImpl>
 
     /** The list of Config path roots. */
     Roots m_roots;
+    /** The objects matched by the previous paths. */
+    MatchIndex m_index;
 
 }; // class ConfigImpl
 
@@ -782,11 +1103,20 @@ ConfigImpl::LookupMatches(std::string path)
 {
     NS_LOG_FUNCTION(this << path);
 
+    m_index.Update();
+    const MatchIndex::Matches* matches = m_index.FindMatches(path);
+    if (matches != nullptr)
+    {
+        NS_LOG_LOGIC("path " << path << " indexed");
+        std::vector<Ptr<Object>> objects(matches->objects.begin(), matches->objects.end());
+        return MatchContainer(objects, matches->contexts, path);
+    }
+
     class LookupMatchesResolver : public Resolver
     {
       public:
-        LookupMatchesResolver(std::string path)
-            : Resolver(path)
+        LookupMatchesResolver(std::string path, MatchIndex* index)
+            : Resolver(path, index)
         {
         }
 
@@ -798,7 +1128,7 @@ ConfigImpl::LookupMatches(std::string path)
 
         std::vector<Ptr<Object>> m_objects;
         std::vector<std::string> m_contexts;
-    } resolver = LookupMatchesResolver(path);
+    } resolver = LookupMatchesResolver(path, &m_index);
 
     for (auto i = m_roots.begin(); i != m_roots.end(); i++)
     {
@@ -812,14 +1142,54 @@ ConfigImpl::LookupMatches(std::string path)
     //
     resolver.Resolve(nullptr);
 
+    MatchIndex::Matches found;
+    for (const auto& object : resolver.m_objects)
+    {
+        found.objects.push_back(PeekPointer(object));
+    }
+    found.contexts = resolver.m_contexts;
+    found.walks = resolver.GetWalks();
+    m_index.AddMatches(path, std::move(found));
+
     return MatchContainer(resolver.m_objects, resolver.m_contexts, path);
 }
 
+std::string
+ConfigImpl::ConnectMany(const std::vector<std::pair<std::string, CallbackBase>>& connections,
+                        bool context)
+{
+    NS_LOG_FUNCTION(this << &connections << context);
+
+    // The paths often differ only by their trace source, so look up each
+    // of their roots once; the containers also hold the matching objects
+    // until all the callbacks are connected.
+    std::map<std::string, MatchContainer> containers;
+    for (const auto& [path, cb] : connections)
+    {
+        std::string root;
+        std::string leaf;
+        ParsePath(path, &root, &leaf);
+        auto it = containers.find(root);
+        if (it == containers.end())
+        {
+            it = containers.emplace(root, LookupMatches(root)).first;
+        }
+        bool ok = context ? it->second.ConnectFailSafe(leaf, cb)
+                          : it->second.ConnectWithoutContextFailSafe(leaf, cb);
+        if (!ok)
+        {
+            return path;
+        }
+    }
+    return "";
+}
+
 void
 ConfigImpl::RegisterRootNamespaceObject(Ptr<Object> obj)
 {
     NS_LOG_FUNCTION(this << obj);
     m_roots.push_back(obj);
+    InvalidateMatches();
 }
 
 void
@@ -832,6 +1202,7 @@ ConfigImpl::UnregisterRootNamespaceObject(Ptr<Object> obj)
         if (*i == obj)
         {
             m_roots.erase(i);
+            InvalidateMatches();
             return;
         }
     }
@@ -994,6 +1365,28 @@ Disconnect(std::string path, const CallbackBase& cb)
     ConfigImpl::Get()->Disconnect(path, cb);
 }
 
+void
+ConnectMany(const std::vector<std::pair<std::string, CallbackBase>>& connections)
+{
+    NS_LOG_FUNCTION(&connections);
+    std::string failed = ConfigImpl::Get()->ConnectMany(connections, true);
+    if (!failed.empty())
+    {
+        NS_FATAL_ERROR("Could not connect callback to " << failed);
+    }
+}
+
+void
+ConnectManyWithoutContext(const std::vector<std::pair<std::string, CallbackBase>>& connections)
+{
+    NS_LOG_FUNCTION(&connections);
+    std::string failed = ConfigImpl::Get()->ConnectMany(connections, false);
+    if (!failed.empty())
+    {
+        NS_FATAL_ERROR("Could not connect callback to " << failed);
+    }
+}
+
 MatchContainer
 LookupMatches(std::string path)
 {
@@ -1001,6 +1394,12 @@ LookupMatches(std::string path)
     return ConfigImpl::Get()->LookupMatches(path);
 }
 
+void
+InvalidateMatches()
+{
+    g_matchesGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
 void
 RegisterRootNamespaceObject(Ptr<Object> obj)
 {
@@ -22,6 +22,7 @@
 #include "ptr.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -182,6 +183,30 @@ bool ConnectFailSafe(std::string path, const CallbackBase& cb);
  * This function undoes the work of Config::ConnectWithContext.
  */
 void Disconnect(std::string path, const CallbackBase& cb);
+/**
+ * \ingroup config
+ * \param [in] connections The paths to match trace sources, each with
+ *             the callback to connect to its matching trace sources.
+ *
+ * This function connects each callback as Config::Connect does, but
+ * resolves the objects of the paths which differ only by the name of
+ * their trace source once, and walks each container of objects once for
+ * all the paths.  It is the fastest way to hook the same trace source of
+ * many objects with different callbacks, e.g., one per node.
+ * If no matching trace sources are found for one of the paths, this
+ * method will throw a fatal error.
+ */
+void ConnectMany(const std::vector<std::pair<std::string, CallbackBase>>& connections);
+/**
+ * \ingroup config
+ * \param [in] connections The paths to match trace sources, each with
+ *             the callback to connect to its matching trace sources.
+ *
+ * This function connects each callback as Config::ConnectWithoutContext
+ * does, with the path resolution of Config::ConnectMany.
+ */
+void ConnectManyWithoutContext(
+    const std::vector<std::pair<std::string, CallbackBase>>& connections);
 
 /**
  * \ingroup config
@@ -361,6 +386,22 @@ class MatchContainer
  */
 MatchContainer LookupMatches(std::string path);
 
+/**
+ * \ingroup config
+ * Discard the objects matched by the previous Config paths.
+ *
+ * The objects which match a path are cached, and the cache is discarded
+ * whenever an Object is aggregated, a Pointer or container attribute is
+ * set, a node, device, application, channel, name or root namespace object
+ * is added, or an Object held by the cache is deleted.  The other Objects
+ * created and deleted as the simulation runs keep it.  The cache also
+ * checks that the containers it walked kept their size, and the Pointer
+ * attributes their object.  A model which replaces an object of a
+ * container with a plain setter, after a Config call, must call this
+ * function.
+ */
+void InvalidateMatches();
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -20,9 +20,11 @@
 #include "default-simulator-impl.h"
 
 #include "assert.h"
+#include "enum.h"
 #include "log.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
 
 #include <cmath>
 
@@ -48,7 +50,23 @@ DefaultSimulatorImpl::GetTypeId()
     static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
                             .SetParent<SimulatorImpl>()
                             .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+                            .AddConstructor<DefaultSimulatorImpl>()
+                            .AddAttribute("EventProfile",
+                                          "The file to write the wall-clock time of the events, "
+                                          "by function and context, to at Simulator::Destroy(); "
+                                          "empty to not profile the events.",
+                                          StringValue(""),
+                                          MakeStringAccessor(&DefaultSimulatorImpl::m_profileFile),
+                                          MakeStringChecker())
+                            .AddAttribute("EventProfileFormat",
+                                          "The format of the event profile.",
+                                          EnumValue(EventProfiler::REPORT),
+                                          MakeEnumAccessor<EventProfiler::Format>(
+                                              &DefaultSimulatorImpl::m_profileFormat),
+                                          MakeEnumChecker(EventProfiler::REPORT,
+                                                          "Report",
+                                                          EventProfiler::FOLDED,
+                                                          "Folded"));
     return tid;
 }
 
@@ -62,7 +80,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
+    m_profileFormat = EventProfiler::REPORT;
     m_mainThreadId = std::this_thread::get_id();
 }
 
@@ -100,6 +118,11 @@ DefaultSimulatorImpl::Destroy()
             ev->Invoke();
         }
     }
+    if (m_profiler)
+    {
+        m_profiler->Write(m_profileFile, m_profileFormat);
+        m_profiler.reset();
+    }
 }
 
 void
@@ -141,7 +164,14 @@ DefaultSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (m_profiler)
+    {
+        m_profiler->Invoke(next.impl, next.key.m_context);
+    }
+    else
+    {
+        next.impl->Invoke();
+    }
     next.impl->Unref();
 
     ProcessEventsWithContext();
@@ -156,22 +186,12 @@ DefaultSimulatorImpl::IsFinished() const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext()
 {
-    if (m_eventsWithContextEmpty)
+    if (m_eventsWithContext.IsEmpty())
     {
         return;
     }
 
-    // swap queues
-    EventsWithContext eventsWithContext;
-    {
-        std::unique_lock lock{m_eventsWithContextMutex};
-        m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
-    }
-    while (!eventsWithContext.empty())
-    {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
+    m_eventsWithContext.Drain([this](const EventWithContext& event) {
         Scheduler::Event ev;
         ev.impl = event.event;
         ev.key.m_ts = m_currentTs + event.timestamp;
@@ -180,7 +200,7 @@ DefaultSimulatorImpl::ProcessEventsWithContext()
         m_uid++;
         m_unscheduledEvents++;
         m_events->Insert(ev);
-    }
+    });
 }
 
 void
@@ -192,11 +212,25 @@ DefaultSimulatorImpl::Run()
     ProcessEventsWithContext();
     m_stop = false;
 
+    if (!m_profileFile.empty() && !m_profiler)
+    {
+        m_profiler = std::make_unique<EventProfiler>();
+    }
+    if (m_profiler)
+    {
+        m_profiler->StartRun();
+    }
+
     while (!m_events->IsEmpty() && !m_stop)
     {
         ProcessOneEvent();
     }
 
+    if (m_profiler)
+    {
+        m_profiler->StopRun();
+    }
+
     // If the simulator stopped naturally by lack of events, make a
     // consistency test to check that we didn't lose any events along the way.
     NS_ASSERT(!m_events->IsEmpty() || m_unscheduledEvents == 0);
@@ -264,11 +298,7 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         // Current time added in ProcessEventsWithContext()
         ev.timestamp = delay.GetTimeStep();
         ev.event = event;
-        {
-            std::unique_lock lock{m_eventsWithContextMutex};
-            m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
-        }
+        m_eventsWithContext.Push(ev);
     }
 }
 
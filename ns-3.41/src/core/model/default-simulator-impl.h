@@ -20,10 +20,13 @@
 #ifndef DEFAULT_SIMULATOR_IMPL_H
 #define DEFAULT_SIMULATOR_IMPL_H
 
+#include "event-profiler.h"
+#include "mpsc-queue.h"
 #include "simulator-impl.h"
 
 #include <list>
-#include <mutex>
+#include <memory>
+#include <string>
 #include <thread>
 
 /**
@@ -42,6 +45,10 @@ class Scheduler;
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * Setting the EventProfile attribute to a file name profiles the events
+ * of the simulation with an EventProfiler, which Destroy() writes to the
+ * file in the format given by the EventProfileFormat attribute.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -97,17 +104,11 @@ class DefaultSimulatorImpl : public SimulatorImpl
         EventImpl* event;
     };
 
-    /** Container type for the events from a different context. */
-    typedef std::list<EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * The events scheduled from other threads, pushed without locking and
+     * moved to the primary event queue in batches.
      */
-    bool m_eventsWithContextEmpty;
-    /** Mutex to control access to the list of events with context. */
-    std::mutex m_eventsWithContextMutex;
+    MpscQueue<EventWithContext> m_eventsWithContext;
 
     /** Container type for the events to run at Simulator::Destroy() */
     typedef std::list<EventId> DestroyEvents;
@@ -136,6 +137,13 @@ class DefaultSimulatorImpl : public SimulatorImpl
 
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
+
+    /** The file to write the event profile to, or empty to not profile events. */
+    std::string m_profileFile;
+    /** The format of the event profile. */
+    EventProfiler::Format m_profileFormat;
+    /** The event profiler, while profiling. */
+    std::unique_ptr<EventProfiler> m_profiler;
 };
 
 } // namespace ns3
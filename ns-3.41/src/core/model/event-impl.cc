@@ -21,6 +21,8 @@
 
 #include "log.h"
 
+#include <cstring>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +34,181 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+#if defined(__SANITIZE_ADDRESS__)
+/** Keep events on the heap, where AddressSanitizer can check them. */
+constexpr bool POOL_EVENTS = false;
+#else
+/** Recycle the memory of events. */
+constexpr bool POOL_EVENTS = true;
+#endif
+
+/**
+ * \ingroup events
+ * Free lists of event memory, by size class, for one thread.
+ *
+ * Every block is allocated on its own from the heap, so a block freed by
+ * another thread than the one which allocated it, as happens with events
+ * scheduled with Simulator::ScheduleWithContext from other threads, simply
+ * joins the free list of the thread which frees it.
+ */
+class EventPool
+{
+  public:
+    /** Size classes are multiples of this many bytes. */
+    static constexpr std::size_t GRANULARITY = 16;
+    /** Number of size classes; larger events use the heap directly. */
+    static constexpr std::size_t CLASSES = 16;
+    /** Maximum number of free blocks kept per size class. */
+    static constexpr std::size_t MAX_FREE = 4096;
+
+    /** Release the free blocks. */
+    ~EventPool();
+
+    /**
+     * \param [in] size The size of an event, at most GRANULARITY * CLASSES.
+     * \returns The memory for the event.
+     */
+    void* Allocate(std::size_t size);
+    /**
+     * \param [in] p The memory of an event.
+     * \param [in] size The size of the event.
+     */
+    void Free(void* p, std::size_t size);
+
+    /**
+     * \returns The pool of the calling thread, or \c nullptr once it has
+     * been destroyed at thread exit.
+     */
+    static EventPool* Get();
+    /**
+     * \param [in] size The size of an event, at most GRANULARITY * CLASSES.
+     * \returns The size of the blocks of the size class of the event.
+     */
+    static std::size_t GetBlockSize(std::size_t size);
+
+  private:
+    /** A free block, linked through its first bytes. */
+    struct Block
+    {
+        Block* next; //!< The next free block of the size class
+    };
+
+    Block* m_free[CLASSES]{};      //!< Free blocks, by size class
+    std::size_t m_count[CLASSES]{}; //!< Number of free blocks, by size class
+};
+
+/** Whether the pool of this thread has been destroyed. */
+thread_local bool g_eventPoolDestroyed = false;
+
+EventPool::~EventPool()
+{
+    for (std::size_t c = 0; c < CLASSES; c++)
+    {
+        while (m_free[c])
+        {
+            Block* block = m_free[c];
+            m_free[c] = block->next;
+            ::operator delete(block);
+        }
+    }
+    g_eventPoolDestroyed = true;
+}
+
+EventPool*
+EventPool::Get()
+{
+    if (g_eventPoolDestroyed)
+    {
+        return nullptr;
+    }
+    thread_local EventPool pool;
+    return &pool;
+}
+
+std::size_t
+EventPool::GetBlockSize(std::size_t size)
+{
+    return ((size - 1) / GRANULARITY + 1) * GRANULARITY;
+}
+
+void*
+EventPool::Allocate(std::size_t size)
+{
+    std::size_t c = (size - 1) / GRANULARITY;
+    Block* block = m_free[c];
+    if (block)
+    {
+        m_free[c] = block->next;
+        m_count[c]--;
+        return block;
+    }
+    return ::operator new(GetBlockSize(size));
+}
+
+void
+EventPool::Free(void* p, std::size_t size)
+{
+    std::size_t c = (size - 1) / GRANULARITY;
+    if (m_count[c] == MAX_FREE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto block = static_cast<Block*>(p);
+    block->next = m_free[c];
+    m_free[c] = block;
+    m_count[c]++;
+}
+
+} // namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    if (POOL_EVENTS && size <= EventPool::GRANULARITY * EventPool::CLASSES)
+    {
+        EventPool* pool = EventPool::Get();
+        if (pool)
+        {
+            return pool->Allocate(size);
+        }
+        // The pool of the thread which frees the event may recycle it for
+        // any event of its size class
+        return ::operator new(EventPool::GetBlockSize(size));
+    }
+    return ::operator new(size);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    if (POOL_EVENTS && size <= EventPool::GRANULARITY * EventPool::CLASSES)
+    {
+        EventPool* pool = EventPool::Get();
+        if (pool)
+        {
+            pool->Free(p, size);
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
+void*
+EventImpl::operator new(std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t /* size */, std::align_val_t alignment)
+{
+    ::operator delete(p, alignment);
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -67,4 +244,45 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+EventImpl::Function
+EventImpl::GetFunction() const
+{
+    return {nullptr, &typeid(*this)};
+}
+
+const void*
+EventImpl::GetMemberFunction(const void* object, const void* member, std::size_t size)
+{
+#if defined(__GXX_ABI_VERSION)
+    // A pair of the function address, or one plus the vtable offset for
+    // virtual functions, and the adjustment of the this pointer.  The ARM
+    // variant keeps the virtual flag in the adjustment instead.
+    if (size != sizeof(std::uintptr_t) + sizeof(std::ptrdiff_t))
+    {
+        return nullptr;
+    }
+    std::uintptr_t ptr;
+    std::ptrdiff_t adj;
+    std::memcpy(&ptr, member, sizeof(ptr));
+    std::memcpy(&adj, static_cast<const char*>(member) + sizeof(ptr), sizeof(adj));
+#if defined(__arm__) || defined(__aarch64__)
+    bool isVirtual = (adj & 1) != 0;
+    adj >>= 1;
+    std::uintptr_t offset = ptr;
+#else
+    bool isVirtual = (ptr & 1) != 0;
+    std::uintptr_t offset = ptr - 1;
+#endif
+    if (!isVirtual)
+    {
+        return reinterpret_cast<const void*>(ptr);
+    }
+    const char* self = static_cast<const char*>(object) + adj;
+    const char* vtable = *reinterpret_cast<const char* const*>(self);
+    return *reinterpret_cast<const void* const*>(vtable + offset);
+#else
+    return nullptr;
+#endif
+}
+
 } // namespace ns3
@@ -21,7 +21,10 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
+#include <new>
 #include <stdint.h>
+#include <typeinfo>
 
 /**
  * \file
@@ -41,6 +44,14 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated and released at a very high rate, so the memory
+ * of an event is not returned to the heap when it is deleted but kept on
+ * a per-thread free list of its size class, from which the next event of
+ * a similar size is allocated.  The arguments MakeEvent() binds are
+ * stored in the event object itself, so that scheduling an event usually
+ * does not touch the heap at all.  Larger events, and all events in
+ * builds with AddressSanitizer, use the heap directly.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -67,6 +78,67 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /** The function an event calls, as identified by the EventProfiler. */
+    struct Function
+    {
+        /** The code address of the function, or nullptr if it is not known. */
+        const void* address;
+        /** The type of the function, or of the functor the event calls. */
+        const std::type_info* type;
+    };
+
+    /**
+     * Identify the function this event calls.
+     *
+     * The events made by MakeEvent() return the function or member function
+     * they were made from, resolving virtual member functions to the final
+     * overrider of the bound object.  Other events return their own type.
+     *
+     * \returns The function this event calls.
+     */
+    virtual Function GetFunction() const;
+
+    /**
+     * Resolve the code address a pointer to member function calls.
+     *
+     * This decodes the representation of pointers to member functions of the
+     * Itanium C++ ABI, used by GCC and Clang; with other compilers it returns
+     * nullptr.
+     *
+     * \param [in] object The bound object, converted to the class of the member.
+     * \param [in] member The pointer to member function.
+     * \param [in] size The size of the pointer to member function.
+     * \returns The address of the function, or nullptr if it is not known.
+     */
+    static const void* GetMemberFunction(const void* object, const void* member, std::size_t size);
+
+    /**
+     * Allocate an event from the free list of its size class.
+     * \param [in] size The size of the event object.
+     * \returns The memory for the event.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Return the memory of an event to the free list of its size class.
+     * \param [in] p The memory of the event.
+     * \param [in] size The size of the event object.
+     */
+    static void operator delete(void* p, std::size_t size);
+    /**
+     * Allocate an over-aligned event, from the heap.
+     * \param [in] size The size of the event object.
+     * \param [in] alignment The alignment of the event object.
+     * \returns The memory for the event.
+     */
+    static void* operator new(std::size_t size, std::align_val_t alignment);
+    /**
+     * Release an over-aligned event, to the heap.
+     * \param [in] p The memory of the event.
+     * \param [in] size The size of the event object.
+     * \param [in] alignment The alignment of the event object.
+     */
+    static void operator delete(void* p, std::size_t size, std::align_val_t alignment);
+
   protected:
     /**
      * Implementation for Invoke().
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+
+#include "fatal-error.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+#if __has_include(<dlfcn.h>)
+#include <dlfcn.h>
+#define NS3_EVENT_PROFILER_DLADDR
+#endif
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EventProfiler");
+
+namespace
+{
+
+/**
+ * \ingroup events
+ * Demangle a C++ name.
+ * \param [in] mangled The mangled name.
+ * \returns The demangled name, or \pname{mangled} if it is not a C++ name.
+ */
+std::string
+Demangle(const char* mangled)
+{
+    std::string name = mangled;
+#if (__GNUC__ >= 3)
+    int status;
+    char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+    if (status == 0)
+    {
+        name = demangled;
+    }
+    std::free(demangled);
+#endif
+    return name;
+}
+
+/**
+ * \ingroup events
+ * Print a context.
+ * \param [in] context The context.
+ * \returns The context as text.
+ */
+std::string
+ContextName(uint32_t context)
+{
+    return context == Simulator::NO_CONTEXT ? "-" : std::to_string(context);
+}
+
+} // unnamed namespace
+
+bool
+EventProfiler::Key::operator==(const Key& other) const
+{
+    return function.address == other.function.address && function.type == other.function.type &&
+           context == other.context;
+}
+
+std::size_t
+EventProfiler::KeyHash::operator()(const Key& key) const
+{
+    std::size_t hash = std::hash<const void*>()(key.function.address);
+    hash = hash * 31 + std::hash<const void*>()(key.function.type);
+    return hash * 31 + key.context;
+}
+
+EventProfiler::EventProfiler()
+    : m_cancelled(0),
+      m_runTime(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+EventProfiler::Invoke(EventImpl* event, uint32_t context)
+{
+    if (event->IsCancelled())
+    {
+        m_cancelled++;
+        return;
+    }
+    // Identify the function first: the event may destroy its object
+    Key key{event->GetFunction(), context};
+    Clock::time_point start = Clock::now();
+    event->Invoke();
+    Clock::duration time = Clock::now() - start;
+    Cost& cost = m_costs[key];
+    cost.count++;
+    cost.time += std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+void
+EventProfiler::StartRun()
+{
+    NS_LOG_FUNCTION(this);
+    m_runStart = Clock::now();
+}
+
+void
+EventProfiler::StopRun()
+{
+    NS_LOG_FUNCTION(this);
+    Clock::duration time = Clock::now() - m_runStart;
+    m_runTime += std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+std::string
+EventProfiler::GetName(const EventImpl::Function& function)
+{
+    std::string type = Demangle(function.type->name());
+    if (function.address == nullptr)
+    {
+        return type;
+    }
+    std::ostringstream oss;
+#ifdef NS3_EVENT_PROFILER_DLADDR
+    Dl_info info;
+    if (dladdr(function.address, &info) != 0)
+    {
+        if (info.dli_sname != nullptr && info.dli_saddr == function.address)
+        {
+            return Demangle(info.dli_sname);
+        }
+        if (info.dli_fname != nullptr)
+        {
+            std::string module = info.dli_fname;
+            module = module.substr(module.find_last_of('/') + 1);
+            oss << type << " at " << module << "+0x" << std::hex
+                << static_cast<const char*>(function.address) -
+                       static_cast<const char*>(info.dli_fbase);
+            return oss.str();
+        }
+    }
+#endif
+    oss << type << " at " << function.address;
+    return oss.str();
+}
+
+void
+EventProfiler::Write(std::ostream& os, Format format) const
+{
+    NS_LOG_FUNCTION(this << &os << format);
+    switch (format)
+    {
+    case REPORT:
+        WriteReport(os);
+        break;
+    case FOLDED:
+        WriteFolded(os);
+        break;
+    }
+}
+
+void
+EventProfiler::Write(const std::string& filename, Format format) const
+{
+    NS_LOG_FUNCTION(this << filename << format);
+    std::ofstream os(filename);
+    if (!os)
+    {
+        NS_FATAL_ERROR("Cannot open the event profile file \"" << filename << "\"");
+    }
+    Write(os, format);
+}
+
+void
+EventProfiler::WriteReport(std::ostream& os) const
+{
+    /** The cost of a function, over all contexts. */
+    struct Total
+    {
+        std::string name;       //!< The name of the function.
+        uint64_t count{0};      //!< The number of events.
+        uint64_t time{0};       //!< The time of the events.
+        uint32_t busiest{0};    //!< The context with the most time.
+        uint64_t busiestTime{0}; //!< The time of the events in the busiest context.
+    };
+
+    std::map<std::string, Total> totals;
+    uint64_t count = 0;
+    uint64_t time = 0;
+    for (const auto& [key, cost] : m_costs)
+    {
+        std::string name = GetName(key.function);
+        Total& total = totals[name];
+        total.name = name;
+        total.count += cost.count;
+        total.time += cost.time;
+        if (cost.time >= total.busiestTime)
+        {
+            total.busiest = key.context;
+            total.busiestTime = cost.time;
+        }
+        count += cost.count;
+        time += cost.time;
+    }
+    std::vector<Total> sorted;
+    for (const auto& [name, total] : totals)
+    {
+        sorted.push_back(total);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Total& a, const Total& b) {
+        return a.time > b.time;
+    });
+
+    std::ios_base::fmtflags flags = os.flags();
+    os << std::fixed << std::setprecision(3);
+    os << "Event profile: " << count << " events, " << m_cancelled << " cancelled events"
+       << std::endl;
+    os << "Wall-clock time: " << m_runTime * 1e-9 << " s in Simulator::Run(), " << time * 1e-9
+       << " s in events";
+    if (m_runTime > 0)
+    {
+        os << " (" << std::setprecision(1) << time * 100.0 / m_runTime << "%)";
+    }
+    os << std::endl << std::endl;
+    os << std::setw(12) << "time (ms)" << std::setw(8) << "share" << std::setw(12) << "events"
+       << std::setw(12) << "mean (us)"
+       << "  busiest context   function" << std::endl;
+    for (const auto& total : sorted)
+    {
+        std::ostringstream busiest;
+        busiest << std::fixed << std::setprecision(1) << ContextName(total.busiest) << " ("
+                << (total.time > 0 ? total.busiestTime * 100.0 / total.time : 100.0) << "%)";
+        os << std::setprecision(3) << std::setw(12) << total.time * 1e-6 << std::setprecision(1)
+           << std::setw(7) << (time > 0 ? total.time * 100.0 / time : 0.0) << "%"
+           << std::setw(12) << total.count << std::setprecision(3) << std::setw(12)
+           << total.time * 1e-3 / total.count << "  " << std::left << std::setw(18)
+           << busiest.str() << std::right << total.name << std::endl;
+    }
+    os.flags(flags);
+}
+
+void
+EventProfiler::WriteFolded(std::ostream& os) const
+{
+    std::map<std::string, uint64_t> stacks;
+    for (const auto& [key, cost] : m_costs)
+    {
+        std::string node = key.context == Simulator::NO_CONTEXT
+                               ? std::string("no node")
+                               : "node " + std::to_string(key.context);
+        stacks[node + ";" + GetName(key.function)] += cost.time;
+    }
+    for (const auto& [stack, time] : stacks)
+    {
+        os << stack << " " << time << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include "event-impl.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup events
+ *
+ * Attribute the wall-clock time of the events of a simulation to the
+ * functions they call.
+ *
+ * A simulator implementation invokes its events through Invoke(), which
+ * times each event and adds its time to the function the event calls
+ * (see EventImpl::GetFunction()) in the context of the event.  Write()
+ * then prints either a report of the functions sorted by their total time,
+ * or the time per context and function in the folded stack format of
+ * flame graph tools, such as flamegraph.pl:
+ *
+ * \code
+ *   node 3;ns3::TcpSocketBase::ReTxTimeout() 812345
+ * \endcode
+ *
+ * where the count is in nanoseconds.
+ *
+ * Functions are named from the symbols of the shared libraries; functions
+ * without an exported symbol, like those of the main program, are named by
+ * their type and their offset in their module, and lambdas by their type.
+ */
+class EventProfiler
+{
+  public:
+    /** The format of the profile. */
+    enum Format
+    {
+        REPORT, //!< Functions sorted by their total time.
+        FOLDED  //!< Folded stacks, for flame graphs.
+    };
+
+    /** Constructor. */
+    EventProfiler();
+
+    /**
+     * Invoke an event, recording its time.
+     * \param [in] event The event.
+     * \param [in] context The context of the event.
+     */
+    void Invoke(EventImpl* event, uint32_t context);
+
+    /** Notify the start of Simulator::Run(). */
+    void StartRun();
+    /** Notify the end of Simulator::Run(). */
+    void StopRun();
+
+    /**
+     * Write the profile.
+     * \param [in,out] os The output stream.
+     * \param [in] format The format of the profile.
+     */
+    void Write(std::ostream& os, Format format) const;
+    /**
+     * Write the profile to a file.
+     * \param [in] filename The name of the file.
+     * \param [in] format The format of the profile.
+     */
+    void Write(const std::string& filename, Format format) const;
+
+    /**
+     * Get the name the profile gives to a function.
+     * \param [in] function The function.
+     * \returns The name.
+     */
+    static std::string GetName(const EventImpl::Function& function);
+
+  private:
+    /** The clock timing the events. */
+    using Clock = std::chrono::steady_clock;
+
+    /** A function called in a context. */
+    struct Key
+    {
+        EventImpl::Function function; //!< The function.
+        uint32_t context;             //!< The context.
+
+        /**
+         * Equality operator.
+         * \param [in] other The other key.
+         * \returns \c true if the keys are equal.
+         */
+        bool operator==(const Key& other) const;
+    };
+
+    /** Hash a Key. */
+    struct KeyHash
+    {
+        /**
+         * Hash a key.
+         * \param [in] key The key.
+         * \returns The hash.
+         */
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /** The cost of a function in a context. */
+    struct Cost
+    {
+        uint64_t count; //!< The number of events.
+        uint64_t time;  //!< The wall-clock time of the events, in nanoseconds.
+    };
+
+    /**
+     * Write the report format.
+     * \param [in,out] os The output stream.
+     */
+    void WriteReport(std::ostream& os) const;
+    /**
+     * Write the folded stack format.
+     * \param [in,out] os The output stream.
+     */
+    void WriteFolded(std::ostream& os) const;
+
+    /** The cost of each function in each context. */
+    std::unordered_map<Key, Cost, KeyHash> m_costs;
+    /** The number of events which were cancelled. */
+    uint64_t m_cancelled;
+    /** The wall-clock time of Simulator::Run(), in nanoseconds. */
+    uint64_t m_runTime;
+    /** The start of the current Simulator::Run(). */
+    Clock::time_point m_runStart;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
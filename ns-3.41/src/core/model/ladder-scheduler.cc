@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+#include "type-id.h"
+#include "uinteger.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+namespace
+{
+
+/**
+ * Order events earliest first.
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \p a is earlier than \p b.
+ */
+bool
+Earlier(const Scheduler::Event& a, const Scheduler::Event& b)
+{
+    return a.key < b.key;
+}
+
+} // namespace
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LadderScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<LadderScheduler>()
+            .AddAttribute("Threshold",
+                          "Number of events above which a bucket is split into a new rung "
+                          "rather than sorted",
+                          TypeId::ATTR_CONSTRUCT,
+                          UintegerValue(50),
+                          MakeUintegerAccessor(&LadderScheduler::m_threshold),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topStart(0),
+      m_topMin(UINT64_MAX),
+      m_topMax(0),
+      m_rungs(MAX_RUNGS),
+      m_nRungs(0),
+      m_bottomHead(0),
+      m_threshold(50),
+      m_qSize(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+LadderScheduler::CurrentStart(const Rung& rung)
+{
+    return rung.start + rung.current * rung.width;
+}
+
+uint64_t
+LadderScheduler::SpawnRung(Bucket& events, uint64_t start, uint64_t end)
+{
+    NS_LOG_FUNCTION(this << events.size() << start << end);
+    NS_ASSERT(m_nRungs < MAX_RUNGS && end > start && !events.empty());
+
+    // As many buckets as events, of at least one time unit each
+    uint64_t span = end - start;
+    uint64_t n = events.size();
+    Rung& rung = m_rungs[m_nRungs++];
+    rung.start = start;
+    rung.width = (span + n - 1) / n;
+    rung.nBuckets = (span + rung.width - 1) / rung.width;
+    rung.current = 0;
+    if (rung.buckets.size() < rung.nBuckets)
+    {
+        rung.buckets.resize(rung.nBuckets);
+    }
+    for (const auto& ev : events)
+    {
+        rung.buckets[(ev.key.m_ts - start) / rung.width].push_back(ev);
+    }
+    events.clear();
+    NS_LOG_LOGIC("rung " << m_nRungs - 1 << ": " << rung.nBuckets << " buckets of " << rung.width);
+    return start + rung.nBuckets * rung.width;
+}
+
+void
+LadderScheduler::InsertBottom(const Event& ev)
+{
+    // Events mostly come after those of Bottom, like a burst of events at
+    // the same time stamp, and are then appended
+    auto first = m_bottom.begin() + m_bottomHead;
+    if (first == m_bottom.end() || !Earlier(ev, m_bottom.back()))
+    {
+        m_bottom.push_back(ev);
+    }
+    else
+    {
+        m_bottom.insert(std::upper_bound(first, m_bottom.end(), ev, Earlier), ev);
+    }
+
+    // Spread the events later than the earliest time stamp over a new rung
+    // once they are too many to be kept sorted; those at the earliest time
+    // stamp stay, since a rung cannot split them
+    if (m_bottom.size() - m_bottomHead > m_threshold && m_nRungs < MAX_RUNGS)
+    {
+        uint64_t earliest = m_bottom[m_bottomHead].key.m_ts;
+        auto later = std::upper_bound(m_bottom.begin() + m_bottomHead,
+                                      m_bottom.end(),
+                                      earliest,
+                                      [](uint64_t ts, const Event& e) { return ts < e.key.m_ts; });
+        if (static_cast<uint32_t>(m_bottom.end() - later) > m_threshold)
+        {
+            Bucket events(later, m_bottom.end());
+            m_bottom.erase(later, m_bottom.end());
+            uint64_t end = m_nRungs > 0 ? CurrentStart(m_rungs[m_nRungs - 1]) : m_topStart;
+            SpawnRung(events, events.front().key.m_ts, end);
+        }
+    }
+}
+
+void
+LadderScheduler::PopBottom(Bucket::iterator it)
+{
+    if (it - m_bottom.begin() == m_bottomHead)
+    {
+        m_bottomHead++;
+    }
+    else
+    {
+        m_bottom.erase(it);
+    }
+    if (m_bottomHead == m_bottom.size())
+    {
+        m_bottom.clear();
+        m_bottomHead = 0;
+    }
+}
+
+void
+LadderScheduler::Refill()
+{
+    while (m_bottom.empty())
+    {
+        if (m_nRungs == 0)
+        {
+            if (m_top.empty())
+            {
+                return;
+            }
+            if (m_top.size() <= m_threshold || m_topMin == m_topMax)
+            {
+                std::sort(m_top.begin(), m_top.end(), Earlier);
+                m_bottom.swap(m_top);
+                m_topStart = m_topMax + 1;
+            }
+            else
+            {
+                m_topStart = SpawnRung(m_top, m_topMin, m_topMax + 1);
+            }
+            m_topMin = UINT64_MAX;
+            m_topMax = 0;
+            continue;
+        }
+
+        // Move the next non-empty bucket of the lowest rung down
+        Rung& rung = m_rungs[m_nRungs - 1];
+        while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty())
+        {
+            rung.current++;
+        }
+        if (rung.current == rung.nBuckets)
+        {
+            m_nRungs--;
+            continue;
+        }
+        Bucket& bucket = rung.buckets[rung.current];
+        uint64_t bucketStart = CurrentStart(rung);
+        rung.current++;
+        if (bucket.size() > m_threshold && rung.width > 1 && m_nRungs < MAX_RUNGS)
+        {
+            SpawnRung(bucket, bucketStart, bucketStart + rung.width);
+        }
+        else
+        {
+            std::sort(bucket.begin(), bucket.end(), Earlier);
+            m_bottom.swap(bucket);
+        }
+    }
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    m_qSize++;
+
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+    }
+    else
+    {
+        uint32_t i = 0;
+        while (i < m_nRungs && ts < CurrentStart(m_rungs[i]))
+        {
+            i++;
+        }
+        if (i < m_nRungs)
+        {
+            Rung& rung = m_rungs[i];
+            rung.buckets[(ts - rung.start) / rung.width].push_back(ev);
+        }
+        else
+        {
+            InsertBottom(ev);
+        }
+    }
+    Refill();
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Scheduler::Event ev = m_bottom[m_bottomHead];
+    PopBottom(m_bottom.begin() + m_bottomHead);
+    m_qSize--;
+    Refill();
+    NS_LOG_LOGIC("remove ts=" << ev.key.m_ts << ", uid=" << ev.key.m_uid);
+    return ev;
+}
+
+bool
+LadderScheduler::RemoveFrom(Bucket& bucket, const Event& ev)
+{
+    for (auto& i : bucket)
+    {
+        if (i.key.m_uid == ev.key.m_uid)
+        {
+            NS_ASSERT(ev.impl == i.impl);
+            i = bucket.back();
+            bucket.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+
+    uint64_t ts = ev.key.m_ts;
+    bool found;
+    if (ts >= m_topStart)
+    {
+        found = RemoveFrom(m_top, ev);
+    }
+    else
+    {
+        uint32_t i = 0;
+        while (i < m_nRungs && ts < CurrentStart(m_rungs[i]))
+        {
+            i++;
+        }
+        if (i < m_nRungs)
+        {
+            Rung& rung = m_rungs[i];
+            found = RemoveFrom(rung.buckets[(ts - rung.start) / rung.width], ev);
+        }
+        else
+        {
+            auto it = std::lower_bound(m_bottom.begin() + m_bottomHead,
+                                       m_bottom.end(),
+                                       ev,
+                                       Earlier);
+            found = it != m_bottom.end() && it->key.m_uid == ev.key.m_uid;
+            if (found)
+            {
+                PopBottom(it);
+            }
+        }
+    }
+    NS_ASSERT(found);
+    m_qSize--;
+    Refill();
+}
+
+} // namespace ns3
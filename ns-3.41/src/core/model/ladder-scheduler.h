@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue of
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Tang, Goh and Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are kept in three tiers:
+ *  - Top, an unsorted `std::vector` of the events later than every rung
+ *    of the ladder, with the range of their time stamps;
+ *  - the Ladder, up to eight rungs of buckets.  When the ladder runs out
+ *    the whole of Top becomes its first rung, with as many buckets as
+ *    events, sized from the span of their time stamps.  A bucket holding
+ *    more than \c Threshold events when it is reached spawns a finer rung
+ *    over its own span instead of being sorted, so bucket widths follow
+ *    the event time distribution as it changes;
+ *  - Bottom, a sorted `std::vector` of the earliest events, from the
+ *    front of which events are dequeued.  Events later than those of
+ *    Bottom, like a burst of events at the same time stamp, are appended.
+ *    Once more than \c Threshold events of Bottom are later than its
+ *    earliest time stamp, these are turned back into a rung.
+ *
+ * Only Bottom is ever sorted, and it holds at most around \c Threshold
+ * events later than its earliest time stamp, unless the ladder is full.
+ * Bottom is refilled as soon as it empties, so PeekNext() is a simple
+ * read.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to Top, a bucket or Bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Head of Bottom
+ * Remove()     | Linear          | Search of Top or a bucket
+ * RemoveNext() | ~Constant       | Each event moves down a bounded number of rungs
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 8 rungs and 2 `std::vector`      | Preallocated rungs
+ * Per Event | 0, plus a `std::vector` per bucket | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Events of a tier or bucket. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder: buckets of equal width. */
+    struct Rung
+    {
+        uint64_t start;              //!< Time stamp at the start of the first bucket
+        uint64_t width;              //!< Span of a bucket, in dimensionless time units
+        uint32_t nBuckets;           //!< Number of buckets in use
+        uint32_t current;            //!< First bucket not yet moved down
+        std::vector<Bucket> buckets; //!< Buckets, kept allocated across uses
+    };
+
+    /** Maximum number of rungs. */
+    static const uint32_t MAX_RUNGS = 8;
+
+    /**
+     * \param [in] rung A rung.
+     * \returns The time stamp at the start of the current bucket of \p rung.
+     */
+    static uint64_t CurrentStart(const Rung& rung);
+
+    /**
+     * Spread events over a new rung below the others.
+     *
+     * \param [in,out] events The events, emptied.
+     * \param [in] start The earliest time stamp of the rung.
+     * \param [in] end The time stamp from which the rung's parent, or Top,
+     *             takes over.
+     * \returns The end of the last bucket of the rung.
+     */
+    uint64_t SpawnRung(Bucket& events, uint64_t start, uint64_t end);
+    /**
+     * Insert an event in Bottom, keeping it sorted, and turn its later
+     * events into a rung if they grow too many.
+     *
+     * \param [in] ev The event.
+     */
+    void InsertBottom(const Scheduler::Event& ev);
+    /**
+     * Remove an event from Bottom.
+     *
+     * \param [in] it The event.
+     */
+    void PopBottom(Bucket::iterator it);
+    /** Refill Bottom from the ladder, or Top, if Bottom is empty. */
+    void Refill();
+    /**
+     * Remove an event from an unsorted bucket.
+     *
+     * \param [in,out] bucket The bucket.
+     * \param [in] ev The event.
+     * \returns \c true if the event was found.
+     */
+    static bool RemoveFrom(Bucket& bucket, const Scheduler::Event& ev);
+
+    Bucket m_top;                //!< Events from m_topStart, unsorted
+    uint64_t m_topStart;         //!< Time stamp from which events go to Top
+    uint64_t m_topMin;           //!< Lower bound of the time stamps in Top
+    uint64_t m_topMax;           //!< Upper bound of the time stamps in Top
+    std::vector<Rung> m_rungs;   //!< Rungs, outermost first, MAX_RUNGS allocated
+    uint32_t m_nRungs;           //!< Number of rungs in use
+    Bucket m_bottom;             //!< Earliest events, sorted from m_bottomHead
+    uint32_t m_bottomHead;       //!< Index of the next event of Bottom
+    uint32_t m_threshold;        //!< Events above which a bucket spawns a rung
+    uint32_t m_qSize;            //!< Number of events in queue
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
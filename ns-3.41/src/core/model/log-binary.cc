@@ -0,0 +1,1071 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "log-binary.h"
+
+#include "environment-variable.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "nstime.h"
+#include "simulator.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogSetBinaryFile(), ns3::LogDecodeBinary() and ns3::BinaryLogRecord
+ * implementations.
+ *
+ * The file starts with an 8 bytes magic and a 32 bits version, followed
+ * by blocks:
+ *   - \c D: a string definition, its 32 bits identifier, 32 bits length
+ *     and bytes;
+ *   - \c R: records, the 8 bits time resolution, 32 bits length, and the
+ *     records of one thread.
+ *
+ * A record is its 32 bits length, 8 bits kind and prefixes, 32 bits level,
+ * component and function identifiers, 64 bits time step and 32 bits
+ * context, followed by the tagged arguments.  All values are in the host
+ * byte order.
+ */
+
+namespace ns3
+{
+
+namespace
+{
+
+/** The magic at the start of a binary log file. */
+const char BINARY_LOG_MAGIC[8] = {'n', 's', '3', '-', 'b', 'l', 'o', 'g'};
+/** The binary log file format version. */
+const uint32_t BINARY_LOG_VERSION = 1;
+/** The size of a record header. */
+const std::size_t RECORD_HEADER_SIZE = 30;
+
+/** The prefixes of a record. */
+enum Prefix : uint8_t
+{
+    PREFIX_TIME = 1,  //!< Simulation time
+    PREFIX_NODE = 2,  //!< Simulation context
+    PREFIX_FUNC = 4,  //!< Component and function names
+    PREFIX_LEVEL = 8, //!< Log level label
+};
+
+/** Whether the log messages go to the binary file. */
+std::atomic<bool> g_binaryLogEnabled{false};
+
+/** Whether the thread log of this thread has been destroyed. */
+thread_local bool t_binaryLogExited = false;
+
+/**
+ * The records of one thread, waiting to be written out: a single
+ * producer, single consumer ring buffer.
+ */
+struct BinaryLogRing
+{
+    /** The capacity in bytes. */
+    static constexpr uint64_t SIZE = 1 << 20;
+
+    std::unique_ptr<uint8_t[]> data{new uint8_t[SIZE]}; //!< The bytes
+    std::atomic<uint64_t> head{0};                        //!< Total bytes appended
+    std::atomic<uint64_t> tail{0};                        //!< Total bytes written out
+    bool owned{true};                                     //!< Whether a thread appends to it
+};
+
+/**
+ * The binary log file, its string definitions and the thread which
+ * writes out the records.
+ */
+class BinaryLog
+{
+  public:
+    /** \returns The binary log. */
+    static BinaryLog& Get();
+
+    /** Destructor, closes the file. */
+    ~BinaryLog();
+
+    /**
+     * Open a file, closing the current one.
+     * \param [in] filename The file name.
+     */
+    void Open(const std::string& filename);
+    /** Write out the pending records and close the file. */
+    void Close();
+
+    /**
+     * Add a string definition.
+     * \param [in] s The string.
+     * \param [in] length Its length.
+     * \returns The identifier and a stable copy of the string.
+     */
+    std::pair<uint32_t, const std::string*> Define(const char* s, std::size_t length);
+
+    /** \returns An unused ring for the calling thread. */
+    BinaryLogRing* Acquire();
+    /**
+     * Give back the ring of an exiting thread.
+     * \param [in] ring The ring.
+     */
+    void Release(BinaryLogRing* ring);
+
+    /**
+     * Write out a record too large for a ring.
+     * \param [in] ring The ring of the calling thread.
+     * \param [in] record The record.
+     */
+    void WriteLarge(BinaryLogRing* ring, const std::vector<uint8_t>& record);
+
+    /** Wake up the writer thread. */
+    void Wake();
+
+  private:
+    /** The writer thread loop. */
+    void Run();
+    /** Write out the pending definitions and records. */
+    void Drain();
+    /**
+     * Write out the pending definitions, with the file mutex held.
+     */
+    void WriteDefinitions();
+    /**
+     * Write a block header.
+     * \param [in] length The length of the records.
+     */
+    void WriteChunkHeader(uint32_t length);
+
+    std::mutex m_control;              //!< Serializes Open() and Close()
+    std::mutex m_fileMutex;            //!< Protects the file
+    std::ofstream m_file;              //!< The file
+    std::thread m_writer;              //!< The writer thread
+    std::mutex m_wakeMutex;            //!< Protects m_stop
+    std::condition_variable m_wakeUp;  //!< Wakes up the writer thread
+    bool m_stop{false};                //!< Whether the writer thread should stop
+    std::mutex m_stringsMutex;         //!< Protects m_strings
+    std::deque<std::string> m_strings; //!< The string definitions
+    std::size_t m_written{0};          //!< Definitions written in the file
+    std::mutex m_ringsMutex;           //!< Protects m_rings
+    std::vector<std::unique_ptr<BinaryLogRing>> m_rings; //!< The rings of all threads
+};
+
+BinaryLog&
+BinaryLog::Get()
+{
+    static BinaryLog log;
+    return log;
+}
+
+BinaryLog::~BinaryLog()
+{
+    Close();
+}
+
+void
+BinaryLog::Open(const std::string& filename)
+{
+    Close();
+    std::lock_guard lock(m_control);
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+    {
+        NS_FATAL_ERROR("Cannot open the binary log file " << filename);
+    }
+    m_file.write(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&BINARY_LOG_VERSION), sizeof(BINARY_LOG_VERSION));
+    m_written = 0;
+    m_stop = false;
+    m_writer = std::thread(&BinaryLog::Run, this);
+    g_binaryLogEnabled.store(true);
+}
+
+void
+BinaryLog::Close()
+{
+    std::lock_guard lock(m_control);
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    g_binaryLogEnabled.store(false);
+    {
+        std::lock_guard wakeLock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wakeUp.notify_one();
+    m_writer.join();
+    Drain();
+    m_file.close();
+}
+
+std::pair<uint32_t, const std::string*>
+BinaryLog::Define(const char* s, std::size_t length)
+{
+    std::lock_guard lock(m_stringsMutex);
+    m_strings.emplace_back(s, length);
+    return {m_strings.size() - 1, &m_strings.back()};
+}
+
+BinaryLogRing*
+BinaryLog::Acquire()
+{
+    std::lock_guard lock(m_ringsMutex);
+    for (auto& ring : m_rings)
+    {
+        if (!ring->owned)
+        {
+            // The records left by the previous thread come first
+            ring->owned = true;
+            return ring.get();
+        }
+    }
+    m_rings.push_back(std::make_unique<BinaryLogRing>());
+    return m_rings.back().get();
+}
+
+void
+BinaryLog::Release(BinaryLogRing* ring)
+{
+    std::lock_guard lock(m_ringsMutex);
+    ring->owned = false;
+}
+
+void
+BinaryLog::WriteLarge(BinaryLogRing* ring, const std::vector<uint8_t>& record)
+{
+    // Keep the records of the thread in order
+    while (ring->tail.load(std::memory_order_acquire) != ring->head.load(std::memory_order_relaxed))
+    {
+        Wake();
+        std::this_thread::yield();
+    }
+    std::lock_guard lock(m_fileMutex);
+    WriteDefinitions();
+    WriteChunkHeader(record.size());
+    m_file.write(reinterpret_cast<const char*>(record.data()), record.size());
+}
+
+void
+BinaryLog::Wake()
+{
+    m_wakeUp.notify_one();
+}
+
+void
+BinaryLog::Run()
+{
+    bool stop = false;
+    while (!stop)
+    {
+        {
+            std::unique_lock lock(m_wakeMutex);
+            m_wakeUp.wait_for(lock, std::chrono::milliseconds(10));
+            stop = m_stop;
+        }
+        Drain();
+    }
+}
+
+void
+BinaryLog::Drain()
+{
+    std::vector<std::pair<BinaryLogRing*, uint64_t>> heads;
+    {
+        std::lock_guard lock(m_ringsMutex);
+        for (auto& ring : m_rings)
+        {
+            heads.emplace_back(ring.get(), ring->head.load(std::memory_order_acquire));
+        }
+    }
+    std::lock_guard lock(m_fileMutex);
+    // The strings of the records appended so far are defined by now
+    WriteDefinitions();
+    for (auto [ring, head] : heads)
+    {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        if (head == tail)
+        {
+            continue;
+        }
+        WriteChunkHeader(head - tail);
+        uint64_t start = tail % BinaryLogRing::SIZE;
+        uint64_t first = std::min(head - tail, BinaryLogRing::SIZE - start);
+        m_file.write(reinterpret_cast<const char*>(ring->data.get() + start), first);
+        m_file.write(reinterpret_cast<const char*>(ring->data.get()), head - tail - first);
+        ring->tail.store(head, std::memory_order_release);
+    }
+    m_file.flush();
+}
+
+void
+BinaryLog::WriteDefinitions()
+{
+    std::lock_guard lock(m_stringsMutex);
+    for (; m_written < m_strings.size(); m_written++)
+    {
+        const std::string& s = m_strings[m_written];
+        uint32_t id = m_written;
+        uint32_t length = s.size();
+        m_file.put('D');
+        m_file.write(reinterpret_cast<const char*>(&id), sizeof(id));
+        m_file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        m_file.write(s.data(), length);
+    }
+}
+
+void
+BinaryLog::WriteChunkHeader(uint32_t length)
+{
+    m_file.put('R');
+    m_file.put(static_cast<char>(Time::GetResolution()));
+    m_file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+}
+
+/** The binary log state of a thread. */
+struct ThreadLog
+{
+    /** An interned string. */
+    struct Interned
+    {
+        uint32_t id;             //!< The identifier
+        const std::string* text; //!< The string
+    };
+
+    /** Destructor, gives back the ring. */
+    ~ThreadLog()
+    {
+        t_binaryLogExited = true;
+        if (ring != nullptr)
+        {
+            BinaryLog::Get().Release(ring);
+        }
+    }
+
+    /**
+     * Get the identifier of a string, which may change at its address.
+     * \param [in] key The address identifying the string.
+     * \param [in] s The string.
+     * \param [in] length Its length.
+     * \returns The identifier.
+     */
+    uint32_t Intern(const void* key, const char* s, std::size_t length)
+    {
+        auto it = strings.find(key);
+        if (it != strings.end() && it->second.text->size() == length &&
+            std::memcmp(it->second.text->data(), s, length) == 0)
+        {
+            return it->second.id;
+        }
+        auto [id, text] = BinaryLog::Get().Define(s, length);
+        strings[key] = {id, text};
+        return id;
+    }
+
+    /**
+     * Get the identifier of a name which never changes.
+     * \param [in] key The address identifying the name.
+     * \param [in] name A function returning the name.
+     * \returns The identifier.
+     */
+    template <typename F>
+    uint32_t InternName(const void* key, F name)
+    {
+        auto it = strings.find(key);
+        if (it != strings.end())
+        {
+            return it->second.id;
+        }
+        std::string s = name();
+        auto [id, text] = BinaryLog::Get().Define(s.data(), s.size());
+        strings[key] = {id, text};
+        return id;
+    }
+
+    /**
+     * Append a record to the ring, waiting for room if needed.
+     * \param [in] record The record.
+     */
+    void Commit(const std::vector<uint8_t>& record)
+    {
+        if (ring == nullptr)
+        {
+            ring = BinaryLog::Get().Acquire();
+        }
+        uint64_t size = record.size();
+        if (size > BinaryLogRing::SIZE / 2)
+        {
+            BinaryLog::Get().WriteLarge(ring, record);
+            return;
+        }
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        while (head + size - ring->tail.load(std::memory_order_acquire) > BinaryLogRing::SIZE)
+        {
+            BinaryLog::Get().Wake();
+            std::this_thread::yield();
+        }
+        uint64_t start = head % BinaryLogRing::SIZE;
+        uint64_t first = std::min(size, BinaryLogRing::SIZE - start);
+        std::memcpy(ring->data.get() + start, record.data(), first);
+        std::memcpy(ring->data.get(), record.data() + first, size - first);
+        ring->head.store(head + size, std::memory_order_release);
+        if (head + size - ring->tail.load(std::memory_order_relaxed) > BinaryLogRing::SIZE / 4)
+        {
+            BinaryLog::Get().Wake();
+        }
+    }
+
+    std::unordered_map<const void*, Interned> strings;     //!< The interned strings
+    std::vector<std::unique_ptr<BinaryLogStream>> streams; //!< The streams, by nesting depth
+    std::size_t depth{0};                                  //!< The nesting depth
+    BinaryLogRing* ring{nullptr};                          //!< The ring of the thread
+};
+
+/** The binary log state of this thread. */
+thread_local ThreadLog t_threadLog;
+
+/**
+ * \ingroup logging
+ * Open the binary log file set by the \c NS_LOG_BINARY environment variable.
+ */
+class BinaryLogEnvVarCheck
+{
+  public:
+    /** Constructor, opens the file. */
+    BinaryLogEnvVarCheck()
+    {
+        auto [found, value] = EnvironmentVariable::Get("NS_LOG_BINARY");
+        if (found && !value.empty())
+        {
+            LogSetBinaryFile(value);
+        }
+    }
+};
+
+/** Invoke the \c NS_LOG_BINARY handler. */
+BinaryLogEnvVarCheck g_binaryLogEnvVarCheck;
+
+/**
+ * Read a value from a block.
+ * \param [in,out] p The read position.
+ * \param [in] end The end of the block.
+ * \param [out] value The value.
+ * \returns \c false if the block is too short.
+ */
+template <typename T>
+bool
+Read(const uint8_t*& p, const uint8_t* end, T& value)
+{
+    if (end - p < static_cast<std::ptrdiff_t>(sizeof(T)))
+    {
+        return false;
+    }
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+/**
+ * Print a raw value.
+ * \param [in,out] p The read position.
+ * \param [in] end The end of the block.
+ * \param [in,out] os The stream to print on.
+ * \returns \c false if the block is too short.
+ */
+template <typename T>
+bool
+Print(const uint8_t*& p, const uint8_t* end, std::ostream& os)
+{
+    T value;
+    if (!Read(p, end, value))
+    {
+        return false;
+    }
+    os << value;
+    return true;
+}
+
+/**
+ * Print the arguments of a record.
+ * \param [in] p The first argument.
+ * \param [in] end The end of the record.
+ * \param [in] strings The string definitions.
+ * \param [in,out] os The stream to print on.
+ * \returns \c false if the record is malformed.
+ */
+bool
+PrintArguments(const uint8_t* p,
+               const uint8_t* end,
+               const std::vector<std::string>& strings,
+               std::ostream& os)
+{
+    bool ok = true;
+    while (ok && p < end)
+    {
+        uint8_t tag = *p++;
+        switch (tag)
+        {
+        case BinaryLogStream::TEXT:
+        case BinaryLogStream::STRING: {
+            uint32_t length;
+            if (!Read(p, end, length) || static_cast<uint64_t>(end - p) < length)
+            {
+                return false;
+            }
+            if (tag == BinaryLogStream::TEXT)
+            {
+                // The text is formatted already
+                os.write(reinterpret_cast<const char*>(p), length);
+            }
+            else
+            {
+                os << std::string(reinterpret_cast<const char*>(p), length);
+            }
+            p += length;
+            break;
+        }
+        case BinaryLogStream::LITERAL: {
+            uint32_t id;
+            if (!Read(p, end, id) || id >= strings.size())
+            {
+                return false;
+            }
+            os << strings[id];
+            break;
+        }
+        case BinaryLogStream::STATE: {
+            int64_t flags;
+            int64_t precision;
+            int64_t width;
+            char fill;
+            if (!Read(p, end, flags) || !Read(p, end, precision) || !Read(p, end, width) ||
+                !Read(p, end, fill))
+            {
+                return false;
+            }
+            os.flags(static_cast<std::ios_base::fmtflags>(flags));
+            os.precision(precision);
+            os.width(width);
+            os.fill(fill);
+            break;
+        }
+        case BinaryLogStream::POINTER: {
+            uint64_t pointer;
+            if (!Read(p, end, pointer))
+            {
+                return false;
+            }
+            os << reinterpret_cast<const void*>(pointer);
+            break;
+        }
+        case BinaryLogStream::TIME: {
+            int64_t time;
+            if (!Read(p, end, time))
+            {
+                return false;
+            }
+            os << Time(time);
+            break;
+        }
+        case BinaryLogStream::BOOL:
+            ok = Print<bool>(p, end, os);
+            break;
+        case BinaryLogStream::CHAR:
+            ok = Print<char>(p, end, os);
+            break;
+        case BinaryLogStream::SCHAR:
+            ok = Print<signed char>(p, end, os);
+            break;
+        case BinaryLogStream::UCHAR:
+            ok = Print<unsigned char>(p, end, os);
+            break;
+        case BinaryLogStream::SHORT:
+            ok = Print<short>(p, end, os);
+            break;
+        case BinaryLogStream::USHORT:
+            ok = Print<unsigned short>(p, end, os);
+            break;
+        case BinaryLogStream::INT:
+            ok = Print<int>(p, end, os);
+            break;
+        case BinaryLogStream::UINT:
+            ok = Print<unsigned int>(p, end, os);
+            break;
+        case BinaryLogStream::LONG:
+            ok = Print<long>(p, end, os);
+            break;
+        case BinaryLogStream::ULONG:
+            ok = Print<unsigned long>(p, end, os);
+            break;
+        case BinaryLogStream::LLONG:
+            ok = Print<long long>(p, end, os);
+            break;
+        case BinaryLogStream::ULLONG:
+            ok = Print<unsigned long long>(p, end, os);
+            break;
+        case BinaryLogStream::FLOAT:
+            ok = Print<float>(p, end, os);
+            break;
+        case BinaryLogStream::DOUBLE:
+            ok = Print<double>(p, end, os);
+            break;
+        case BinaryLogStream::LDOUBLE:
+            ok = Print<long double>(p, end, os);
+            break;
+        default:
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/**
+ * Print the simulation time prefix, as DefaultTimePrinter() does.
+ * \param [in] time The time step.
+ * \param [in,out] os The stream to print on.
+ */
+void
+PrintTime(int64_t time, std::ostream& os)
+{
+    os << std::fixed;
+    switch (Time::GetResolution())
+    {
+    case Time::US:
+        os << std::setprecision(6);
+        break;
+    case Time::NS:
+        os << std::setprecision(9);
+        break;
+    case Time::PS:
+        os << std::setprecision(12);
+        break;
+    case Time::FS:
+        os << std::setprecision(15);
+        break;
+    default:
+        os << std::setprecision(5);
+    }
+    os << Time(time).As(Time::S) << " ";
+}
+
+} // unnamed namespace
+
+void
+LogSetBinaryFile(const std::string& filename)
+{
+    if (filename.empty())
+    {
+        BinaryLog::Get().Close();
+    }
+    else
+    {
+        BinaryLog::Get().Open(filename);
+    }
+}
+
+bool
+LogDecodeBinary(std::istream& is, std::ostream& os, const std::string& component, int64_t node)
+{
+    char magic[sizeof(BINARY_LOG_MAGIC)];
+    uint32_t version;
+    is.read(magic, sizeof(magic));
+    is.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!is || std::memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) != 0 ||
+        version != BINARY_LOG_VERSION)
+    {
+        return false;
+    }
+
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    char fill = os.fill();
+
+    std::vector<std::string> strings;
+    std::vector<uint8_t> block;
+    bool ok = true;
+    char type;
+    while (ok && is.get(type))
+    {
+        if (type == 'D')
+        {
+            uint32_t id;
+            uint32_t length;
+            if (!is.read(reinterpret_cast<char*>(&id), sizeof(id)) ||
+                !is.read(reinterpret_cast<char*>(&length), sizeof(length)))
+            {
+                ok = false;
+                break;
+            }
+            if (id >= strings.size())
+            {
+                strings.resize(id + 1);
+            }
+            strings[id].resize(length);
+            ok = bool(is.read(strings[id].data(), length));
+            continue;
+        }
+        char resolution;
+        uint32_t length;
+        if (type != 'R' || !is.get(resolution) ||
+            !is.read(reinterpret_cast<char*>(&length), sizeof(length)))
+        {
+            ok = false;
+            break;
+        }
+        block.resize(length);
+        if (!is.read(reinterpret_cast<char*>(block.data()), length))
+        {
+            ok = false;
+            break;
+        }
+        if (resolution != static_cast<char>(Time::GetResolution()))
+        {
+            Time::SetResolution(static_cast<Time::Unit>(resolution));
+        }
+
+        const uint8_t* p = block.data();
+        const uint8_t* end = p + length;
+        while (ok && p < end)
+        {
+            const uint8_t* start = p;
+            uint32_t size;
+            uint8_t kind;
+            uint8_t prefixes;
+            uint32_t level;
+            uint32_t componentId;
+            uint32_t functionId;
+            int64_t time;
+            uint32_t context;
+            if (!Read(p, end, size) || size < RECORD_HEADER_SIZE ||
+                static_cast<uint64_t>(end - start) < size ||
+                !Read(p, end, kind) || !Read(p, end, prefixes) || !Read(p, end, level) ||
+                !Read(p, end, componentId) || !Read(p, end, functionId) || !Read(p, end, time) ||
+                !Read(p, end, context) || componentId >= strings.size() ||
+                functionId >= strings.size())
+            {
+                ok = false;
+                break;
+            }
+            const uint8_t* next = start + size;
+            const std::string& name = strings[componentId];
+            if ((!component.empty() && name != component) ||
+                (node >= 0 && context != static_cast<uint64_t>(node)))
+            {
+                p = next;
+                continue;
+            }
+
+            os.flags(std::ios_base::skipws | std::ios_base::dec);
+            os.precision(6);
+            os.fill(' ');
+            if (prefixes & PREFIX_TIME)
+            {
+                PrintTime(time, os);
+                os.flags(std::ios_base::skipws | std::ios_base::dec);
+                os.precision(6);
+            }
+            if (prefixes & PREFIX_NODE)
+            {
+                if (context == Simulator::NO_CONTEXT)
+                {
+                    os << "-1 ";
+                }
+                else
+                {
+                    os << context << " ";
+                }
+            }
+            if (kind == BinaryLogRecord::FUNCTION_NOARGS)
+            {
+                os << name << ":" << strings[functionId] << "()" << std::endl;
+                p = next;
+                continue;
+            }
+            if (kind == BinaryLogRecord::FUNCTION)
+            {
+                os << name << ":" << strings[functionId] << "(";
+            }
+            else
+            {
+                if (prefixes & PREFIX_FUNC)
+                {
+                    os << name << ":" << strings[functionId] << "(): ";
+                }
+                if (prefixes & PREFIX_LEVEL)
+                {
+                    os << "[" << LogComponent::GetLevelLabel(static_cast<LogLevel>(level))
+                       << "] ";
+                }
+            }
+            os.setf(std::ios_base::boolalpha);
+            ok = PrintArguments(p, next, strings, os);
+            os.flags(std::ios_base::skipws | std::ios_base::dec);
+            os.precision(6);
+            os.width(0);
+            os.fill(' ');
+            if (kind == BinaryLogRecord::FUNCTION)
+            {
+                os << ")";
+            }
+            os << std::endl;
+            p = next;
+        }
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+    os.fill(fill);
+    return ok && is.eof();
+}
+
+BinaryLogStream::BinaryLogStream()
+    : std::ostream(nullptr),
+      m_flags(flags()),
+      m_precision(precision()),
+      m_width(width()),
+      m_fill(fill())
+{
+    rdbuf(&m_buffer);
+}
+
+BinaryLogStream::TextBuffer::int_type
+BinaryLogStream::TextBuffer::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        m_text.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize
+BinaryLogStream::TextBuffer::xsputn(const char* s, std::streamsize n)
+{
+    m_text.append(s, n);
+    return n;
+}
+
+void
+BinaryLogStream::Start(uint8_t kind,
+                       uint8_t prefixes,
+                       uint32_t level,
+                       uint32_t component,
+                       uint32_t function,
+                       int64_t time,
+                       uint32_t context)
+{
+    clear();
+    m_flags = std::ios_base::skipws | std::ios_base::dec | std::ios_base::boolalpha;
+    m_precision = 6;
+    m_width = 0;
+    m_fill = ' ';
+    flags(m_flags);
+    precision(m_precision);
+    width(m_width);
+    fill(m_fill);
+
+    m_buffer.m_text.clear();
+    m_data.clear();
+    uint32_t size = 0;
+    Append(&size, sizeof(size));
+    Append(&kind, sizeof(kind));
+    Append(&prefixes, sizeof(prefixes));
+    Append(&level, sizeof(level));
+    Append(&component, sizeof(component));
+    Append(&function, sizeof(function));
+    Append(&time, sizeof(time));
+    Append(&context, sizeof(context));
+}
+
+const std::vector<uint8_t>&
+BinaryLogStream::Finish()
+{
+    FlushText();
+    uint32_t size = m_data.size();
+    std::memcpy(m_data.data(), &size, sizeof(size));
+    return m_data;
+}
+
+void
+BinaryLogStream::WriteTime(int64_t time)
+{
+    Prepare();
+    uint8_t tag = TIME;
+    Append(&tag, sizeof(tag));
+    Append(&time, sizeof(time));
+}
+
+void
+BinaryLogStream::WriteLiteral(const char* literal, std::size_t length)
+{
+    Prepare();
+    uint8_t tag = LITERAL;
+    uint32_t id = t_threadLog.Intern(literal, literal, length);
+    Append(&tag, sizeof(tag));
+    Append(&id, sizeof(id));
+}
+
+void
+BinaryLogStream::WriteString(const char* s, std::size_t length)
+{
+    Prepare();
+    uint8_t tag = STRING;
+    uint32_t size = length;
+    Append(&tag, sizeof(tag));
+    Append(&size, sizeof(size));
+    Append(s, length);
+}
+
+void
+BinaryLogStream::WritePointer(const void* pointer)
+{
+    Prepare();
+    uint8_t tag = POINTER;
+    uint64_t value = reinterpret_cast<uintptr_t>(pointer);
+    Append(&tag, sizeof(tag));
+    Append(&value, sizeof(value));
+}
+
+void
+BinaryLogStream::WriteRaw(uint8_t tag, const void* value, std::size_t size)
+{
+    Prepare();
+    Append(&tag, sizeof(tag));
+    Append(value, size);
+}
+
+void
+BinaryLogStream::Prepare()
+{
+    FlushText();
+    if (flags() != m_flags || precision() != m_precision || width() != m_width ||
+        fill() != m_fill)
+    {
+        m_flags = flags();
+        m_precision = precision();
+        m_width = width();
+        m_fill = fill();
+        uint8_t tag = STATE;
+        int64_t flagsValue = m_flags;
+        int64_t precisionValue = m_precision;
+        int64_t widthValue = m_width;
+        Append(&tag, sizeof(tag));
+        Append(&flagsValue, sizeof(flagsValue));
+        Append(&precisionValue, sizeof(precisionValue));
+        Append(&widthValue, sizeof(widthValue));
+        Append(&m_fill, sizeof(m_fill));
+    }
+    // The raw value consumes the width, as formatted output does
+    width(0);
+    m_width = 0;
+}
+
+void
+BinaryLogStream::FlushText()
+{
+    std::string& text = m_buffer.m_text;
+    if (!text.empty())
+    {
+        uint8_t tag = TEXT;
+        uint32_t length = text.size();
+        Append(&tag, sizeof(tag));
+        Append(&length, sizeof(length));
+        Append(text.data(), length);
+        text.clear();
+    }
+}
+
+void
+BinaryLogStream::Append(const void* data, std::size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_data.insert(m_data.end(), bytes, bytes + size);
+}
+
+bool
+BinaryLogRecord::IsEnabled()
+{
+    return g_binaryLogEnabled.load(std::memory_order_relaxed) && !t_binaryLogExited;
+}
+
+BinaryLogRecord::BinaryLogRecord(const LogComponent& component,
+                                 uint32_t level,
+                                 Kind kind,
+                                 const char* function)
+{
+    ThreadLog& log = t_threadLog;
+    if (log.depth == log.streams.size())
+    {
+        log.streams.push_back(std::make_unique<BinaryLogStream>());
+    }
+    m_stream = log.streams[log.depth++].get();
+
+    uint8_t prefixes = 0;
+    int64_t time = 0;
+    uint32_t context = 0;
+    if (component.IsEnabled(LOG_PREFIX_TIME) && LogGetTimePrinter() != nullptr)
+    {
+        prefixes |= PREFIX_TIME;
+        time = Simulator::Now().GetTimeStep();
+    }
+    if (component.IsEnabled(LOG_PREFIX_NODE) && LogGetNodePrinter() != nullptr)
+    {
+        prefixes |= PREFIX_NODE;
+        context = Simulator::GetContext();
+    }
+    if (component.IsEnabled(LOG_PREFIX_FUNC))
+    {
+        prefixes |= PREFIX_FUNC;
+    }
+    if (component.IsEnabled(LOG_PREFIX_LEVEL))
+    {
+        prefixes |= PREFIX_LEVEL;
+    }
+
+    uint32_t componentId = log.InternName(&component, [&component]() { return component.Name(); });
+    uint32_t functionId = log.InternName(function, [function]() { return std::string(function); });
+    m_stream->Start(kind, prefixes, level, componentId, functionId, time, context);
+}
+
+BinaryLogRecord::~BinaryLogRecord()
+{
+    ThreadLog& log = t_threadLog;
+    log.Commit(m_stream->Finish());
+    log.depth--;
+}
+
+BinaryLogStream&
+BinaryLogRecord::GetStream()
+{
+    return *m_stream;
+}
+
+BinaryParameterLogger::BinaryParameterLogger(BinaryLogStream& os)
+    : m_os(os)
+{
+}
+
+} // namespace ns3
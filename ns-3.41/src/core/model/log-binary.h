@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NS3_LOG_BINARY_H
+#define NS3_LOG_BINARY_H
+
+#include <cstring>
+#include <iostream>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogSetBinaryFile(), ns3::LogDecodeBinary() declarations,
+ * and the ns3::BinaryLogRecord class used by the logging macros.
+ */
+
+namespace ns3
+{
+
+class LogComponent;
+class Time;
+template <typename T>
+class Ptr;
+
+/**
+ * \ingroup logging
+ *
+ * Write the log messages to a binary file instead of \c std::clog.
+ *
+ * The messages of NS_LOG(), NS_LOG_FUNCTION() and NS_LOG_FUNCTION_NOARGS()
+ * are then recorded unformatted: the prefixes as the simulation time step
+ * and context, the string literals as identifiers, the numbers, strings,
+ * pointers and times as raw values, and the stream manipulators as the
+ * state of the stream.  Arguments of other types are formatted with their
+ * \c operator<<, as are the arguments which follow them in the message.
+ * Each thread appends its records to its own buffer, which a background
+ * thread writes out; the file is decoded offline with LogDecodeBinary(),
+ * or the \c decode-binary-log program, into the text the messages would
+ * have printed.
+ *
+ * A few differences remain with the text output: the time prefix is always
+ * printed as DefaultTimePrinter() would, \c NS_LOG_APPEND_CONTEXT is not
+ * called, the node prefix recording the context instead, and a message
+ * logged while formatting another one comes before it rather than in its
+ * middle.  NS_LOG_UNCOND() and the fatal errors still print to \c std::clog.
+ *
+ * The file may also be set with the \c NS_LOG_BINARY environment variable.
+ * It should be changed while the simulation threads are not logging.
+ *
+ * \param [in] filename The file name, or an empty string to write out the
+ *             pending messages, close the file and print to \c std::clog
+ *             again.
+ */
+void LogSetBinaryFile(const std::string& filename);
+
+/**
+ * \ingroup logging
+ *
+ * Decode a binary log file written by LogSetBinaryFile().
+ *
+ * \param [in] is The binary log.
+ * \param [out] os The stream to write the messages on.
+ * \param [in] component Only decode the messages of this log component,
+ *             if not empty.
+ * \param [in] node Only decode the messages logged in this context,
+ *             if not negative.
+ * \returns \c false if the file is not a binary log, or is truncated.
+ */
+bool LogDecodeBinary(std::istream& is,
+                     std::ostream& os,
+                     const std::string& component = "",
+                     int64_t node = -1);
+
+/**
+ * \ingroup logging
+ *
+ * The stream a binary log message is written on.
+ *
+ * \internal
+ * The values of the types known to the binary log are recorded by the
+ * operator<<() overloads below, which are better matches than the
+ * \c std::ostream ones.  Any other value is formatted by its own
+ * \c std::ostream operator, into the text buffer of this stream; the
+ * manipulators set the state of this stream, which is recorded before the
+ * next raw value.
+ */
+class BinaryLogStream : public std::ostream
+{
+  public:
+    /** The argument tags. */
+    enum Tag : uint8_t
+    {
+        TEXT = 1, //!< Formatted text
+        LITERAL,  //!< A string literal identifier
+        STRING,   //!< A string
+        STATE,    //!< Stream flags, precision, width and fill
+        BOOL,     //!< bool
+        CHAR,     //!< char
+        SCHAR,    //!< signed char
+        UCHAR,    //!< unsigned char
+        SHORT,    //!< short
+        USHORT,   //!< unsigned short
+        INT,      //!< int
+        UINT,     //!< unsigned int
+        LONG,     //!< long
+        ULONG,    //!< unsigned long
+        LLONG,    //!< long long
+        ULLONG,   //!< unsigned long long
+        FLOAT,    //!< float
+        DOUBLE,   //!< double
+        LDOUBLE,  //!< long double
+        POINTER,  //!< An object pointer
+        TIME,     //!< A Time, as its time step
+    };
+
+    /**
+     * Get the tag of an arithmetic type.
+     * \tparam T \deduced The type.
+     * \returns The tag, or 0 if the values of the type are not recorded raw.
+     */
+    template <typename T>
+    static constexpr uint8_t GetArithmeticTag();
+
+    /**
+     * Check whether the values of a type are recorded raw.
+     * \tparam T \deduced The type, as deduced by a forwarding reference.
+     * \returns \c true if the type is known to the binary log.
+     */
+    template <typename T>
+    static constexpr bool IsRaw();
+
+    /** Constructor. */
+    BinaryLogStream();
+
+    /**
+     * Start a record.
+     * \param [in] kind The record kind.
+     * \param [in] prefixes The prefixes to print.
+     * \param [in] level The log level.
+     * \param [in] component The log component identifier.
+     * \param [in] function The function name identifier.
+     * \param [in] time The simulation time step.
+     * \param [in] context The simulation context.
+     */
+    void Start(uint8_t kind,
+               uint8_t prefixes,
+               uint32_t level,
+               uint32_t component,
+               uint32_t function,
+               int64_t time,
+               uint32_t context);
+    /**
+     * Finish a record.
+     * \returns The record.
+     */
+    const std::vector<uint8_t>& Finish();
+
+    /**
+     * Record a value of a type known to the binary log.
+     * \tparam T \deduced The value type.
+     * \param [in] value The value.
+     */
+    template <typename T>
+    void Write(T&& value);
+    /**
+     * Record a time.
+     * \param [in] time The time step.
+     */
+    void WriteTime(int64_t time);
+
+  private:
+    /** The streambuf collecting the formatted text. */
+    class TextBuffer : public std::streambuf
+    {
+      public:
+        std::string m_text; //!< The pending text
+
+      protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+    };
+
+    /**
+     * Record a string literal.
+     * \param [in] literal The literal.
+     * \param [in] length Its length.
+     */
+    void WriteLiteral(const char* literal, std::size_t length);
+    /**
+     * Record a string.
+     * \param [in] s The string.
+     * \param [in] length Its length.
+     */
+    void WriteString(const char* s, std::size_t length);
+    /**
+     * Record an object pointer.
+     * \param [in] pointer The pointer.
+     */
+    void WritePointer(const void* pointer);
+    /**
+     * Record an arithmetic value.
+     * \param [in] tag The value tag.
+     * \param [in] value The value.
+     * \param [in] size The value size.
+     */
+    void WriteRaw(uint8_t tag, const void* value, std::size_t size);
+    /**
+     * Append the pending text, and the state of the stream if it changed,
+     * before a raw value.
+     */
+    void Prepare();
+    /** Append the pending text to the record. */
+    void FlushText();
+    /**
+     * Append bytes to the record.
+     * \param [in] data The bytes.
+     * \param [in] size The number of bytes.
+     */
+    void Append(const void* data, std::size_t size);
+
+    TextBuffer m_buffer;             //!< The formatted text
+    std::vector<uint8_t> m_data;     //!< The record
+    std::ios_base::fmtflags m_flags; //!< Flags recorded last
+    std::streamsize m_precision;     //!< Precision recorded last
+    std::streamsize m_width;         //!< Width recorded last
+    char m_fill;                     //!< Fill character recorded last
+};
+
+/**
+ * \ingroup logging
+ *
+ * A binary log record, written out when it goes out of scope.
+ *
+ * \internal
+ * Logging implementation class; should not be used directly.
+ */
+class BinaryLogRecord
+{
+  public:
+    /** The record kinds. */
+    enum Kind : uint8_t
+    {
+        MESSAGE = 0,     //!< NS_LOG()
+        FUNCTION,        //!< NS_LOG_FUNCTION()
+        FUNCTION_NOARGS, //!< NS_LOG_FUNCTION_NOARGS()
+    };
+
+    /**
+     * Check whether the log messages go to a binary file.
+     * \returns \c true if a binary log file is open.
+     */
+    static bool IsEnabled();
+
+    /**
+     * Start a record.
+     * \param [in] component The log component.
+     * \param [in] level The log level.
+     * \param [in] kind The record kind.
+     * \param [in] function The function name.
+     */
+    BinaryLogRecord(const LogComponent& component,
+                    uint32_t level,
+                    Kind kind,
+                    const char* function);
+    /** Write out the record. */
+    ~BinaryLogRecord();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    BinaryLogRecord(const BinaryLogRecord&) = delete;
+    BinaryLogRecord& operator=(const BinaryLogRecord&) = delete;
+
+    /** \returns The stream to write the message on. */
+    BinaryLogStream& GetStream();
+
+  private:
+    BinaryLogStream* m_stream; //!< The stream of the record
+};
+
+/**
+ * \ingroup logging
+ *
+ * Insert `, ` when streaming function arguments to a binary log record,
+ * as ParameterLogger does.
+ */
+class BinaryParameterLogger
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] os The stream of the record.
+     */
+    BinaryParameterLogger(BinaryLogStream& os);
+
+    /**
+     * Write a function parameter,
+     * separating parameters after the first by `,` strings.
+     *
+     * \param [in] param The function parameter.
+     * \return This BinaryParameterLogger, so it's chainable.
+     */
+    template <typename T>
+    BinaryParameterLogger& operator<<(const T& param);
+
+    /**
+     * Overload for vectors, to print each element.
+     *
+     * \param [in] vector The vector of parameters
+     * \return This BinaryParameterLogger, so it's chainable.
+     */
+    template <typename T>
+    BinaryParameterLogger& operator<<(const std::vector<T>& vector);
+
+  private:
+    bool m_first{true};    //!< First argument flag, doesn't get `, `.
+    BinaryLogStream& m_os; //!< The stream of the record.
+};
+
+/**
+ * \ingroup logging
+ * Record a value of a type known to the binary log.
+ *
+ * \param [in,out] stream The stream of the record.
+ * \param [in] value The value.
+ * \returns The stream.
+ */
+template <typename T, std::enable_if_t<BinaryLogStream::IsRaw<T>(), bool> = true>
+inline BinaryLogStream&
+operator<<(BinaryLogStream& stream, T&& value)
+{
+    stream.Write(std::forward<T>(value));
+    return stream;
+}
+
+/*************************************************************************
+ *  Implementation of the templates declared above.
+ *************************************************************************/
+
+/**
+ * \ingroup logging
+ * Check whether a type is a Ptr.
+ * \tparam T \explicit The type.
+ */
+template <typename T>
+struct IsBinaryLogPtr : std::false_type
+{
+};
+
+/**
+ * \ingroup logging
+ * Check whether a type is a Ptr.
+ * \tparam T \explicit The pointee type.
+ */
+template <typename T>
+struct IsBinaryLogPtr<Ptr<T>> : std::true_type
+{
+};
+
+template <typename T>
+constexpr uint8_t
+BinaryLogStream::GetArithmeticTag()
+{
+    // clang-format off
+    return std::is_same_v<T, bool> ? BOOL
+         : std::is_same_v<T, char> ? CHAR
+         : std::is_same_v<T, signed char> ? SCHAR
+         : std::is_same_v<T, unsigned char> ? UCHAR
+         : std::is_same_v<T, short> ? SHORT
+         : std::is_same_v<T, unsigned short> ? USHORT
+         : std::is_same_v<T, int> ? INT
+         : std::is_same_v<T, unsigned int> ? UINT
+         : std::is_same_v<T, long> ? LONG
+         : std::is_same_v<T, unsigned long> ? ULONG
+         : std::is_same_v<T, long long> ? LLONG
+         : std::is_same_v<T, unsigned long long> ? ULLONG
+         : std::is_same_v<T, float> ? FLOAT
+         : std::is_same_v<T, double> ? DOUBLE
+         : std::is_same_v<T, long double> ? LDOUBLE
+         : 0;
+    // clang-format on
+}
+
+template <typename T>
+constexpr bool
+BinaryLogStream::IsRaw()
+{
+    using U = std::remove_cv_t<std::remove_reference_t<T>>;
+    if constexpr (std::is_array_v<U>)
+    {
+        return std::is_same_v<std::remove_cv_t<std::remove_extent_t<U>>, char> &&
+               std::rank_v<U> == 1 && std::extent_v<U> > 0;
+    }
+    else if constexpr (std::is_pointer_v<U>)
+    {
+        using P = std::remove_pointer_t<U>;
+        // Function and volatile pointers print as bool
+        return !std::is_function_v<P> && !std::is_volatile_v<P>;
+    }
+    else
+    {
+        return GetArithmeticTag<U>() != 0 || std::is_same_v<U, std::string> ||
+               std::is_same_v<U, Time> || IsBinaryLogPtr<U>::value;
+    }
+}
+
+template <typename T>
+void
+BinaryLogStream::Write(T&& value)
+{
+    using U = std::remove_cv_t<std::remove_reference_t<T>>;
+    if constexpr (std::is_array_v<U>)
+    {
+        std::size_t length = strnlen(value, std::extent_v<U>);
+        if constexpr (std::is_const_v<std::remove_reference_t<T>>)
+        {
+            WriteLiteral(value, length);
+        }
+        else
+        {
+            WriteString(value, length);
+        }
+    }
+    else if constexpr (std::is_same_v<U, std::string>)
+    {
+        WriteString(value.data(), value.size());
+    }
+    else if constexpr (std::is_pointer_v<U>)
+    {
+        using P = std::remove_cv_t<std::remove_pointer_t<U>>;
+        if constexpr (std::is_same_v<P, char> || std::is_same_v<P, signed char> ||
+                      std::is_same_v<P, unsigned char>)
+        {
+            if (value == nullptr)
+            {
+                // Fail the stream as std::ostream does
+                static_cast<std::ostream&>(*this) << value;
+            }
+            else
+            {
+                const char* s = reinterpret_cast<const char*>(value);
+                WriteString(s, std::strlen(s));
+            }
+        }
+        else
+        {
+            WritePointer(static_cast<const void*>(value));
+        }
+    }
+    else if constexpr (std::is_same_v<U, Time>)
+    {
+        WriteTime(value.GetTimeStep());
+    }
+    else if constexpr (IsBinaryLogPtr<U>::value)
+    {
+        WritePointer(PeekPointer(value));
+    }
+    else
+    {
+        WriteRaw(GetArithmeticTag<U>(), &value, sizeof(U));
+    }
+}
+
+template <typename T>
+BinaryParameterLogger&
+BinaryParameterLogger::operator<<(const T& param)
+{
+    if (m_first)
+    {
+        m_first = false;
+    }
+    else
+    {
+        m_os << ", ";
+    }
+
+    if constexpr (std::is_convertible_v<T, std::string>)
+    {
+        m_os << "\"" << param << "\"";
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        // Use + unary operator to cast uint8_t / int8_t to uint32_t / int32_t, respectively
+        m_os << +param;
+    }
+    else
+    {
+        m_os << param;
+    }
+
+    return *this;
+}
+
+template <typename T>
+BinaryParameterLogger&
+BinaryParameterLogger::operator<<(const std::vector<T>& vector)
+{
+    for (const auto& i : vector)
+    {
+        *this << i;
+    }
+    return *this;
+}
+
+} // namespace ns3
+
+#endif /* NS3_LOG_BINARY_H */
@@ -184,6 +184,15 @@
     {                                                                                              \
         if (g_log.IsEnabled(level))                                                                \
         {                                                                                          \
+            if (ns3::BinaryLogRecord::IsEnabled())                                                 \
+            {                                                                                      \
+                ns3::BinaryLogRecord ns3BinaryLog(g_log,                                           \
+                                                  level,                                           \
+                                                  ns3::BinaryLogRecord::MESSAGE,                   \
+                                                  __FUNCTION__);                                   \
+                ns3BinaryLog.GetStream() << msg;                                                   \
+                break;                                                                             \
+            }                                                                                      \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
             NS_LOG_APPEND_CONTEXT;                                                                 \
@@ -209,6 +218,14 @@
     {                                                                                              \
         if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
         {                                                                                          \
+            if (ns3::BinaryLogRecord::IsEnabled())                                                 \
+            {                                                                                      \
+                ns3::BinaryLogRecord ns3BinaryLog(g_log,                                           \
+                                                  ns3::LOG_FUNCTION,                               \
+                                                  ns3::BinaryLogRecord::FUNCTION_NOARGS,           \
+                                                  __FUNCTION__);                                   \
+                break;                                                                             \
+            }                                                                                      \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
             NS_LOG_APPEND_CONTEXT;                                                                 \
@@ -243,6 +260,15 @@
     {                                                                                              \
         if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
         {                                                                                          \
+            if (ns3::BinaryLogRecord::IsEnabled())                                                 \
+            {                                                                                      \
+                ns3::BinaryLogRecord ns3BinaryLog(g_log,                                           \
+                                                  ns3::LOG_FUNCTION,                               \
+                                                  ns3::BinaryLogRecord::FUNCTION,                  \
+                                                  __FUNCTION__);                                   \
+                ns3::BinaryParameterLogger(ns3BinaryLog.GetStream()) << parameters;                \
+                break;                                                                             \
+            }                                                                                      \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
             NS_LOG_APPEND_CONTEXT;                                                                 \
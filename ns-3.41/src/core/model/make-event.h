@@ -353,6 +353,9 @@ EventImpl* MakeEvent(T function);
 #include "event-impl.h"
 #include "type-traits.h"
 
+#include <type_traits>
+#include <typeinfo>
+
 namespace ns3
 {
 
@@ -392,6 +395,87 @@ struct EventMemberImplObjTraits<T*>
     }
 };
 
+/**
+ * \ingroup makeeventmemptr
+ * Helper for the MakeEvent functions which take a class method.
+ *
+ * This helper gives the class of a member function pointer.
+ *
+ * This is the generic template declaration, for which the class is unknown.
+ *
+ * \tparam MEM \explicit The class method function signature.
+ */
+template <typename MEM>
+struct EventMemberImplClassTraits
+{
+    /** The class of the method. */
+    using Class = void;
+};
+
+/**
+ * \ingroup makeeventmemptr
+ * Helper for the MakeEvent functions which take a class method.
+ *
+ * This is the specialization for non-const methods.
+ *
+ * \tparam R \deduced The return type of the method.
+ * \tparam C \deduced The class of the method.
+ * \tparam NE \deduced Whether the method is noexcept.
+ * \tparam Args \deduced The argument types of the method.
+ */
+template <typename R, typename C, bool NE, typename... Args>
+struct EventMemberImplClassTraits<R (C::*)(Args...) noexcept(NE)>
+{
+    /** The class of the method. */
+    using Class = C;
+};
+
+/**
+ * \ingroup makeeventmemptr
+ * Helper for the MakeEvent functions which take a class method.
+ *
+ * This is the specialization for const methods.
+ *
+ * \tparam R \deduced The return type of the method.
+ * \tparam C \deduced The class of the method.
+ * \tparam NE \deduced Whether the method is noexcept.
+ * \tparam Args \deduced The argument types of the method.
+ */
+template <typename R, typename C, bool NE, typename... Args>
+struct EventMemberImplClassTraits<R (C::*)(Args...) const noexcept(NE)>
+{
+    /** The class of the method. */
+    using Class = C;
+};
+
+/**
+ * \ingroup makeeventmemptr
+ * Helper for the MakeEvent functions which take a class method.
+ *
+ * This helper identifies the method the event calls on the object.
+ *
+ * \tparam MEM \deduced The class method function signature.
+ * \tparam OBJ \deduced The class type holding the method.
+ * \param [in] obj Class instance.
+ * \param [in] mem_ptr Class method member function pointer.
+ * \returns The function the event calls.
+ */
+template <typename MEM, typename OBJ>
+EventImpl::Function
+EventMemberImplGetFunction([[maybe_unused]] const OBJ& obj, const MEM& mem_ptr)
+{
+    using Class = typename EventMemberImplClassTraits<MEM>::Class;
+    if constexpr (std::is_void_v<Class>)
+    {
+        return {nullptr, &typeid(MEM)};
+    }
+    else
+    {
+        const Class* object = &EventMemberImplObjTraits<OBJ>::GetReference(obj);
+        return {EventImpl::GetMemberFunction(object, &mem_ptr, sizeof(mem_ptr)), &typeid(MEM)};
+    }
+}
+
 template <typename MEM, typename OBJ>
 EventImpl*
 MakeEvent(MEM mem_ptr, OBJ obj)
@@ -416,6 +500,11 @@ MakeEvent(MEM mem_ptr, OBJ obj)
             (EventMemberImplObjTraits<OBJ>::GetReference(m_obj).*m_function)();
         }
 
+        Function GetFunction() const override
+        {
+            return EventMemberImplGetFunction(m_obj, m_function);
+        }
+
         OBJ m_obj;
         MEM m_function;
     }* ev = new EventMemberImpl0(obj, mem_ptr);
@@ -449,6 +538,11 @@ MakeEvent(MEM mem_ptr, OBJ obj, T1 a1)
             (EventMemberImplObjTraits<OBJ>::GetReference(m_obj).*m_function)(m_a1);
         }
 
+        Function GetFunction() const override
+        {
+            return EventMemberImplGetFunction(m_obj, m_function);
+        }
+
         OBJ m_obj;
         MEM m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
@@ -484,6 +578,11 @@ MakeEvent(MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
             (EventMemberImplObjTraits<OBJ>::GetReference(m_obj).*m_function)(m_a1, m_a2);
         }
 
+        Function GetFunction() const override
+        {
+            return EventMemberImplGetFunction(m_obj, m_function);
+        }
+
         OBJ m_obj;
         MEM m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
@@ -521,6 +620,11 @@ MakeEvent(MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
             (EventMemberImplObjTraits<OBJ>::GetReference(m_obj).*m_function)(m_a1, m_a2, m_a3);
         }
 
+        Function GetFunction() const override
+        {
+            return EventMemberImplGetFunction(m_obj, m_function);
+        }
+
         OBJ m_obj;
         MEM m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
@@ -561,6 +665,11 @@ MakeEvent(MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4)
              m_function)(m_a1, m_a2, m_a3, m_a4);
         }
 
+        Function GetFunction() const override
+        {
+            return EventMemberImplGetFunction(m_obj, m_function);
+        }
+
         OBJ m_obj;
         MEM m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
@@ -609,6 +718,11 @@ MakeEvent(MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
              m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
         }
 
+        Function GetFunction() const override
+        {
+            return EventMemberImplGetFunction(m_obj, m_function);
+        }
+
         OBJ m_obj;
         MEM m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
@@ -660,6 +774,11 @@ MakeEvent(MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6)
              m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
         }
 
+        Function GetFunction() const override
+        {
+            return EventMemberImplGetFunction(m_obj, m_function);
+        }
+
         OBJ m_obj;
         MEM m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
@@ -700,6 +819,11 @@ MakeEvent(void (*f)(U1), T1 a1)
             (*m_function)(m_a1);
         }
 
+        Function GetFunction() const override
+        {
+            return {reinterpret_cast<const void*>(m_function), &typeid(F)};
+        }
+
         F m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
     }* ev = new EventFunctionImpl1(f, a1);
@@ -735,6 +859,11 @@ MakeEvent(void (*f)(U1, U2), T1 a1, T2 a2)
             (*m_function)(m_a1, m_a2);
         }
 
+        Function GetFunction() const override
+        {
+            return {reinterpret_cast<const void*>(m_function), &typeid(F)};
+        }
+
         F m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
         typename TypeTraits<T2>::ReferencedType m_a2;
@@ -772,6 +901,11 @@ MakeEvent(void (*f)(U1, U2, U3), T1 a1, T2 a2, T3 a3)
             (*m_function)(m_a1, m_a2, m_a3);
         }
 
+        Function GetFunction() const override
+        {
+            return {reinterpret_cast<const void*>(m_function), &typeid(F)};
+        }
+
         F m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
         typename TypeTraits<T2>::ReferencedType m_a2;
@@ -818,6 +952,11 @@ MakeEvent(void (*f)(U1, U2, U3, U4), T1 a1, T2 a2, T3 a3, T4 a4)
             (*m_function)(m_a1, m_a2, m_a3, m_a4);
         }
 
+        Function GetFunction() const override
+        {
+            return {reinterpret_cast<const void*>(m_function), &typeid(F)};
+        }
+
         F m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
         typename TypeTraits<T2>::ReferencedType m_a2;
@@ -868,6 +1007,11 @@ MakeEvent(void (*f)(U1, U2, U3, U4, U5), T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
             (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
         }
 
+        Function GetFunction() const override
+        {
+            return {reinterpret_cast<const void*>(m_function), &typeid(F)};
+        }
+
         F m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
         typename TypeTraits<T2>::ReferencedType m_a2;
@@ -922,6 +1066,11 @@ MakeEvent(void (*f)(U1, U2, U3, U4, U5, U6), T1 a1, T2 a2, T3 a3, T4 a4, T5 a5,
             (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
         }
 
+        Function GetFunction() const override
+        {
+            return {reinterpret_cast<const void*>(m_function), &typeid(F)};
+        }
+
         F m_function;
         typename TypeTraits<T1>::ReferencedType m_a1;
         typename TypeTraits<T2>::ReferencedType m_a2;
@@ -956,6 +1105,11 @@ MakeEvent(T function)
             m_function();
         }
 
+        Function GetFunction() const override
+        {
+            return {nullptr, &typeid(T)};
+        }
+
         T m_function;
     }* ev = new EventImplFunctional(function);
 
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ *
+ * A multi-producer single-consumer FIFO queue, used to hand over events
+ * scheduled from other threads to the simulator thread.
+ *
+ * Values go to a bounded ring whose slots carry a sequence number
+ * (Vyukov's bounded queue): a producer claims a slot with a single
+ * compare-and-swap of the tail and publishes it with a release store, so
+ * pushes never take a lock nor allocate.  Should the ring be full, values
+ * go to a mutex-protected overflow vector instead, and keep going there
+ * until the consumer has taken them, so that the values of any one
+ * producer still come out in the order they were pushed.
+ *
+ * Push() may be called from any thread; Drain() and IsEmpty() only from
+ * the consumer thread.
+ *
+ * \tparam T \pname{Value type}, default constructible and copyable.
+ */
+template <typename T>
+class MpscQueue
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] capacity Number of ring slots, rounded up to a power of two.
+     */
+    explicit MpscQueue(std::size_t capacity = 1024);
+
+    /**
+     * Add a value.  Thread-safe.
+     * \param [in] value The value.
+     */
+    void Push(const T& value);
+
+    /**
+     * Take every published value, in order.  Values still being pushed are
+     * left for the next call.
+     * \tparam F \deduced Type of the consumer function.
+     * \param [in] consume Called with each value.
+     * \returns The number of values taken.
+     */
+    template <typename F>
+    std::size_t Drain(F consume);
+
+    /**
+     * \returns \c true if no value has been pushed since the last Drain().
+     */
+    bool IsEmpty() const;
+
+  private:
+    /** A ring slot. */
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence; //!< Position the slot is ready for
+        T value;                           //!< The value
+    };
+
+    /**
+     * Push a value to the ring.
+     * \param [in] value The value.
+     * \returns \c false if the ring is full.
+     */
+    bool TryPush(const T& value);
+
+    std::unique_ptr<Slot[]> m_slots; //!< The ring
+    std::size_t m_mask;              //!< Number of slots minus one
+
+    alignas(64) std::atomic<std::size_t> m_tail; //!< Next position to claim
+    alignas(64) std::size_t m_head;              //!< Next position to consume
+
+    std::atomic<bool> m_overflowing; //!< Whether values go to m_overflow
+    std::mutex m_overflowMutex;      //!< Protects m_overflow
+    std::vector<T> m_overflow;       //!< Values pushed while the ring was full
+};
+
+/*************************************************************************
+ *  Implementation of the templates declared above.
+ *************************************************************************/
+
+template <typename T>
+MpscQueue<T>::MpscQueue(std::size_t capacity)
+    : m_tail(0),
+      m_head(0),
+      m_overflowing(false)
+{
+    std::size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    m_slots.reset(new Slot[size]);
+    m_mask = size - 1;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::TryPush(const T& value)
+{
+    std::size_t position = m_tail.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;)
+    {
+        slot = &m_slots[position & m_mask];
+        std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence - position);
+        if (diff == 0)
+        {
+            if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+    slot->value = value;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+void
+MpscQueue<T>::Push(const T& value)
+{
+    if (!m_overflowing.load(std::memory_order_acquire) && TryPush(value))
+    {
+        return;
+    }
+    std::unique_lock lock{m_overflowMutex};
+    m_overflow.push_back(value);
+    m_overflowing.store(true, std::memory_order_release);
+}
+
+template <typename T>
+template <typename F>
+std::size_t
+MpscQueue<T>::Drain(F consume)
+{
+    std::size_t count = 0;
+    for (;;)
+    {
+        Slot& slot = m_slots[m_head & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+        {
+            break;
+        }
+        consume(slot.value);
+        slot.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+        m_head++;
+        count++;
+    }
+
+    // The overflow holds values pushed after all those of the ring by the
+    // same producer, take it only once the ring has no claimed slot left
+    if (m_overflowing.load(std::memory_order_acquire) &&
+        m_tail.load(std::memory_order_acquire) == m_head)
+    {
+        std::vector<T> overflow;
+        {
+            std::unique_lock lock{m_overflowMutex};
+            overflow.swap(m_overflow);
+            m_overflowing.store(false, std::memory_order_release);
+        }
+        for (const auto& value : overflow)
+        {
+            consume(value);
+        }
+        count += overflow.size();
+    }
+    return count;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty() const
+{
+    return m_tail.load(std::memory_order_acquire) == m_head &&
+           !m_overflowing.load(std::memory_order_acquire);
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
@@ -19,6 +19,7 @@
 
 #include "abort.h"
 #include "assert.h"
+#include "config.h"
 #include "log.h"
 #include "object.h"
 #include "singleton.h"
@@ -315,6 +316,7 @@ NamesPriv::Clear()
     m_root.m_name = "Names";
     m_root.m_object = nullptr;
     m_root.m_nameMap.clear();
+    Config::InvalidateMatches();
 }
 
 bool
@@ -422,6 +424,7 @@ NamesPriv::Add(Ptr<Object> context, std::string name, Ptr<Object> object)
     auto newNode = new NameNode(node, name, object);
     node->m_nameMap[name] = newNode;
     m_objectMap[object] = newNode;
+    Config::InvalidateMatches();
 
     return true;
 }
@@ -545,6 +548,7 @@ NamesPriv::Rename(Ptr<Object> context, std::string oldname, std::string newname)
         node->m_nameMap.erase(i);
         changeNode->m_name = newname;
         node->m_nameMap[newname] = changeNode;
+        Config::InvalidateMatches();
         return true;
     }
 }
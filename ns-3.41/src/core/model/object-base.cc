@@ -20,8 +20,11 @@
 
 #include "assert.h"
 #include "attribute-construction-list.h"
+#include "config.h"
 #include "environment-variable.h"
 #include "log.h"
+#include "object-ptr-container.h"
+#include "pointer.h"
 #include "string.h"
 #include "trace-source-accessor.h"
 
@@ -197,6 +200,12 @@ ObjectBase::DoSet(Ptr<const AttributeAccessor> accessor,
         return false;
     }
     bool ok = accessor->Set(this, *v);
+    if (ok && (dynamic_cast<const PointerChecker*>(PeekPointer(checker)) ||
+               dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(checker))))
+    {
+        // the object may now be reached by other Config paths
+        Config::InvalidateMatches();
+    }
     return ok;
 }
 
@@ -150,4 +150,11 @@ ObjectPtrContainerAccessor::HasSetter() const
     return false;
 }
 
+bool
+ObjectPtrContainerAccessor::GetN(const ObjectBase* object, std::size_t* n) const
+{
+    NS_LOG_FUNCTION(this << object << n);
+    return DoGetN(object, n);
+}
+
 } // namespace ns3
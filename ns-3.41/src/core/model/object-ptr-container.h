@@ -232,6 +232,14 @@ class ObjectPtrContainerAccessor : public AttributeAccessor
     bool Get(const ObjectBase* object, AttributeValue& value) const override;
     bool HasGetter() const override;
     bool HasSetter() const override;
+    /**
+     * Get the number of instances in the container, without getting them.
+     *
+     * \param [in] object The container object.
+     * \param [out] n The number of instances in the container.
+     * \returns true if the value could be obtained successfully.
+     */
+    bool GetN(const ObjectBase* object, std::size_t* n) const;
 
   private:
     /**
@@ -22,6 +22,7 @@
 
 #include "assert.h"
 #include "attribute.h"
+#include "config.h"
 #include "log.h"
 #include "object-factory.h"
 #include "string.h"
@@ -96,6 +97,7 @@ Object::Object()
     : m_tid(Object::GetTypeId()),
       m_disposed(false),
       m_initialized(false),
+      m_configIndexed(false),
       m_aggregates((Aggregates*)std::malloc(sizeof(Aggregates))),
       m_getObjectCount(0)
 {
@@ -108,6 +110,11 @@ Object::~Object()
 {
     // remove this object from the aggregate list
     NS_LOG_FUNCTION(this);
+    if (m_configIndexed)
+    {
+        // the Config path index holds a pointer to this object
+        Config::InvalidateMatches();
+    }
     uint32_t n = m_aggregates->n;
     for (uint32_t i = 0; i < n; i++)
     {
@@ -133,6 +140,7 @@ Object::Object(const Object& o)
     : m_tid(o.m_tid),
       m_disposed(false),
       m_initialized(false),
+      m_configIndexed(false),
       m_aggregates((Aggregates*)std::malloc(sizeof(Aggregates))),
       m_getObjectCount(0)
 {
@@ -321,6 +329,7 @@ Object::AggregateObject(Ptr<Object> o)
     // Now that we are done with them, we can free our old aggregate buffers
     std::free(a);
     std::free(b);
+    Config::InvalidateMatches();
 }
 
 /**
@@ -45,6 +45,11 @@ class AttributeAccessor;
 class AttributeValue;
 class TraceSourceAccessor;
 
+namespace Config
+{
+class MatchIndex;
+} // namespace Config
+
 /**
  * \ingroup core
  * \defgroup object Object
@@ -328,6 +333,7 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
     friend class ObjectFactory;
     friend class AggregateIterator;
     friend struct ObjectDeleter;
+    friend class Config::MatchIndex;
 
     /**@}*/
 
@@ -428,6 +434,11 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      * \c false otherwise
      */
     bool m_initialized;
+    /**
+     * Set to \c true once the index of the Config paths holds a pointer
+     * to this Object, so that deleting it discards the index.
+     */
+    bool m_configIndexed;
     /**
      * A pointer to an array of 'aggregates'.
      *
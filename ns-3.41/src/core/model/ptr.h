@@ -141,6 +141,12 @@ class Ptr
      * \param [in] o The other Ptr instance.
      */
     Ptr(const Ptr& o);
+    /**
+     * Move by taking over the reference of the other Ptr.
+     *
+     * \param [in] o The other Ptr instance, left null.
+     */
+    Ptr(Ptr&& o) noexcept;
     /**
      * Copy, removing \c const qualifier.
      *
@@ -158,6 +164,13 @@ class Ptr
      * \return A reference to self.
      */
     Ptr<T>& operator=(const Ptr& o);
+    /**
+     * Move assignment operator, taking over the reference of the other Ptr.
+     *
+     * \param [in] o The other Ptr instance, left null.
+     * \return A reference to self.
+     */
+    Ptr<T>& operator=(Ptr&& o) noexcept;
     /**
      * An rvalue member access.
      * \returns A pointer to the underlying object.
@@ -672,6 +685,13 @@ Ptr<T>::Ptr(const Ptr& o)
     }
 }
 
+template <typename T>
+Ptr<T>::Ptr(Ptr&& o) noexcept
+    : m_ptr(o.m_ptr)
+{
+    o.m_ptr = nullptr;
+}
+
 template <typename T>
 template <typename U>
 Ptr<T>::Ptr(const Ptr<U>& o)
@@ -706,6 +726,24 @@ Ptr<T>::operator=(const Ptr& o)
     return *this;
 }
 
+template <typename T>
+Ptr<T>&
+Ptr<T>::operator=(Ptr&& o) noexcept
+{
+    if (&o == this)
+    {
+        return *this;
+    }
+    T* old = m_ptr;
+    m_ptr = o.m_ptr;
+    o.m_ptr = nullptr;
+    if (old != nullptr)
+    {
+        old->Unref();
+    }
+    return *this;
+}
+
 template <typename T>
 T*
 Ptr<T>::operator->()
@@ -111,6 +111,14 @@ class EventImpl;
  *      <td class="markdownTableBodyLeft"> 0 </td>
  * </tr>
  * <tr class="markdownTableBody">
+ *      <td class="markdownTableBodyLeft"> LadderScheduler </td>
+ *      <td class="markdownTableBodyLeft"> Rungs of `std::vector` buckets </td>
+ *      <td class="markdownTableBodyLeft"> Constant </td>
+ *      <td class="markdownTableBodyLeft"> Constant </td>
+ *      <td class="markdownTableBodyLeft"> 8 rungs </td>
+ *      <td class="markdownTableBodyLeft"> 0 </td>
+ * </tr>
+ * <tr class="markdownTableBody">
  *      <td class="markdownTableBodyLeft"> ListScheduler </td>
  *      <td class="markdownTableBodyLeft"> `std::list` </td>
  *      <td class="markdownTableBodyLeft"> Linear </td>
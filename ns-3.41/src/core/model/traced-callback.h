@@ -27,9 +27,45 @@
 /**
  * \file
  * \ingroup tracing
- * ns3::TracedCallback declaration and template implementation.
+ * ns3::TracedCallback declaration and template implementation,
+ * and the NS_TRACE macro.
  */
 
+/**
+ * \ingroup tracing
+ * Fire a trace source, if any trace sink is connected to it.
+ *
+ * Unlike a plain call of the trace source, the arguments are evaluated
+ * only when a sink is connected, so that the Ptr conversions, packet
+ * copies or other computations needed to build them cost nothing
+ * otherwise.  If the build is configured with \c NS3_TRACING=OFF, the
+ * trace point is compiled out: its sinks are never called.  Models which
+ * connect to a trace source for their own needs, like the flow control
+ * of the devices by their Queue, must thus fire it with a plain call.
+ *
+ * \param [in] trace The TracedCallback.
+ * \param [in] ... The arguments of the TracedCallback.
+ */
+#ifdef NS3_TRACING_DISABLE
+#define NS_TRACE(trace, ...)                                                                       \
+    do                                                                                             \
+    {                                                                                              \
+        if constexpr (false)                                                                       \
+        {                                                                                          \
+            (trace)(__VA_ARGS__);                                                                  \
+        }                                                                                          \
+    } while (false)
+#else
+#define NS_TRACE(trace, ...)                                                                       \
+    do                                                                                             \
+    {                                                                                              \
+        if (!(trace).IsEmpty())                                                                    \
+        {                                                                                          \
+            (trace)(__VA_ARGS__);                                                                  \
+        }                                                                                          \
+    } while (false)
+#endif
+
 namespace ns3
 {
 
@@ -45,7 +81,13 @@ namespace ns3
  *
  * This is a functor: the chain of Callbacks is invoked by
  * calling the \c operator() form with the appropriate
- * number of arguments.
+ * number of arguments.  On hot paths, fire it with NS_TRACE,
+ * which skips the construction of the arguments when no Callback
+ * is connected.
+ *
+ * If the build is configured with \c NS3_TRACING=OFF, the trace
+ * points fired with NS_TRACE are compiled out, while plain calls
+ * still invoke the chain of Callbacks.
  *
  * \tparam Ts \explicit Types of the functor arguments.
  */
@@ -189,7 +231,7 @@ TracedCallback<Ts...>::Disconnect(const CallbackBase& callback, std::string path
 }
 
 template <typename... Ts>
-void
+inline void
 TracedCallback<Ts...>::operator()(Ts... args) const
 {
     for (auto i = m_callbackList.begin(); i != m_callbackList.end(); i++)
@@ -199,7 +241,7 @@ TracedCallback<Ts...>::operator()(Ts... args) const
 }
 
 template <typename... Ts>
-bool
+inline bool
 TracedCallback<Ts...>::IsEmpty() const
 {
     return m_callbackList.empty();
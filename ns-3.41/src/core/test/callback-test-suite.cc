@@ -18,6 +18,9 @@
 #include "ns3/callback.h"
 #include "ns3/test.h"
 
+#include <array>
+#include <functional>
+#include <numeric>
 #include <stdint.h>
 
 using namespace ns3;
@@ -1178,6 +1181,298 @@ MakeCallbackTemplatesTestCase::DoRun()
     that.CheckParentalRights();
 }
 
+/**
+ * \ingroup callback-tests
+ *
+ * Test the storage of the callable objects of the Callbacks, inline or on
+ * the heap, and the calls through them.
+ */
+class CallbackStorageTestCase : public TestCase
+{
+  public:
+    CallbackStorageTestCase();
+
+    ~CallbackStorageTestCase() override
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * A callable object counting its instances.
+     * \tparam SIZE The size of its payload.
+     */
+    template <std::size_t SIZE>
+    struct Counted
+    {
+        Counted()
+        {
+            s_live++;
+        }
+
+        /**
+         * Copy constructor.
+         * \param [in] other The object to copy.
+         */
+        Counted(const Counted& other)
+            : m_payload(other.m_payload)
+        {
+            s_live++;
+            s_copies++;
+        }
+
+        /**
+         * Move constructor.
+         * \param [in] other The object to move.
+         */
+        Counted(Counted&& other) noexcept
+            : m_payload(other.m_payload)
+        {
+            s_live++;
+        }
+
+        ~Counted()
+        {
+            s_live--;
+        }
+
+        /**
+         * Increment a value.
+         * \param [in] x The value.
+         * \return The value plus one.
+         */
+        int operator()(int x)
+        {
+            return x + 1;
+        }
+
+        std::array<char, SIZE> m_payload{}; //!< The payload
+    };
+
+    /** An object whose method is bound to a Ptr to it. */
+    class Target : public SimpleRefCount<Target>
+    {
+      public:
+        /**
+         * Add a value to the total.
+         * \param [in] x The value.
+         * \return The total.
+         */
+        int Add(int x)
+        {
+            m_total += x;
+            return m_total;
+        }
+
+        int m_total{0}; //!< The total
+    };
+
+    /**
+     * Check the copies, moves and destruction of a stored callable object.
+     * \tparam SIZE The size of the payload of the callable object.
+     */
+    template <std::size_t SIZE>
+    void CheckStorage();
+
+    static int s_live;   //!< Number of live Counted instances
+    static int s_copies; //!< Number of copies of Counted instances
+};
+
+int CallbackStorageTestCase::s_live = 0;
+int CallbackStorageTestCase::s_copies = 0;
+
+/**
+ * Test function - sums a bound array and a value.
+ * \param [in] values The bound values.
+ * \param [in] x The value.
+ * \return The sum.
+ */
+uint64_t
+TestFSum(std::array<uint64_t, 16> values, uint64_t x)
+{
+    return std::accumulate(values.begin(), values.end(), x);
+}
+
+/**
+ * Test function - adds a value to a total.
+ * \param [out] total The total.
+ * \param [in] x The value.
+ */
+void
+TestFAccumulate(int& total, int x)
+{
+    total += x;
+}
+
+CallbackStorageTestCase::CallbackStorageTestCase()
+    : TestCase("Check the storage of callable objects")
+{
+}
+
+template <std::size_t SIZE>
+void
+CallbackStorageTestCase::CheckStorage()
+{
+    s_live = 0;
+    s_copies = 0;
+    {
+        CallbackFunction<int, int> f{Counted<SIZE>()};
+        NS_TEST_EXPECT_MSG_EQ(s_live, 1, "Temporary not destroyed");
+        NS_TEST_EXPECT_MSG_EQ(f(1), 2, "Wrong call result");
+
+        CallbackFunction<int, int> g(f);
+        NS_TEST_EXPECT_MSG_EQ(s_live, 2, "Callable object not copied");
+        NS_TEST_EXPECT_MSG_EQ(s_copies, 1, "Callable object not copied");
+        NS_TEST_EXPECT_MSG_EQ(g(2), 3, "Wrong call result of the copy");
+
+        CallbackFunction<int, int> h(std::move(f));
+        NS_TEST_EXPECT_MSG_EQ(bool(f), false, "Moved wrapper not empty");
+        NS_TEST_EXPECT_MSG_EQ(s_live, 2, "Moved callable object not destroyed");
+        NS_TEST_EXPECT_MSG_EQ(s_copies, 1, "Callable object copied by a move");
+        NS_TEST_EXPECT_MSG_EQ(h(3), 4, "Wrong call result of the moved wrapper");
+
+        g = h;
+        NS_TEST_EXPECT_MSG_EQ(s_live, 2, "Overwritten callable object not destroyed");
+        f = std::move(g);
+        NS_TEST_EXPECT_MSG_EQ(s_live, 2, "Callable object leaked by a move");
+        NS_TEST_EXPECT_MSG_EQ(f(4), 5, "Wrong call result of the assigned wrapper");
+    }
+    NS_TEST_EXPECT_MSG_EQ(s_live, 0, "Callable objects leaked");
+}
+
+void
+CallbackStorageTestCase::DoRun()
+{
+    // Callable objects stored inline, and on the heap
+    CheckStorage<8>();
+    CheckStorage<CallbackFunction<int, int>::CAPACITY * 2>();
+
+    //
+    // A method bound to a Ptr, as a protocol binds the Send() of its lower
+    // layer, stored inline
+    //
+    Ptr<Target> target = Create<Target>();
+    Callback<int, int> add = MakeCallback(&Target::Add, target);
+    auto impl = DynamicCast<CallbackImpl<int, int>>(add.GetImpl());
+    NS_TEST_ASSERT_MSG_EQ(bool(impl), true, "Unexpected callback implementation");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetFunction().IsInline(),
+                          true,
+                          "Method bound to a Ptr not stored inline");
+    NS_TEST_EXPECT_MSG_EQ(add(3), 3, "Wrong call result");
+    NS_TEST_EXPECT_MSG_EQ(target->m_total, 3, "Method not called on the bound object");
+
+    //
+    // Bound arguments too large to be stored inline
+    //
+    std::array<uint64_t, 16> values;
+    std::iota(values.begin(), values.end(), 1);
+    Callback<uint64_t, uint64_t> sum = MakeBoundCallback(&TestFSum, values);
+    NS_TEST_EXPECT_MSG_EQ(sum(1000), 1136, "Wrong sum");
+    Callback<uint64_t> bound = sum.Bind(2000);
+    Callback<uint64_t, uint64_t> copy = sum;
+    sum.Nullify();
+    NS_TEST_EXPECT_MSG_EQ(bound(), 2136, "Wrong sum of the bound callback");
+    NS_TEST_EXPECT_MSG_EQ(copy(3000), 3136, "Wrong sum of the copy");
+    NS_TEST_EXPECT_MSG_EQ(MakeBoundCallback(&TestFSum, values).IsEqual(copy),
+                          true,
+                          "Callbacks bound to equal values should be equal");
+
+    //
+    // A callable object returning a value, called by a callback returning void
+    //
+    int last = 0;
+    Callback<void, int> discard([&last](int x) {
+        last = x;
+        return x;
+    });
+    discard(42);
+    NS_TEST_EXPECT_MSG_EQ(last, 42, "Callback did not fire");
+
+    //
+    // An argument bound by reference
+    //
+    int total = 0;
+    Callback<void, int> accumulate = MakeBoundCallback(&TestFAccumulate, std::ref(total));
+    accumulate(3);
+    accumulate(4);
+    NS_TEST_EXPECT_MSG_EQ(total, 7, "Bound reference not updated");
+}
+
+/**
+ * \ingroup callback-tests
+ *
+ * Test a call which destroys the callback being called, as a socket does
+ * when it closes from its receive callback and releases the endpoint
+ * holding the callback.
+ */
+class SelfDestroyingCallbackTestCase : public TestCase
+{
+  public:
+    SelfDestroyingCallbackTestCase();
+
+    ~SelfDestroyingCallbackTestCase() override
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /** An object kept alive only by a callback to one of its methods. */
+    class Holder : public SimpleRefCount<Holder>
+    {
+      public:
+        Holder()
+        {
+            s_live++;
+        }
+
+        ~Holder()
+        {
+            s_live--;
+        }
+
+        /**
+         * Reset the callback holding this object, then use the object.
+         * \param [in] x A value to store.
+         */
+        void Release(int x)
+        {
+            m_callback.Nullify();
+            s_liveAfterReset = s_live;
+            m_value = x;
+        }
+
+        Callback<void, int> m_callback; //!< The callback to Release()
+        int m_value{0};                 //!< The stored value
+    };
+
+    static int s_live;           //!< Number of live Holder instances
+    static int s_liveAfterReset; //!< Number of live Holder instances after the reset
+};
+
+int SelfDestroyingCallbackTestCase::s_live = 0;
+int SelfDestroyingCallbackTestCase::s_liveAfterReset = 0;
+
+SelfDestroyingCallbackTestCase::SelfDestroyingCallbackTestCase()
+    : TestCase("Check a call can destroy the callback being called")
+{
+}
+
+void
+SelfDestroyingCallbackTestCase::DoRun()
+{
+    Ptr<Holder> holder = Create<Holder>();
+    holder->m_callback = MakeCallback(&Holder::Release, holder);
+    Holder* raw = PeekPointer(holder);
+    holder = nullptr;
+    NS_TEST_ASSERT_MSG_EQ(s_live, 1, "Holder not kept alive by its callback");
+
+    raw->m_callback(5);
+    NS_TEST_EXPECT_MSG_EQ(s_liveAfterReset, 1, "Holder destroyed during the call");
+    NS_TEST_EXPECT_MSG_EQ(s_live, 0, "Holder not destroyed after the call");
+}
+
 /**
  * \ingroup callback-tests
  *
@@ -1198,6 +1493,8 @@ CallbackTestSuite::CallbackTestSuite()
     AddTestCase(new CallbackEqualityTestCase, TestCase::QUICK);
     AddTestCase(new NullifyCallbackTestCase, TestCase::QUICK);
     AddTestCase(new MakeCallbackTemplatesTestCase, TestCase::QUICK);
+    AddTestCase(new CallbackStorageTestCase, TestCase::QUICK);
+    AddTestCase(new SelfDestroyingCallbackTestCase, TestCase::QUICK);
 }
 
 static CallbackTestSuite g_gallbackTestSuite; //!< Static variable for test initialization
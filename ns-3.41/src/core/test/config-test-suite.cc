@@ -84,6 +84,12 @@ class ConfigTestObject : public Object
      * \param b test object b
      */
     void SetNodeB(Ptr<ConfigTestObject> b);
+    /**
+     * Replace a node B function
+     * \param i the index of the node b
+     * \param b test object b
+     */
+    void ReplaceNodeB(std::size_t i, Ptr<ConfigTestObject> b);
 
     /**
      * Get node A function
@@ -165,6 +171,12 @@ ConfigTestObject::SetNodeB(Ptr<ConfigTestObject> b)
     m_nodeB = b;
 }
 
+void
+ConfigTestObject::ReplaceNodeB(std::size_t i, Ptr<ConfigTestObject> b)
+{
+    m_nodesB[i] = b;
+}
+
 void
 ConfigTestObject::AddNodeA(Ptr<ConfigTestObject> a)
 {
@@ -864,6 +876,176 @@ SearchAttributesOfParentObjectsTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), 42, "Object Attribute \"X\" not settable in derived class");
 }
 
+/**
+ * \ingroup config-tests
+ * Test the index of the objects matched by Config paths, and
+ * Config::ConnectMany.
+ */
+class MatchIndexConfigTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    MatchIndexConfigTestCase();
+
+    /**
+     * Trace callback with context path.
+     * \param path The context path.
+     * \param old The old value.
+     * \param newValue The new value.
+     */
+    void TraceWithPath(std::string path,
+                       int16_t old [[maybe_unused]],
+                       int16_t newValue [[maybe_unused]])
+    {
+        m_paths.push_back(path);
+    }
+
+    /**
+     * Trace callback without context.
+     * \param old The old value.
+     * \param newValue The new value.
+     */
+    void Trace(int16_t old [[maybe_unused]], int16_t newValue)
+    {
+        m_sum += newValue;
+    }
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    std::vector<std::string> m_paths; //!< The context paths traced.
+    int16_t m_sum;                    //!< The sum of the values traced.
+};
+
+MatchIndexConfigTestCase::MatchIndexConfigTestCase()
+    : TestCase("Check that the objects matched by paths follow the changes of the objects"),
+      m_sum(0)
+{
+}
+
+void
+MatchIndexConfigTestCase::DoRun()
+{
+    Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject>();
+    Config::MatchContainer matches = Config::LookupMatches("/Names/Index");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 0, "Object found before being named");
+    Names::Add("Index", root);
+    matches = Config::LookupMatches("/Names/Index");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Named object not found");
+
+    root->AddNodeB(CreateObject<ConfigTestObject>());
+    root->AddNodeB(CreateObject<ConfigTestObject>());
+    matches = Config::LookupMatches("/Names/Index/NodesB/*");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 2, "Created objects not found");
+    Config::MatchContainer again = Config::LookupMatches("/Names/Index/NodesB/*");
+    NS_TEST_ASSERT_MSG_EQ(again.GetN(), 2, "Indexed path does not match the same objects");
+    for (std::size_t i = 0; i < again.GetN(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(again.Get(i), matches.Get(i), "Different object " << i);
+        NS_TEST_EXPECT_MSG_EQ(again.GetMatchedPath(i),
+                              matches.GetMatchedPath(i),
+                              "Different context " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(again.GetMatchedPath(1), "/Names/Index/NodesB/1/", "Wrong context");
+
+    Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject>();
+    root->AddNodeB(b);
+    matches = Config::LookupMatches("/Names/Index/NodesB/*");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 3, "Object created after the lookup not found");
+    matches = Config::LookupMatches("/Names/Index/NodesB/02");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Object not found by index");
+    NS_TEST_EXPECT_MSG_EQ(matches.Get(0), b, "Wrong object found by index");
+    NS_TEST_EXPECT_MSG_EQ(matches.GetMatchedPath(0), "/Names/Index/NodesB/2/", "Wrong context");
+
+    // An existing object made reachable by a Pointer attribute
+    Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject>();
+    matches = Config::LookupMatches("/Names/Index/NodeA");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 0, "Object found before being set");
+    root->SetAttribute("NodeA", PointerValue(a));
+    matches = Config::LookupMatches("/Names/Index/NodeA");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Object set as attribute not found");
+
+    // An existing object aggregated
+    Ptr<DerivedConfigObject> derived = CreateObject<DerivedConfigObject>();
+    matches = Config::LookupMatches("/Names/Index/$DerivedConfigObject");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 0, "Object found before being aggregated");
+    root->AggregateObject(derived);
+    matches = Config::LookupMatches("/Names/Index/$DerivedConfigObject");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Aggregated object not found");
+
+    // An existing object stored in a Pointer attribute by a plain setter
+    Ptr<ConfigTestObject> c = CreateObject<ConfigTestObject>();
+    matches = Config::LookupMatches("/Names/Index/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 0, "Object found before being set");
+    root->SetNodeB(c);
+    matches = Config::LookupMatches("/Names/Index/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Object set by a plain setter not found");
+
+    Config::ConnectMany(
+        {{"/Names/Index/NodesB/0|2/Source",
+          MakeCallback(&MatchIndexConfigTestCase::TraceWithPath, this)},
+         {"/Names/Index/NodeA/Source",
+          MakeCallback(&MatchIndexConfigTestCase::TraceWithPath, this)},
+         {"/Names/Index/NodeB/Source",
+          MakeCallback(&MatchIndexConfigTestCase::TraceWithPath, this)}});
+    Config::ConnectManyWithoutContext(
+        {{"/Names/Index/NodesB/*/Source", MakeCallback(&MatchIndexConfigTestCase::Trace, this)},
+         {"/Names/Index/NodeA/Source", MakeCallback(&MatchIndexConfigTestCase::Trace, this)}});
+    Config::MatchContainer nodes = Config::LookupMatches("/Names/Index/NodesB/*");
+    for (std::size_t i = 0; i < nodes.GetN(); i++)
+    {
+        nodes.Get(i)->SetAttribute("Source", IntegerValue(i + 1));
+    }
+    a->SetAttribute("Source", IntegerValue(10));
+    c->SetAttribute("Source", IntegerValue(20));
+    std::vector<std::string> expected = {"/Names/Index/NodesB/0/Source",
+                                         "/Names/Index/NodesB/2/Source",
+                                         "/Names/Index/NodeA/Source",
+                                         "/Names/Index/NodeB/Source"};
+    NS_TEST_ASSERT_MSG_EQ(m_paths.size(), expected.size(), "Wrong number of traces");
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_paths[i], expected[i], "Wrong context of trace " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_sum, 1 + 2 + 3 + 10, "Wrong traces without context");
+
+    // The objects created and deleted as the simulation runs, e.g., the
+    // sockets, keep the index, which still holds an object replaced in its
+    // container by a plain setter
+    Ptr<Object> first = Config::LookupMatches("/Names/Index/NodesB/0").Get(0);
+    Ptr<ConfigTestObject> d = CreateObject<ConfigTestObject>();
+    root->ReplaceNodeB(0, d);
+    for (int i = 0; i < 10; i++)
+    {
+        Ptr<ConfigTestObject> other = CreateObject<ConfigTestObject>();
+        other->Initialize();
+        other->Dispose();
+    }
+    matches = Config::LookupMatches("/Names/Index/NodesB/0");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Object not found by index");
+    NS_TEST_EXPECT_MSG_EQ(matches.Get(0), first, "Index discarded by unrelated objects");
+    Config::InvalidateMatches();
+    matches = Config::LookupMatches("/Names/Index/NodesB/0");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Object not found after InvalidateMatches");
+    NS_TEST_EXPECT_MSG_EQ(matches.Get(0), d, "Replaced object not found");
+
+    // Deleting an indexed object discards the index
+    d = nullptr;
+    matches = Config::MatchContainer();
+    Ptr<ConfigTestObject> e = CreateObject<ConfigTestObject>();
+    root->ReplaceNodeB(0, e);
+    matches = Config::LookupMatches("/Names/Index/NodesB/0");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Object not found by index");
+    NS_TEST_EXPECT_MSG_EQ(matches.Get(0), e, "Index kept a deleted object");
+}
+
+void
+MatchIndexConfigTestCase::DoTeardown()
+{
+    Names::Clear();
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -882,6 +1064,7 @@ ConfigTestSuite::ConfigTestSuite()
     AddTestCase(new UnderRootNamespaceConfigTestCase);
     AddTestCase(new ObjectVectorConfigTestCase);
     AddTestCase(new SearchAttributesOfParentObjectsTestCase);
+    AddTestCase(new MatchIndexConfigTestCase);
 }
 
 /**
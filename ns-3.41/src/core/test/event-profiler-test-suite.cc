@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/event-profiler.h"
+#include "ns3/make-event.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <set>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup events
+ * \ingroup event-profiler-tests
+ * EventProfiler test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup event-profiler-tests EventProfiler tests
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup event-profiler-tests
+ * The object of the profiled events.
+ */
+class ProfiledObject
+{
+  public:
+    virtual ~ProfiledObject() = default;
+
+    /**
+     * A non-virtual event.
+     * \param [in] i An argument.
+     */
+    void Count(int i);
+    /** A virtual event. */
+    virtual void Handle();
+
+    int m_count{0}; //!< The sum of the Count() arguments.
+};
+
+void
+ProfiledObject::Count(int i)
+{
+    m_count += i;
+}
+
+void
+ProfiledObject::Handle()
+{
+}
+
+/**
+ * \ingroup event-profiler-tests
+ * A derived object of the profiled events.
+ */
+class DerivedProfiledObject : public ProfiledObject
+{
+  public:
+    void Handle() override;
+};
+
+void
+DerivedProfiledObject::Handle()
+{
+    m_count++;
+}
+
+/**
+ * \ingroup event-profiler-tests
+ * A function event.
+ * \param [in] object The object.
+ */
+void
+ProfiledFunction(ProfiledObject* object)
+{
+    object->m_count += 100;
+}
+
+/**
+ * \ingroup event-profiler-tests
+ *
+ * \brief Check the EventProfiler identifies the functions of events.
+ */
+class EventProfilerTestCase : public TestCase
+{
+  public:
+    EventProfilerTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Get the stacks of a folded profile, without their times.
+     * \param [in] folded The folded profile.
+     * \returns The stacks.
+     */
+    std::set<std::string> GetStacks(const std::string& folded);
+};
+
+EventProfilerTestCase::EventProfilerTestCase()
+    : TestCase("Check the EventProfiler identifies the functions of events")
+{
+}
+
+std::set<std::string>
+EventProfilerTestCase::GetStacks(const std::string& folded)
+{
+    std::set<std::string> stacks;
+    std::istringstream lines(folded);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        stacks.insert(line.substr(0, line.find_last_of(' ')));
+    }
+    return stacks;
+}
+
+void
+EventProfilerTestCase::DoRun()
+{
+    DerivedProfiledObject object;
+    ProfiledObject* base = &object;
+    auto lambda = [&object]() { object.m_count += 1000; };
+    std::string lambdaName = "ns3::tests::EventProfilerTestCase::DoRun()::{lambda()#1}";
+
+    EventProfiler profiler;
+    EventImpl* cancelled = MakeEvent(&ProfiledObject::Count, base, 7);
+    cancelled->Cancel();
+    profiler.Invoke(cancelled, 1);
+    cancelled->Unref();
+    std::set<std::string> expected;
+    for (uint32_t context = 1; context <= 2; context++)
+    {
+        EventImpl* events[] = {MakeEvent(&ProfiledObject::Count, base, 1),
+                               MakeEvent(&ProfiledObject::Handle, base),
+                               MakeEvent(&ProfiledFunction, base),
+                               MakeEvent(lambda)};
+        for (auto event : events)
+        {
+            profiler.Invoke(event, context);
+            event->Unref();
+        }
+        std::string node = "node " + std::to_string(context) + ";";
+        expected.insert(node + "ns3::tests::ProfiledObject::Count(int)");
+        expected.insert(node + "ns3::tests::DerivedProfiledObject::Handle()");
+        expected.insert(node + "ns3::tests::ProfiledFunction(ns3::tests::ProfiledObject*)");
+        expected.insert(node + lambdaName);
+    }
+    NS_TEST_EXPECT_MSG_EQ(object.m_count, 2 * 1102, "Events not invoked");
+
+    std::ostringstream folded;
+    profiler.Write(folded, EventProfiler::FOLDED);
+    NS_TEST_EXPECT_MSG_EQ((GetStacks(folded.str()) == expected),
+                          true,
+                          "Unexpected folded profile:\n"
+                              << folded.str());
+
+    std::ostringstream report;
+    profiler.Write(report, EventProfiler::REPORT);
+    NS_TEST_EXPECT_MSG_EQ(report.str().find("Event profile: 8 events, 1 cancelled events"),
+                          0,
+                          "Unexpected report:\n"
+                              << report.str());
+    NS_TEST_EXPECT_MSG_NE(report.str().find(" 2 " /* events */),
+                          std::string::npos,
+                          "Unexpected report:\n"
+                              << report.str());
+
+    // Through the simulator
+    std::string filename = CreateTempDirFilename("profile.folded");
+    Simulator::Destroy();
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfile", StringValue(filename));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfileFormat",
+                       EnumValue(EventProfiler::FOLDED));
+    Simulator::ScheduleWithContext(3, Seconds(1), &ProfiledObject::Handle, base);
+    Simulator::Schedule(Seconds(2), &ProfiledFunction, base);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::ifstream is(filename);
+    std::ostringstream file;
+    file << is.rdbuf();
+    expected = {"node 3;ns3::tests::DerivedProfiledObject::Handle()",
+                "no node;ns3::tests::ProfiledFunction(ns3::tests::ProfiledObject*)"};
+    NS_TEST_EXPECT_MSG_EQ((GetStacks(file.str()) == expected),
+                          true,
+                          "Unexpected simulator profile:\n"
+                              << file.str());
+}
+
+void
+EventProfilerTestCase::DoTeardown()
+{
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfile", StringValue(""));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::EventProfileFormat",
+                       EnumValue(EventProfiler::REPORT));
+}
+
+/**
+ * \ingroup event-profiler-tests
+ *
+ * \brief EventProfiler TestSuite
+ */
+class EventProfilerTestSuite : public TestSuite
+{
+  public:
+    EventProfilerTestSuite()
+        : TestSuite("event-profiler", UNIT)
+    {
+        AddTestCase(new EventProfilerTestCase(), TestCase::QUICK);
+    }
+};
+
+static EventProfilerTestSuite g_eventProfilerTestSuite; //!< Static variable for test initialization
+
+} // namespace tests
+
+} // namespace ns3
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * \ingroup logging-tests
+ * Binary log test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup logging-tests Logging tests
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+NS_LOG_COMPONENT_DEFINE("BinaryLogTestSuite");
+
+/**
+ * \ingroup logging-tests
+ * A type the binary log does not know.
+ */
+struct Opaque
+{
+    int value; //!< The value
+};
+
+/**
+ * \ingroup logging-tests
+ * Print an Opaque.
+ * \param [in,out] os The output stream.
+ * \param [in] opaque The Opaque.
+ * \returns The output stream.
+ */
+std::ostream&
+operator<<(std::ostream& os, const Opaque& opaque)
+{
+    return os << "opaque(" << opaque.value << ")";
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * \brief Check the binary log decodes into the text log.
+ */
+class BinaryLogTestCase : public TestCase
+{
+  public:
+    BinaryLogTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Log messages of all kinds.
+     * \param [in] i The message parameter.
+     */
+    void Log(int32_t i);
+    /**
+     * Log messages before, and in events of, a simulation.
+     * \param [in] node3Only Only log in the event with context 3.
+     */
+    void Scenario(bool node3Only);
+    /**
+     * Capture the text log of a scenario.
+     * \param [in] node3Only Only log in the event with context 3.
+     * \returns The text.
+     */
+    std::string RunText(bool node3Only);
+    /**
+     * Log a scenario to a binary file.
+     * \returns The file name.
+     */
+    std::string RunBinary();
+    /**
+     * Decode a binary log.
+     * \param [in] filename The file name.
+     * \param [in] component The component filter.
+     * \param [in] node The node filter.
+     * \returns The text.
+     */
+    std::string Decode(const std::string& filename,
+                       const std::string& component = "",
+                       int64_t node = -1);
+};
+
+BinaryLogTestCase::BinaryLogTestCase()
+    : TestCase("Check the binary log decodes into the text log")
+{
+}
+
+void
+BinaryLogTestCase::Log(int32_t i)
+{
+    NS_LOG_FUNCTION(this << i << "literal" << std::string("string") << uint8_t(7) << true << 1.5);
+    NS_LOG_FUNCTION_NOARGS();
+    NS_LOG_DEBUG("int " << i << " uint8 " << uint8_t(65) << " int8 " << int8_t(66) << " bool "
+                        << (i > 0) << " char " << 'c');
+    // The text log keeps the precision and fill of a message for the next ones
+    NS_LOG_INFO("double " << 1.0 / 3 << " " << std::setprecision(3) << 2.0 / 3 << " "
+                          << std::fixed << 1.25 << " float " << 0.5f << " uint64 "
+                          << uint64_t(1) << 40 << std::setprecision(6));
+    NS_LOG_LOGIC("hex " << std::hex << 255 << std::dec << " width [" << std::setw(6)
+                        << std::setfill('*') << 42 << "] [" << std::left << std::setw(5) << "ab"
+                        << "]" << std::setfill(' '));
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "buffer%d", i);
+    NS_LOG_WARN(buffer << " " << static_cast<const char*>(buffer));
+    std::snprintf(buffer, sizeof(buffer), "changed%d", i);
+    NS_LOG_WARN(buffer);
+    NS_LOG_ERROR("time " << Seconds(1.5) << " pointer " << this << " null " << Ptr<Object>()
+                         << " opaque " << Opaque{i} << " after " << 3 << std::endl
+                         << "second line");
+    NS_LOG_DEBUG(i);
+    if (i == 2)
+    {
+        // Larger than the buffer of a thread
+        NS_LOG_DEBUG(std::string(600000, 'x'));
+    }
+}
+
+void
+BinaryLogTestCase::Scenario(bool node3Only)
+{
+    if (!node3Only)
+    {
+        Log(0);
+        Simulator::Schedule(Seconds(2), &BinaryLogTestCase::Log, this, 2);
+    }
+    Simulator::ScheduleWithContext(3, Seconds(1.5), &BinaryLogTestCase::Log, this, 1);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+std::string
+BinaryLogTestCase::RunText(bool node3Only)
+{
+    std::ostringstream text;
+    std::streambuf* clog = std::clog.rdbuf(text.rdbuf());
+    Scenario(node3Only);
+    std::clog.rdbuf(clog);
+    return text.str();
+}
+
+std::string
+BinaryLogTestCase::RunBinary()
+{
+    std::string filename = CreateTempDirFilename("binary.log");
+    LogSetBinaryFile(filename);
+    Scenario(false);
+    LogSetBinaryFile("");
+    return filename;
+}
+
+std::string
+BinaryLogTestCase::Decode(const std::string& filename, const std::string& component, int64_t node)
+{
+    std::ifstream is(filename, std::ios::binary);
+    std::ostringstream text;
+    NS_TEST_EXPECT_MSG_EQ(LogDecodeBinary(is, text, component, node), true, "Decoding failed");
+    return text.str();
+}
+
+void
+BinaryLogTestCase::DoRun()
+{
+#ifdef NS3_LOG_ENABLE
+    LogComponentEnable("BinaryLogTestSuite", LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+
+    std::string text = RunText(false);
+    std::string filename = RunBinary();
+    NS_TEST_ASSERT_MSG_NE(text.find("changed"), std::string::npos, "Missing messages");
+    NS_TEST_EXPECT_MSG_EQ(Decode(filename), text, "Binary log differs from the text log");
+    NS_TEST_EXPECT_MSG_EQ(Decode(filename, "BinaryLogTestSuite"), text, "Component filtered out");
+    NS_TEST_EXPECT_MSG_EQ(Decode(filename, "Other"), "", "Other component not filtered out");
+    NS_TEST_EXPECT_MSG_EQ(Decode(filename, "", 3), RunText(true), "Node not filtered");
+
+    // Concurrent threads, without simulation prefixes
+    LogSetBinaryFile(filename);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; t++)
+    {
+        threads.emplace_back([t]() {
+            for (uint32_t j = 0; j < 20000; j++)
+            {
+                NS_LOG_DEBUG("thread " << t << " message " << j);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    LogSetBinaryFile("");
+
+    std::istringstream lines(Decode(filename));
+    std::vector<uint32_t> next(4, 0);
+    std::string line;
+    uint32_t misordered = 0;
+    while (std::getline(lines, line))
+    {
+        uint32_t t;
+        uint32_t j;
+        const char* format = "BinaryLogTestSuite:operator()(): [DEBUG] thread %u message %u";
+        if (std::sscanf(line.c_str(), format, &t, &j) != 2 || t >= 4 || next[t]++ != j)
+        {
+            misordered++;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(misordered, 0, "Thread messages lost or out of order");
+    NS_TEST_EXPECT_MSG_EQ(next[0] + next[1] + next[2] + next[3], 80000, "Thread messages lost");
+#endif /* NS3_LOG_ENABLE */
+}
+
+void
+BinaryLogTestCase::DoTeardown()
+{
+    LogComponentDisable("BinaryLogTestSuite", LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * \brief Binary log TestSuite
+ */
+class BinaryLogTestSuite : public TestSuite
+{
+  public:
+    BinaryLogTestSuite()
+        : TestSuite("log-binary", UNIT)
+    {
+        AddTestCase(new BinaryLogTestCase(), TestCase::QUICK);
+    }
+};
+
+static BinaryLogTestSuite g_binaryLogTestSuite; //!< Static variable for test initialization
+
+} // namespace tests
+
+} // namespace ns3
@@ -18,12 +18,17 @@
  */
 #include "ns3/calendar-scheduler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#include <iterator>
+#include <random>
+#include <set>
+
 using namespace ns3;
 
 /**
@@ -707,6 +712,159 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the order of events in a scheduler driven directly, against
+ * a sorted reference, with dense, tied and far apart time stamps.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check the order of events in " + schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    std::mt19937 rng(1);
+    std::set<Scheduler::EventKey> reference;
+    uint64_t now = 0;
+    uint32_t uid = 0;
+
+    for (uint32_t step = 0; step < 20000; step++)
+    {
+        uint32_t action = rng() % 8;
+        if (action < 4 || reference.empty())
+        {
+            // Mostly dense delays, some ties with the present and long timers
+            uint64_t delay = rng() % 4 == 0 ? 0 : rng() % 1000;
+            if (rng() % 50 == 0)
+            {
+                delay = 1000000000 + rng() % 1000000;
+            }
+            Scheduler::Event ev{nullptr, {now + delay, uid++, 0}};
+            scheduler->Insert(ev);
+            reference.insert(ev.key);
+        }
+        else if (action < 7)
+        {
+            Scheduler::Event ev = scheduler->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid, reference.begin()->m_uid, "Earliest event");
+            NS_TEST_ASSERT_MSG_EQ(ev.key.m_ts, reference.begin()->m_ts, "Earliest time");
+            reference.erase(reference.begin());
+            now = ev.key.m_ts;
+        }
+        else
+        {
+            auto key = reference.begin();
+            std::advance(key, rng() % reference.size());
+            scheduler->Remove(Scheduler::Event{nullptr, *key});
+            reference.erase(key);
+        }
+        NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), reference.empty(), "Empty");
+        if (!reference.empty())
+        {
+            NS_TEST_ASSERT_MSG_EQ(scheduler->PeekNext().key.m_uid,
+                                  reference.begin()->m_uid,
+                                  "Next event");
+        }
+    }
+    // A burst of events at the present, mixed with some later ones
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        uint64_t delay = i % 10 == 0 ? 1 + rng() % 1000 : 0;
+        Scheduler::Event ev{nullptr, {now + delay, uid++, 0}};
+        scheduler->Insert(ev);
+        reference.insert(ev.key);
+        NS_TEST_ASSERT_MSG_EQ(scheduler->PeekNext().key.m_uid,
+                              reference.begin()->m_uid,
+                              "Next event in a burst");
+    }
+    while (!reference.empty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(scheduler->RemoveNext().key.m_uid,
+                              reference.begin()->m_uid,
+                              "Drained in order");
+        reference.erase(reference.begin());
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), true, "Drained");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the memory of events is recycled, and that bound
+ * arguments survive it.
+ */
+class EventPoolTestCase : public TestCase
+{
+  public:
+    EventPoolTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Record the sum of the arguments.
+     * \param a First argument.
+     * \param b Second argument.
+     */
+    void Sum(uint64_t a, uint64_t b);
+
+    uint64_t m_sum; //!< Sum of the arguments of the events run.
+};
+
+EventPoolTestCase::EventPoolTestCase()
+    : TestCase("Check that event memory is recycled"),
+      m_sum(0)
+{
+}
+
+void
+EventPoolTestCase::Sum(uint64_t a, uint64_t b)
+{
+    m_sum += a + b;
+}
+
+void
+EventPoolTestCase::DoRun()
+{
+    EventImpl* first = MakeEvent(&EventPoolTestCase::Sum, this, 1, 2);
+    void* memory = first;
+    first->Unref();
+    EventImpl* second = MakeEvent(&EventPoolTestCase::Sum, this, 3, 4);
+#if !defined(__SANITIZE_ADDRESS__)
+    NS_TEST_EXPECT_MSG_EQ(static_cast<void*>(second), memory, "Memory reused");
+#endif
+    second->Invoke();
+    second->Unref();
+    NS_TEST_EXPECT_MSG_EQ(m_sum, 7, "Arguments bound");
+
+    for (uint64_t i = 0; i < 10000; i++)
+    {
+        Simulator::Schedule(NanoSeconds(i % 100), &EventPoolTestCase::Sum, this, i, 0);
+        Simulator::Schedule(NanoSeconds(i % 7), [this, i]() { m_sum += i; });
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(m_sum, 7 + 2 * (10000 * 9999 / 2), "Every event run once");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -730,6 +888,19 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+
+        for (const auto& scheduler : {ListScheduler::GetTypeId(),
+                                      MapScheduler::GetTypeId(),
+                                      CalendarScheduler::GetTypeId(),
+                                      PriorityQueueScheduler::GetTypeId(),
+                                      LadderScheduler::GetTypeId()})
+        {
+            factory.SetTypeId(scheduler);
+            AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        }
+        AddTestCase(new EventPoolTestCase, TestCase::QUICK);
     }
 };
 
@@ -21,6 +21,7 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
+#include "ns3/mpsc-queue.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
@@ -30,6 +31,7 @@
 #include <list>
 #include <thread> // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -278,6 +280,71 @@ ThreadedSimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that an MpscQueue hands over every value of concurrent
+ * producers, in the order each producer pushed them, including when its
+ * ring overflows.
+ */
+class MpscQueueTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param capacity The number of ring slots.
+     */
+    MpscQueueTestCase(std::size_t capacity);
+    void DoRun() override;
+
+  private:
+    std::size_t m_capacity; //!< The number of ring slots.
+};
+
+MpscQueueTestCase::MpscQueueTestCase(std::size_t capacity)
+    : TestCase("Check MpscQueue with " + std::to_string(capacity) + " slots"),
+      m_capacity(capacity)
+{
+}
+
+void
+MpscQueueTestCase::DoRun()
+{
+    const uint32_t producers = 4;
+    const uint32_t values = 100000;
+    MpscQueue<std::pair<uint32_t, uint32_t>> queue(m_capacity);
+
+    std::vector<std::thread> threads;
+    for (uint32_t producer = 0; producer < producers; producer++)
+    {
+        threads.emplace_back([&queue, producer]() {
+            for (uint32_t i = 0; i < values; i++)
+            {
+                queue.Push({producer, i});
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(producers, 0);
+    uint32_t received = 0;
+    bool ordered = true;
+    while (received < producers * values)
+    {
+        received += queue.Drain([&](const std::pair<uint32_t, uint32_t>& value) {
+            ordered = ordered && value.second == next[value.first];
+            next[value.first] = value.second + 1;
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(ordered, true, "Values of each producer in order");
+    NS_TEST_EXPECT_MSG_EQ(received, producers * values, "Every value received");
+    NS_TEST_EXPECT_MSG_EQ(queue.IsEmpty(), true, "Empty once drained");
+}
+
 /**
  * \ingroup threaded-tests
  *
@@ -298,10 +365,14 @@ class ThreadedSimulatorTestSuite : public TestSuite
             "ns3::HeapScheduler",
             "ns3::MapScheduler",
             "ns3::CalendarScheduler",
+            "ns3::LadderScheduler",
         };
         unsigned int threadCounts[] = {0, 2, 10, 20};
         ObjectFactory factory;
 
+        AddTestCase(new MpscQueueTestCase(1024), TestCase::QUICK);
+        AddTestCase(new MpscQueueTestCase(2), TestCase::QUICK);
+
         for (auto& simulatorType : simulatorTypes)
         {
             for (auto& schedulerType : schedulerTypes)
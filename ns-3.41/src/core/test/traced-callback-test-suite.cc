@@ -133,6 +133,55 @@ BasicTracedCallbackTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(m_two, true, "Callback CbTwo not called");
 }
 
+/**
+ * \ingroup tracedcallback-tests
+ *
+ * Check that NS_TRACE evaluates its arguments only when a callback is
+ * connected, and not at all when tracing is disabled.
+ */
+class NsTraceTestCase : public TestCase
+{
+  public:
+    NsTraceTestCase();
+
+    ~NsTraceTestCase() override
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+NsTraceTestCase::NsTraceTestCase()
+    : TestCase("Check NS_TRACE argument evaluation")
+{
+}
+
+void
+NsTraceTestCase::DoRun()
+{
+    TracedCallback<int> trace;
+    int evaluated = 0;
+    int sum = 0;
+    auto argument = [&evaluated](int x) {
+        evaluated++;
+        return x;
+    };
+
+    NS_TRACE(trace, argument(1));
+    NS_TEST_EXPECT_MSG_EQ(evaluated, 0, "Argument evaluated with no callback connected");
+
+    trace.ConnectWithoutContext(Callback<void, int>([&sum](int x) { sum += x; }));
+    NS_TRACE(trace, argument(2));
+#ifdef NS3_TRACING_DISABLE
+    NS_TEST_EXPECT_MSG_EQ(evaluated, 0, "Argument evaluated with tracing disabled");
+    NS_TEST_EXPECT_MSG_EQ(sum, 0, "Callback called with tracing disabled");
+#else
+    NS_TEST_EXPECT_MSG_EQ(evaluated, 1, "Argument not evaluated");
+    NS_TEST_EXPECT_MSG_EQ(sum, 2, "Callback not called");
+#endif
+}
+
 /**
  * \ingroup tracedcallback-tests
  *
@@ -148,6 +197,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite()
     : TestSuite("traced-callback", UNIT)
 {
     AddTestCase(new BasicTracedCallbackTestCase, TestCase::QUICK);
+    AddTestCase(new NsTraceTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite
@@ -10,14 +10,21 @@
 #include "ospf-helper.h"
 #include "ns3/ospf-routing.h"
 
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/node-list.h"
 #include "ns3/node.h"
 #include "ns3/ospf-l4-protocol.h"
 #include "ns3/ptr.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/global-router-interface.h"
 
+#include <fstream>
+#include <sstream>
+
 namespace ns3
 {
 OspfHelper::OspfHelper()
@@ -26,16 +33,15 @@ OspfHelper::OspfHelper()
 }
 
 OspfHelper::OspfHelper(const OspfHelper& o)
-        : m_factory(o.m_factory)
+        : m_factory(o.m_factory),
+          m_nodeConfig(o.m_nodeConfig),
+          m_allNodesConfig(o.m_allNodesConfig)
 {
-    m_interfaceExclusions = o.m_interfaceExclusions;
-    m_interfaceMetrics = o.m_interfaceMetrics;
 }
 
 OspfHelper::~OspfHelper()
 {
-    m_interfaceExclusions.clear();
-    m_interfaceMetrics.clear();
+    m_nodeConfig.clear();
 }
 OspfHelper* OspfHelper::Copy() const
 {
@@ -46,25 +52,73 @@ Ptr<Ipv4RoutingProtocol> OspfHelper::Create(Ptr<Node> node) const
 {
     Ptr<OspfRouting> ospf = m_factory.Create<OspfRouting>();
 
-    auto it = m_interfaceExclusions.find(node);
-
-    if (it != m_interfaceExclusions.end())
+    ApplyConfig(m_allNodesConfig, ospf);
+    if (node->GetId() < m_nodeConfig.size())
     {
-        ospf->SetInterfaceExclusions(it->second);
+        const NodeConfig& config = m_nodeConfig[node->GetId()];
+        if (m_allNodesConfig.exclusions.empty() && m_allNodesConfig.suppressions.empty() &&
+            m_allNodesConfig.demandCircuits.empty())
+        {
+            ApplyConfig(config, ospf);
+        }
+        else
+        {
+            // Interface sets replace each other, merge them with those of every node
+            NodeConfig merged = config;
+            merged.exclusions.insert(m_allNodesConfig.exclusions.begin(),
+                                     m_allNodesConfig.exclusions.end());
+            merged.suppressions.insert(m_allNodesConfig.suppressions.begin(),
+                                       m_allNodesConfig.suppressions.end());
+            merged.demandCircuits.insert(m_allNodesConfig.demandCircuits.begin(),
+                                         m_allNodesConfig.demandCircuits.end());
+            ApplyConfig(merged, ospf);
+        }
     }
 
-    auto iter = m_interfaceMetrics.find(node);
+    node->AggregateObject(ospf);
+    return ospf;
+}
 
-    if (iter != m_interfaceMetrics.end())
+void OspfHelper::ApplyConfig(const NodeConfig& config, Ptr<OspfRouting> ospf)
+{
+    if (config.hasArea)
+    {
+        ospf->SetArea(config.area);
+    }
+    if (!config.exclusions.empty())
+    {
+        ospf->SetInterfaceExclusions(config.exclusions);
+    }
+    if (!config.suppressions.empty())
     {
-        for (auto subiter = iter->second.begin(); subiter != iter->second.end(); subiter++)
+        ospf->SetPrefixSuppressions(config.suppressions);
+    }
+    if (!config.demandCircuits.empty())
+    {
+        ospf->SetDemandCircuits(config.demandCircuits);
+    }
+    for (const auto& metric : config.metrics)
+    {
+        ospf->SetInterfaceMetric(metric.first, metric.second);
+    }
+    for (const auto& attribute : config.attributes)
+    {
+        if (!ospf->SetAttributeFailSafe(attribute.first, *attribute.second) &&
+            !ospf->GetProtocol()->SetAttributeFailSafe(attribute.first, *attribute.second))
         {
-            ospf->SetInterfaceMetric(subiter->first, subiter->second);
+            NS_FATAL_ERROR("Invalid OSPF attribute " << attribute.first << " or value "
+                                                     << attribute.second->SerializeToString(nullptr));
         }
     }
+}
 
-    node->AggregateObject(ospf);
-    return ospf;
+OspfHelper::NodeConfig& OspfHelper::GetConfig(uint32_t nodeId)
+{
+    if (nodeId >= m_nodeConfig.size())
+    {
+        m_nodeConfig.resize(nodeId + 1);
+    }
+    return m_nodeConfig[nodeId];
 }
 
 void OspfHelper::Set(std::string name, const AttributeValue& value){
@@ -73,24 +127,208 @@ void OspfHelper::Set(std::string name, const AttributeValue& value){
 
 void OspfHelper::ExcludeInterface(Ptr<Node> node, uint32_t interface)
 {
-    auto it = m_interfaceExclusions.find(node);
+    GetConfig(node->GetId()).exclusions.insert(interface);
+}
+
+void OspfHelper::ExcludeInterface(NodeContainer nodes, uint32_t interface)
+{
+    for (auto node = nodes.Begin(); node != nodes.End(); node++)
+    {
+        ExcludeInterface(*node, interface);
+    }
+}
+
+void OspfHelper::SuppressPrefix(Ptr<Node> node, uint32_t interface)
+{
+    GetConfig(node->GetId()).suppressions.insert(interface);
+}
 
-    if (it == m_interfaceExclusions.end()){
-    std::set<uint32_t> interfaces;
-    interfaces.insert(interface);
+void OspfHelper::SuppressPrefix(NodeContainer nodes, uint32_t interface)
+{
+    for (auto node = nodes.Begin(); node != nodes.End(); node++)
+    {
+        SuppressPrefix(*node, interface);
+    }
+}
 
-    m_interfaceExclusions.insert(std::make_pair(node, interfaces));
+void OspfHelper::SetDemandCircuit(Ptr<Node> node, uint32_t interface)
+{
+    GetConfig(node->GetId()).demandCircuits.insert(interface);
+}
 
-    }else{
-        it->second.insert(interface);
+void OspfHelper::SetDemandCircuit(NodeContainer nodes, uint32_t interface)
+{
+    for (auto node = nodes.Begin(); node != nodes.End(); node++)
+    {
+        SetDemandCircuit(*node, interface);
     }
 }
 
 void OspfHelper::AssignAreaNumber(Ptr<Node> node, int a_id){
-    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-    Ptr<Ipv4RoutingProtocol> proto = ipv4->GetRoutingProtocol();
-    Ptr<OspfRouting> ospfRouting = DynamicCast<OspfRouting>(proto);
-    ospfRouting->SetArea(a_id);
+    NodeConfig& config = GetConfig(node->GetId());
+    config.hasArea = true;
+    config.area = a_id;
+
+    // Already installed: OspfRouting is aggregated to the node
+    Ptr<OspfRouting> ospfRouting = node->GetObject<OspfRouting>();
+    if (ospfRouting)
+    {
+        ospfRouting->SetArea(a_id);
+    }
+}
+
+void OspfHelper::AssignAreaNumber(NodeContainer nodes, int a_id){
+    for (auto node = nodes.Begin(); node != nodes.End(); node++)
+    {
+        AssignAreaNumber(*node, a_id);
+    }
+}
+
+void OspfHelper::SetInterfaceMetric(Ptr<Node> node, uint32_t interface, uint8_t metric)
+{
+    GetConfig(node->GetId()).metrics[interface] = metric;
+}
+
+void OspfHelper::SetInterfaceMetric(NodeContainer nodes, uint32_t interface, uint8_t metric)
+{
+    for (auto node = nodes.Begin(); node != nodes.End(); node++)
+    {
+        SetInterfaceMetric(*node, interface, metric);
+    }
+}
+
+void OspfHelper::SetProtocolAttribute(NodeContainer nodes, std::string name, const AttributeValue& value)
+{
+    // One copy shared by the nodes
+    Ptr<AttributeValue> copy = value.Copy();
+    for (auto node = nodes.Begin(); node != nodes.End(); node++)
+    {
+        GetConfig((*node)->GetId()).attributes.emplace_back(name, copy);
+    }
+}
+
+void OspfHelper::LoadConfig(std::string filename)
+{
+    std::ifstream file(filename);
+    NS_ABORT_MSG_UNLESS(file.is_open(), "Cannot open OSPF configuration " << filename);
+
+    TypeId::AttributeInformation info;
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ','))
+        {
+            size_t first = field.find_first_not_of(" \t\r");
+            size_t last = field.find_last_not_of(" \t\r");
+            fields.push_back(first == std::string::npos ? "" : field.substr(first, last - first + 1));
+        }
+        if (fields.empty() || (fields.size() == 1 && fields[0].empty()))
+        {
+            continue;
+        }
+        NS_ABORT_MSG_IF(fields.size() < 3, filename << ":" << lineNumber << ": too few fields");
+
+        // The nodes: an ID, a range of IDs or every node
+        std::vector<NodeConfig*> configs;
+        const std::string& nodes = fields[0];
+        if (nodes == "*")
+        {
+            configs.push_back(&m_allNodesConfig);
+        }
+        else
+        {
+            size_t dash = nodes.find('-');
+            uint32_t first;
+            uint32_t last;
+            try
+            {
+                first = std::stoul(nodes.substr(0, dash));
+                last = (dash == std::string::npos) ? first : std::stoul(nodes.substr(dash + 1));
+            }
+            catch (const std::exception&)
+            {
+                NS_FATAL_ERROR(filename << ":" << lineNumber << ": bad nodes " << nodes);
+            }
+            NS_ABORT_MSG_IF(last < first, filename << ":" << lineNumber << ": empty range");
+            GetConfig(last);
+            for (uint32_t id = first; id <= last; id++)
+            {
+                configs.push_back(&m_nodeConfig[id]);
+            }
+        }
+
+        const std::string& setting = fields[1];
+        auto number = [&](const std::string& text, unsigned long max) {
+            size_t end = 0;
+            unsigned long value = 0;
+            try
+            {
+                value = std::stoul(text, &end);
+            }
+            catch (const std::exception&)
+            {
+                end = 0;
+            }
+            NS_ABORT_MSG_IF(end == 0 || end != text.size() || value > max,
+                            filename << ":" << lineNumber << ": bad number " << text);
+            return value;
+        };
+        if (setting == "area")
+        {
+            int area = number(fields[2], INT32_MAX);
+            for (auto config : configs)
+            {
+                config->hasArea = true;
+                config->area = area;
+            }
+        }
+        else if (setting == "exclude" || setting == "suppress" || setting == "demand")
+        {
+            uint32_t interface = number(fields[2], UINT32_MAX);
+            for (auto config : configs)
+            {
+                if (setting == "exclude")
+                {
+                    config->exclusions.insert(interface);
+                }
+                else if (setting == "suppress")
+                {
+                    config->suppressions.insert(interface);
+                }
+                else
+                {
+                    config->demandCircuits.insert(interface);
+                }
+            }
+        }
+        else if (setting == "metric")
+        {
+            NS_ABORT_MSG_IF(fields.size() < 4, filename << ":" << lineNumber << ": no cost");
+            uint32_t interface = number(fields[2], UINT32_MAX);
+            uint8_t metric = number(fields[3], UINT8_MAX);
+            for (auto config : configs)
+            {
+                config->metrics[interface] = metric;
+            }
+        }
+        else
+        {
+            NS_ABORT_MSG_UNLESS(OspfRouting::GetTypeId().LookupAttributeByName(setting, &info) ||
+                                    OspfL4Protocol::GetTypeId().LookupAttributeByName(setting, &info),
+                                filename << ":" << lineNumber << ": unknown setting " << setting);
+            Ptr<AttributeValue> value = StringValue(fields[2]).Copy();
+            for (auto config : configs)
+            {
+                config->attributes.emplace_back(setting, value);
+            }
+        }
+    }
 }
 
 void OspfHelper::CreateAndAggregateObjectFromTypeId(Ptr<Node> node, const std::string typeId)
@@ -107,7 +345,41 @@ void OspfHelper::CreateAndAggregateObjectFromTypeId(Ptr<Node> node, const std::s
     node->AggregateObject(protocol);
 }
 
+void OspfHelper::SetMaxMetricOnStartup(Time duration){
+    m_factory.Set("MaxMetricOnStartup", TimeValue(duration));
+    m_factory.Set("MaxMetricUntilConverged", BooleanValue(false));
+}
+
+void OspfHelper::SetMaxMetricUntilConverged(Time limit){
+    m_factory.Set("MaxMetricOnStartup", TimeValue(limit));
+    m_factory.Set("MaxMetricUntilConverged", BooleanValue(true));
+}
+
+void OspfHelper::FreezeAt(Time freezeTime, NodeContainer nodes){
+    for (auto node = nodes.Begin(); node != nodes.End(); node++)
+    {
+        Simulator::ScheduleWithContext((*node)->GetId(), freezeTime, &OspfHelper::Freeze, *node);
+    }
+}
+
+void OspfHelper::FreezeAllAt(Time freezeTime){
+    FreezeAt(freezeTime, NodeContainer::GetGlobal());
+}
+
+void OspfHelper::Freeze(Ptr<Node> node){
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    if (!ipv4 || !ipv4->GetRoutingProtocol())
+    {
+        return;
+    }
+    Ptr<OspfRouting> ospfRouting = GetRouting<OspfRouting>(ipv4->GetRoutingProtocol());
+    if (ospfRouting)
+    {
+        ospfRouting->Freeze();
+    }
+}
+
 void OspfHelper::Install(Ptr<Node> node){
     CreateAndAggregateObjectFromTypeId(node, "ns3::OspfL4Protocol");
 }
-}
\ No newline at end of file
+}
@@ -5,6 +5,13 @@
  *
  *  File: ospf-helper.h
  *
+ *  Per-node configuration (areas, interface costs, exclusions, suppressed
+ *  prefixes, demand circuits and protocol attributes such as the timers) is kept in a vector
+ *  indexed by node ID and applied when OSPF is created on the node, so that
+ *  whole NodeContainers can be configured before installation without
+ *  looking up their routing protocols. LoadConfig reads the same settings
+ *  from a file.
+ *
  */
 
 #ifndef OSPF_HELPER_H
@@ -12,13 +19,23 @@
 
 #include "ipv4-routing-helper.h"
 
+#include "ns3/attribute.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
+#include "ns3/nstime.h"
 #include "ns3/object-factory.h"
 
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace ns3
 {
 
+class OspfRouting;
+
 class OspfHelper : public Ipv4RoutingHelper{
     public:
         OspfHelper();
@@ -38,24 +55,154 @@ class OspfHelper : public Ipv4RoutingHelper{
 
         void ExcludeInterface(Ptr<Node> node, uint32_t interface);
 
-        void AssignAreaNumber(Ptr<Node>, int);
+        /**
+         * \brief Do not run OSPF on an interface of every node of a container.
+         * \param nodes the nodes
+         * \param interface the interface index
+         */
+        void ExcludeInterface(NodeContainer nodes, uint32_t interface);
+
+        /**
+         * \brief Keep running OSPF on an interface but stop advertising its
+         * prefix (RFC 6860), typically a transit link between routers.
+         * \param node the node
+         * \param interface the interface index
+         */
+        void SuppressPrefix(Ptr<Node> node, uint32_t interface);
+        void SuppressPrefix(NodeContainer nodes, uint32_t interface);
+
+        /**
+         * \brief Treat an interface as an RFC 1793 demand circuit: once its
+         * adjacencies are full, Hellos and LSA refreshes are no longer sent
+         * over it and LSAs flooded over it do not age.
+         * \param node the node
+         * \param interface the interface index
+         */
+        void SetDemandCircuit(Ptr<Node> node, uint32_t interface);
+        void SetDemandCircuit(NodeContainer nodes, uint32_t interface);
+
+        /**
+         * \brief Set the area of a node, now if OSPF is installed on it and
+         * when it is installed otherwise.
+         * \param node the node
+         * \param a_id the area ID
+         */
+        void AssignAreaNumber(Ptr<Node> node, int a_id);
+        void AssignAreaNumber(NodeContainer nodes, int a_id);
+
+        /**
+         * \brief Set the cost of an interface, advertised in the Router-LSA.
+         * \param node the node
+         * \param interface the interface index
+         * \param metric the cost
+         */
+        void SetInterfaceMetric(Ptr<Node> node, uint32_t interface, uint8_t metric);
+        void SetInterfaceMetric(NodeContainer nodes, uint32_t interface, uint8_t metric);
+
+        /**
+         * \brief Set an attribute of OspfRouting, or failing that of its
+         * OspfL4Protocol (e.g. HelloInterval), on some nodes.
+         * \param nodes the nodes
+         * \param name the attribute name
+         * \param value the attribute value
+         */
+        void SetProtocolAttribute(NodeContainer nodes, std::string name, const AttributeValue& value);
+
+        /**
+         * \brief Read per-node settings from a file.
+         *
+         * One setting per line, '#' starting a comment:
+         * \verbatim
+           nodes,area,<area ID>
+           nodes,exclude,<interface>
+           nodes,suppress,<interface>
+           nodes,demand,<interface>
+           nodes,metric,<interface>,<cost>
+           nodes,<attribute>,<value>    e.g. 0-99,HelloInterval,5s
+           \endverbatim
+         * where nodes is a node ID, an inclusive range of node IDs "a-b", or
+         * "*" for every node OSPF is installed on by this helper. Attributes
+         * are those of SetProtocolAttribute. A malformed line is fatal.
+         *
+         * \param filename the file
+         */
+        void LoadConfig(std::string filename);
 
         void Install(Ptr<Node> node);
 
-        //void SetInterfaceMetric(Ptr<Node> node, uint32_t interface, uint8_t metric);
+        /**
+         * \brief Make the routers advertise their links with MaxLinkMetric
+         * (RFC 6987) for some time after they start, so that no transit
+         * traffic goes through them while their routing table is incomplete.
+         * \param duration the time
+         */
+        void SetMaxMetricOnStartup(Time duration);
+
+        /**
+         * \brief Make the routers advertise their links with MaxLinkMetric
+         * from startup until their routing table is calculated over a
+         * synchronised LSDB.
+         * \param limit the longest time to do so, zero for no limit
+         */
+        void SetMaxMetricUntilConverged(Time limit = Seconds(0));
+
+        /**
+         * \brief Compile the OSPF routes of some nodes into read-only
+         * forwarding tables at a given time, see OspfRouting::Freeze.
+         * \param freezeTime the time, typically once OSPF has converged
+         * \param nodes the nodes
+         */
+        static void FreezeAt(Time freezeTime, NodeContainer nodes);
+
+        /**
+         * \brief Freeze the OSPF routes of every node at a given time.
+         * \param freezeTime the time
+         */
+        static void FreezeAllAt(Time freezeTime);
 
         //void SetGatewayRouter(Ptr<Node> node, Ipv4Address nextHop, uint32_t interface);
             //route to lead out of subnet
     protected:
+        /**
+         * \brief Freeze the OSPF routes of a node, if it runs OSPF.
+         * \param node the node
+         */
+        static void Freeze(Ptr<Node> node);
+
         void CreateAndAggregateObjectFromTypeId(Ptr<Node> node, const std::string typeId);
 
     private:
+        /// Settings of a node, see LoadConfig
+        struct NodeConfig
+        {
+            bool hasArea = false;
+            int area = 0;
+            std::set<uint32_t> exclusions;
+            std::set<uint32_t> suppressions;
+            std::set<uint32_t> demandCircuits;
+            std::map<uint32_t, uint8_t> metrics;
+            std::vector<std::pair<std::string, Ptr<AttributeValue>>> attributes;
+        };
+
+        /**
+         * \param nodeId a node ID
+         * \return the settings of the node, created if need be
+         */
+        NodeConfig& GetConfig(uint32_t nodeId);
+
+        /**
+         * \brief Apply settings to an OSPF instance.
+         * \param config the settings
+         * \param ospf the instance
+         */
+        static void ApplyConfig(const NodeConfig& config, Ptr<OspfRouting> ospf);
+
         ObjectFactory m_factory;
 
-        std::map<Ptr<Node>, std::set<uint32_t>> m_interfaceExclusions;
-        std::map<Ptr<Node>, std::map<uint32_t, uint8_t>> m_interfaceMetrics;
+        std::vector<NodeConfig> m_nodeConfig;       //!< By node ID
+        NodeConfig m_allNodesConfig;                //!< Applied to every node first
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Nathan Nunes
+ *
+ *  File: ospf6-helper.cc
+ *
+ */
+
+#include "ospf6-helper.h"
+
+#include "ns3/node.h"
+#include "ns3/ospf6-routing.h"
+#include "ns3/ptr.h"
+
+namespace ns3
+{
+Ospf6Helper::Ospf6Helper()
+{
+    m_factory.SetTypeId("ns3::Ospf6Routing");
+}
+
+Ospf6Helper::Ospf6Helper(const Ospf6Helper& o)
+        : m_factory(o.m_factory)
+{
+    m_interfaceExclusions = o.m_interfaceExclusions;
+    m_prefixSuppressions = o.m_prefixSuppressions;
+    m_interfaceMetrics = o.m_interfaceMetrics;
+}
+
+Ospf6Helper::~Ospf6Helper()
+{
+    m_interfaceExclusions.clear();
+    m_prefixSuppressions.clear();
+    m_interfaceMetrics.clear();
+}
+
+Ospf6Helper* Ospf6Helper::Copy() const
+{
+    return new Ospf6Helper(*this);
+}
+
+Ptr<Ipv6RoutingProtocol> Ospf6Helper::Create(Ptr<Node> node) const
+{
+    Ptr<Ospf6Routing> ospf = m_factory.Create<Ospf6Routing>();
+
+    auto it = m_interfaceExclusions.find(node);
+    if (it != m_interfaceExclusions.end())
+    {
+        ospf->SetInterfaceExclusions(it->second);
+    }
+
+    auto suppressed = m_prefixSuppressions.find(node);
+    if (suppressed != m_prefixSuppressions.end())
+    {
+        ospf->SetPrefixSuppressions(suppressed->second);
+    }
+
+    auto iter = m_interfaceMetrics.find(node);
+    if (iter != m_interfaceMetrics.end())
+    {
+        for (const auto& metric : iter->second)
+        {
+            ospf->SetInterfaceMetric(metric.first, metric.second);
+        }
+    }
+
+    node->AggregateObject(ospf);
+    return ospf;
+}
+
+void Ospf6Helper::Set(std::string name, const AttributeValue& value){
+    m_factory.Set(name, value);
+}
+
+void Ospf6Helper::SuppressPrefix(Ptr<Node> node, uint32_t interface)
+{
+    m_prefixSuppressions[node].insert(interface);
+}
+
+void Ospf6Helper::ExcludeInterface(Ptr<Node> node, uint32_t interface)
+{
+    m_interfaceExclusions[node].insert(interface);
+}
+
+void Ospf6Helper::SetInterfaceMetric(Ptr<Node> node, uint32_t interface, uint8_t metric)
+{
+    m_interfaceMetrics[node][interface] = metric;
+}
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Nathan Nunes
+ *
+ *  File: ospf6-helper.h
+ *
+ *  Installs OSPFv3 (Ospf6Routing) on IPv6 nodes, the counterpart of
+ *  OspfHelper. A dual-stack router gets one of each.
+ *
+ */
+
+#ifndef OSPF6_HELPER_H
+#define OSPF6_HELPER_H
+
+#include "ipv6-routing-helper.h"
+
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/object-factory.h"
+
+#include <map>
+#include <set>
+
+namespace ns3
+{
+
+class Ospf6Helper : public Ipv6RoutingHelper{
+    public:
+        Ospf6Helper();
+        ~Ospf6Helper() override;
+
+        Ospf6Helper(const Ospf6Helper& o);
+
+        Ospf6Helper& operator=(const Ospf6Helper&) = delete;
+
+        Ospf6Helper* Copy() const override;
+
+        Ptr<Ipv6RoutingProtocol> Create(Ptr<Node> node) const override;
+
+        void Set(std::string name, const AttributeValue& value);
+
+        void ExcludeInterface(Ptr<Node> node, uint32_t interface);
+
+        /**
+         * \brief Keep running OSPF on an interface but stop advertising its
+         * prefix (RFC 6860), typically a transit link between routers.
+         * \param node the node
+         * \param interface the interface index
+         */
+        void SuppressPrefix(Ptr<Node> node, uint32_t interface);
+
+        void SetInterfaceMetric(Ptr<Node> node, uint32_t interface, uint8_t metric);
+
+    private:
+        ObjectFactory m_factory;
+
+        std::map<Ptr<Node>, std::set<uint32_t>> m_interfaceExclusions;
+        std::map<Ptr<Node>, std::set<uint32_t>> m_prefixSuppressions;
+        std::map<Ptr<Node>, std::map<uint32_t, uint8_t>> m_interfaceMetrics;
+};
+
+}
+
+#endif
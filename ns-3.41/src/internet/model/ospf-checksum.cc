@@ -0,0 +1,182 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-checksum.cc
+ *
+ */
+
+#include "ospf-checksum.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3 {
+
+namespace {
+
+/// Offset of the checksum field in an LSA header
+const uint32_t LSA_CHECKSUM_OFFSET = 16;
+
+/// Size of the LS age field, which the LS checksum does not cover
+const uint32_t LSA_AGE_SIZE = 2;
+
+/**
+ * Block size of the Fletcher kernel. The weighted sum of a block fits in
+ * 32 bits (255 * 4096 * 4095 / 2 < 2^32), so the inner loop only needs
+ * 32 bit lanes.
+ */
+const uint32_t FLETCHER_BLOCK = 4096;
+
+bool
+IsLittleEndian()
+{
+    const uint16_t one = 1;
+    uint8_t first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+/**
+ * One's complement sum of a buffer in native byte order, not folded.
+ *
+ * The one's complement sum is byte order independent (RFC 1071 2.B) so the
+ * buffer is summed as native 32 bit words in four independent accumulators
+ * and only the folded result is swapped back to network order.
+ */
+uint64_t
+NativeSum(const uint8_t* data, uint32_t size)
+{
+    uint64_t acc0 = 0;
+    uint64_t acc1 = 0;
+    uint64_t acc2 = 0;
+    uint64_t acc3 = 0;
+    while (size >= 16)
+    {
+        uint32_t words[4];
+        std::memcpy(words, data, sizeof(words));
+        acc0 += words[0];
+        acc1 += words[1];
+        acc2 += words[2];
+        acc3 += words[3];
+        data += 16;
+        size -= 16;
+    }
+    uint64_t acc = acc0 + acc1 + acc2 + acc3;
+    while (size >= 2)
+    {
+        uint16_t word;
+        std::memcpy(&word, data, sizeof(word));
+        acc += word;
+        data += 2;
+        size -= 2;
+    }
+    if (size == 1)
+    {
+        const uint8_t padded[2] = {data[0], 0};
+        uint16_t word;
+        std::memcpy(&word, padded, sizeof(word));
+        acc += word;
+    }
+    return acc;
+}
+
+/**
+ * Fletcher sums of a buffer: sum = sum of b[i], weighted = sum of
+ * (size - i) * b[i], which is what the byte at a time C0/C1 recurrence of
+ * ISO 8473 computes before the modulo.
+ */
+void
+FletcherSums(const uint8_t* data, uint32_t size, uint64_t& sum, uint64_t& weighted)
+{
+    sum = 0;
+    weighted = 0;
+    for (uint32_t k = 0; k < size; k += FLETCHER_BLOCK)
+    {
+        uint32_t n = std::min(FLETCHER_BLOCK, size - k);
+        const uint8_t* block = data + k;
+        uint32_t blockSum = 0;
+        uint32_t blockWeighted = 0;
+        for (uint32_t j = 0; j < n; j++)
+        {
+            blockSum += block[j];
+            blockWeighted += j * block[j];
+        }
+        // sum over the block of (size - k - j) * b[k + j]
+        weighted += uint64_t(size - k) * blockSum - blockWeighted;
+        sum += blockSum;
+    }
+}
+
+} // namespace
+
+uint16_t
+OspfInternetChecksum(const uint8_t* data, uint32_t size)
+{
+    uint64_t acc = NativeSum(data, size);
+    while (acc >> 16)
+    {
+        acc = (acc & 0xffff) + (acc >> 16);
+    }
+    auto sum = static_cast<uint16_t>(acc);
+    if (IsLittleEndian())
+    {
+        sum = static_cast<uint16_t>((sum << 8) | (sum >> 8));
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+uint16_t
+OspfLsaChecksum(const uint8_t* lsa, uint32_t length)
+{
+    if (length < LSA_CHECKSUM_OFFSET + 2)
+    {
+        return 0;
+    }
+
+    // The checksummed data starts after LS age, the checksum sits at
+    // 'offset' in it and is taken as zero.
+    const uint8_t* data = lsa + LSA_AGE_SIZE;
+    uint32_t size = length - LSA_AGE_SIZE;
+    uint32_t offset = LSA_CHECKSUM_OFFSET - LSA_AGE_SIZE;
+
+    uint64_t sum;
+    uint64_t weighted;
+    FletcherSums(data, size, sum, weighted);
+    sum -= data[offset] + data[offset + 1];
+    weighted -= uint64_t(size - offset) * data[offset] + uint64_t(size - offset - 1) * data[offset + 1];
+
+    auto c0 = static_cast<int64_t>(sum % 255);
+    auto c1 = static_cast<int64_t>(weighted % 255);
+
+    // ISO 8473 Annex C, as in RFC 905 and most OSPF implementations
+    int64_t x = ((int64_t(size) - offset - 1) * c0 - c1) % 255;
+    if (x <= 0)
+    {
+        x += 255;
+    }
+    int64_t y = 510 - c0 - x;
+    if (y > 255)
+    {
+        y -= 255;
+    }
+    return static_cast<uint16_t>((x << 8) | y);
+}
+
+bool
+OspfLsaChecksumOk(const uint8_t* lsa, uint32_t length)
+{
+    if (length < LSA_CHECKSUM_OFFSET + 2)
+    {
+        return false;
+    }
+
+    uint64_t sum;
+    uint64_t weighted;
+    FletcherSums(lsa + LSA_AGE_SIZE, length - LSA_AGE_SIZE, sum, weighted);
+    return (sum % 255) == 0 && (weighted % 255) == 0;
+}
+
+}
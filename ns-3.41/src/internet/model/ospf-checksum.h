@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-checksum.h
+ *
+ *  The two checksums used by OSPF:
+ *
+ *  - the packet checksum (RFC 2328 D.4.1), the Internet one's complement
+ *    checksum of the whole OSPF packet with the authentication field
+ *    excluded;
+ *  - the LS checksum (RFC 2328 12.1.7), the ISO 8473 Fletcher checksum
+ *    of an LSA, LS age excluded.
+ *
+ *  Both kernels work on plain byte arrays in wide blocks so that the
+ *  compiler can vectorise them; they are used on every OSPF packet and on
+ *  every installed LSA when checksums are enabled.
+ *
+ */
+
+#ifndef OSPF_CHECKSUM_H
+#define OSPF_CHECKSUM_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Internet checksum (RFC 1071) of a buffer.
+ * \param data the buffer
+ * \param size the buffer size in bytes; an odd trailing byte is padded with zero
+ * \return the one's complement of the one's complement sum, in host order.
+ * A buffer holding a correct checksum gives 0.
+ */
+uint16_t OspfInternetChecksum(const uint8_t* data, uint32_t size);
+
+/**
+ * \brief Compute the LS checksum of an LSA.
+ * \param lsa the LSA, starting with its LS age field
+ * \param length the LSA length in bytes (the LSA header length field)
+ * \return the checksum to store in the LSA header. The current content of
+ * the checksum field is ignored.
+ */
+uint16_t OspfLsaChecksum(const uint8_t* lsa, uint32_t length);
+
+/**
+ * \brief Verify the LS checksum of an LSA.
+ * \param lsa the LSA, starting with its LS age field
+ * \param length the LSA length in bytes
+ * \return true if the checksum stored in the LSA is correct
+ */
+bool OspfLsaChecksumOk(const uint8_t* lsa, uint32_t length);
+
+}
+
+#endif // OSPF_CHECKSUM_H
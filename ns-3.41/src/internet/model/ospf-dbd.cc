@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-dbd.cc
+ *
+ */
+
+#include "ospf-dbd.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED(OspfDbd);
+
+OspfDbd::OspfDbd()
+    : m_version(2),
+      m_mtu(0),
+      m_flags(0),
+      m_sequence(0)
+{
+}
+
+TypeId OspfDbd::GetTypeId() {
+    static TypeId tid = TypeId("ns3::OspfDbd")
+                            .SetParent<Header>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<OspfDbd>();
+    return tid;
+}
+
+TypeId OspfDbd::GetInstanceTypeId() const {
+    return GetTypeId();
+}
+
+void OspfDbd::Print(std::ostream& os) const {
+    os << "flags " << int(m_flags) << " seq " << m_sequence << " headers " << m_headers.size();
+}
+
+uint32_t OspfDbd::GetSerializedSize() const {
+    return ((m_version == 3) ? 12 : 8) + OspfLsaHeader::SIZE * m_headers.size();
+}
+
+void OspfDbd::Serialize(Buffer::Iterator start) const {
+    Buffer::Iterator i = start;
+
+    if (m_version == 3)
+    {
+        i.WriteHtonU32(OspfLsa::V3_OPTIONS);
+        i.WriteHtonU16(m_mtu);
+        i.WriteU8(0);
+    }
+    else
+    {
+        i.WriteHtonU16(m_mtu);
+        i.WriteU8(0);               // options
+    }
+    i.WriteU8(m_flags);
+    i.WriteHtonU32(m_sequence);
+    for (const auto& header : m_headers)
+    {
+        header.Serialize(i, m_version);
+    }
+}
+
+uint32_t OspfDbd::Deserialize(Buffer::Iterator start) {
+    Buffer::Iterator i = start;
+
+    if (m_version == 3)
+    {
+        i.ReadNtohU32();            // options
+    }
+    m_mtu = i.ReadNtohU16();
+    i.ReadU8();
+    m_flags = i.ReadU8();
+    m_sequence = i.ReadNtohU32();
+
+    uint32_t headerNumber = i.GetRemainingSize() / OspfLsaHeader::SIZE;
+    m_headers.resize(headerNumber);
+    for (auto& header : m_headers)
+    {
+        header.Deserialize(i, m_version);
+    }
+
+    return GetSerializedSize();
+}
+
+void OspfDbd::SetMtu(uint16_t mtu) {
+    m_mtu = mtu;
+}
+uint16_t OspfDbd::GetMtu() const {
+    return m_mtu;
+}
+void OspfDbd::SetFlags(uint8_t flags) {
+    m_flags = flags;
+}
+uint8_t OspfDbd::GetFlags() const {
+    return m_flags;
+}
+bool OspfDbd::HasFlag(uint8_t flag) const {
+    return (m_flags & flag) != 0;
+}
+void OspfDbd::SetSequence(uint32_t sequence) {
+    m_sequence = sequence;
+}
+uint32_t OspfDbd::GetSequence() const {
+    return m_sequence;
+}
+void OspfDbd::AddLsaHeader(const OspfLsaHeader& header) {
+    m_headers.push_back(header);
+}
+const std::vector<OspfLsaHeader>& OspfDbd::GetLsaHeaders() const {
+    return m_headers;
+}
+void OspfDbd::SetVersion(uint8_t version) {
+    m_version = version;
+}
+uint8_t OspfDbd::GetVersion() const {
+    return m_version;
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-dbd.h
+ *
+ *  Body of an OSPF Database Description packet (RFC 2328 A.3.3).
+ *
+ *    interface MTU (2) | options (1) | flags (1, I/M/MS)
+ *    DD sequence number (4)
+ *    LSA headers (20 each)
+ *
+ *  and in OSPFv3 (RFC 5340 A.3.3):
+ *
+ *    0 (1) | options (3)
+ *    interface MTU (2) | 0 (1) | flags (1)
+ *    DD sequence number (4)
+ *    LSA headers (20 each)
+ *
+ */
+
+#ifndef OSPF_DBD_H
+#define OSPF_DBD_H
+
+#include "ospf-lsa.h"
+
+#include "ns3/header.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+class OspfDbd : public Header {
+public:
+    /// Flags field bits
+    enum Flags
+    {
+        MS = 0x01,      //!< Master/Slave
+        M = 0x02,       //!< More
+        I = 0x04        //!< Init
+    };
+
+    OspfDbd();
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    void SetMtu(uint16_t mtu);
+    uint16_t GetMtu() const;
+    void SetFlags(uint8_t flags);
+    uint8_t GetFlags() const;
+    bool HasFlag(uint8_t flag) const;
+    void SetSequence(uint32_t sequence);
+    uint32_t GetSequence() const;
+    void AddLsaHeader(const OspfLsaHeader& header);
+    const std::vector<OspfLsaHeader>& GetLsaHeaders() const;
+
+    /**
+     * \param version the OSPF version, 2 (the default) or 3, which decides
+     * the wire format. Must be set before the body is removed from a packet.
+     */
+    void SetVersion(uint8_t version);
+    uint8_t GetVersion() const;
+
+private:
+    uint8_t m_version;
+    uint16_t m_mtu;
+    uint8_t m_flags;
+    uint32_t m_sequence;                    //!< DD sequence number
+    std::vector<OspfLsaHeader> m_headers;
+};
+
+}
+
+#endif // OSPF_DBD_H
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-fib.cc
+ *
+ */
+
+#include "ospf-fib.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace ns3 {
+
+const uint32_t OspfFib::NO_ROUTE = std::numeric_limits<uint32_t>::max();
+
+OspfFib::OspfFib()
+{
+}
+
+void OspfFib::Compile(const std::vector<OspfRoutingTableEntry>& routes, Ptr<Ipv4> ipv4) {
+    Clear();
+
+    // Prefixes as [start, end) ranges, enclosing ones before those they hold
+    struct Prefix
+    {
+        uint64_t start;
+        uint64_t end;
+        uint32_t route;
+    };
+    std::vector<Prefix> prefixes;
+    prefixes.reserve(routes.size());
+    m_routes.reserve(routes.size());
+    for (const auto& entry : routes)
+    {
+        uint32_t mask = entry.GetDestNetworkMask().Get();
+        uint32_t network = entry.GetDestNetwork().Get() & mask;
+        prefixes.push_back({network, uint64_t(network | ~mask) + 1, uint32_t(m_routes.size())});
+
+        Ptr<Ipv4Route> route = Create<Ipv4Route>();
+        route->SetSource(ipv4->SourceAddressSelection(entry.GetInterface(), Ipv4Address(network)));
+        route->SetDestination(Ipv4Address(network));
+        route->SetGateway(entry.GetGateway());
+        route->SetOutputDevice(ipv4->GetNetDevice(entry.GetInterface()));
+        m_routes.push_back(route);
+    }
+    std::stable_sort(prefixes.begin(), prefixes.end(), [](const Prefix& a, const Prefix& b) {
+        return a.start != b.start ? a.start < b.start : a.end > b.end;
+    });
+
+    // Sweep the address space keeping the prefixes enclosing the cursor on a
+    // stack, innermost on top, and close a range wherever the top changes
+    std::vector<std::pair<uint64_t, uint32_t>> enclosing;
+    uint64_t cursor = 0;
+    auto emit = [&](uint64_t upTo, uint32_t route) {
+        if (cursor >= upTo)
+        {
+            return;
+        }
+        if (m_rangeRoute.empty() || m_rangeRoute.back() != route)
+        {
+            m_rangeStart.push_back(uint32_t(cursor));
+            m_rangeRoute.push_back(route);
+        }
+        cursor = upTo;
+    };
+    auto advance = [&](uint64_t to) {
+        while (!enclosing.empty() && enclosing.back().first <= to)
+        {
+            emit(enclosing.back().first, enclosing.back().second);
+            enclosing.pop_back();
+        }
+        emit(to, enclosing.empty() ? NO_ROUTE : enclosing.back().second);
+    };
+
+    for (size_t p = 0; p < prefixes.size(); p++)
+    {
+        if (p > 0 && prefixes[p].start == prefixes[p - 1].start &&
+            prefixes[p].end == prefixes[p - 1].end)
+        {
+            continue;
+        }
+        advance(prefixes[p].start);
+        enclosing.emplace_back(prefixes[p].end, prefixes[p].route);
+    }
+    advance(uint64_t(1) << 32);
+
+    m_rangeStart.shrink_to_fit();
+    m_rangeRoute.shrink_to_fit();
+}
+
+void OspfFib::Clear() {
+    m_rangeStart.clear();
+    m_rangeRoute.clear();
+    m_routes.clear();
+}
+
+Ptr<Ipv4Route> OspfFib::Lookup(Ipv4Address dst) const {
+    if (m_rangeStart.empty())
+    {
+        return nullptr;
+    }
+    // The first range starts at 0.0.0.0, so there is always one to the left
+    auto next = std::upper_bound(m_rangeStart.begin(), m_rangeStart.end(), dst.Get());
+    uint32_t route = m_rangeRoute[next - m_rangeStart.begin() - 1];
+    return route == NO_ROUTE ? nullptr : m_routes[route];
+}
+
+uint32_t OspfFib::GetRangeNumber() const {
+    return m_rangeStart.size();
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-fib.h
+ *
+ *  A read-only forwarding table compiled from the OSPF routing table once
+ *  the network has converged (see OspfRouting::Freeze).
+ *
+ *  The routes, which nest or are disjoint, are flattened into the sorted
+ *  list of address ranges over which the longest matching prefix does not
+ *  change. A lookup is a binary search over the first address of each
+ *  range, all kept in one contiguous array, and returns an Ipv4Route built
+ *  at compile time.
+ *
+ */
+
+#ifndef OSPF_FIB_H
+#define OSPF_FIB_H
+
+#include "ipv4-route.h"
+#include "ipv4.h"
+#include "ospf-routing-table-entry.h"
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ptr.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+class OspfFib {
+public:
+    OspfFib();
+
+    /**
+     * \brief Replace the table with the given routes.
+     * \param routes the routes, longest prefix first as kept by OspfRouting
+     * \param ipv4 the stack the routes belong to, for devices and sources
+     */
+    void Compile(const std::vector<OspfRoutingTableEntry>& routes, Ptr<Ipv4> ipv4);
+
+    /// Release the table and its routes
+    void Clear();
+
+    /**
+     * \param dst a destination
+     * \return the route of the longest matching prefix, or nullptr. The
+     * route is shared by every destination of the prefix and must not be
+     * modified; its destination is the prefix's network address.
+     */
+    Ptr<Ipv4Route> Lookup(Ipv4Address dst) const;
+
+    /// \return the number of address ranges the routes were flattened into
+    uint32_t GetRangeNumber() const;
+
+private:
+    /// Route index of a range no route covers
+    static const uint32_t NO_ROUTE;
+
+    std::vector<uint32_t> m_rangeStart;         //!< First address of a range, ascending
+    std::vector<uint32_t> m_rangeRoute;         //!< Route of a range, or NO_ROUTE
+    std::vector<Ptr<Ipv4Route>> m_routes;       //!< Precomputed routes
+};
+
+}
+
+#endif // OSPF_FIB_H
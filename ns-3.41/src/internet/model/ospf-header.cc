@@ -12,12 +12,35 @@
 */
 
 #include "ospf-header.h"
+#include "ospf-checksum.h"
 #include "ns3/address-utils.h"
 
+#include <algorithm>
+#include <vector>
+
+/// Offset and size of the authentication field, not covered by the checksum
+#define OSPF_AUTH_OFFSET 16
+#define OSPF_AUTH_SIZE 8
+
+/// Size of the IPv6 pseudo-header in front of an OSPFv3 packet
+#define OSPF6_PSEUDO_HEADER_SIZE 40
+
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED(OspfHeader);
 
+OspfHeader::OspfHeader()
+    : m_calcChecksum(false),
+      m_goodChecksum(true),
+      m_protocol(0),
+      m_version(2),
+      m_packet_type(0),
+      m_packetLength(0),
+      m_routerId(0),
+      m_areaId(0)
+{
+}
+
 /******************************************************************************
  *
  * MRG: Overridden functions from Header class
@@ -37,35 +60,132 @@ TypeId OspfHeader::GetInstanceTypeId() const {
 }
 
 void OspfHeader::Print(std::ostream& os) const {
-    // TODO
+    os << "version " << int(m_version) << " type " << m_packet_type << " length " << m_packetLength
+       << " router " << m_routerId << " area " << m_areaId;
 }
 
 uint32_t OspfHeader::GetSerializedSize() const {
-    // TODO - replace with a real value
-    return 8;
+    return (m_version == 3) ? 16 : 24;
 }
 
 void OspfHeader::Serialize(Buffer::Iterator start) const {
-    // TODO
+    Buffer::Iterator i = start;
+
+    i.WriteU8(m_version);
+    i.WriteU8(m_packet_type);
+    i.WriteHtonU16(m_packetLength);
+    i.WriteHtonU32(m_routerId);
+    i.WriteHtonU32(m_areaId);
+    i.WriteU16(0);                  // checksum
+    if (m_version == 3)
+    {
+        i.WriteU16(0);              // instance ID 0, reserved
+    }
+    else
+    {
+        i.WriteU16(0);              // AuType, null authentication
+        i.WriteU32(0);              // authentication
+        i.WriteU32(0);
+    }
+
+    if (m_calcChecksum)
+    {
+        uint16_t checksum = CalculateChecksum(start);
+        i = start;
+        i.Next(12);
+        i.WriteHtonU16(checksum);
+    }
 }
 
 uint32_t OspfHeader::Deserialize(Buffer::Iterator start) {
-    // TODO
-    return 0;
+    Buffer::Iterator i = start;
+
+    m_version = i.ReadU8();
+    m_packet_type = i.ReadU8();
+    m_packetLength = i.ReadNtohU16();
+    m_routerId = i.ReadNtohU32();
+    m_areaId = i.ReadNtohU32();
+    i.ReadU16();                    // checksum
+    if (m_version == 3)
+    {
+        i.ReadU16();                // instance ID, reserved
+    }
+    else
+    {
+        i.ReadU16();                // AuType
+        i.ReadU32();                // authentication
+        i.ReadU32();
+    }
+
+    if (m_calcChecksum)
+    {
+        // Summing the packet with its checksum in place gives zero
+        m_goodChecksum = (CalculateChecksum(start) == 0);
+    }
+
+    return GetSerializedSize();
 }
-/*void OspfHeader::EnableChecksums(){
+
+uint16_t OspfHeader::CalculateChecksum(Buffer::Iterator start) const {
+    uint32_t size = std::min<uint32_t>(m_packetLength, start.GetRemainingSize());
+    if (size < GetSerializedSize())
+    {
+        return 0xffff;
+    }
+
+    // Linearise the packet so the checksum kernel sees contiguous bytes,
+    // behind the IPv6 pseudo-header for OSPFv3
+    uint32_t offset = (m_version == 3) ? OSPF6_PSEUDO_HEADER_SIZE : 0;
+    uint8_t small[OSPF6_PSEUDO_HEADER_SIZE + 1500];
+    std::vector<uint8_t> large;
+    uint8_t* data = small;
+    if (offset + size > sizeof(small))
+    {
+        large.resize(offset + size);
+        data = large.data();
+    }
+    start.Read(data + offset, size);
+
+    if (m_version == 3)
+    {
+        Ipv6Address::ConvertFrom(m_source).GetBytes(data);
+        Ipv6Address::ConvertFrom(m_destination).GetBytes(data + 16);
+        data[32] = size >> 24;
+        data[33] = size >> 16;
+        data[34] = size >> 8;
+        data[35] = size;
+        std::fill(data + 36, data + 39, 0);
+        data[39] = m_protocol;
+    }
+    else
+    {
+        std::fill(data + OSPF_AUTH_OFFSET, data + OSPF_AUTH_OFFSET + OSPF_AUTH_SIZE, 0);
+    }
+
+    return OspfInternetChecksum(data, offset + size);
+}
+
+void OspfHeader::EnableChecksums(){
     m_calcChecksum = true;
-}*/
+}
+bool OspfHeader::IsChecksumOk() const{
+    return m_goodChecksum;
+}
 void OspfHeader::InitializeChecksum(Ipv4Address source, Ipv4Address destination, uint8_t protocol){
     m_source = source;
     m_destination = destination;
     m_protocol = protocol;
 }
-void OspfHeader::SetState(int new_state){
-    m_state = new_state;
+void OspfHeader::InitializeChecksum(Ipv6Address source, Ipv6Address destination, uint8_t protocol){
+    m_source = source;
+    m_destination = destination;
+    m_protocol = protocol;
 }
-int OspfHeader::GetState() const{
-    return m_state;
+void OspfHeader::SetVersion(uint8_t version){
+    m_version = version;
+}
+uint8_t OspfHeader::GetVersion() const{
+    return m_version;
 }
 void OspfHeader::SetPacketType(int new_packet_type){
     m_packet_type = new_packet_type;
@@ -73,11 +193,23 @@ void OspfHeader::SetPacketType(int new_packet_type){
 int OspfHeader::GetPacketType() const{
     return m_packet_type;
 }
-void OspfHeader::SetMask(Ipv4Mask ipv4Mask) {
-    m_mask = ipv4Mask;
+void OspfHeader::SetPacketLength(uint16_t length){
+    m_packetLength = length;
+}
+uint16_t OspfHeader::GetPacketLength() const{
+    return m_packetLength;
+}
+void OspfHeader::SetRouterId(uint32_t r_id){
+    m_routerId = r_id;
 }
-Ipv4Mask OspfHeader::GetMask() {
-    return m_mask;
+uint32_t OspfHeader::GetRouterId() const{
+    return m_routerId;
+}
+void OspfHeader::SetAreaId(uint32_t a_id){
+    m_areaId = a_id;
+}
+uint32_t OspfHeader::GetAreaId() const{
+    return m_areaId;
 }
 
-}
\ No newline at end of file
+}
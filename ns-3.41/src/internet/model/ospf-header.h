@@ -18,6 +18,28 @@
  *
  *  All headers in ns3 are represented by subclassing Header.
  *
+ *  The wire format is the 24 byte common header of RFC 2328 (A.3.1):
+ *
+ *    version (1) | type (1) | packet length (2)
+ *    router ID (4)
+ *    area ID (4)
+ *    checksum (2) | AuType (2)
+ *    authentication (8)
+ *
+ *  OSPFv3 (RFC 5340 A.3.1) drops authentication and has a 16 byte header
+ *  whose checksum covers the IPv6 pseudo-header:
+ *
+ *    version (1) | type (1) | packet length (2)
+ *    router ID (4)
+ *    area ID (4)
+ *    checksum (2) | instance ID (1) | 0 (1)
+ *
+ *  The version is read back by Deserialize, so the same OspfHeader receives
+ *  both.
+ *
+ *  The body of the packet (e.g. an OspfHello) is a separate header which
+ *  is added to the packet before this one.
+ *
  */
 
 #ifndef OSPF_HEADER_H
@@ -25,6 +47,7 @@
 
 #include "ns3/header.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
 
 #include <stdint.h>
 #include <string>
@@ -34,6 +57,8 @@ namespace ns3 {
 class OspfHeader : public Header {
 public:
 
+    OspfHeader();
+
     /**
      * \brief Get the type ID.
      * \return the object TypeId
@@ -45,25 +70,70 @@ public:
     uint32_t GetSerializedSize() const override;
     void Serialize(Buffer::Iterator start) const override;
     uint32_t Deserialize(Buffer::Iterator start) override;
-    //void EnableChecksums();
+
+    /**
+     * \brief Enable checksum calculation (on Serialize) and verification
+     * (on Deserialize). The checksum covers the whole OSPF packet, so the
+     * packet length must be set before the header is added to the packet.
+     */
+    void EnableChecksums();
+
+    /**
+     * \return true if checksums are disabled or the received checksum is
+     * correct
+     */
+    bool IsChecksumOk() const;
     void InitializeChecksum(Ipv4Address source, Ipv4Address destination, uint8_t protocol);
-    void SetState(int);
-    int GetState() const;
+
+    /**
+     * \brief Set the IPv6 pseudo-header covered by the OSPFv3 checksum.
+     * \param source the source address
+     * \param destination the destination address
+     * \param protocol the protocol number
+     */
+    void InitializeChecksum(Ipv6Address source, Ipv6Address destination, uint8_t protocol);
+
+    /**
+     * \param version the OSPF version, 2 (the default) or 3
+     */
+    void SetVersion(uint8_t version);
+    uint8_t GetVersion() const;
     void SetPacketType(int);
     int GetPacketType() const;
-    void SetMask(Ipv4Mask);
-    Ipv4Mask GetMask();
+
+    /**
+     * \brief Set the length of the whole OSPF packet, this header included.
+     * \param length the packet length in bytes
+     */
+    void SetPacketLength(uint16_t length);
+    uint16_t GetPacketLength() const;
+    void SetRouterId(uint32_t);
+    uint32_t GetRouterId() const;
+    void SetAreaId(uint32_t);
+    uint32_t GetAreaId() const;
 
 private:
+
+    /**
+     * \brief Compute the checksum of the serialised packet starting at start.
+     * \param start the start of the OSPF header
+     * \return the Internet checksum of the packet, authentication excluded
+     * (OSPFv2) or IPv6 pseudo-header included (OSPFv3)
+     */
+    uint16_t CalculateChecksum(Buffer::Iterator start) const;
+
     bool m_calcChecksum;
+    bool m_goodChecksum;
     Address m_source;           //!< Source IP address
     Address m_destination;      //!< Destination IP address
-    uint8_t m_protocol;        //!< Protocol number
-    Ipv4Mask m_mask;
-    int m_state;
-    int m_packet_type;
+    uint8_t m_protocol;         //!< Protocol number
+    uint8_t m_version;          //!< OSPF version
+    int m_packet_type;          //!< OSPF packet type (OspfL4Protocol::PacketType)
+    uint16_t m_packetLength;    //!< Length of the OSPF packet, header included
+    uint32_t m_routerId;        //!< Router ID of the packet's source
+    uint32_t m_areaId;          //!< Area the packet belongs to
 };
 
 }
 
-#endif // OSPF_HEADER_H
\ No newline at end of file
+#endif // OSPF_HEADER_H
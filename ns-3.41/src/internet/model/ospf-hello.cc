@@ -9,13 +9,21 @@
 
 #include <stdint.h>
 #include <string>
+#include <algorithm>
 #include "ospf-hello.h"
+#include "ospf-lsa.h"
 
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED(OspfHello);
 
-OspfHello::OspfHello() {
+OspfHello::OspfHello()
+    : m_version(2),
+      m_interfaceId(0),
+      m_helloInterval(0),
+      m_deadInterval(0),
+      m_options(0)
+{
 
 }
 
@@ -23,24 +31,129 @@ OspfHello::~OspfHello() {
 
 }
 
-void OspfHello::setNeighbors(OspfNeighborTable::neighborList newNeighbors) {
-    m_neighbors = newNeighbors;
+TypeId OspfHello::GetTypeId() {
+    static TypeId tid = TypeId("ns3::OspfHello")
+                            .SetParent<Header>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<OspfHello>();
+    return tid;
 }
-OspfNeighborTable::neighborList OspfHello::getNeighbors() {
+
+TypeId OspfHello::GetInstanceTypeId() const {
+    return GetTypeId();
+}
+
+void OspfHello::Print(std::ostream& os) const {
+    os << "mask " << m_mask << " hello " << m_helloInterval << " dead " << m_deadInterval
+       << " neighbors " << m_neighbors.size();
+}
+
+uint32_t OspfHello::GetSerializedSize() const {
+    return 20 + 4 * m_neighbors.size();
+}
+
+void OspfHello::Serialize(Buffer::Iterator start) const {
+    Buffer::Iterator i = start;
+
+    if (m_version == 3)
+    {
+        i.WriteHtonU32(m_interfaceId);
+        i.WriteHtonU32(OspfLsa::V3_OPTIONS | m_options);    // router priority 0, options
+        i.WriteHtonU16(m_helloInterval);
+        i.WriteHtonU16(m_deadInterval);
+    }
+    else
+    {
+        i.WriteHtonU32(m_mask.Get());
+        i.WriteHtonU16(m_helloInterval);
+        i.WriteU8(m_options);       // options
+        i.WriteU8(0);               // router priority, no DR election
+        i.WriteHtonU32(m_deadInterval);
+    }
+    i.WriteU32(0);                  // designated router
+    i.WriteU32(0);                  // backup designated router
+    for (uint32_t neighbor : m_neighbors)
+    {
+        i.WriteHtonU32(neighbor);
+    }
+}
+
+uint32_t OspfHello::Deserialize(Buffer::Iterator start) {
+    Buffer::Iterator i = start;
+
+    if (m_version == 3)
+    {
+        m_interfaceId = i.ReadNtohU32();
+        m_options = i.ReadNtohU32() & 0xffffff & ~OspfLsa::V3_OPTIONS;
+        m_helloInterval = i.ReadNtohU16();
+        m_deadInterval = i.ReadNtohU16();
+    }
+    else
+    {
+        m_mask.Set(i.ReadNtohU32());
+        m_helloInterval = i.ReadNtohU16();
+        m_options = i.ReadU8();
+        i.ReadU8();
+        m_deadInterval = i.ReadNtohU32();
+    }
+    i.ReadU32();
+    i.ReadU32();
+
+    uint32_t neighborNumber = i.GetRemainingSize() / 4;
+    m_neighbors.resize(neighborNumber);
+    for (uint32_t n = 0; n < neighborNumber; n++)
+    {
+        m_neighbors[n] = i.ReadNtohU32();
+    }
+
+    return GetSerializedSize();
+}
+
+void OspfHello::setNeighbors(std::vector<uint32_t> newNeighbors) {
+    m_neighbors = std::move(newNeighbors);
+}
+const std::vector<uint32_t>& OspfHello::getNeighbors() const {
     return m_neighbors;
 }
+bool OspfHello::hasNeighbor(uint32_t r_id) const {
+    return std::find(m_neighbors.begin(), m_neighbors.end(), r_id) != m_neighbors.end();
+}
 
-void OspfHello::setRouterId(uint32_t r_id) {
-    router_id = r_id;
+void OspfHello::setMask(Ipv4Mask mask) {
+    m_mask = mask;
+}
+Ipv4Mask OspfHello::getMask() const {
+    return m_mask;
+}
+void OspfHello::setHelloInterval(uint16_t interval) {
+    m_helloInterval = interval;
+}
+uint16_t OspfHello::getHelloInterval() const {
+    return m_helloInterval;
 }
-uint32_t OspfHello::getRouterId() {
-    return router_id;
+void OspfHello::setDeadInterval(uint32_t interval) {
+    m_deadInterval = interval;
 }
-void OspfHello::setAreaId(int a_id) {
-    area_id = a_id;
+uint32_t OspfHello::getDeadInterval() const {
+    return m_deadInterval;
 }
-int OspfHello::getAreaId() {
-    return area_id;
+void OspfHello::setOptions(uint32_t options) {
+    m_options = options;
+}
+uint32_t OspfHello::getOptions() const {
+    return m_options;
+}
+void OspfHello::setInterfaceId(uint32_t interfaceId) {
+    m_interfaceId = interfaceId;
+}
+uint32_t OspfHello::getInterfaceId() const {
+    return m_interfaceId;
+}
+void OspfHello::SetVersion(uint8_t version) {
+    m_version = version;
+}
+uint8_t OspfHello::GetVersion() const {
+    return m_version;
 }
 
-}
\ No newline at end of file
+}
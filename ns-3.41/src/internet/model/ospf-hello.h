@@ -5,6 +5,25 @@
  *
  *  File: ospf-hello.h
  *
+ *  Body of an OSPF Hello packet (RFC 2328 A.3.2). The OspfHeader is added
+ *  in front of it by OspfL4Protocol::Send.
+ *
+ *    network mask (4)
+ *    hello interval (2) | options (1) | router priority (1)
+ *    router dead interval (4)
+ *    designated router (4)
+ *    backup designated router (4)
+ *    neighbor router IDs (4 each)
+ *
+ *  and in OSPFv3 (RFC 5340 A.3.2), the mask giving way to an interface ID:
+ *
+ *    interface ID (4)
+ *    router priority (1) | options (3)
+ *    hello interval (2) | router dead interval (2)
+ *    designated router (4)
+ *    backup designated router (4)
+ *    neighbor router IDs (4 each)
+ *
  */
 
 #ifndef OSPF_HELLO_H
@@ -12,28 +31,67 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
-#include "ospf-header.h"
-#include "ospf-neighbor-table.h"
+#include "ns3/header.h"
+#include "ns3/ipv4-address.h"
 
 namespace ns3 {
-class OspfNeighborTable;
 
-class OspfHello : public OspfHeader{
+class OspfHello : public Header{
 public:
     OspfHello();
-    ~OspfHello();
-    void setNeighbors(OspfNeighborTable::neighborList);
-    OspfNeighborTable::neighborList getNeighbors();
-    void setRouterId(uint32_t);
-    uint32_t getRouterId();
-    void setAreaId(int);
-    int getAreaId();
+    ~OspfHello() override;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    void setNeighbors(std::vector<uint32_t>);
+    const std::vector<uint32_t>& getNeighbors() const;
+    bool hasNeighbor(uint32_t) const;
+    void setMask(Ipv4Mask);
+    Ipv4Mask getMask() const;
+    void setHelloInterval(uint16_t);
+    uint16_t getHelloInterval() const;
+    void setDeadInterval(uint32_t);
+    uint32_t getDeadInterval() const;
+
+    /**
+     * \param options the options we set in addition to the mandatory
+     * OSPFv3 ones, e.g. OspfLsa::DC_OPTION
+     */
+    void setOptions(uint32_t options);
+    uint32_t getOptions() const;
+
+    /**
+     * \param interfaceId the ID of the sending interface (OSPFv3)
+     */
+    void setInterfaceId(uint32_t interfaceId);
+    uint32_t getInterfaceId() const;
+
+    /**
+     * \param version the OSPF version, 2 (the default) or 3, which decides
+     * the wire format. Must be set before the body is removed from a packet.
+     */
+    void SetVersion(uint8_t version);
+    uint8_t GetVersion() const;
 private:
-    OspfNeighborTable::neighborList m_neighbors;
-    uint32_t router_id;
-    int area_id;
+    uint8_t m_version;
+    Ipv4Mask m_mask;
+    uint32_t m_interfaceId;             //!< OSPFv3 only
+    uint16_t m_helloInterval;           //!< HelloInterval in seconds
+    uint32_t m_deadInterval;            //!< RouterDeadInterval in seconds
+    uint32_t m_options;                 //!< Options field
+    std::vector<uint32_t> m_neighbors;  //!< Router IDs seen on the interface
 };
 
 }
-#endif
\ No newline at end of file
+#endif
@@ -9,6 +9,10 @@
  */
 
 #include "ospf-l4-protocol.h"
+#include "ospf-dbd.h"
+#include "ospf-lsack.h"
+#include "ospf-lsr.h"
+#include "ospf-lsu.h"
 
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
@@ -16,6 +20,7 @@
 #include "ipv4.h"
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
+#include "ipv6-l3-protocol.h"
 #include "ipv6-route.h"
 #include "ipv6.h"
 
@@ -25,14 +30,27 @@
 #include "ns3/node.h"
 #include "ns3/object-map.h"
 #include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
 
-#include "ipv4-packet-info-tag.h"
-
+#include <algorithm>
 #include <unordered_map>
 #include <set>
 
 #define OSPF_ALL_NODE "224.0.0.5"
 
+/// AllSPFRouters for OSPFv3 (RFC 5340 A.1)
+#define OSPF6_ALL_ROUTERS "ff02::5"
+
+/// Size of the IPv4 and OSPF headers in front of every OSPF packet body
+#define OSPF_OVERHEAD (20 + 24)
+
+/// Size of the IPv6 and OSPFv3 headers in front of every OSPFv3 packet body
+#define OSPF6_OVERHEAD (40 + 16)
+
+/// Period of the LSDB aging sweep, seconds
+#define OSPF_AGING_PERIOD 60
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE("OspfL4Protocol");
@@ -45,7 +63,15 @@ const uint8_t OspfL4Protocol::PROTOCOL_NUMBER = 89;
 // Constructor
 OspfL4Protocol::OspfL4Protocol()
         : m_endPoints(new Ipv4EndPointDemux()),
-          m_endPoints6(new Ipv6EndPointDemux())
+          m_endPoints6(new Ipv6EndPointDemux()),
+          m_version(2),
+          m_allDemandCircuits(false),
+          m_routerId(0),
+          m_areaId(0),
+          m_routerLsaOriginated(false),
+          m_running(false),
+          m_maxMetric(false),
+          m_restarting(false)
 {
     NS_LOG_FUNCTION(this);
     m_neighbor_table = OspfNeighborTable();
@@ -58,11 +84,56 @@ OspfL4Protocol::~OspfL4Protocol(){
 
 // GetTypeId
 TypeId OspfL4Protocol::GetTypeId() {
-        static TypeId tid;
-        tid = TypeId("ns3::OspfL4Protocol")
+        static TypeId tid = TypeId("ns3::OspfL4Protocol")
                 .SetParent<IpL4Protocol>()
                 .SetGroupName("Internet")
-                .AddConstructor<OspfL4Protocol>();
+                .AddConstructor<OspfL4Protocol>()
+                .AddAttribute("HelloInterval",
+                              "The time between two Hello packets on an interface.",
+                              TimeValue(Seconds(10)),
+                              MakeTimeAccessor(&OspfL4Protocol::m_helloInterval),
+                              MakeTimeChecker())
+                .AddAttribute("RouterDeadInterval",
+                              "The time without Hellos after which a neighbor is declared down.",
+                              TimeValue(Seconds(40)),
+                              MakeTimeAccessor(&OspfL4Protocol::m_routerDeadInterval),
+                              MakeTimeChecker())
+                .AddAttribute("RxmtInterval",
+                              "The time between retransmissions of unacknowledged DBD, "
+                              "LS Request and LS Update packets.",
+                              TimeValue(Seconds(5)),
+                              MakeTimeAccessor(&OspfL4Protocol::m_rxmtInterval),
+                              MakeTimeChecker())
+                .AddAttribute("MinLSInterval",
+                              "The minimum time between two originations of our Router-LSA.",
+                              TimeValue(Seconds(5)),
+                              MakeTimeAccessor(&OspfL4Protocol::m_minLsInterval),
+                              MakeTimeChecker())
+                .AddAttribute("LSRefreshTime",
+                              "The time after which our Router-LSA is re-originated "
+                              "even if it did not change.",
+                              TimeValue(Seconds(1800)),
+                              MakeTimeAccessor(&OspfL4Protocol::m_lsRefreshTime),
+                              MakeTimeChecker())
+                .AddAttribute("GracePeriod",
+                              "The time our neighbors keep our adjacencies during a graceful "
+                              "restart (RFC 3623).",
+                              TimeValue(Seconds(120)),
+                              MakeTimeAccessor(&OspfL4Protocol::m_gracePeriod),
+                              MakeTimeChecker())
+                .AddAttribute("GracefulRestartHelper",
+                              "Whether we help neighbors through a graceful restart.",
+                              BooleanValue(true),
+                              MakeBooleanAccessor(&OspfL4Protocol::m_helperSupport),
+                              MakeBooleanChecker())
+                .AddTraceSource("NeighborState",
+                                "A neighbor changed state.",
+                                MakeTraceSourceAccessor(&OspfL4Protocol::m_neighborStateTrace),
+                                "ns3::OspfL4Protocol::NeighborStateTracedCallback")
+                .AddTraceSource("LsaInstall",
+                                "An LSA was installed in the LSDB.",
+                                MakeTraceSourceAccessor(&OspfL4Protocol::m_lsaInstallTrace),
+                                "ns3::OspfL4Protocol::LsaInstallTracedCallback");
     return tid;
 }
 
@@ -100,6 +171,30 @@ void OspfL4Protocol::DoDispose() {
         delete m_endPoints6;
         m_endPoints6 = nullptr;
     }
+    m_helloEvent.Cancel();
+    m_routerLsaEvent.Cancel();
+    m_refreshEvent.Cancel();
+    m_agingEvent.Cancel();
+    m_restartEvent.Cancel();
+    m_graceEvent.Cancel();
+    for (auto& neighbor : m_neighbor_table.getCurrentNeighbors())
+    {
+        Simulator::Cancel(neighbor.inactivityTimer);
+        neighbor.state = States::DOWN;
+        ResetAdjacency(neighbor, States::DOWN);
+    }
+    for (auto& helped : m_helping)
+    {
+        helped.second.expiry.Cancel();
+    }
+    m_helping.clear();
+    m_lsdb.Clear();
+    m_lsdbChanged.Nullify();
+    m_helloCache.clear();
+    m_interfaceRoutes.clear();
+    m_interfaceRoutes6.clear();
+    m_ipv4 = nullptr;
+    m_ipv6 = nullptr;
     m_node = nullptr;
     m_downTarget.Nullify();
     m_downTarget6.Nullify();
@@ -113,11 +208,10 @@ void OspfL4Protocol::NotifyNewAggregate() {
 
     Ptr<Node> node = this->GetObject<Node>();
     Ptr<Ipv4> ipv4 = this->GetObject<Ipv4>();
-    Ptr<Ipv6> ipv6 = node->GetObject<Ipv6>();
 
     if (!m_node)
     {
-        if (node && (ipv4 || ipv6))
+        if (node && ipv4)
         {
             this->SetNode(node);
             // Ptr<UdpSocketFactoryImpl> udpFactory = CreateObject<UdpSocketFactoryImpl>();
@@ -126,16 +220,13 @@ void OspfL4Protocol::NotifyNewAggregate() {
         }
     }
 
+    // Only the OSPFv2 instance is aggregated, an OSPFv3 one is inserted into
+    // the IPv6 stack by Ospf6Routing
     if (ipv4 && m_downTarget.IsNull())
     {
         ipv4->Insert(this);
         this->SetDownTarget(MakeCallback(&Ipv4::Send, ipv4));
     }
-    if (ipv6 && m_downTarget6.IsNull())
-    {
-        ipv6->Insert(this);
-        this->SetDownTarget6(MakeCallback(&Ipv6::Send, ipv6));
-    }
     IpL4Protocol::NotifyNewAggregate();
 }
 
@@ -163,59 +254,76 @@ IpL4Protocol::DownTargetCallback6 OspfL4Protocol::GetDownTarget6() const {
     return m_downTarget6;
 }
 
-void OspfL4Protocol::Send(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr, Ipv4Mask ipv4Mask, OspfHeader ospfHeader, int packetType, int currentState)
+void OspfL4Protocol::Send(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr, int packetType)
 {
     NS_LOG_FUNCTION(this << packet << saddr << daddr);
 
-    ospfHeader.InitializeChecksum(saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER);
-    ospfHeader.SetState(currentState);
-    ospfHeader.SetPacketType(packetType);
-    ospfHeader.SetMask(ipv4Mask);
-
-    packet->AddHeader(ospfHeader);
-
-    m_downTarget(packet, saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER, nullptr);
+    Send(packet, saddr, daddr, packetType, nullptr);
 }
 
-void OspfL4Protocol::Send(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr, Ipv4Mask ipv4Mask, OspfHeader ospfHeader, int packetType, int currentState, Ptr<Ipv4Route> route)
+void OspfL4Protocol::Send(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr, int packetType, Ptr<Ipv4Route> route)
 {
     NS_LOG_FUNCTION(this << packet << saddr << daddr << route);
 
+    OspfHeader ospfHeader;
     ospfHeader.InitializeChecksum(saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER);
-    ospfHeader.SetState(currentState);
     ospfHeader.SetPacketType(packetType);
-    ospfHeader.SetMask(ipv4Mask);
+    ospfHeader.SetRouterId(m_routerId);
+    ospfHeader.SetAreaId(m_areaId);
+    ospfHeader.SetPacketLength(packet->GetSize() + ospfHeader.GetSerializedSize());
+    if (Node::ChecksumEnabled())
+    {
+        ospfHeader.EnableChecksums();
+    }
 
     packet->AddHeader(ospfHeader);
 
+    // OSPF packets are never forwarded (RFC 2328 A.1)
+    SocketIpTtlTag ttlTag;
+    ttlTag.SetTtl(1);
+    packet->AddPacketTag(ttlTag);
+
+    if (packetType > 0 && packetType < static_cast<int>(m_stats.packetsSent.size()))
+    {
+        m_stats.packetsSent[packetType]++;
+    }
     m_downTarget(packet, saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER, route);
 }
 
-void OspfL4Protocol::Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr)
+void OspfL4Protocol::Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr, int packetType)
 {
     NS_LOG_FUNCTION(this << packet << saddr << daddr);
 
-    OspfHeader ospfHeader;
-
-    //create iv6 for header later
-    //ospfHeader.InitializeChecksum(saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER);
-
-    packet->AddHeader(ospfHeader);
-
-    m_downTarget6(packet, saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER, nullptr);
+    Send(packet, saddr, daddr, packetType, nullptr);
 }
 
-void OspfL4Protocol::Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr, Ptr<Ipv6Route> route)
+void OspfL4Protocol::Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr, int packetType, Ptr<Ipv6Route> route)
 {
     NS_LOG_FUNCTION(this << packet << saddr << daddr << route);
 
     OspfHeader ospfHeader;
-
-    //create ipv6 for header later
-    //ospfHeader.InitializeChecksum(saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER);
+    ospfHeader.SetVersion(3);
+    ospfHeader.InitializeChecksum(saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER);
+    ospfHeader.SetPacketType(packetType);
+    ospfHeader.SetRouterId(m_routerId);
+    ospfHeader.SetAreaId(m_areaId);
+    ospfHeader.SetPacketLength(packet->GetSize() + ospfHeader.GetSerializedSize());
+    if (Node::ChecksumEnabled())
+    {
+        ospfHeader.EnableChecksums();
+    }
 
     packet->AddHeader(ospfHeader);
 
+    // OSPFv3 packets never leave the link either (RFC 5340 A.1)
+    SocketIpv6HopLimitTag hopLimitTag;
+    hopLimitTag.SetHopLimit(1);
+    packet->AddPacketTag(hopLimitTag);
+
+    if (packetType > 0 && packetType < static_cast<int>(m_stats.packetsSent.size()))
+    {
+        m_stats.packetsSent[packetType]++;
+    }
     m_downTarget6(packet, saddr, daddr, OspfL4Protocol::PROTOCOL_NUMBER, route);
 }
 
@@ -226,26 +334,20 @@ OspfL4Protocol::Receive(Ptr<Packet> packet, const Ipv4Header& header, Ptr<Ipv4In
     OspfHeader ospfHeader;
 
     ospfHeader.InitializeChecksum(header.GetSource(), header.GetDestination(), OspfL4Protocol::PROTOCOL_NUMBER);
-
-    packet->PeekHeader(ospfHeader);
-
-    Ipv4PacketInfoTag interfaceInfo;
-    if (!packet->RemovePacketTag(interfaceInfo))
+    if (Node::ChecksumEnabled())
     {
-        NS_ABORT_MSG("No incoming interface on RIP message, aborting.");
+        ospfHeader.EnableChecksums();
     }
-    uint32_t incomingIf = interfaceInfo.GetRecvIf();
 
-    if (ospfHeader.GetState() == States::DOWN){
-        HandleDownResponse(packet, header, ospfHeader, interface, incomingIf);
-    }
-    if (ospfHeader.GetState() == States::INIT){
-        HandleInitResponse(packet, header, ospfHeader, interface, incomingIf);
-    }
-    if (ospfHeader.GetState() == States::TWO_WAY){
-        HandleTwoWayResponse(packet, header, ospfHeader, interface, incomingIf);
+    packet->RemoveHeader(ospfHeader);
+
+    if (!ospfHeader.IsChecksumOk())
+    {
+        NS_LOG_INFO("Bad checksum : dropping packet!");
+        return IpL4Protocol::RX_CSUM_FAILED;
     }
 
+    ReceivePacket(packet, ospfHeader, header.GetSource(), m_ipv4->GetInterfaceForDevice(interface->GetDevice()));
     return IpL4Protocol::RX_OK;
 }
 
@@ -254,10 +356,83 @@ OspfL4Protocol::Receive(Ptr<Packet> packet, const Ipv6Header& header, Ptr<Ipv6In
 {
     NS_LOG_FUNCTION("Receive" << this << packet << header.GetSource() << header.GetDestination());
     OspfHeader ospfHeader;
-    //implement for ipv6
+
+    ospfHeader.InitializeChecksum(header.GetSource(), header.GetDestination(), OspfL4Protocol::PROTOCOL_NUMBER);
+    if (Node::ChecksumEnabled())
+    {
+        ospfHeader.EnableChecksums();
+    }
+
+    packet->RemoveHeader(ospfHeader);
+
+    if (!ospfHeader.IsChecksumOk())
+    {
+        NS_LOG_INFO("Bad checksum : dropping packet!");
+        return IpL4Protocol::RX_CSUM_FAILED;
+    }
+
+    if (!m_ipv6)
+    {
+        return IpL4Protocol::RX_OK;
+    }
+    ReceivePacket(packet, ospfHeader, header.GetSource(), m_ipv6->GetInterfaceForDevice(interface->GetDevice()));
     return IpL4Protocol::RX_OK;
 }
 
+void OspfL4Protocol::ReceivePacket(Ptr<Packet> packet, const OspfHeader& ospfHeader, const Address& source, int32_t incomingIf)
+{
+    if (!m_running)
+    {
+        // Not started, restarting, or dormant because another rank owns the node
+        NS_LOG_LOGIC("Ignoring OSPF packet, protocol is not running");
+        return;
+    }
+    if (incomingIf < 0 || m_interfaceExclusions.find(incomingIf) != m_interfaceExclusions.end())
+    {
+        NS_LOG_LOGIC("Ignoring OSPF packet on excluded interface " << incomingIf);
+        return;
+    }
+    if (ospfHeader.GetVersion() != m_version)
+    {
+        NS_LOG_LOGIC("Ignoring OSPF version " << int(ospfHeader.GetVersion()) << " packet");
+        return;
+    }
+    if (ospfHeader.GetRouterId() == m_routerId || ospfHeader.GetAreaId() != uint32_t(m_areaId))
+    {
+        NS_LOG_LOGIC("Ignoring OSPF packet from router " << ospfHeader.GetRouterId()
+                                                         << " area " << ospfHeader.GetAreaId());
+        return;
+    }
+
+    uint32_t packetType = ospfHeader.GetPacketType();
+    if (packetType > 0 && packetType < m_stats.packetsReceived.size())
+    {
+        m_stats.packetsReceived[packetType]++;
+    }
+
+    switch (packetType)
+    {
+    case PacketType::HELLO:
+        HandleHello(packet, source, ospfHeader, incomingIf);
+        break;
+    case PacketType::DBD:
+        HandleDbd(packet, ospfHeader, incomingIf);
+        break;
+    case PacketType::LSR:
+        HandleLsRequest(packet, ospfHeader, incomingIf);
+        break;
+    case PacketType::LSU:
+        HandleLsUpdate(packet, ospfHeader, incomingIf);
+        break;
+    case PacketType::LSAck:
+        HandleLsAck(packet, ospfHeader, incomingIf);
+        break;
+    default:
+        NS_LOG_LOGIC("Unknown OSPF packet type " << ospfHeader.GetPacketType());
+        break;
+    }
+}
+
 
 void
 OspfL4Protocol::ReceiveIcmp(Ipv4Address icmpSource,
@@ -326,41 +501,95 @@ OspfL4Protocol::ReceiveIcmp(Ipv6Address icmpSource,
 
 void OspfL4Protocol::startDownState()
 {
-    OspfNeighborTable::neighborList neighbor_table = m_neighbor_table.getCurrentNeighbors();
-    for (uint32_t i = 0; i < m_ipv4->GetNInterfaces(); i++)
+    NS_LOG_FUNCTION(this);
+
+    // In a distributed simulation every rank holds every node, but only the
+    // owning rank runs its protocol: the others would flood duplicate packets
+    // into their local neighbours and keep a full LSDB per remote router
+    if (m_node && m_node->GetSystemId() != Simulator::GetSystemId())
+    {
+        NS_LOG_LOGIC("Node " << m_node->GetId() << " is simulated by rank "
+                             << m_node->GetSystemId() << ", staying dormant");
+        return;
+    }
+
+    m_interfaceRoutes.assign(m_version == 2 ? GetNInterfaces() : 0, nullptr);
+    m_interfaceRoutes6.assign(m_version == 3 ? GetNInterfaces() : 0, nullptr);
+    m_helloCache.assign(GetNInterfaces(), HelloCacheEntry());
+
+    Ptr<Ipv6L3Protocol> ipv6L3 = DynamicCast<Ipv6L3Protocol>(m_ipv6);
+    for (uint32_t i = 0; i < GetNInterfaces(); i++)
     {
-        Ptr<LoopbackNetDevice> check = DynamicCast<LoopbackNetDevice>(m_ipv4->GetNetDevice(i));
-        if (check) {
+        if (m_interfaceExclusions.find(i) != m_interfaceExclusions.end())
+        {
             continue;
         }
-
-        bool activeInterface = false;
-        if (m_interfaceExclusions.find(i) == m_interfaceExclusions.end())
+        if (m_version == 3)
+        {
+            m_ipv6->SetForwarding(i, true);
+            if (ipv6L3)
+            {
+                ipv6L3->AddMulticastAddress(Ipv6Address(OSPF6_ALL_ROUTERS), i);
+            }
+        }
+        else
         {
-            activeInterface = true;
             m_ipv4->SetForwarding(i, true);
         }
+    }
+
+    m_running = true;
+    SendHelloPackets();
+
+    // Our Router-LSA with our stub networks only, neighbors are added as
+    // adjacencies come up. After a graceful restart the copy our neighbors
+    // hold is kept until the adjacencies are back.
+    if (!m_restarting)
+    {
+        OriginateRouterLsa(true);
+    }
+    m_agingEvent = Simulator::Schedule(Seconds(OSPF_AGING_PERIOD), &OspfL4Protocol::AgeLsdb, this);
+}
+
+void OspfL4Protocol::SendHelloPackets()
+{
+    NS_LOG_FUNCTION(this);
+
+    bool needed = false;
+    for (uint32_t i = 0; i < GetNInterfaces(); i++)
+    {
+        if (!IsOspfInterface(i) || IsHelloSuppressed(i)) {
+            continue;
+        }
+        needed = true;
+
+        if (m_version == 3)
+        {
+            // One Hello per link, from the link-local address
+            Ipv6Address local = GetLinkLocalAddress(i);
+            if (local != Ipv6Address::GetAny())
+            {
+                Ptr<Packet> p = GetHelloPacket(i, Ipv4Mask())->Copy();
+                Send(p, local, Ipv6Address(OSPF6_ALL_ROUTERS), PacketType::HELLO, GetInterfaceRoute6(i));
+            }
+            continue;
+        }
 
         for (uint32_t j = 0; j < m_ipv4->GetNAddresses(i); j++)
         {
-            bool isInterfaceFull = false;
             Ipv4InterfaceAddress address = m_ipv4->GetAddress(i, j);
-            if (address.GetScope() != Ipv4InterfaceAddress::HOST && activeInterface) {
-                if (!neighbor_table.empty()) {
-                    for (const auto &row: neighbor_table) {
-                        for (const auto &tableItems: row) {
-                            if (address == tableItems.ipInterface->GetAddress(i)) {
-                                isInterfaceFull = true;
-                            }
-                        }
-                    }
-                }
-                if (!isInterfaceFull) {
-                    SendDownPacket(address);
-                }
+            if (address.GetScope() != Ipv4InterfaceAddress::HOST) {
+                SendDownPacket(i, address);
             }
         }
     }
+
+    // Demand circuits only: resumed when an adjacency goes down or an
+    // interface changes
+    if (needed)
+    {
+        m_helloEvent = Simulator::Schedule(m_helloInterval, &OspfL4Protocol::SendHelloPackets, this);
+    }
 }
 
 void OspfL4Protocol::SetIpv4(Ptr<Ipv4> the_ipv4)
@@ -368,171 +597,1531 @@ void OspfL4Protocol::SetIpv4(Ptr<Ipv4> the_ipv4)
     m_ipv4 = the_ipv4;
 }
 
+void OspfL4Protocol::SetIpv6(Ptr<Ipv6> ipv6)
+{
+    m_ipv6 = ipv6;
+    m_version = 3;
+}
+
+uint8_t OspfL4Protocol::GetVersion() const
+{
+    return m_version;
+}
+
+uint32_t OspfL4Protocol::GetNInterfaces() const
+{
+    return (m_version == 3) ? m_ipv6->GetNInterfaces() : m_ipv4->GetNInterfaces();
+}
+
+Ptr<NetDevice> OspfL4Protocol::GetInterfaceDevice(uint32_t interface) const
+{
+    return (m_version == 3) ? m_ipv6->GetNetDevice(interface) : m_ipv4->GetNetDevice(interface);
+}
+
+bool OspfL4Protocol::IsInterfaceUp(uint32_t interface) const
+{
+    return (m_version == 3) ? m_ipv6->IsUp(interface) : m_ipv4->IsUp(interface);
+}
+
+uint16_t OspfL4Protocol::GetInterfaceMtu(uint32_t interface) const
+{
+    return (m_version == 3) ? m_ipv6->GetMtu(interface) : m_ipv4->GetMtu(interface);
+}
+
+bool OspfL4Protocol::IsOspfInterface(uint32_t interface) const
+{
+    Ptr<LoopbackNetDevice> check = DynamicCast<LoopbackNetDevice>(GetInterfaceDevice(interface));
+    return !check && IsInterfaceUp(interface) &&
+           m_interfaceExclusions.find(interface) == m_interfaceExclusions.end();
+}
+
+uint32_t OspfL4Protocol::GetPacketOverhead() const
+{
+    return (m_version == 3) ? OSPF6_OVERHEAD : OSPF_OVERHEAD;
+}
+
+bool OspfL4Protocol::IsSupportedLsType(uint16_t type) const
+{
+    if (m_version == 3)
+    {
+        return type == OspfLsa::V3_ROUTER_LSA || type == OspfLsa::V3_INTRA_AREA_PREFIX_LSA;
+    }
+    return type == OspfLsa::ROUTER_LSA || type == OspfLsa::AREA_LOCAL_OPAQUE_LSA;
+}
+
 void OspfL4Protocol::SetExclusions(std::set<uint32_t> iExclusions)
 {
     m_interfaceExclusions = iExclusions;
 }
 
-void OspfL4Protocol::SendDownPacket(Ipv4InterfaceAddress address)
+void OspfL4Protocol::SetPrefixSuppressions(const std::set<uint32_t>& interfaces)
 {
-    Ptr<Packet> p = Create<Packet>();
-    OspfHello helloHeader;
-    helloHeader.setNeighbors(m_neighbor_table.getCurrentNeighbors());
-    helloHeader.setRouterId(m_routerId);
-    helloHeader.setAreaId(m_areaId);
-    if (address.GetScope() != Ipv4InterfaceAddress::HOST)
+    m_prefixSuppressions = interfaces;
+    if (m_running)
     {
-        Send(p, address.GetLocal(), OSPF_ALL_NODE, address.GetMask(), helloHeader, PacketType::HELLO, States::DOWN);
+        ScheduleRouterLsa();
     }
 }
 
+void OspfL4Protocol::SetTeAttributes(uint32_t interface,
+                                     DataRate bandwidth,
+                                     DataRate reservableBandwidth,
+                                     uint32_t adminGroup)
+{
+    NS_LOG_FUNCTION(this << interface << bandwidth << reservableBandwidth << adminGroup);
+    OspfLsa::TeLink& link = m_teLinks[interface];
+    link.maxBandwidth = bandwidth.GetBitRate() / 8.0;
+    link.maxReservableBandwidth = reservableBandwidth.GetBitRate() / 8.0;
+    // Nothing is reserved, there is no signalling protocol
+    link.unreservedBandwidth = link.maxReservableBandwidth;
+    link.adminGroup = adminGroup;
+    if (m_running)
+    {
+        ScheduleRouterLsa();
+    }
+}
 
-void OspfL4Protocol::HandleDownResponse(Ptr<Packet> packet, Ipv4Header header, OspfHeader ospfHeader, Ptr<Ipv4Interface> interface, uint32_t incomingIf){
-    //TODO manage when down is received but no down is sent i.e. straight to 2-Way
-    OspfHello helloHeader;
-    packet->PeekHeader(helloHeader);
-    if (helloHeader.getAreaId() == m_areaId and ospfHeader.GetMask() == interface->GetAddress(incomingIf).GetMask()) {
-        m_neighbor_table.addNeighbors(header.GetSource(), ospfHeader.GetMask(), interface, ospfHeader.GetState(),
-                                      helloHeader.getRouterId());
-        SendInitPacket(interface->GetAddress(incomingIf), header.GetSource());
+void OspfL4Protocol::SetDemandCircuits(const std::set<uint32_t>& interfaces, bool all)
+{
+    m_demandCircuits = interfaces;
+    m_allDemandCircuits = all;
+    // The DC option of our Hellos
+    m_helloCache.clear();
+}
+
+bool OspfL4Protocol::IsDemandCircuit(uint32_t interface) const
+{
+    return m_allDemandCircuits || m_demandCircuits.find(interface) != m_demandCircuits.end();
+}
+
+bool OspfL4Protocol::IsHelloSuppressed(uint32_t interface) const
+{
+    bool adjacent = false;
+    for (const auto& neighbor : m_neighbor_table.getCurrentNeighbors())
+    {
+        if (neighbor.interface != interface)
+        {
+            continue;
+        }
+        if (neighbor.state != States::FULL || !neighbor.demandCircuit)
+        {
+            return false;
+        }
+        adjacent = true;
     }
+    return adjacent;
 }
 
-void OspfL4Protocol::SendInitPacket(Ipv4InterfaceAddress address, Ipv4Address daddr){
-    Ptr<Packet> p = Create<Packet>();
-    OspfHello helloHeader;
-    helloHeader.setNeighbors(m_neighbor_table.getCurrentNeighbors());
-    helloHeader.setRouterId(m_routerId);
-    helloHeader.setAreaId(m_areaId);
-    if (address.GetScope() != Ipv4InterfaceAddress::HOST)
+Ptr<Packet> OspfL4Protocol::GetHelloPacket(uint32_t interface, Ipv4Mask mask)
+{
+    if (interface >= m_helloCache.size())
+    {
+        m_helloCache.resize(interface + 1);
+    }
+
+    HelloCacheEntry& entry = m_helloCache[interface];
+    if (!entry.packet || entry.mask != mask)
     {
-        Send(p, address.GetLocal(), daddr, address.GetMask(), helloHeader, PacketType::HELLO, States::INIT);
+        NS_LOG_LOGIC("Building Hello for interface " << interface);
+        OspfHello helloHeader;
+        helloHeader.SetVersion(m_version);
+        helloHeader.setInterfaceId(interface);
+        helloHeader.setNeighbors(m_neighbor_table.getNeighborIds(interface));
+        helloHeader.setMask(mask);
+        helloHeader.setHelloInterval(m_helloInterval.GetSeconds());
+        helloHeader.setDeadInterval(m_routerDeadInterval.GetSeconds());
+        helloHeader.setOptions(IsDemandCircuit(interface) ? OspfLsa::DC_OPTION : 0);
+
+        entry.packet = Create<Packet>();
+        entry.packet->AddHeader(helloHeader);
+        entry.mask = mask;
     }
+    return entry.packet;
 }
 
-void OspfL4Protocol::HandleInitResponse(Ptr<Packet> packet, Ipv4Header header, OspfHeader ospfHeader, Ptr<Ipv4Interface> interface, uint32_t incomingIf){
-    //TODO loop through ospfheader table if our IP address exists, if so move to 2-Way state
-    OspfHello helloHeader;
-    packet->PeekHeader(helloHeader);
-    OspfNeighborTable::neighborList neighbors = helloHeader.getNeighbors();
-    if (neighbors.empty()){
-        SendDownPacket(interface->GetAddress(incomingIf));
-    }else{
-        bool check = false;
-        for (const auto& row : neighbors){
-            for (const auto& neighborItems : row){
-                if (neighborItems.router_id == m_routerId){
-                    check = true;
-                }
-            }
+void OspfL4Protocol::InvalidateHelloPacket(uint32_t interface)
+{
+    if (interface < m_helloCache.size())
+    {
+        m_helloCache[interface].packet = nullptr;
+    }
+}
+
+Ptr<Ipv4Route> OspfL4Protocol::GetInterfaceRoute(uint32_t interface)
+{
+    if (interface >= m_interfaceRoutes.size())
+    {
+        m_interfaceRoutes.resize(interface + 1);
+    }
+
+    Ptr<Ipv4Route>& route = m_interfaceRoutes[interface];
+    if (!route)
+    {
+        route = Create<Ipv4Route>();
+        route->SetGateway(Ipv4Address::GetAny());
+        route->SetOutputDevice(m_ipv4->GetNetDevice(interface));
+    }
+    return route;
+}
+
+Ptr<Ipv6Route> OspfL4Protocol::GetInterfaceRoute6(uint32_t interface)
+{
+    if (interface >= m_interfaceRoutes6.size())
+    {
+        m_interfaceRoutes6.resize(interface + 1);
+    }
+
+    Ptr<Ipv6Route>& route = m_interfaceRoutes6[interface];
+    if (!route)
+    {
+        route = Create<Ipv6Route>();
+        route->SetGateway(Ipv6Address::GetZero());
+        route->SetOutputDevice(m_ipv6->GetNetDevice(interface));
+    }
+    return route;
+}
+
+Ipv6Address OspfL4Protocol::GetLinkLocalAddress(uint32_t interface) const
+{
+    for (uint32_t j = 0; j < m_ipv6->GetNAddresses(interface); j++)
+    {
+        Ipv6InterfaceAddress address = m_ipv6->GetAddress(interface, j);
+        if (address.GetScope() == Ipv6InterfaceAddress::LINKLOCAL)
+        {
+            return address.GetAddress();
+        }
+    }
+    return Ipv6Address::GetAny();
+}
+
+Ipv4InterfaceAddress OspfL4Protocol::GetInterfaceAddress(uint32_t interface, Ipv4Address peer) const
+{
+    Ipv4InterfaceAddress found;
+    for (uint32_t j = 0; j < m_ipv4->GetNAddresses(interface); j++)
+    {
+        Ipv4InterfaceAddress address = m_ipv4->GetAddress(interface, j);
+        if (address.GetScope() == Ipv4InterfaceAddress::HOST) {
+            continue;
         }
-        if (helloHeader.getAreaId() != m_areaId){
-            check = false;
+        if (address.GetMask().IsMatch(address.GetLocal(), peer)) {
+            return address;
         }
-        if (check){
-            bool add_neighbor = false;
-            OspfNeighborTable::neighborList m_current_neighbors = m_neighbor_table.getCurrentNeighbors();
-            if (m_current_neighbors.empty()){
-                add_neighbor = true;
-            }else{
-                bool iterator_check = false;
-                for (const auto& row : m_current_neighbors){
-                    for (const auto& neighborItems : row){
-                        if (neighborItems.router_id == helloHeader.getRouterId()){
-                            iterator_check = true;
-                        }
-                    }
-                }
-                if (iterator_check){
-                    add_neighbor = false;
-                }else{
-                    add_neighbor = true;
-                }
-            }
-            if (add_neighbor) {
-                m_neighbor_table.addNeighbors(header.GetSource(), ospfHeader.GetMask(), interface,
-                                              ospfHeader.GetState(), helloHeader.getRouterId());
-                SendTwoWayPacket(interface->GetAddress(incomingIf), header.GetSource());
-            }else{
-                m_neighbor_table.set_State(States::INIT, m_routerId);
-                SendTwoWayPacket(interface->GetAddress(incomingIf), header.GetSource());
-            }
-        }else{
-            SendDownPacket(interface->GetAddress(incomingIf));
+        if (found.GetLocal() == Ipv4Address()) {
+            found = address;
         }
     }
+    return found;
 }
 
-void OspfL4Protocol::SendTwoWayPacket(Ipv4InterfaceAddress address, Ipv4Address daddr){
-    Ptr<Packet> p = Create<Packet>();
-    OspfHello helloHeader;
-    helloHeader.setNeighbors(m_neighbor_table.getCurrentNeighbors());
-    helloHeader.setRouterId(m_routerId);
-    helloHeader.setAreaId(m_areaId);
+void OspfL4Protocol::SendDownPacket(uint32_t interface, Ipv4InterfaceAddress address)
+{
+    if (address.GetScope() != Ipv4InterfaceAddress::HOST)
+    {
+        Ptr<Packet> p = GetHelloPacket(interface, address.GetMask())->Copy();
+        Send(p, address.GetLocal(), OSPF_ALL_NODE, PacketType::HELLO, GetInterfaceRoute(interface));
+    }
+}
+
+void OspfL4Protocol::SendHelloTo(uint32_t interface, const Address& daddr){
+    if (m_version == 3)
+    {
+        Ptr<Packet> p = GetHelloPacket(interface, Ipv4Mask())->Copy();
+        Send(p, GetLinkLocalAddress(interface), Ipv6Address::ConvertFrom(daddr), PacketType::HELLO, GetInterfaceRoute6(interface));
+        return;
+    }
+
+    Ipv4Address peer = Ipv4Address::ConvertFrom(daddr);
+    Ipv4InterfaceAddress address = GetInterfaceAddress(interface, peer);
     if (address.GetScope() != Ipv4InterfaceAddress::HOST)
     {
-        Send(p, address.GetLocal(), daddr, address.GetMask(), helloHeader, PacketType::HELLO, States::TWO_WAY);
+        Ptr<Packet> p = GetHelloPacket(interface, address.GetMask())->Copy();
+        Send(p, address.GetLocal(), peer, PacketType::HELLO, GetInterfaceRoute(interface));
     }
 }
 
-void OspfL4Protocol::HandleTwoWayResponse(Ptr<Packet> packet, Ipv4Header header, OspfHeader ospfHeader, Ptr<Ipv4Interface> interface, uint32_t incomingIf){
+void OspfL4Protocol::HandleHello(Ptr<Packet> packet, const Address& source, OspfHeader ospfHeader, uint32_t incomingIf){
     OspfHello helloHeader;
-    packet->PeekHeader(helloHeader);
-    OspfNeighborTable::neighborList neighbors = helloHeader.getNeighbors();
-    if (neighbors.empty()){
-        SendDownPacket(interface->GetAddress(incomingIf));
+    helloHeader.SetVersion(m_version);
+    packet->RemoveHeader(helloHeader);
+
+    // OSPFv3 Hellos carry no mask (RFC 5340 4.2.1.1)
+    bool maskMismatch = false;
+    if (m_version == 2)
+    {
+        Ipv4InterfaceAddress address = GetInterfaceAddress(incomingIf, Ipv4Address::ConvertFrom(source));
+        maskMismatch = helloHeader.getMask() != address.GetMask();
+    }
+    if (maskMismatch ||
+        helloHeader.getHelloInterval() != uint16_t(m_helloInterval.GetSeconds()) ||
+        helloHeader.getDeadInterval() != uint32_t(m_routerDeadInterval.GetSeconds()))
+    {
+        NS_LOG_LOGIC("Hello parameters mismatch with router " << ospfHeader.GetRouterId());
+        return;
+    }
+
+    int state = m_neighbor_table.get_State(ospfHeader.GetRouterId(), incomingIf);
+    if (state == States::DOWN){
+        HandleDownResponse(source, ospfHeader, helloHeader, incomingIf);
+    }else if (state == States::INIT){
+        HandleInitResponse(source, ospfHeader, helloHeader, incomingIf);
     }else{
-        bool check = false;
-        for (const auto& row : neighbors){
-            for (const auto& neighborItems : row){
-                if (neighborItems.router_id == m_routerId){
-                    check = true;
-                }
-            }
-        }
-        if (helloHeader.getAreaId() != m_areaId){
-            check = false;
-        }
-        if (check){
-            bool neighbor_exist = true;
-            OspfNeighborTable::neighborList m_current_neighbors = m_neighbor_table.getCurrentNeighbors();
-            if (m_current_neighbors.empty()){
-                neighbor_exist = false;
-            }else{
-                //check routers own neighbor table to see if entry for neighbor exists
-                bool iterator_check = false;
-                for (const auto& row : m_current_neighbors){
-                    for (const auto& neighborItems : row){
-                        if (neighborItems.router_id == helloHeader.getRouterId()){
-                            iterator_check = true;
-                        }
-                    }
-                }
-                if (iterator_check){
-                    neighbor_exist = true;
-                }else{
-                    neighbor_exist = false;
-                }
-            }
-            if (neighbor_exist) {
-                //check if state is already TWO_WAY if so needs to proceed to Exchange State else send TWO_WAY packet
-                int state = m_neighbor_table.get_State(m_routerId);
-                if (state == States::TWO_WAY){
-                    //Start Exchange state....send DBD packets
-                }else{
-                    m_neighbor_table.set_State(States::TWO_WAY, m_routerId);
-                    SendTwoWayPacket(interface->GetAddress(incomingIf), header.GetSource());
-                }
-            }else{
-                //should send DOWN state packet as entry should already be recorded
-                SendDownPacket(interface->GetAddress(incomingIf));
-            }
-        }else{
-            SendDownPacket(interface->GetAddress(incomingIf));
-        }
+        HandleTwoWayResponse(source, ospfHeader, helloHeader, incomingIf);
+    }
+
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(ospfHeader.GetRouterId(), incomingIf);
+    if (neighbor != nullptr){
+        neighbor->demandCircuit = IsDemandCircuit(incomingIf) &&
+                                  (helloHeader.getOptions() & OspfLsa::DC_OPTION);
     }
 }
 
+void OspfL4Protocol::HandleDownResponse(const Address& source, OspfHeader ospfHeader, const OspfHello& helloHeader, uint32_t incomingIf){
+    uint32_t r_id = ospfHeader.GetRouterId();
+    if (m_version == 3){
+        m_neighbor_table.addNeighbors(Ipv4Address(), Ipv4Mask(), incomingIf, States::DOWN, r_id);
+        OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, incomingIf);
+        neighbor->ip6Add = Ipv6Address::ConvertFrom(source);
+        neighbor->interfaceId = helloHeader.getInterfaceId();
+    }else{
+        m_neighbor_table.addNeighbors(Ipv4Address::ConvertFrom(source), helloHeader.getMask(), incomingIf, States::DOWN, r_id);
+    }
+    SetNeighborState(*m_neighbor_table.findNeighbor(r_id, incomingIf), States::INIT);
+    InvalidateHelloPacket(incomingIf);
+    RefreshInactivityTimer(r_id, incomingIf);
+
+    if (helloHeader.hasNeighbor(m_routerId)){
+        // The neighbor has already heard us, go straight to 2-Way
+        HandleInitResponse(source, ospfHeader, helloHeader, incomingIf);
+    }else{
+        SendHelloTo(incomingIf, source);
+    }
+}
+
+void OspfL4Protocol::HandleInitResponse(const Address& source, OspfHeader ospfHeader, const OspfHello& helloHeader, uint32_t incomingIf){
+    uint32_t r_id = ospfHeader.GetRouterId();
+    RefreshInactivityTimer(r_id, incomingIf);
+
+    if (helloHeader.hasNeighbor(m_routerId)){
+        SetNeighborState(*m_neighbor_table.findNeighbor(r_id, incomingIf), States::TWO_WAY);
+        SendHelloTo(incomingIf, source);
+        // Every 2-Way neighbor becomes adjacent
+        StartExchange(*m_neighbor_table.findNeighbor(r_id, incomingIf));
+    }
+}
+
+void OspfL4Protocol::HandleTwoWayResponse(const Address& source, OspfHeader ospfHeader, const OspfHello& helloHeader, uint32_t incomingIf){
+    uint32_t r_id = ospfHeader.GetRouterId();
+    RefreshInactivityTimer(r_id, incomingIf);
+
+    if (!helloHeader.hasNeighbor(m_routerId)){
+        // 1-WayReceived: the neighbor has lost us (e.g. it restarted)
+        NS_LOG_LOGIC("Neighbor " << r_id << " no longer lists us, back to Init");
+        ResetAdjacency(*m_neighbor_table.findNeighbor(r_id, incomingIf), States::INIT);
+        SendHelloTo(incomingIf, source);
+    }
+}
+
+void OspfL4Protocol::RefreshInactivityTimer(uint32_t r_id, uint32_t interface){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, interface);
+    if (neighbor != nullptr){
+        neighbor->inactivityTimer.Cancel();
+        if (neighbor->state == States::FULL && neighbor->demandCircuit){
+            // Hellos stop once the demand circuit is up (RFC 1793 3.2.1)
+            return;
+        }
+        neighbor->inactivityTimer = Simulator::Schedule(m_routerDeadInterval,
+                                                        &OspfL4Protocol::HandleNeighborDead,
+                                                        this,
+                                                        r_id,
+                                                        interface);
+    }
+}
+
+void OspfL4Protocol::HandleNeighborDead(uint32_t r_id, uint32_t interface){
+    NS_LOG_FUNCTION(this << r_id << interface);
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, interface);
+    if (neighbor != nullptr){
+        ResetAdjacency(*neighbor, States::DOWN);
+    }
+    m_neighbor_table.delete_neighbor(r_id, interface);
+    InvalidateHelloPacket(interface);
+}
+
+
+void OspfL4Protocol::SetInterfaceMetrics(const std::map<uint32_t, uint8_t>& metrics){
+    m_interfaceMetrics = metrics;
+}
+
+uint16_t OspfL4Protocol::GetInterfaceMetric(uint32_t interface) const{
+    auto it = m_interfaceMetrics.find(interface);
+    if (it != m_interfaceMetrics.end()){
+        return it->second;
+    }
+    return (m_version == 3) ? m_ipv6->GetMetric(interface) : m_ipv4->GetMetric(interface);
+}
+
+void OspfL4Protocol::SetLsdbChangedCallback(Callback<void> cb){
+    m_lsdbChanged = cb;
+}
+
+const OspfLsdb& OspfL4Protocol::GetLsdb() const{
+    return m_lsdb;
+}
+
+uint32_t OspfL4Protocol::GetRouterId() const{
+    return m_routerId;
+}
+
+OspfStats OspfL4Protocol::GetStats() const{
+    OspfStats stats = m_stats;
+    stats.lsdbSize = m_lsdb.GetSize();
+    return stats;
+}
+
+Ipv4Address OspfL4Protocol::GetNeighborAddress(uint32_t r_id, uint32_t interface){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, interface);
+    if (neighbor == nullptr || neighbor->state != States::FULL){
+        return Ipv4Address::GetZero();
+    }
+    return neighbor->ipAdd;
+}
+
+Ipv6Address OspfL4Protocol::GetNeighborAddress6(uint32_t r_id, uint32_t interface){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, interface);
+    if (neighbor == nullptr || neighbor->state != States::FULL){
+        return Ipv6Address::GetAny();
+    }
+    return neighbor->ip6Add;
+}
+
+void OspfL4Protocol::NotifyInterfaceChange(uint32_t interface){
+    NS_LOG_FUNCTION(this << interface);
+    if (!m_running){
+        // Not started yet, the first Router-LSA will see the change
+        return;
+    }
+    if (!IsInterfaceUp(interface)){
+        for (uint32_t r_id : m_neighbor_table.getNeighborIds(interface)){
+            HandleNeighborDead(r_id, interface);
+        }
+    }
+    InvalidateHelloPacket(interface);
+    ResumeHellos();
+    ScheduleRouterLsa();
+}
+
+void OspfL4Protocol::ResumeHellos(){
+    if (m_running && !m_helloEvent.IsRunning()){
+        m_helloEvent = Simulator::ScheduleNow(&OspfL4Protocol::SendHelloPackets, this);
+    }
+}
+
+void OspfL4Protocol::SetMaxMetric(bool maxMetric){
+    NS_LOG_FUNCTION(this << maxMetric);
+    if (m_maxMetric == maxMetric){
+        return;
+    }
+    m_maxMetric = maxMetric;
+    if (m_running){
+        ScheduleRouterLsa();
+    }
+}
+
+bool OspfL4Protocol::IsMaxMetric() const{
+    return m_maxMetric;
+}
+
+bool OspfL4Protocol::IsFullyAdjacent() const{
+    const auto& neighbors = m_neighbor_table.getCurrentNeighbors();
+    return !neighbors.empty() &&
+           std::all_of(neighbors.begin(), neighbors.end(), [](const auto& neighbor) {
+               return neighbor.state == States::FULL;
+           });
+}
+
+void OspfL4Protocol::SendToNeighbor(const OspfNeighborTable::neighborItems& neighbor, Ptr<Packet> packet, int packetType){
+    if (m_version == 3){
+        Send(packet, GetLinkLocalAddress(neighbor.interface), neighbor.ip6Add, packetType, GetInterfaceRoute6(neighbor.interface));
+        return;
+    }
+    Ipv4InterfaceAddress address = GetInterfaceAddress(neighbor.interface, neighbor.ipAdd);
+    Send(packet, address.GetLocal(), neighbor.ipAdd, packetType, GetInterfaceRoute(neighbor.interface));
+}
+
+/******************************************************************************
+ *
+ * Database exchange
+ *
+ *****************************************************************************/
+
+void OspfL4Protocol::StartExchange(OspfNeighborTable::neighborItems& neighbor){
+    NS_LOG_FUNCTION(this << neighbor.router_id << neighbor.interface);
+    ResetAdjacency(neighbor, States::EXSTART);
+
+    // We claim to be the master until the neighbor's router ID says otherwise
+    neighbor.master = true;
+    neighbor.ddSequence = static_cast<uint32_t>(Simulator::Now().GetMicroSeconds()) + m_routerId;
+
+    OspfDbd dbd;
+    dbd.SetVersion(m_version);
+    dbd.SetMtu(GetInterfaceMtu(neighbor.interface));
+    dbd.SetFlags(OspfDbd::I | OspfDbd::M | OspfDbd::MS);
+    dbd.SetSequence(neighbor.ddSequence);
+    neighbor.lastDbd = Create<Packet>();
+    neighbor.lastDbd->AddHeader(dbd);
+    neighbor.lastDbdFlags = dbd.GetFlags();
+    SendDbd(neighbor);
+}
+
+void OspfL4Protocol::SetNeighborState(OspfNeighborTable::neighborItems& neighbor, int state){
+    if (neighbor.state != state){
+        int oldState = neighbor.state;
+        neighbor.state = state;
+        m_stats.neighborTransitions++;
+        m_neighborStateTrace(neighbor.router_id, neighbor.interface, oldState, state);
+        if (oldState == States::FULL && neighbor.demandCircuit){
+            // Hellos may have stopped on the link
+            ResumeHellos();
+        }
+    }
+}
+
+void OspfL4Protocol::ResetAdjacency(OspfNeighborTable::neighborItems& neighbor, int state){
+    bool wasFull = (neighbor.state == States::FULL);
+    SetNeighborState(neighbor, state);
+    neighbor.master = false;
+    neighbor.moreToReceive = true;
+    neighbor.summaryList.clear();
+    neighbor.summaryNext = 0;
+    neighbor.lastDbd = nullptr;
+    neighbor.lastDbdFlags = 0;
+    neighbor.requestList.clear();
+    neighbor.lastRequested.clear();
+    neighbor.retransmissionList.clear();
+    neighbor.pendingUpdates.clear();
+    neighbor.ddRetransmit.Cancel();
+    neighbor.lsrRetransmit.Cancel();
+    neighbor.lsuRetransmit.Cancel();
+    neighbor.lsuFlush.Cancel();
+
+    if (wasFull && state != States::FULL){
+        // The adjacency leaves our Router-LSA
+        ScheduleRouterLsa();
+    }
+}
+
+void OspfL4Protocol::HandleDbd(Ptr<Packet> packet, OspfHeader ospfHeader, uint32_t incomingIf){
+    uint32_t r_id = ospfHeader.GetRouterId();
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, incomingIf);
+    if (neighbor == nullptr){
+        return;
+    }
+
+    OspfDbd dbd;
+    dbd.SetVersion(m_version);
+    packet->RemoveHeader(dbd);
+
+    if (neighbor->state == States::INIT){
+        // The neighbor has heard us, this is 2-WayReceived (RFC 2328 10.6)
+        SetNeighborState(*neighbor, States::TWO_WAY);
+        StartExchange(*neighbor);
+    }
+
+    switch (neighbor->state)
+    {
+    case States::EXSTART:
+        HandleExStartDbd(*neighbor, dbd);
+        break;
+    case States::EXCHANGE:
+        if (!neighbor->master && dbd.GetSequence() == neighbor->ddSequence){
+            // Duplicate from the master, our answer was lost
+            SendDbd(*neighbor);
+        }else if (neighbor->master && dbd.GetSequence() != neighbor->ddSequence){
+            NS_LOG_LOGIC("Old DBD from slave " << r_id << " ignored");
+        }else if (dbd.HasFlag(OspfDbd::I) || dbd.HasFlag(OspfDbd::MS) == neighbor->master ||
+                  (!neighbor->master && dbd.GetSequence() != neighbor->ddSequence + 1)){
+            NS_LOG_LOGIC("SeqNumberMismatch with " << r_id);
+            StartExchange(*neighbor);
+            HandleExStartDbd(*neighbor, dbd);
+        }else if (neighbor->master){
+            ProcessDbd(*neighbor, dbd);
+            MasterNextDbd(*neighbor);
+        }else{
+            neighbor->ddSequence = dbd.GetSequence();
+            ProcessDbd(*neighbor, dbd);
+            SendNextDbd(*neighbor);
+            if (!neighbor->moreToReceive && !(neighbor->lastDbdFlags & OspfDbd::M)){
+                ExchangeDone(*neighbor);
+            }
+        }
+        break;
+    case States::LOADING:
+    case States::FULL:
+        if (dbd.HasFlag(OspfDbd::I)){
+            // The neighbor restarted the exchange
+            StartExchange(*neighbor);
+            HandleExStartDbd(*neighbor, dbd);
+        }else if (!neighbor->master && dbd.GetSequence() == neighbor->ddSequence){
+            SendDbd(*neighbor);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void OspfL4Protocol::HandleExStartDbd(OspfNeighborTable::neighborItems& neighbor, const OspfDbd& dbd){
+    bool slave = dbd.HasFlag(OspfDbd::I) && dbd.HasFlag(OspfDbd::M) && dbd.HasFlag(OspfDbd::MS) &&
+                 dbd.GetLsaHeaders().empty() && neighbor.router_id > m_routerId;
+    bool master = !dbd.HasFlag(OspfDbd::I) && !dbd.HasFlag(OspfDbd::MS) &&
+                  dbd.GetSequence() == neighbor.ddSequence && neighbor.router_id < m_routerId;
+    if (!slave && !master){
+        return;
+    }
+
+    NS_LOG_LOGIC("Exchange with " << neighbor.router_id << (master ? " as master" : " as slave"));
+    SetNeighborState(neighbor, States::EXCHANGE);
+    neighbor.master = master;
+    neighbor.summaryList.clear();
+    neighbor.summaryNext = 0;
+    for (const auto& item : m_lsdb.GetEntries()){
+        // MaxAge LSAs are being flushed, they are not described
+        if (m_lsdb.GetAge(item.second) < OspfLsa::MAX_AGE){
+            neighbor.summaryList.push_back(item.second.lsa->GetHeader());
+            neighbor.summaryList.back().age = m_lsdb.GetAge(item.second);
+        }
+    }
+
+    if (slave){
+        neighbor.ddSequence = dbd.GetSequence();
+        SendNextDbd(neighbor);
+    }else{
+        ProcessDbd(neighbor, dbd);
+        MasterNextDbd(neighbor);
+    }
+}
+
+void OspfL4Protocol::ProcessDbd(OspfNeighborTable::neighborItems& neighbor, const OspfDbd& dbd){
+    neighbor.moreToReceive = dbd.HasFlag(OspfDbd::M);
+    for (const auto& header : dbd.GetLsaHeaders()){
+        if (!IsSupportedLsType(header.type)){
+            continue;
+        }
+        OspfLsaKey key = header.GetKey();
+        if (!m_lsdb.Get(key) || header.IsMoreRecentThan(m_lsdb.GetCurrentHeader(key))){
+            neighbor.requestList[key] = header;
+        }
+    }
+    // Requests can be sent while the exchange goes on
+    if (!neighbor.requestList.empty() && neighbor.lastRequested.empty()){
+        SendLsRequest(neighbor);
+    }
+}
+
+void OspfL4Protocol::SendNextDbd(OspfNeighborTable::neighborItems& neighbor){
+    OspfDbd dbd;
+    dbd.SetVersion(m_version);
+    dbd.SetMtu(GetInterfaceMtu(neighbor.interface));
+    uint32_t capacity = (GetInterfaceMtu(neighbor.interface) - GetPacketOverhead() - dbd.GetSerializedSize()) / OspfLsaHeader::SIZE;
+
+    dbd.SetSequence(neighbor.ddSequence);
+    uint32_t added = 0;
+    while (neighbor.summaryNext < neighbor.summaryList.size() && added < capacity){
+        dbd.AddLsaHeader(neighbor.summaryList[neighbor.summaryNext++]);
+        added++;
+    }
+    uint8_t flags = neighbor.master ? OspfDbd::MS : 0;
+    if (neighbor.summaryNext < neighbor.summaryList.size()){
+        flags |= OspfDbd::M;
+    }
+    dbd.SetFlags(flags);
+
+    neighbor.lastDbd = Create<Packet>();
+    neighbor.lastDbd->AddHeader(dbd);
+    neighbor.lastDbdFlags = flags;
+    SendDbd(neighbor);
+}
+
+void OspfL4Protocol::MasterNextDbd(OspfNeighborTable::neighborItems& neighbor){
+    if (!(neighbor.lastDbdFlags & OspfDbd::M) && !neighbor.moreToReceive){
+        ExchangeDone(neighbor);
+    }else{
+        neighbor.ddSequence++;
+        SendNextDbd(neighbor);
+    }
+}
+
+void OspfL4Protocol::SendDbd(OspfNeighborTable::neighborItems& neighbor){
+    neighbor.ddRetransmit.Cancel();
+    SendToNeighbor(neighbor, neighbor.lastDbd->Copy(), PacketType::DBD);
+    if (neighbor.master){
+        // Only the master retransmits, the slave answers duplicates
+        neighbor.ddRetransmit = Simulator::Schedule(m_rxmtInterval,
+                                                    &OspfL4Protocol::RetransmitDbd,
+                                                    this,
+                                                    neighbor.router_id,
+                                                    neighbor.interface);
+    }
+}
+
+void OspfL4Protocol::RetransmitDbd(uint32_t r_id, uint32_t interface){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, interface);
+    if (neighbor != nullptr && neighbor->master &&
+        (neighbor->state == States::EXSTART || neighbor->state == States::EXCHANGE)){
+        NS_LOG_LOGIC("Retransmitting DBD to " << r_id);
+        m_stats.dbdRetransmissions++;
+        SendDbd(*neighbor);
+    }
+}
+
+void OspfL4Protocol::ExchangeDone(OspfNeighborTable::neighborItems& neighbor){
+    neighbor.ddRetransmit.Cancel();
+    neighbor.summaryList.clear();
+    if (neighbor.requestList.empty()){
+        AdjacencyFull(neighbor);
+    }else{
+        SetNeighborState(neighbor, States::LOADING);
+        if (neighbor.lastRequested.empty()){
+            SendLsRequest(neighbor);
+        }
+    }
+}
+
+void OspfL4Protocol::AdjacencyFull(OspfNeighborTable::neighborItems& neighbor){
+    NS_LOG_LOGIC("Adjacency with " << neighbor.router_id << " on interface " << neighbor.interface
+                                   << " is full");
+    SetNeighborState(neighbor, States::FULL);
+    neighbor.lastRequested.clear();
+    neighbor.lsrRetransmit.Cancel();
+    if (neighbor.demandCircuit){
+        neighbor.inactivityTimer.Cancel();
+    }
+    ScheduleRouterLsa();
+    if (m_restarting){
+        CheckGracefulRestartDone();
+    }
+}
+
+void OspfL4Protocol::SendLsRequest(OspfNeighborTable::neighborItems& neighbor){
+    uint32_t capacity = (GetInterfaceMtu(neighbor.interface) - GetPacketOverhead()) / OspfLsRequest::ENTRY_SIZE;
+
+    OspfLsRequest request;
+    neighbor.lastRequested.clear();
+    for (const auto& item : neighbor.requestList){
+        if (neighbor.lastRequested.size() >= capacity){
+            break;
+        }
+        request.AddRequest(item.first);
+        neighbor.lastRequested.push_back(item.first);
+    }
+
+    Ptr<Packet> p = Create<Packet>();
+    p->AddHeader(request);
+    SendToNeighbor(neighbor, p, PacketType::LSR);
+
+    neighbor.lsrRetransmit.Cancel();
+    neighbor.lsrRetransmit = Simulator::Schedule(m_rxmtInterval,
+                                                 &OspfL4Protocol::RetransmitLsRequest,
+                                                 this,
+                                                 neighbor.router_id,
+                                                 neighbor.interface);
+}
+
+void OspfL4Protocol::RetransmitLsRequest(uint32_t r_id, uint32_t interface){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, interface);
+    if (neighbor != nullptr && !neighbor->requestList.empty() &&
+        (neighbor->state == States::EXCHANGE || neighbor->state == States::LOADING)){
+        NS_LOG_LOGIC("Retransmitting LS Request to " << r_id);
+        m_stats.lsrRetransmissions++;
+        SendLsRequest(*neighbor);
+    }
+}
+
+void OspfL4Protocol::HandleLsRequest(Ptr<Packet> packet, OspfHeader ospfHeader, uint32_t incomingIf){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(ospfHeader.GetRouterId(), incomingIf);
+    if (neighbor == nullptr || neighbor->state < States::EXCHANGE){
+        return;
+    }
+
+    OspfLsRequest request;
+    packet->RemoveHeader(request);
+
+    std::vector<Ptr<OspfLsa>> lsas;
+    for (const auto& key : request.GetRequests()){
+        Ptr<OspfLsa> lsa = m_lsdb.Get(key);
+        if (lsa){
+            lsas.push_back(lsa);
+        }else{
+            NS_LOG_LOGIC("BadLSReq from " << ospfHeader.GetRouterId());
+        }
+    }
+    if (!lsas.empty()){
+        SendLsUpdates(*neighbor, lsas);
+    }
+}
+
+/******************************************************************************
+ *
+ * Flooding
+ *
+ *****************************************************************************/
+
+void OspfL4Protocol::HandleLsUpdate(Ptr<Packet> packet, OspfHeader ospfHeader, uint32_t incomingIf){
+    uint32_t r_id = ospfHeader.GetRouterId();
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, incomingIf);
+    if (neighbor == nullptr || neighbor->state < States::EXCHANGE){
+        return;
+    }
+
+    OspfLsUpdate update;
+    update.SetVersion(m_version);
+    packet->RemoveHeader(update);
+
+    OspfLsAck ack;
+    ack.SetVersion(m_version);
+    std::vector<Ptr<OspfLsa>> moreRecent;   // our copies, sent back to the neighbor
+    bool changed = false;
+    bool reoriginate = false;
+    for (const auto& lsa : update.GetLsas()){
+        const OspfLsaHeader& received = lsa->GetHeader();
+        if (IsGraceLsa(received)){
+            // Link-local: acknowledged but neither installed nor flooded
+            ack.AddLsaHeader(received);
+            HandleGraceLsa(*neighbor, lsa);
+            continue;
+        }
+        if (!IsSupportedLsType(received.type)){
+            NS_LOG_LOGIC("Unsupported LS type " << int(received.type));
+            continue;
+        }
+        if (Node::ChecksumEnabled() && !lsa->IsChecksumOk()){
+            NS_LOG_LOGIC("Bad LS checksum, dropping " << received);
+            continue;
+        }
+
+        OspfLsaKey key = received.GetKey();
+        Ptr<OspfLsa> current = m_lsdb.Get(key);
+        if (!current && received.GetAge() >= OspfLsa::MAX_AGE && !IsExchanging()){
+            ack.AddLsaHeader(received);
+            continue;
+        }
+
+        OspfLsaHeader currentHeader;
+        if (current){
+            currentHeader = m_lsdb.GetCurrentHeader(key);
+        }
+
+        if (!current || received.IsMoreRecentThan(currentHeader)){
+            ack.AddLsaHeader(received);
+            auto request = neighbor->requestList.find(key);
+            if (request != neighbor->requestList.end() && !request->second.IsMoreRecentThan(received)){
+                neighbor->requestList.erase(request);
+            }
+            bool refresh = current && current->HasSameContent(*lsa);
+            changed |= InstallLsa(lsa);
+            if (received.advertisingRouter == m_routerId){
+                // An old instance of our own LSA, e.g. from before a restart:
+                // take over its sequence number (RFC 2328 13.4). During a
+                // graceful restart it stays as it is until we leave it.
+                reoriginate = !m_restarting;
+                if (m_restarting){
+                    // Not flooded, but no other neighbor needs to send it
+                    for (auto& other : m_neighbor_table.getCurrentNeighbors()){
+                        auto pending = other.requestList.find(key);
+                        if (pending == other.requestList.end() ||
+                            pending->second.IsMoreRecentThan(received)){
+                            continue;
+                        }
+                        other.requestList.erase(pending);
+                        if (&other != neighbor && other.state == States::LOADING &&
+                            other.requestList.empty()){
+                            AdjacencyFull(other);
+                        }
+                    }
+                }
+                continue;
+            }
+            FloodLsa(lsa, r_id, incomingIf, refresh);
+        }else if (received.IsSameInstance(currentHeader)){
+            auto pending = neighbor->retransmissionList.find(key);
+            if (pending != neighbor->retransmissionList.end()){
+                // Implied acknowledgment
+                neighbor->retransmissionList.erase(pending);
+            }else{
+                ack.AddLsaHeader(received);
+            }
+        }else if (currentHeader.GetAge() < OspfLsa::MAX_AGE ||
+                  currentHeader.sequence != OspfLsa::MAX_SEQUENCE_NUMBER){
+            moreRecent.push_back(current);
+        }
+    }
+
+    if (!ack.GetLsaHeaders().empty()){
+        Ptr<Packet> p = Create<Packet>();
+        p->AddHeader(ack);
+        SendToNeighbor(*neighbor, p, PacketType::LSAck);
+    }
+    if (!moreRecent.empty()){
+        SendLsUpdates(*neighbor, moreRecent);
+    }
+
+    if (neighbor->requestList.empty()){
+        neighbor->lastRequested.clear();
+        neighbor->lsrRetransmit.Cancel();
+        if (neighbor->state == States::LOADING){
+            AdjacencyFull(*neighbor);
+        }
+    }else if (!neighbor->lastRequested.empty()){
+        bool answered = true;
+        for (const auto& key : neighbor->lastRequested){
+            answered = answered && neighbor->requestList.find(key) == neighbor->requestList.end();
+        }
+        if (answered){
+            SendLsRequest(*neighbor);
+        }
+    }
+
+    if (reoriginate){
+        OriginateRouterLsa(true);
+    }
+    if (m_restarting){
+        CheckGracefulRestartDone();
+    }
+    if (changed){
+        NotifyLsdbChanged();
+    }
+}
+
+void OspfL4Protocol::HandleLsAck(Ptr<Packet> packet, OspfHeader ospfHeader, uint32_t incomingIf){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(ospfHeader.GetRouterId(), incomingIf);
+    if (neighbor == nullptr || neighbor->state < States::EXCHANGE){
+        return;
+    }
+
+    OspfLsAck ack;
+    ack.SetVersion(m_version);
+    packet->RemoveHeader(ack);
+
+    for (const auto& header : ack.GetLsaHeaders()){
+        auto pending = neighbor->retransmissionList.find(header.GetKey());
+        if (pending != neighbor->retransmissionList.end() &&
+            pending->second->GetHeader().IsSameInstance(header)){
+            neighbor->retransmissionList.erase(pending);
+        }
+    }
+}
+
+bool OspfL4Protocol::InstallLsa(Ptr<OspfLsa> lsa){
+    NS_LOG_LOGIC("Installing " << lsa->GetHeader());
+    OspfLsaKey key = lsa->GetKey();
+    Ptr<OspfLsa> previous = m_lsdb.Install(lsa);
+    m_stats.lsaInstalls++;
+    m_lsaInstallTrace(lsa);
+
+    // The previous instance no longer needs to be acknowledged
+    for (auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+        neighbor.retransmissionList.erase(key);
+    }
+    return !previous || !previous->HasSameContent(*lsa);
+}
+
+void OspfL4Protocol::FloodLsa(Ptr<OspfLsa> lsa, uint32_t fromRouter, uint32_t fromInterface, bool refresh){
+    OspfLsaKey key = lsa->GetKey();
+    const OspfLsaHeader& header = lsa->GetHeader();
+
+    for (auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+        if (neighbor.state < States::EXCHANGE){
+            continue;
+        }
+
+        auto request = neighbor.requestList.find(key);
+        if (request != neighbor.requestList.end()){
+            if (request->second.IsMoreRecentThan(header)){
+                continue;
+            }
+            bool same = request->second.IsSameInstance(header);
+            neighbor.requestList.erase(request);
+            if (neighbor.state == States::LOADING && neighbor.requestList.empty()){
+                AdjacencyFull(neighbor);
+            }
+            if (same){
+                continue;
+            }
+        }
+
+        if (neighbor.router_id == fromRouter && neighbor.interface == fromInterface){
+            continue;
+        }
+        if (refresh && neighbor.demandCircuit && neighbor.state == States::FULL){
+            continue;
+        }
+
+        neighbor.retransmissionList[key] = lsa;
+        QueueLsUpdate(neighbor, lsa);
+    }
+}
+
+void OspfL4Protocol::QueueLsUpdate(OspfNeighborTable::neighborItems& neighbor, Ptr<OspfLsa> lsa){
+    neighbor.pendingUpdates.push_back(lsa);
+    if (!neighbor.lsuFlush.IsRunning()){
+        neighbor.lsuFlush = Simulator::ScheduleNow(&OspfL4Protocol::FlushLsUpdates,
+                                                   this,
+                                                   neighbor.router_id,
+                                                   neighbor.interface);
+    }
+    if (!neighbor.lsuRetransmit.IsRunning()){
+        neighbor.lsuRetransmit = Simulator::Schedule(m_rxmtInterval,
+                                                     &OspfL4Protocol::RetransmitLsUpdates,
+                                                     this,
+                                                     neighbor.router_id,
+                                                     neighbor.interface);
+    }
+}
+
+void OspfL4Protocol::FlushLsUpdates(uint32_t r_id, uint32_t interface){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, interface);
+    if (neighbor == nullptr){
+        return;
+    }
+
+    // Skip LSAs acknowledged or superseded since they were queued
+    std::vector<Ptr<OspfLsa>> lsas;
+    for (const auto& lsa : neighbor->pendingUpdates){
+        auto pending = neighbor->retransmissionList.find(lsa->GetKey());
+        if (pending != neighbor->retransmissionList.end() && pending->second == lsa){
+            lsas.push_back(lsa);
+        }
+    }
+    neighbor->pendingUpdates.clear();
+    if (!lsas.empty()){
+        SendLsUpdates(*neighbor, lsas);
+    }
+}
+
+void OspfL4Protocol::RetransmitLsUpdates(uint32_t r_id, uint32_t interface){
+    OspfNeighborTable::neighborItems* neighbor = m_neighbor_table.findNeighbor(r_id, interface);
+    if (neighbor == nullptr || neighbor->state < States::EXCHANGE ||
+        neighbor->retransmissionList.empty()){
+        return;
+    }
+
+    NS_LOG_LOGIC("Retransmitting " << neighbor->retransmissionList.size() << " LSAs to " << r_id);
+    std::vector<Ptr<OspfLsa>> lsas;
+    lsas.reserve(neighbor->retransmissionList.size());
+    for (const auto& item : neighbor->retransmissionList){
+        lsas.push_back(item.second);
+    }
+    m_stats.lsaRetransmissions += lsas.size();
+    SendLsUpdates(*neighbor, lsas);
+    neighbor->lsuRetransmit = Simulator::Schedule(m_rxmtInterval,
+                                                  &OspfL4Protocol::RetransmitLsUpdates,
+                                                  this,
+                                                  r_id,
+                                                  interface);
+}
+
+void OspfL4Protocol::SendLsUpdates(const OspfNeighborTable::neighborItems& neighbor, const std::vector<Ptr<OspfLsa>>& lsas){
+    uint32_t capacity = GetInterfaceMtu(neighbor.interface) - GetPacketOverhead();
+
+    OspfLsUpdate update;
+    update.SetVersion(m_version);
+    for (const auto& lsa : lsas){
+        // An LSA larger than the MTU goes alone and is fragmented by IP
+        if (update.GetLsaNumber() > 0 &&
+            update.GetSerializedSize() + lsa->GetSerializedSize() > capacity){
+            Ptr<Packet> p = Create<Packet>();
+            p->AddHeader(update);
+            SendToNeighbor(neighbor, p, PacketType::LSU);
+            update = OspfLsUpdate();
+            update.SetVersion(m_version);
+        }
+        update.AddLsa(lsa, GetTransmitAge(lsa, neighbor.demandCircuit));
+    }
+    if (update.GetLsaNumber() > 0){
+        Ptr<Packet> p = Create<Packet>();
+        p->AddHeader(update);
+        SendToNeighbor(neighbor, p, PacketType::LSU);
+    }
+}
+
+uint16_t OspfL4Protocol::GetTransmitAge(Ptr<OspfLsa> lsa, bool demandCircuit) const{
+    OspfLsaKey key = lsa->GetKey();
+    const OspfLsaHeader& header = lsa->GetHeader();
+    uint16_t age = (m_lsdb.Get(key) == lsa) ? m_lsdb.GetAge(key) : header.GetAge();
+    age = std::min<uint16_t>(age + 1, OspfLsa::MAX_AGE);
+    // Flushed LSAs are always aged
+    if (age < OspfLsa::MAX_AGE && (demandCircuit || header.IsDoNotAge())){
+        age |= OspfLsa::DO_NOT_AGE;
+    }
+    return age;
+}
+
+bool OspfL4Protocol::IsExchanging() const{
+    for (const auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+        if (neighbor.state == States::EXCHANGE || neighbor.state == States::LOADING){
+            return true;
+        }
+    }
+    return false;
+}
+
+/******************************************************************************
+ *
+ * LSA origination and aging
+ *
+ *****************************************************************************/
+
+void OspfL4Protocol::ScheduleRouterLsa(){
+    if (m_routerLsaEvent.IsRunning() || (!m_ipv4 && !m_ipv6)){
+        return;
+    }
+    Time delay = Seconds(0);
+    if (m_routerLsaOriginated && m_lastRouterLsa + m_minLsInterval > Simulator::Now()){
+        delay = m_lastRouterLsa + m_minLsInterval - Simulator::Now();
+    }
+    m_routerLsaEvent = Simulator::Schedule(delay, &OspfL4Protocol::OriginateRouterLsa, this, false);
+}
+
+void OspfL4Protocol::OriginateRouterLsa(bool force){
+    NS_LOG_FUNCTION(this << force);
+    if (m_restarting){
+        NS_LOG_LOGIC("Graceful restart, keeping our previous Router-LSA");
+        return;
+    }
+
+    Ptr<OspfLsa> lsa = Create<OspfLsa>(m_version);
+    OspfLsaHeader& header = lsa->GetHeader();
+    header.linkStateId = (m_version == 3) ? 0 : m_routerId;
+    header.advertisingRouter = m_routerId;
+
+    // OSPFv3 moves the prefixes to an Intra-Area-Prefix-LSA referencing the
+    // Router-LSA (RFC 5340 4.4.3.9)
+    Ptr<OspfLsa> prefixLsa;
+    if (m_version == 3){
+        prefixLsa = Create<OspfLsa>(m_version);
+        prefixLsa->GetHeader().type = OspfLsa::V3_INTRA_AREA_PREFIX_LSA;
+        prefixLsa->GetHeader().linkStateId = 0;
+        prefixLsa->GetHeader().advertisingRouter = m_routerId;
+        prefixLsa->SetReferencedLsa(lsa->GetKey());
+    }
+
+    for (uint32_t i = 0; i < GetNInterfaces(); i++){
+        if (!IsOspfInterface(i)){
+            bool loopback = DynamicCast<LoopbackNetDevice>(GetInterfaceDevice(i)) &&
+                            IsInterfaceUp(i) &&
+                            m_interfaceExclusions.find(i) == m_interfaceExclusions.end();
+            if (!loopback){
+                continue;
+            }
+            // Addresses given to the loopback, e.g. router addresses, are
+            // advertised as host routes (RFC 2328 9.1, RFC 5340 4.4.3.9)
+            if (m_version == 3){
+                for (uint32_t j = 0; j < m_ipv6->GetNAddresses(i); j++){
+                    Ipv6InterfaceAddress address = m_ipv6->GetAddress(i, j);
+                    if (address.GetScope() == Ipv6InterfaceAddress::GLOBAL){
+                        prefixLsa->AddPrefix(address.GetAddress(), 128, 0);
+                    }
+                }
+                continue;
+            }
+            for (uint32_t j = 0; j < m_ipv4->GetNAddresses(i); j++){
+                Ipv4Address local = m_ipv4->GetAddress(i, j).GetLocal();
+                if (!local.IsLocalhost()){
+                    lsa->AddRouterLink(local.Get(), 0xffffffff, OspfLsa::STUB_NETWORK, 0);
+                }
+            }
+            continue;
+        }
+
+        uint16_t metric = GetInterfaceMetric(i);
+        // A stub router keeps transit traffic off its links (RFC 6987)
+        uint16_t linkMetric = m_maxMetric ? OspfLsa::MAX_LINK_METRIC : metric;
+        auto addLink = [&](uint32_t r_id, Ipv4Address ipAdd, uint32_t interfaceId) {
+            if (m_version == 3){
+                lsa->AddRouterLink(r_id, i, OspfLsa::POINT_TO_POINT, linkMetric, interfaceId);
+            }else{
+                Ipv4Address local = GetInterfaceAddress(i, ipAdd).GetLocal();
+                lsa->AddRouterLink(r_id, local.Get(), OspfLsa::POINT_TO_POINT, linkMetric);
+            }
+        };
+        // Neighbors we help through a restart stay adjacent (RFC 3623 3.2)
+        std::set<uint32_t> advertised;
+        for (const auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+            if (neighbor.interface != i ||
+                (neighbor.state != States::FULL &&
+                 m_helping.find({neighbor.router_id, i}) == m_helping.end())){
+                continue;
+            }
+            addLink(neighbor.router_id, neighbor.ipAdd, neighbor.interfaceId);
+            advertised.insert(neighbor.router_id);
+        }
+        for (const auto& helped : m_helping){
+            if (helped.first.second == i && advertised.find(helped.first.first) == advertised.end()){
+                addLink(helped.first.first, helped.second.ipAdd, helped.second.interfaceId);
+            }
+        }
+
+        if (m_prefixSuppressions.find(i) != m_prefixSuppressions.end()){
+            // Transit only, the link network is not advertised (RFC 6860)
+            continue;
+        }
+
+        if (m_version == 3){
+            for (uint32_t j = 0; j < m_ipv6->GetNAddresses(i); j++){
+                Ipv6InterfaceAddress address = m_ipv6->GetAddress(i, j);
+                if (address.GetScope() != Ipv6InterfaceAddress::GLOBAL){
+                    continue;
+                }
+                Ipv6Prefix prefix = address.GetPrefix();
+                prefixLsa->AddPrefix(address.GetAddress().CombinePrefix(prefix),
+                                     prefix.GetPrefixLength(),
+                                     metric);
+            }
+            continue;
+        }
+        for (uint32_t j = 0; j < m_ipv4->GetNAddresses(i); j++){
+            Ipv4InterfaceAddress address = m_ipv4->GetAddress(i, j);
+            if (address.GetScope() == Ipv4InterfaceAddress::HOST){
+                continue;
+            }
+            Ipv4Mask mask = address.GetMask();
+            lsa->AddRouterLink(address.GetLocal().CombineMask(mask).Get(),
+                               mask.Get(),
+                               OspfLsa::STUB_NETWORK,
+                               metric);
+        }
+    }
+
+    bool changed = false;
+    bool originated = OriginateLsa(lsa, force, changed);
+    if (prefixLsa){
+        originated = OriginateLsa(prefixLsa, force, changed) || originated;
+    }
+    if (m_version == 2){
+        originated = OriginateTeLsas(force, changed) || originated;
+    }
+    if (!originated){
+        NS_LOG_LOGIC("Router-LSA unchanged");
+        return;
+    }
+
+    m_lastRouterLsa = Simulator::Now();
+    m_routerLsaOriginated = true;
+    m_routerLsaEvent.Cancel();
+    m_refreshEvent.Cancel();
+    m_refreshEvent = Simulator::Schedule(m_lsRefreshTime, &OspfL4Protocol::RefreshRouterLsa, this);
+    if (changed){
+        NotifyLsdbChanged();
+    }
+}
+
+bool OspfL4Protocol::OriginateLsa(Ptr<OspfLsa> lsa, bool force, bool& changed){
+    OspfLsaHeader& header = lsa->GetHeader();
+    Ptr<OspfLsa> current = m_lsdb.Get(lsa->GetKey());
+    bool refresh = current && current->HasSameContent(*lsa);
+    if (refresh && !force){
+        return false;
+    }
+    header.sequence = current ? current->GetHeader().sequence + 1 : OspfLsa::INITIAL_SEQUENCE_NUMBER;
+    lsa->UpdateChecksum();
+
+    changed = InstallLsa(lsa) || changed;
+    FloodLsa(lsa, m_routerId, GetNInterfaces(), refresh);
+    return true;
+}
+
+bool OspfL4Protocol::OriginateTeLsas(bool force, bool& changed){
+    bool originated = false;
+    for (uint32_t i = 0; i < GetNInterfaces(); i++){
+        // One LSA per interface, the interface index as its instance
+        OspfLsaKey key{OspfLsa::AREA_LOCAL_OPAQUE_LSA,
+                       (uint32_t(OspfLsa::TE_OPAQUE_TYPE) << 24) | i,
+                       m_routerId};
+        auto te = m_teLinks.find(i);
+        const OspfNeighborTable::neighborItems* adjacent = nullptr;
+        if (te != m_teLinks.end() && IsOspfInterface(i)){
+            for (const auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+                if (neighbor.interface == i && neighbor.state == States::FULL){
+                    adjacent = &neighbor;
+                    break;
+                }
+            }
+        }
+
+        if (!adjacent){
+            // Withdraw the LSA of a link we no longer advertise
+            Ptr<OspfLsa> current = m_lsdb.Get(key);
+            if (current && m_lsdb.GetAge(key) < OspfLsa::MAX_AGE){
+                Ptr<OspfLsa> flush = Create<OspfLsa>(*current);
+                flush->GetHeader().age = OspfLsa::MAX_AGE;
+                changed = InstallLsa(flush) || changed;
+                FloodLsa(flush, m_routerId, GetNInterfaces());
+                originated = true;
+            }
+            continue;
+        }
+
+        OspfLsa::TeLink link = te->second;
+        link.linkId = adjacent->router_id;
+        link.localAddress = GetInterfaceAddress(i, adjacent->ipAdd).GetLocal().Get();
+        Ptr<OspfLsa> lsa = Create<OspfLsa>(m_version);
+        lsa->GetHeader().type = key.type;
+        lsa->GetHeader().linkStateId = key.linkStateId;
+        lsa->GetHeader().advertisingRouter = m_routerId;
+        lsa->AddTeLink(link);
+        originated = OriginateLsa(lsa, force, changed) || originated;
+    }
+    return originated;
+}
+
+void OspfL4Protocol::RefreshRouterLsa(){
+    OriginateRouterLsa(true);
+}
+
+void OspfL4Protocol::AgeLsdb(){
+    std::vector<Ptr<OspfLsa>> expired;
+    std::vector<OspfLsaKey> flushed;
+    for (const auto& item : m_lsdb.GetEntries()){
+        if (m_lsdb.GetAge(item.second) < OspfLsa::MAX_AGE){
+            continue;
+        }
+        if (item.second.lsa->GetHeader().GetAge() < OspfLsa::MAX_AGE){
+            expired.push_back(item.second.lsa);
+            continue;
+        }
+        // Flushed: remove once every neighbor has acknowledged it
+        bool acknowledged = !IsExchanging();
+        for (const auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+            acknowledged = acknowledged &&
+                           neighbor.retransmissionList.find(item.first) == neighbor.retransmissionList.end();
+        }
+        if (acknowledged){
+            flushed.push_back(item.first);
+        }
+    }
+
+    bool changed = false;
+    for (const auto& lsa : expired){
+        NS_LOG_LOGIC("Flushing " << lsa->GetHeader());
+        Ptr<OspfLsa> flush = Create<OspfLsa>(*lsa);
+        flush->GetHeader().age = OspfLsa::MAX_AGE;
+        changed |= InstallLsa(flush);
+        FloodLsa(flush, m_routerId, GetNInterfaces());
+    }
+    for (const auto& key : flushed){
+        m_lsdb.Remove(key);
+    }
+    if (changed){
+        NotifyLsdbChanged();
+    }
+
+    m_agingEvent = Simulator::Schedule(Seconds(OSPF_AGING_PERIOD), &OspfL4Protocol::AgeLsdb, this);
+}
+
+void OspfL4Protocol::NotifyLsdbChanged(){
+    if (!m_lsdbChanged.IsNull()){
+        m_lsdbChanged();
+    }
+}
+
+/******************************************************************************
+ *
+ * Graceful restart
+ *
+ *****************************************************************************/
+
+void OspfL4Protocol::Restart(Time downtime, bool graceful){
+    NS_LOG_FUNCTION(this << downtime << graceful);
+    if (!m_running){
+        NS_LOG_LOGIC("Not running, nothing to restart");
+        return;
+    }
+
+    if (graceful){
+        // The Grace-LSAs go out before anything is lost
+        for (const auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+            if (neighbor.state == States::FULL){
+                SendLsUpdates(neighbor, {CreateGraceLsa(neighbor, false)});
+            }
+        }
+    }
+
+    m_helloEvent.Cancel();
+    m_refreshEvent.Cancel();
+    m_agingEvent.Cancel();
+    m_graceEvent.Cancel();
+    for (auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+        neighbor.inactivityTimer.Cancel();
+        neighbor.state = States::DOWN;
+        ResetAdjacency(neighbor, States::DOWN);
+    }
+    m_neighbor_table.getCurrentNeighbors().clear();
+    for (auto& helped : m_helping){
+        helped.second.expiry.Cancel();
+    }
+    m_helping.clear();
+    m_routerLsaEvent.Cancel();
+    m_helloCache.clear();
+    m_lsdb.Clear();
+    m_running = false;
+    m_routerLsaOriginated = false;
+
+    m_restarting = graceful;
+    if (graceful){
+        m_graceEvent = Simulator::Schedule(m_gracePeriod, &OspfL4Protocol::ExitGracefulRestart, this);
+    }else{
+        // The routing table goes with the LSDB
+        NotifyLsdbChanged();
+    }
+    m_restartEvent.Cancel();
+    m_restartEvent = Simulator::Schedule(downtime, &OspfL4Protocol::startDownState, this);
+}
+
+bool OspfL4Protocol::IsRestarting() const{
+    return m_restarting;
+}
+
+uint32_t OspfL4Protocol::GetHelpedNeighborNumber() const{
+    return m_helping.size();
+}
+
+Ptr<OspfLsa> OspfL4Protocol::CreateGraceLsa(const OspfNeighborTable::neighborItems& neighbor, bool maxAge){
+    Ptr<OspfLsa> lsa = Create<OspfLsa>(m_version);
+    OspfLsaHeader& header = lsa->GetHeader();
+    header.advertisingRouter = m_routerId;
+    header.sequence = OspfLsa::INITIAL_SEQUENCE_NUMBER + (maxAge ? 1 : 0);
+    header.age = maxAge ? OspfLsa::MAX_AGE : 0;
+
+    // Grace period left, the reason is a planned restart (RFC 3623 A)
+    Time left = m_graceEvent.IsRunning() ? Simulator::GetDelayLeft(m_graceEvent) : m_gracePeriod;
+    lsa->AddTlv(OspfLsa::GRACE_PERIOD_TLV, uint32_t(left.GetSeconds()));
+    lsa->AddTlv(OspfLsa::RESTART_REASON_TLV, std::vector<uint8_t>{1});
+    if (m_version == 3){
+        header.type = OspfLsa::V3_GRACE_LSA;
+        header.linkStateId = neighbor.interface;
+    }else{
+        header.type = OspfLsa::LINK_LOCAL_OPAQUE_LSA;
+        header.linkStateId = uint32_t(OspfLsa::GRACE_OPAQUE_TYPE) << 24;
+        Ipv4Address local = GetInterfaceAddress(neighbor.interface, neighbor.ipAdd).GetLocal();
+        lsa->AddTlv(OspfLsa::INTERFACE_ADDRESS_TLV, local.Get());
+    }
+    lsa->UpdateChecksum();
+    return lsa;
+}
+
+bool OspfL4Protocol::IsGraceLsa(const OspfLsaHeader& header) const{
+    if (m_version == 3){
+        return header.type == OspfLsa::V3_GRACE_LSA;
+    }
+    return header.type == OspfLsa::LINK_LOCAL_OPAQUE_LSA &&
+           (header.linkStateId >> 24) == OspfLsa::GRACE_OPAQUE_TYPE;
+}
+
+void OspfL4Protocol::HandleGraceLsa(const OspfNeighborTable::neighborItems& neighbor, Ptr<OspfLsa> lsa){
+    const OspfLsaHeader& header = lsa->GetHeader();
+    auto key = std::make_pair(neighbor.router_id, neighbor.interface);
+    if (header.GetAge() >= OspfLsa::MAX_AGE){
+        // The neighbor is back and has re-originated its LSAs
+        if (m_helping.find(key) != m_helping.end()){
+            NS_LOG_LOGIC("Neighbor " << neighbor.router_id << " left graceful restart");
+            StopHelping(neighbor.router_id, neighbor.interface);
+        }
+        return;
+    }
+
+    const OspfLsa::Tlv* period = lsa->FindTlv(OspfLsa::GRACE_PERIOD_TLV);
+    if (!m_helperSupport || period == nullptr || period->value.size() != 4){
+        return;
+    }
+    uint32_t seconds = (uint32_t(period->value[0]) << 24) | (uint32_t(period->value[1]) << 16) |
+                       (uint32_t(period->value[2]) << 8) | period->value[3];
+    if (seconds <= header.GetAge()){
+        return;
+    }
+
+    auto helped = m_helping.find(key);
+    if (helped == m_helping.end()){
+        // Only a full adjacency with nothing left to flood to it can be kept
+        // as it is: a pending LSA means the topology is changing (RFC 3623 3.1)
+        if (neighbor.state != States::FULL || !neighbor.retransmissionList.empty()){
+            NS_LOG_LOGIC("Not helping neighbor " << neighbor.router_id);
+            return;
+        }
+        NS_LOG_LOGIC("Helping neighbor " << neighbor.router_id << " for " << seconds << "s");
+        helped = m_helping.emplace(key, HelpedNeighbor{EventId(), neighbor.ipAdd, neighbor.interfaceId}).first;
+    }
+    helped->second.expiry.Cancel();
+    helped->second.expiry = Simulator::Schedule(Seconds(seconds - header.GetAge()),
+                                                &OspfL4Protocol::StopHelping,
+                                                this,
+                                                neighbor.router_id,
+                                                neighbor.interface);
+}
+
+void OspfL4Protocol::StopHelping(uint32_t r_id, uint32_t interface){
+    auto helped = m_helping.find({r_id, interface});
+    if (helped == m_helping.end()){
+        return;
+    }
+    helped->second.expiry.Cancel();
+    m_helping.erase(helped);
+    ScheduleRouterLsa();
+}
+
+void OspfL4Protocol::CheckGracefulRestartDone(){
+    OspfLsaKey key{uint16_t((m_version == 3) ? OspfLsa::V3_ROUTER_LSA : OspfLsa::ROUTER_LSA),
+                   (m_version == 3) ? 0 : m_routerId,
+                   m_routerId};
+    Ptr<OspfLsa> previous = m_lsdb.Get(key);
+    if (!previous){
+        return;
+    }
+
+    // Every adjacency we advertised before restarting is full again
+    for (const auto& link : previous->GetRouterLinks()){
+        if (link.type != OspfLsa::POINT_TO_POINT){
+            continue;
+        }
+        bool full = false;
+        for (const auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+            if (neighbor.router_id != link.linkId || neighbor.state != States::FULL){
+                continue;
+            }
+            if (m_version == 3){
+                full = full || (link.linkData == neighbor.interface &&
+                                link.neighborInterfaceId == neighbor.interfaceId);
+            }else{
+                Ipv4Address local = GetInterfaceAddress(neighbor.interface, neighbor.ipAdd).GetLocal();
+                full = full || local.Get() == link.linkData;
+            }
+        }
+        if (!full){
+            return;
+        }
+    }
+    ExitGracefulRestart();
+}
+
+void OspfL4Protocol::ExitGracefulRestart(){
+    NS_LOG_FUNCTION(this);
+    if (!m_restarting){
+        return;
+    }
+    m_restarting = false;
+    m_graceEvent.Cancel();
+    if (!m_running){
+        // The grace period ended before the downtime, start afresh
+        return;
+    }
+
+    for (const auto& neighbor : m_neighbor_table.getCurrentNeighbors()){
+        if (neighbor.state == States::FULL){
+            SendLsUpdates(neighbor, {CreateGraceLsa(neighbor, true)});
+        }
+    }
+    OriginateRouterLsa(true);
+    NotifyLsdbChanged();
+}
 
 void OspfL4Protocol::SetOspfAreaType(int area_id){
     m_areaId = area_id;
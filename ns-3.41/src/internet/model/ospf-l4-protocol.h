@@ -13,6 +13,18 @@
  *  the IpL4Protocol class which contains a lot of the obvious plumbing
  *  for inserting into a node and connecting to the underlying network layer
  *
+ *  The same engine runs OSPFv2 over IPv4 (SetIpv4) or OSPFv3 over IPv6
+ *  (SetIpv6, RFC 5340). The neighbor state machine, database exchange,
+ *  flooding and aging do not depend on the version; only the packet
+ *  addressing, the wire format of the bodies and the LSAs we originate do.
+ *  A dual-stack router runs one instance of each.
+ *
+ *  Graceful restart (RFC 3623, RFC 5187 for OSPFv3): a restarting router
+ *  announces a grace period in Grace-LSAs to its neighbors, keeps its
+ *  forwarding state while it resynchronises its LSDB and only then
+ *  re-originates its LSAs. Its helpers keep advertising the adjacency
+ *  meanwhile, so the rest of the area sees no change at all.
+ *
  */
 
 #ifndef OSPF_L4_PROTOCOL_H
@@ -21,15 +33,28 @@
 #include "ip-l4-protocol.h"
 #include "ipv6-end-point-demux.h"
 #include "ipv4.h"
+#include "ipv6.h"
 
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
 #include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "ospf-hello.h"
+#include "ospf-header.h"
+#include "ospf-lsdb.h"
+#include "ospf-neighbor-table.h"
+#include "ospf-stats.h"
 
+#include "ns3/callback.h"
+#include "ns3/data-rate.h"
+#include "ns3/traced-callback.h"
+
+#include <map>
 #include <stdint.h>
 #include <unordered_map>
 #include <set>
+#include <vector>
 
 #include "loopback-net-device.h"
 
@@ -45,7 +70,10 @@ class NetDevice;
 class OspfNeighborTable;
 class OspfHello;
 class OspfHeader;
+class OspfDbd;
 class OspfRouting;
+class Ipv4Route;
+class Ipv6Route;
 
 
 class OspfL4Protocol : public IpL4Protocol {
@@ -69,13 +97,14 @@ class OspfL4Protocol : public IpL4Protocol {
         FULL = 7
     };
 
+    // Values are the RFC 2328 packet type codes carried in OspfHeader
     enum PacketType
     {
-        HELLO = 0,
-        DBD = 1,
-        LSA = 2,
-        LSU = 3,
-        LSAck = 4
+        HELLO = 1,
+        DBD = 2,
+        LSR = 3,
+        LSU = 4,
+        LSAck = 5
     };
 
     // Delete copy constructor and assignment operator to avoid misuse
@@ -179,13 +208,46 @@ class OspfL4Protocol : public IpL4Protocol {
      * It is safe to call GetObject() from within this method.
      */
 
-    void Send(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr, Ipv4Mask ipv4Mask, OspfHeader ospfHeader, int packetType, int currentState);
+    /**
+     * \brief Add an OspfHeader to an OSPF packet body and send it.
+     * \param packet the packet body (e.g. a packet holding an OspfHello)
+     * \param saddr the source address
+     * \param daddr the destination address
+     * \param packetType the OSPF packet type (PacketType)
+     */
+    void Send(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr, int packetType);
 
-    void Send(Ptr<Packet> packet, Ipv4Address saddr, Ipv4Address daddr, Ipv4Mask ipv4Mask, OspfHeader ospfHeader, int packetType, int currentState, Ptr<Ipv4Route> route);
+    /**
+     * \brief Add an OspfHeader to an OSPF packet body and send it on a route.
+     * \param packet the packet body (e.g. a packet holding an OspfHello)
+     * \param saddr the source address
+     * \param daddr the destination address
+     * \param packetType the OSPF packet type (PacketType)
+     * \param route the route to use; OSPF packets never leave the link so
+     * this is normally a proxy route for the outgoing interface
+     */
+    void Send(Ptr<Packet> packet,
+              Ipv4Address saddr,
+              Ipv4Address daddr,
+              int packetType,
+              Ptr<Ipv4Route> route);
 
-    void Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr);
+    /**
+     * \brief Add an OSPFv3 OspfHeader to a packet body and send it.
+     * \param packet the packet body
+     * \param saddr the source address, link-local
+     * \param daddr the destination address
+     * \param packetType the OSPF packet type (PacketType)
+     * \param route the route to use, normally a proxy route for the outgoing
+     * interface
+     */
+    void Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr, int packetType);
 
-    void Send(Ptr<Packet> packet, Ipv6Address saddr, Ipv6Address daddr, Ptr<Ipv6Route> route);
+    void Send(Ptr<Packet> packet,
+              Ipv6Address saddr,
+              Ipv6Address daddr,
+              int packetType,
+              Ptr<Ipv6Route> route);
 
     void ReceiveIcmp(Ipv4Address icmpSource,
                      uint8_t icmpTtl,
@@ -210,10 +272,174 @@ class OspfL4Protocol : public IpL4Protocol {
 
     void SetExclusions(std::set<uint32_t>);
 
+    /**
+     * \brief Stop advertising the prefixes of some interfaces (RFC 6860).
+     * Their adjacencies are still advertised, so they carry transit traffic,
+     * but their link networks cannot be addressed from other routers.
+     * \param interfaces the interface indices
+     */
+    void SetPrefixSuppressions(const std::set<uint32_t>& interfaces);
+
+    /**
+     * \brief Advertise the traffic engineering attributes of a point-to-point
+     * interface in an area-local Opaque LSA (RFC 3630) while its neighbor is
+     * fully adjacent, for constrained path computations (see
+     * OspfRouting::ComputeConstrainedPath). OSPFv2 only.
+     * \param interface the interface index
+     * \param bandwidth the maximum bandwidth of the link
+     * \param reservableBandwidth the bandwidth that may be reserved on it
+     * \param adminGroup the administrative groups of the link, a bit mask
+     */
+    void SetTeAttributes(uint32_t interface,
+                         DataRate bandwidth,
+                         DataRate reservableBandwidth,
+                         uint32_t adminGroup);
+
+    /**
+     * \brief Run interfaces as demand circuits (RFC 1793). Once the
+     * neighbor at the other end, which must do the same, is fully adjacent,
+     * Hellos stop and the neighbor is no longer timed out; LSAs are flooded
+     * over the link with DoNotAge set, and new instances that only refresh
+     * an LSA are not flooded over it at all.
+     * \param interfaces the interface indices
+     * \param all every interface, e.g. for a whole area
+     */
+    void SetDemandCircuits(const std::set<uint32_t>& interfaces, bool all = false);
+
+    /**
+     * \param interface an interface index
+     * \return true if the interface is configured as a demand circuit
+     */
+    bool IsDemandCircuit(uint32_t interface) const;
+
     void startDownState();
 
     void SetIpv4(Ptr<Ipv4>);
 
+    /**
+     * \brief Run OSPFv3 over an IPv6 stack instead of OSPFv2 over IPv4. The
+     * protocol is not aggregated to the node in that case: the caller
+     * inserts it into the stack (see Ospf6Routing::SetIpv6).
+     * \param ipv6 the IPv6 stack
+     */
+    void SetIpv6(Ptr<Ipv6> ipv6);
+
+    /**
+     * \return the OSPF version run by this instance, 2 or 3
+     */
+    uint8_t GetVersion() const;
+
+    /**
+     * \brief Set the cost of an interface, advertised in our Router-LSA.
+     * Interfaces without a cost use Ipv4::GetMetric (Ipv6::GetMetric).
+     * \param metrics interface index to cost
+     */
+    void SetInterfaceMetrics(const std::map<uint32_t, uint8_t>& metrics);
+
+    /**
+     * \param interface an interface index
+     * \return the cost of the interface
+     */
+    uint16_t GetInterfaceMetric(uint32_t interface) const;
+
+    /**
+     * \brief Set the callback invoked when the LSDB changes in a way that
+     * requires the routing table to be recalculated (RFC 2328 13.2).
+     * \param cb the callback
+     */
+    void SetLsdbChangedCallback(Callback<void> cb);
+
+    const OspfLsdb& GetLsdb() const;
+    uint32_t GetRouterId() const;
+
+    /**
+     * \return the counters of this router, the LSDB size filled in. The
+     * shortest path ones are left to OspfRouting::GetStats.
+     */
+    OspfStats GetStats() const;
+
+    /**
+     * TracedCallback signature for neighbor state changes.
+     *
+     * \param [in] routerId the neighbor's router ID
+     * \param [in] interface the interface the neighbor is on
+     * \param [in] oldState the previous state
+     * \param [in] newState the new state
+     */
+    typedef void (*NeighborStateTracedCallback)(uint32_t routerId,
+                                                uint32_t interface,
+                                                int oldState,
+                                                int newState);
+
+    /**
+     * TracedCallback signature for LSA installation.
+     *
+     * \param [in] lsa the LSA installed in the LSDB
+     */
+    typedef void (*LsaInstallTracedCallback)(Ptr<const OspfLsa> lsa);
+
+    /**
+     * \param r_id a neighbor's router ID
+     * \param interface the interface the neighbor is on
+     * \return the neighbor's address, or 0.0.0.0 if it is not adjacent
+     */
+    Ipv4Address GetNeighborAddress(uint32_t r_id, uint32_t interface);
+
+    /**
+     * \param r_id a neighbor's router ID
+     * \param interface the interface the neighbor is on
+     * \return the neighbor's link-local address, or :: if it is not adjacent
+     */
+    Ipv6Address GetNeighborAddress6(uint32_t r_id, uint32_t interface);
+
+    /**
+     * \brief An interface went up or down or changed address: drop its
+     * neighbors if it is down and re-originate our Router-LSA.
+     * \param interface the interface index
+     */
+    void NotifyInterfaceChange(uint32_t interface);
+
+    /**
+     * \brief Restart the protocol, e.g. for maintenance, losing its neighbors
+     * and LSDB. The protocol is back up after the downtime.
+     *
+     * A graceful restart first sends Grace-LSAs to the adjacent neighbors
+     * and keeps the routing table until the LSDB is resynchronised or the
+     * GracePeriod expires. Otherwise the routing table is flushed at once.
+     *
+     * \param downtime the time the protocol stays down
+     * \param graceful true for a graceful restart
+     */
+    void Restart(Time downtime, bool graceful);
+
+    /**
+     * \return true from a graceful restart until we leave it, while our
+     * routing table must be kept
+     */
+    bool IsRestarting() const;
+
+    /**
+     * \return the number of restarting neighbors we are helping
+     */
+    uint32_t GetHelpedNeighborNumber() const;
+
+    /**
+     * \brief Advertise our transit links with MaxLinkMetric, as a stub router
+     * (RFC 6987), so that other routers only send through us what has no
+     * other way. Our own networks keep their cost.
+     * \param maxMetric true to advertise MaxLinkMetric
+     */
+    void SetMaxMetric(bool maxMetric);
+
+    /// \return true while our transit links are advertised with MaxLinkMetric
+    bool IsMaxMetric() const;
+
+    /**
+     * \return true if we have neighbors and are fully adjacent with all of
+     * them, i.e. our LSDB is synchronised
+     */
+    bool IsFullyAdjacent() const;
+
   protected:
 
     /**
@@ -245,17 +471,339 @@ class OspfL4Protocol : public IpL4Protocol {
      */
     void DoDispose() override;
 
-    void SendDownPacket(Ipv4InterfaceAddress);
+    /**
+     * \brief Send the periodic Hello on every active interface and
+     * schedule the next one.
+     */
+    void SendHelloPackets();
+
+    void SendDownPacket(uint32_t, Ipv4InterfaceAddress);
+
+    /**
+     * \brief Send our Hello for an interface to a single neighbor.
+     * \param interface the interface index
+     * \param daddr the neighbor's address, IPv4 or IPv6 link-local
+     */
+    void SendHelloTo(uint32_t interface, const Address& daddr);
+
+    /**
+     * \brief Check and dispatch a received OSPF packet, whatever the IP
+     * version it arrived over.
+     * \param packet the packet body
+     * \param ospfHeader the OSPF header removed from the packet
+     * \param source the IP source address
+     * \param incomingIf the interface index it arrived on
+     */
+    void ReceivePacket(Ptr<Packet> packet,
+                       const OspfHeader& ospfHeader,
+                       const Address& source,
+                       int32_t incomingIf);
+
+    /**
+     * \brief Dispatch a received Hello on the state of its sender in the
+     * neighbor table.
+     */
+    void HandleHello(Ptr<Packet>, const Address&, OspfHeader, uint32_t);
+
+    void HandleDownResponse(const Address&, OspfHeader, const OspfHello&, uint32_t);
+
+    void HandleInitResponse(const Address&, OspfHeader, const OspfHello&, uint32_t);
+
+    void HandleTwoWayResponse(const Address&, OspfHeader, const OspfHello&, uint32_t);
+
+    /**
+     * \brief Neighbor's RouterDeadInterval expired.
+     * \param r_id the neighbor's router ID
+     * \param interface the interface the neighbor was heard on
+     */
+    void HandleNeighborDead(uint32_t r_id, uint32_t interface);
+
+    void RefreshInactivityTimer(uint32_t r_id, uint32_t interface);
+
+    /**
+     * \brief Get the Hello body for an interface.
+     *
+     * The body only depends on the neighbors heard on the interface (and the
+     * interface mask), so it is serialised once and cached until the
+     * interface's neighbor set changes. Callers must send a Copy().
+     *
+     * \param interface the interface index
+     * \param mask the mask of the interface address the Hello is sent from
+     * \return the cached Hello body
+     */
+    Ptr<Packet> GetHelloPacket(uint32_t interface, Ipv4Mask mask);
+
+    /**
+     * \brief Drop the cached Hello body of an interface.
+     * \param interface the interface index
+     */
+    void InvalidateHelloPacket(uint32_t interface);
+
+    /**
+     * \param interface the interface index
+     * \return a proxy route sending directly out of the interface
+     */
+    Ptr<Ipv4Route> GetInterfaceRoute(uint32_t interface);
+
+    /**
+     * \param interface the interface index
+     * \return a proxy route sending directly out of the interface (OSPFv3)
+     */
+    Ptr<Ipv6Route> GetInterfaceRoute6(uint32_t interface);
+
+    /**
+     * \param interface the interface index
+     * \return the link-local address OSPFv3 packets are sent from, or ::
+     */
+    Ipv6Address GetLinkLocalAddress(uint32_t interface) const;
+
+    /// \return the number of interfaces of the IP stack we run over
+    uint32_t GetNInterfaces() const;
+    Ptr<NetDevice> GetInterfaceDevice(uint32_t interface) const;
+    bool IsInterfaceUp(uint32_t interface) const;
+    uint16_t GetInterfaceMtu(uint32_t interface) const;
+
+    /**
+     * \param interface the interface index
+     * \return true if OSPF runs on the interface: it is up, not a loopback
+     * and not excluded
+     */
+    bool IsOspfInterface(uint32_t interface) const;
 
-    void SendInitPacket(Ipv4InterfaceAddress, Ipv4Address);
+    /**
+     * \return the size of the IP and OSPF headers in front of every packet
+     * body
+     */
+    uint32_t GetPacketOverhead() const;
 
-    void SendTwoWayPacket(Ipv4InterfaceAddress, Ipv4Address);
+    /**
+     * \param type an LS type
+     * \return true if we store and flood LSAs of this type
+     */
+    bool IsSupportedLsType(uint16_t type) const;
 
-    void HandleDownResponse(Ptr<Packet>, Ipv4Header, OspfHeader, Ptr<Ipv4Interface>, uint32_t);
+    /**
+     * \param interface the interface index
+     * \param peer an address on the attached link
+     * \return the interface address on the same subnet as peer
+     */
+    Ipv4InterfaceAddress GetInterfaceAddress(uint32_t interface, Ipv4Address peer) const;
 
-    void HandleInitResponse(Ptr<Packet>, Ipv4Header, OspfHeader, Ptr<Ipv4Interface>, uint32_t);
+    /**
+     * \brief Add an OspfHeader to a packet body and send it to a neighbor.
+     */
+    void SendToNeighbor(const OspfNeighborTable::neighborItems& neighbor,
+                        Ptr<Packet> packet,
+                        int packetType);
 
-    void HandleTwoWayResponse(Ptr<Packet>, Ipv4Header, OspfHeader, Ptr<Ipv4Interface>, uint32_t);
+    /**************************************************************************
+     *
+     * Database exchange (RFC 2328 10.6 - 10.9)
+     *
+     *************************************************************************/
+
+    /**
+     * \brief Enter ExStart with a neighbor and start negotiating master and
+     * slave.
+     */
+    void StartExchange(OspfNeighborTable::neighborItems& neighbor);
+
+    /**
+     * \brief Change the state of a neighbor, counting and tracing the change.
+     * \param neighbor the neighbor
+     * \param state the neighbor's new state
+     */
+    void SetNeighborState(OspfNeighborTable::neighborItems& neighbor, int state);
+
+    /**
+     * \brief Drop the exchange and flooding state of a neighbor.
+     * \param neighbor the neighbor
+     * \param state the neighbor's new state
+     */
+    void ResetAdjacency(OspfNeighborTable::neighborItems& neighbor, int state);
+
+    void HandleDbd(Ptr<Packet>, OspfHeader, uint32_t);
+    void HandleExStartDbd(OspfNeighborTable::neighborItems& neighbor, const OspfDbd& dbd);
+    void ProcessDbd(OspfNeighborTable::neighborItems& neighbor, const OspfDbd& dbd);
+
+    /**
+     * \brief Describe the next part of the database summary list.
+     */
+    void SendNextDbd(OspfNeighborTable::neighborItems& neighbor);
+
+    /**
+     * \brief The slave acknowledged our last DBD: finish the exchange or
+     * send the next one.
+     */
+    void MasterNextDbd(OspfNeighborTable::neighborItems& neighbor);
+    void SendDbd(OspfNeighborTable::neighborItems& neighbor);
+    void RetransmitDbd(uint32_t r_id, uint32_t interface);
+    void ExchangeDone(OspfNeighborTable::neighborItems& neighbor);
+    void AdjacencyFull(OspfNeighborTable::neighborItems& neighbor);
+
+    void SendLsRequest(OspfNeighborTable::neighborItems& neighbor);
+    void RetransmitLsRequest(uint32_t r_id, uint32_t interface);
+    void HandleLsRequest(Ptr<Packet>, OspfHeader, uint32_t);
+
+    /**************************************************************************
+     *
+     * Flooding (RFC 2328 13)
+     *
+     *************************************************************************/
+
+    void HandleLsUpdate(Ptr<Packet>, OspfHeader, uint32_t);
+    void HandleLsAck(Ptr<Packet>, OspfHeader, uint32_t);
+
+    /**
+     * \brief Install an LSA in the LSDB.
+     * \param lsa the new instance
+     * \return true if the routing table must be recalculated
+     */
+    bool InstallLsa(Ptr<OspfLsa> lsa);
+
+    /**
+     * \brief Flood an LSA to every neighbor in Exchange or above, except the
+     * one it was received from.
+     * \param lsa the LSA
+     * \param fromRouter router ID of the sender, or our own
+     * \param fromInterface interface it was received on
+     * \param refresh the LSA only refreshes the previous instance, it is not
+     * flooded over demand circuits (RFC 1793 3.4)
+     */
+    void FloodLsa(Ptr<OspfLsa> lsa, uint32_t fromRouter, uint32_t fromInterface, bool refresh = false);
+
+    /**
+     * \brief Queue an LSA for the next LS Update to a neighbor. The LSAs
+     * queued during one event are sent together.
+     */
+    void QueueLsUpdate(OspfNeighborTable::neighborItems& neighbor, Ptr<OspfLsa> lsa);
+    void FlushLsUpdates(uint32_t r_id, uint32_t interface);
+    void RetransmitLsUpdates(uint32_t r_id, uint32_t interface);
+
+    /**
+     * \brief Send LSAs to a neighbor in as few LS Updates as the MTU allows.
+     */
+    void SendLsUpdates(const OspfNeighborTable::neighborItems& neighbor,
+                       const std::vector<Ptr<OspfLsa>>& lsas);
+
+    /**
+     * \param lsa an LSA
+     * \param demandCircuit the LSA is sent over a demand circuit
+     * \return the LS age to transmit the LSA with, InfTransDelay included,
+     * with DoNotAge set over demand circuits and kept once set
+     */
+    uint16_t GetTransmitAge(Ptr<OspfLsa> lsa, bool demandCircuit) const;
+
+    /**
+     * \param interface an interface index
+     * \return true if Hellos are suppressed on the interface: every
+     * neighbor on it is fully adjacent over a demand circuit
+     */
+    bool IsHelloSuppressed(uint32_t interface) const;
+
+    /// \brief Restart periodic Hellos if they stopped on demand circuits
+    void ResumeHellos();
+
+    /**
+     * \return true if a neighbor is in Exchange or Loading
+     */
+    bool IsExchanging() const;
+
+    /**************************************************************************
+     *
+     * LSA origination and aging (RFC 2328 12.4, 14)
+     *
+     *************************************************************************/
+
+    /**
+     * \brief Originate a new Router-LSA, no sooner than MinLSInterval after
+     * the previous one.
+     */
+    void ScheduleRouterLsa();
+
+    /**
+     * \brief Build our Router-LSA (and in OSPFv3 the Intra-Area-Prefix-LSA
+     * carrying our prefixes) and install and flood it if it differs from the
+     * database copy.
+     * \param force originate a new instance even if nothing changed
+     */
+    void OriginateRouterLsa(bool force);
+
+    /**
+     * \brief Number, install and flood one of our own LSAs unless the
+     * database copy has the same content.
+     * \param lsa the new LSA, its sequence number and checksum unset
+     * \param force originate a new instance even if nothing changed
+     * \param changed set if the routing table must be recalculated
+     * \return true if a new instance was originated
+     */
+    bool OriginateLsa(Ptr<OspfLsa> lsa, bool force, bool& changed);
+
+    /**
+     * \brief Originate the traffic engineering LSA of each interface with
+     * attributes and a fully adjacent neighbor, flush those of the others.
+     * \param force originate new instances even if nothing changed
+     * \param changed set if the routing table must be recalculated
+     * \return true if an LSA was originated or flushed
+     */
+    bool OriginateTeLsas(bool force, bool& changed);
+
+    void RefreshRouterLsa();
+
+    /**
+     * \brief Flush LSAs that reached MaxAge and remove them once they are
+     * acknowledged by every neighbor.
+     */
+    void AgeLsdb();
+
+    void NotifyLsdbChanged();
+
+    /**************************************************************************
+     *
+     * Graceful restart (RFC 3623)
+     *
+     *************************************************************************/
+
+    /**
+     * \brief Build the Grace-LSA for an interface.
+     * \param neighbor an adjacent neighbor on the interface
+     * \param maxAge true to build the instance flushing it
+     * \return the Grace-LSA
+     */
+    Ptr<OspfLsa> CreateGraceLsa(const OspfNeighborTable::neighborItems& neighbor, bool maxAge);
+
+    /**
+     * \param header an LSA header
+     * \return true if the header is that of a Grace-LSA
+     */
+    bool IsGraceLsa(const OspfLsaHeader& header) const;
+
+    /**
+     * \brief Process a Grace-LSA from a neighbor: start or stop helping it.
+     * \param neighbor the neighbor it was received from
+     * \param lsa the Grace-LSA
+     */
+    void HandleGraceLsa(const OspfNeighborTable::neighborItems& neighbor, Ptr<OspfLsa> lsa);
+
+    /**
+     * \brief Stop helping a neighbor and drop the adjacency from our
+     * Router-LSA unless it came back.
+     * \param r_id the neighbor's router ID
+     * \param interface the interface the neighbor is on
+     */
+    void StopHelping(uint32_t r_id, uint32_t interface);
+
+    /**
+     * \brief Leave a graceful restart once every adjacency of our old
+     * Router-LSA is back.
+     */
+    void CheckGracefulRestartDone();
+
+    /**
+     * \brief Leave a graceful restart: flush the Grace-LSAs, re-originate our
+     * LSAs and recalculate the routing table.
+     */
+    void ExitGracefulRestart();
 
   private:
     Ptr<Node> m_node;                    //!< The node this stack is associated with
@@ -266,10 +814,69 @@ class OspfL4Protocol : public IpL4Protocol {
     IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
 
     Ptr<Ipv4> m_ipv4;
+    Ptr<Ipv6> m_ipv6;                    //!< The IPv6 stack, OSPFv3 only
+    uint8_t m_version;                   //!< OSPF version, see SetIpv6
     std::set<uint32_t> m_interfaceExclusions;
+    std::set<uint32_t> m_prefixSuppressions;        //!< See SetPrefixSuppressions
+    std::map<uint32_t, OspfLsa::TeLink> m_teLinks;  //!< See SetTeAttributes, by interface
+    std::set<uint32_t> m_demandCircuits;            //!< See SetDemandCircuits
+    bool m_allDemandCircuits;                       //!< Every interface is a demand circuit
     OspfNeighborTable m_neighbor_table;
     uint32_t m_routerId;
     int m_areaId;
+
+    Time m_helloInterval;                           //!< HelloInterval
+    Time m_routerDeadInterval;                      //!< RouterDeadInterval
+    EventId m_helloEvent;                           //!< Next periodic Hello
+
+    /// Serialised Hello body of an interface, see GetHelloPacket
+    struct HelloCacheEntry
+    {
+        Ptr<Packet> packet;
+        Ipv4Mask mask;
+    };
+
+    std::vector<HelloCacheEntry> m_helloCache;      //!< Hello bodies, by interface
+    std::vector<Ptr<Ipv4Route>> m_interfaceRoutes;  //!< Proxy routes, by interface
+    std::vector<Ptr<Ipv6Route>> m_interfaceRoutes6; //!< OSPFv3 proxy routes, by interface
+
+    std::map<uint32_t, uint8_t> m_interfaceMetrics; //!< Interface costs
+    OspfLsdb m_lsdb;                                //!< The area's LSDB
+    Callback<void> m_lsdbChanged;                   //!< See SetLsdbChangedCallback
+
+    Time m_rxmtInterval;                            //!< RxmtInterval
+    Time m_minLsInterval;                           //!< MinLSInterval
+    Time m_lsRefreshTime;                           //!< LSRefreshTime
+    Time m_lastRouterLsa;                           //!< When our Router-LSA was last originated
+    bool m_routerLsaOriginated;                     //!< m_lastRouterLsa is valid
+    bool m_running;                                 //!< Started and not restarting
+    bool m_maxMetric;                               //!< See SetMaxMetric
+    EventId m_routerLsaEvent;                       //!< Pending Router-LSA origination
+    EventId m_refreshEvent;                         //!< Router-LSA refresh
+    EventId m_agingEvent;                           //!< Next LSDB aging sweep
+    OspfStats m_stats;                              //!< Counters, see GetStats
+
+    Time m_gracePeriod;                             //!< Grace period we announce
+    bool m_helperSupport;                           //!< Help restarting neighbors
+    bool m_restarting;                              //!< In a graceful restart
+    EventId m_restartEvent;                         //!< End of the downtime
+    EventId m_graceEvent;                           //!< End of our grace period
+
+    /// A restarting neighbor we keep advertising as adjacent
+    struct HelpedNeighbor
+    {
+        EventId expiry;                             //!< End of its grace period
+        Ipv4Address ipAdd;                          //!< Its address (OSPFv2)
+        uint32_t interfaceId;                       //!< Its interface ID (OSPFv3)
+    };
+
+    /// Helped neighbors, by router ID and interface
+    std::map<std::pair<uint32_t, uint32_t>, HelpedNeighbor> m_helping;
+
+    /// Neighbor state changes
+    TracedCallback<uint32_t, uint32_t, int, int> m_neighborStateTrace;
+    /// LSAs installed in the LSDB
+    TracedCallback<Ptr<const OspfLsa>> m_lsaInstallTrace;
 };
 
 }
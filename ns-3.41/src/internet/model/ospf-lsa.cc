@@ -0,0 +1,561 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsa.cc
+ *
+ */
+
+#include "ospf-lsa.h"
+#include "ospf-checksum.h"
+
+#include "ns3/ipv4-address.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+
+/// Sequence numbers and checksums of two instances closer than this (in
+/// seconds) are considered the same instance (RFC 2328 13.1, MaxAgeDiff)
+#define OSPF_MAX_AGE_DIFF 900
+
+namespace ns3 {
+
+const uint32_t OspfLsaHeader::SIZE;
+const uint16_t OspfLsa::MAX_AGE;
+const int32_t OspfLsa::INITIAL_SEQUENCE_NUMBER;
+const int32_t OspfLsa::MAX_SEQUENCE_NUMBER;
+const uint32_t OspfLsa::V3_OPTIONS;
+
+bool OspfLsaKey::operator<(const OspfLsaKey& other) const {
+    return std::tie(type, linkStateId, advertisingRouter) <
+           std::tie(other.type, other.linkStateId, other.advertisingRouter);
+}
+
+bool OspfLsaKey::operator==(const OspfLsaKey& other) const {
+    return type == other.type && linkStateId == other.linkStateId &&
+           advertisingRouter == other.advertisingRouter;
+}
+
+/******************************************************************************
+ *
+ * LSA header
+ *
+ *****************************************************************************/
+
+void OspfLsaHeader::Serialize(Buffer::Iterator& i, uint8_t version) const {
+    i.WriteHtonU16(age);
+    if (version == 3)
+    {
+        i.WriteHtonU16(type);
+    }
+    else
+    {
+        i.WriteU8(options);
+        i.WriteU8(type);
+    }
+    i.WriteHtonU32(linkStateId);
+    i.WriteHtonU32(advertisingRouter);
+    i.WriteHtonU32(static_cast<uint32_t>(sequence));
+    i.WriteHtonU16(checksum);
+    i.WriteHtonU16(length);
+}
+
+void OspfLsaHeader::Deserialize(Buffer::Iterator& i, uint8_t version) {
+    age = i.ReadNtohU16();
+    if (version == 3)
+    {
+        options = 0;
+        type = i.ReadNtohU16();
+    }
+    else
+    {
+        options = i.ReadU8();
+        type = i.ReadU8();
+    }
+    linkStateId = i.ReadNtohU32();
+    advertisingRouter = i.ReadNtohU32();
+    sequence = static_cast<int32_t>(i.ReadNtohU32());
+    checksum = i.ReadNtohU16();
+    length = i.ReadNtohU16();
+}
+
+OspfLsaKey OspfLsaHeader::GetKey() const {
+    return OspfLsaKey{type, linkStateId, advertisingRouter};
+}
+
+bool OspfLsaHeader::IsMoreRecentThan(const OspfLsaHeader& other) const {
+    if (sequence != other.sequence)
+    {
+        return sequence > other.sequence;
+    }
+    if (checksum != other.checksum)
+    {
+        return checksum > other.checksum;
+    }
+    if ((GetAge() >= OspfLsa::MAX_AGE) != (other.GetAge() >= OspfLsa::MAX_AGE))
+    {
+        return GetAge() >= OspfLsa::MAX_AGE;
+    }
+    if (std::abs(int(GetAge()) - int(other.GetAge())) > OSPF_MAX_AGE_DIFF)
+    {
+        return GetAge() < other.GetAge();
+    }
+    return false;
+}
+
+uint16_t OspfLsaHeader::GetAge() const {
+    return age & ~OspfLsa::DO_NOT_AGE;
+}
+
+bool OspfLsaHeader::IsDoNotAge() const {
+    return (age & OspfLsa::DO_NOT_AGE) != 0;
+}
+
+bool OspfLsaHeader::IsSameInstance(const OspfLsaHeader& other) const {
+    return !IsMoreRecentThan(other) && !other.IsMoreRecentThan(*this);
+}
+
+std::ostream& operator<<(std::ostream& os, const OspfLsaHeader& header) {
+    os << "type 0x" << std::hex << header.type << std::dec << " id " << Ipv4Address(header.linkStateId)
+       << " adv " << Ipv4Address(header.advertisingRouter) << " seq 0x" << std::hex
+       << static_cast<uint32_t>(header.sequence) << std::dec << " age " << header.GetAge()
+       << (header.IsDoNotAge() ? " DoNotAge" : "");
+    return os;
+}
+
+/******************************************************************************
+ *
+ * LSA
+ *
+ *****************************************************************************/
+
+bool OspfLsa::RouterLink::operator==(const RouterLink& other) const {
+    return linkId == other.linkId && linkData == other.linkData && type == other.type &&
+           metric == other.metric && neighborInterfaceId == other.neighborInterfaceId;
+}
+
+bool OspfLsa::AddressPrefix::operator==(const AddressPrefix& other) const {
+    return address == other.address && length == other.length && metric == other.metric;
+}
+
+bool OspfLsa::Tlv::operator==(const Tlv& other) const {
+    return type == other.type && value == other.value;
+}
+
+OspfLsa::OspfLsa(uint8_t version)
+    : m_version(version),
+      m_referenced{0, 0, 0}
+{
+    m_header.type = (version == 3) ? V3_ROUTER_LSA : ROUTER_LSA;
+}
+
+uint8_t OspfLsa::GetVersion() const {
+    return m_version;
+}
+
+OspfLsaHeader& OspfLsa::GetHeader() {
+    return m_header;
+}
+
+const OspfLsaHeader& OspfLsa::GetHeader() const {
+    return m_header;
+}
+
+OspfLsaKey OspfLsa::GetKey() const {
+    return m_header.GetKey();
+}
+
+void OspfLsa::AddRouterLink(uint32_t linkId,
+                            uint32_t linkData,
+                            uint8_t type,
+                            uint16_t metric,
+                            uint32_t neighborInterfaceId) {
+    m_routerLinks.push_back(RouterLink{linkId, linkData, type, metric, neighborInterfaceId});
+}
+
+const std::vector<OspfLsa::RouterLink>& OspfLsa::GetRouterLinks() const {
+    return m_routerLinks;
+}
+
+void OspfLsa::SetReferencedLsa(const OspfLsaKey& key) {
+    m_referenced = key;
+}
+
+const OspfLsaKey& OspfLsa::GetReferencedLsa() const {
+    return m_referenced;
+}
+
+void OspfLsa::AddPrefix(Ipv6Address address, uint8_t length, uint16_t metric) {
+    m_prefixes.push_back(AddressPrefix{address, length, metric});
+}
+
+const std::vector<OspfLsa::AddressPrefix>& OspfLsa::GetPrefixes() const {
+    return m_prefixes;
+}
+
+bool OspfLsa::HasTlvBody(uint16_t type) {
+    // Link-local, area and AS scope Opaque LSAs, and the OSPFv3 Grace-LSA
+    return (type >= LINK_LOCAL_OPAQUE_LSA && type <= 11) || type == V3_GRACE_LSA;
+}
+
+void OspfLsa::AddTlv(uint16_t type, const std::vector<uint8_t>& value) {
+    m_tlvs.push_back(Tlv{type, value});
+}
+
+void OspfLsa::AddTlv(uint16_t type, uint32_t value) {
+    AddTlv(type, {uint8_t(value >> 24), uint8_t(value >> 16), uint8_t(value >> 8), uint8_t(value)});
+}
+
+const std::vector<OspfLsa::Tlv>& OspfLsa::GetTlvs() const {
+    return m_tlvs;
+}
+
+const OspfLsa::Tlv* OspfLsa::FindTlv(uint16_t type) const {
+    for (const auto& tlv : m_tlvs)
+    {
+        if (tlv.type == type)
+        {
+            return &tlv;
+        }
+    }
+    return nullptr;
+}
+
+namespace {
+
+/// Append a sub-TLV, padded to 32 bits, to the value of a TLV
+void
+AddSubTlv(std::vector<uint8_t>& value, uint16_t type, const std::vector<uint32_t>& words)
+{
+    uint16_t length = 4 * words.size();
+    value.insert(value.end(), {uint8_t(type >> 8), uint8_t(type), uint8_t(length >> 8), uint8_t(length)});
+    for (uint32_t word : words)
+    {
+        value.insert(value.end(), {uint8_t(word >> 24), uint8_t(word >> 16), uint8_t(word >> 8), uint8_t(word)});
+    }
+}
+
+uint32_t
+ReadWord(const uint8_t* data)
+{
+    return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+}
+
+/// IEEE floating point bandwidths (RFC 3630 2.5.6)
+uint32_t
+FloatToWord(float value)
+{
+    uint32_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+float
+WordToFloat(uint32_t word)
+{
+    float value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+}
+
+}
+
+void OspfLsa::AddTeLink(const TeLink& link) {
+    std::vector<uint8_t> value;
+    uint32_t unreserved = FloatToWord(link.unreservedBandwidth);
+    AddSubTlv(value, TE_LINK_TYPE_SUB_TLV, {uint32_t(POINT_TO_POINT) << 24});
+    AddSubTlv(value, TE_LINK_ID_SUB_TLV, {link.linkId});
+    AddSubTlv(value, TE_LOCAL_ADDRESS_SUB_TLV, {link.localAddress});
+    AddSubTlv(value, TE_MAX_BANDWIDTH_SUB_TLV, {FloatToWord(link.maxBandwidth)});
+    AddSubTlv(value, TE_MAX_RESERVABLE_BANDWIDTH_SUB_TLV, {FloatToWord(link.maxReservableBandwidth)});
+    AddSubTlv(value, TE_UNRESERVED_BANDWIDTH_SUB_TLV, std::vector<uint32_t>(8, unreserved));
+    AddSubTlv(value, TE_ADMIN_GROUP_SUB_TLV, {link.adminGroup});
+    AddTlv(TE_LINK_TLV, value);
+}
+
+bool OspfLsa::GetTeLink(TeLink& link) const {
+    const Tlv* tlv = FindTlv(TE_LINK_TLV);
+    if (!tlv)
+    {
+        return false;
+    }
+    const std::vector<uint8_t>& value = tlv->value;
+    for (size_t offset = 0; offset + 4 <= value.size();)
+    {
+        uint16_t type = (value[offset] << 8) | value[offset + 1];
+        uint16_t length = (value[offset + 2] << 8) | value[offset + 3];
+        offset += 4;
+        if (offset + length > value.size())
+        {
+            break;
+        }
+        if (length >= 4)
+        {
+            uint32_t word = ReadWord(&value[offset]);
+            switch (type)
+            {
+            case TE_LINK_ID_SUB_TLV:
+                link.linkId = word;
+                break;
+            case TE_LOCAL_ADDRESS_SUB_TLV:
+                link.localAddress = word;
+                break;
+            case TE_MAX_BANDWIDTH_SUB_TLV:
+                link.maxBandwidth = WordToFloat(word);
+                break;
+            case TE_MAX_RESERVABLE_BANDWIDTH_SUB_TLV:
+                link.maxReservableBandwidth = WordToFloat(word);
+                break;
+            case TE_UNRESERVED_BANDWIDTH_SUB_TLV:
+                // Priority 0
+                link.unreservedBandwidth = WordToFloat(word);
+                break;
+            case TE_ADMIN_GROUP_SUB_TLV:
+                link.adminGroup = word;
+                break;
+            }
+        }
+        offset += 4 * ((length + 3) / 4);
+    }
+    return true;
+}
+
+bool OspfLsa::HasSameContent(const OspfLsa& other) const {
+    return m_header.type == other.m_header.type && m_header.options == other.m_header.options &&
+           (m_header.GetAge() >= MAX_AGE) == (other.m_header.GetAge() >= MAX_AGE) &&
+           m_routerLinks == other.m_routerLinks && m_referenced == other.m_referenced &&
+           m_prefixes == other.m_prefixes && m_tlvs == other.m_tlvs;
+}
+
+uint32_t OspfLsa::GetBodySize() const {
+    switch (m_header.type)
+    {
+    case ROUTER_LSA:
+        // flags, 0, # links, then 12 bytes per link (no TOS metrics)
+        return 4 + 12 * m_routerLinks.size();
+    case V3_ROUTER_LSA:
+        // flags and options, then 16 bytes per link
+        return 4 + 16 * m_routerLinks.size();
+    case V3_INTRA_AREA_PREFIX_LSA: {
+        // # prefixes, referenced LSA, then each prefix rounded up to words
+        uint32_t size = 12;
+        for (const auto& prefix : m_prefixes)
+        {
+            size += 4 + 4 * ((prefix.length + 31) / 32);
+        }
+        return size;
+    }
+    default: {
+        // TLVs, each value padded to a word
+        uint32_t size = 0;
+        for (const auto& tlv : m_tlvs)
+        {
+            size += 4 + 4 * ((tlv.value.size() + 3) / 4);
+        }
+        return size;
+    }
+    }
+}
+
+uint32_t OspfLsa::GetSerializedSize() const {
+    return OspfLsaHeader::SIZE + GetBodySize();
+}
+
+void OspfLsa::Serialize(Buffer::Iterator& i) const {
+    Serialize(i, m_header.age);
+}
+
+void OspfLsa::Serialize(Buffer::Iterator& i, uint16_t age) const {
+    OspfLsaHeader header = m_header;
+    header.age = age;
+    header.Serialize(i, m_version);
+
+    switch (m_header.type)
+    {
+    case ROUTER_LSA:
+        i.WriteU8(0);               // V, E and B bits
+        i.WriteU8(0);
+        i.WriteHtonU16(m_routerLinks.size());
+        for (const auto& link : m_routerLinks)
+        {
+            i.WriteHtonU32(link.linkId);
+            i.WriteHtonU32(link.linkData);
+            i.WriteU8(link.type);
+            i.WriteU8(0);           // # TOS
+            i.WriteHtonU16(link.metric);
+        }
+        break;
+    case V3_ROUTER_LSA:
+        i.WriteHtonU32(V3_OPTIONS); // flags (none) and options
+        for (const auto& link : m_routerLinks)
+        {
+            i.WriteU8(link.type);
+            i.WriteU8(0);
+            i.WriteHtonU16(link.metric);
+            i.WriteHtonU32(link.linkData);
+            i.WriteHtonU32(link.neighborInterfaceId);
+            i.WriteHtonU32(link.linkId);
+        }
+        break;
+    case V3_INTRA_AREA_PREFIX_LSA:
+        i.WriteHtonU16(m_prefixes.size());
+        i.WriteHtonU16(m_referenced.type);
+        i.WriteHtonU32(m_referenced.linkStateId);
+        i.WriteHtonU32(m_referenced.advertisingRouter);
+        for (const auto& prefix : m_prefixes)
+        {
+            uint8_t bytes[16];
+            prefix.address.GetBytes(bytes);
+            i.WriteU8(prefix.length);
+            i.WriteU8(0);           // prefix options
+            i.WriteHtonU16(prefix.metric);
+            i.Write(bytes, 4 * ((prefix.length + 31) / 32));
+        }
+        break;
+    default:
+        for (const auto& tlv : m_tlvs)
+        {
+            i.WriteHtonU16(tlv.type);
+            i.WriteHtonU16(tlv.value.size());
+            i.Write(tlv.value.data(), tlv.value.size());
+            for (size_t pad = tlv.value.size(); pad % 4 != 0; pad++)
+            {
+                i.WriteU8(0);
+            }
+        }
+        break;
+    }
+}
+
+uint32_t OspfLsa::Deserialize(Buffer::Iterator& i) {
+    m_header.Deserialize(i, m_version);
+    m_routerLinks.clear();
+    m_prefixes.clear();
+    m_tlvs.clear();
+
+    uint32_t read = OspfLsaHeader::SIZE;
+    if (m_header.type == ROUTER_LSA && m_header.length >= OspfLsaHeader::SIZE + 4)
+    {
+        i.ReadU8();
+        i.ReadU8();
+        uint16_t links = i.ReadNtohU16();
+        read += 4;
+        m_routerLinks.reserve(links);
+        for (uint16_t l = 0; l < links && read + 12 <= m_header.length; l++)
+        {
+            RouterLink link;
+            link.linkId = i.ReadNtohU32();
+            link.linkData = i.ReadNtohU32();
+            link.type = i.ReadU8();
+            uint8_t tos = i.ReadU8();
+            link.metric = i.ReadNtohU16();
+            link.neighborInterfaceId = 0;
+            read += 12;
+            // TOS metrics are not supported, skip them
+            i.Next(4 * tos);
+            read += 4 * tos;
+            m_routerLinks.push_back(link);
+        }
+    }
+    else if (m_header.type == V3_ROUTER_LSA && m_header.length >= OspfLsaHeader::SIZE + 4)
+    {
+        i.ReadNtohU32();            // flags and options
+        read += 4;
+        while (read + 16 <= m_header.length)
+        {
+            RouterLink link;
+            link.type = i.ReadU8();
+            i.ReadU8();
+            link.metric = i.ReadNtohU16();
+            link.linkData = i.ReadNtohU32();
+            link.neighborInterfaceId = i.ReadNtohU32();
+            link.linkId = i.ReadNtohU32();
+            read += 16;
+            m_routerLinks.push_back(link);
+        }
+    }
+    else if (m_header.type == V3_INTRA_AREA_PREFIX_LSA &&
+             m_header.length >= OspfLsaHeader::SIZE + 12)
+    {
+        uint16_t prefixes = i.ReadNtohU16();
+        m_referenced.type = i.ReadNtohU16();
+        m_referenced.linkStateId = i.ReadNtohU32();
+        m_referenced.advertisingRouter = i.ReadNtohU32();
+        read += 12;
+        for (uint16_t p = 0; p < prefixes && read + 4 <= m_header.length; p++)
+        {
+            AddressPrefix prefix;
+            prefix.length = std::min<uint8_t>(i.ReadU8(), 128);
+            i.ReadU8();
+            prefix.metric = i.ReadNtohU16();
+            uint32_t words = (prefix.length + 31) / 32;
+            read += 4;
+            if (read + 4 * words > m_header.length)
+            {
+                break;
+            }
+            uint8_t bytes[16] = {};
+            i.Read(bytes, 4 * words);
+            read += 4 * words;
+            prefix.address = Ipv6Address(bytes);
+            m_prefixes.push_back(prefix);
+        }
+    }
+    else if (HasTlvBody(m_header.type))
+    {
+        while (read + 4 <= m_header.length)
+        {
+            Tlv tlv;
+            tlv.type = i.ReadNtohU16();
+            uint16_t length = i.ReadNtohU16();
+            read += 4;
+            uint32_t padded = 4 * ((length + 3) / 4);
+            if (read + padded > m_header.length)
+            {
+                break;
+            }
+            tlv.value.resize(length);
+            i.Read(tlv.value.data(), length);
+            i.Next(padded - length);
+            read += padded;
+            m_tlvs.push_back(std::move(tlv));
+        }
+    }
+    // Skip what is left of the body, all of it for an unknown type
+    if (m_header.length > read)
+    {
+        i.Next(m_header.length - read);
+        read = m_header.length;
+    }
+    return read;
+}
+
+void OspfLsa::UpdateChecksum() {
+    m_header.length = GetSerializedSize();
+    Buffer buffer;
+    buffer.AddAtStart(m_header.length);
+    Buffer::Iterator i = buffer.Begin();
+    m_header.checksum = 0;
+    Serialize(i);
+    m_header.checksum = OspfLsaChecksum(buffer.PeekData(), m_header.length);
+}
+
+bool OspfLsa::IsChecksumOk() const {
+    Buffer buffer;
+    buffer.AddAtStart(GetSerializedSize());
+    Buffer::Iterator i = buffer.Begin();
+    Serialize(i);
+    return m_header.length == buffer.GetSize() &&
+           OspfLsaChecksumOk(buffer.PeekData(), buffer.GetSize());
+}
+
+void OspfLsa::Print(std::ostream& os) const {
+    os << m_header << " links " << m_routerLinks.size() << " prefixes " << m_prefixes.size()
+       << " TLVs " << m_tlvs.size();
+}
+
+}
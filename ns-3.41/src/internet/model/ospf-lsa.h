@@ -0,0 +1,336 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsa.h
+ *
+ *  Link State Advertisements (RFC 2328 A.4 for OSPFv2, RFC 5340 A.4 for
+ *  OSPFv3).
+ *
+ *  An LSA is shared (Ptr) between the LSDB, the neighbors' retransmission
+ *  lists and the LS Update packets it is flooded in, so it is never
+ *  modified once installed; a new instance is a new OspfLsa.
+ *
+ *  The LS age of an installed LSA is the age it was received with plus the
+ *  time it has spent in the LSDB, see OspfLsdb::GetAge. LSAs flooded over
+ *  demand circuits (RFC 1793) have the DoNotAge bit set in their LS age and
+ *  are not aged at all.
+ *
+ *  Both versions share the LSA header layout, except that OSPFv3 widens the
+ *  LS type to 16 bits in place of the options, and use the same flooding
+ *  and aging rules. OSPFv3 Router-LSAs carry no addresses: the prefixes of
+ *  a router are in its Intra-Area-Prefix-LSA instead.
+ *
+ *  Opaque LSAs (RFC 5250) and the OSPFv3 Grace-LSA (RFC 5187) have a body
+ *  of TLVs, kept here as type and value pairs. The Link TLV of the traffic
+ *  engineering LSA (RFC 3630) nests sub-TLVs in its value, see AddTeLink.
+ *
+ */
+
+#ifndef OSPF_LSA_H
+#define OSPF_LSA_H
+
+#include "ns3/buffer.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/simple-ref-count.h"
+
+#include <ostream>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Identifies an LSA in the LSDB (RFC 2328 12.1)
+ */
+struct OspfLsaKey
+{
+    uint16_t type;
+    uint32_t linkStateId;
+    uint32_t advertisingRouter;
+
+    bool operator<(const OspfLsaKey& other) const;
+    bool operator==(const OspfLsaKey& other) const;
+};
+
+/**
+ * The 20 byte LSA header (RFC 2328 A.4.1, RFC 5340 A.4.2), also carried on
+ * its own in Database Description and Link State Acknowledgment packets.
+ */
+struct OspfLsaHeader
+{
+    /// Size of a serialised LSA header
+    static const uint32_t SIZE = 20;
+
+    uint16_t age = 0;
+    uint8_t options = 0;        //!< OSPFv2 only
+    uint16_t type = 0;
+    uint32_t linkStateId = 0;
+    uint32_t advertisingRouter = 0;
+    int32_t sequence = 0;
+    uint16_t checksum = 0;
+    uint16_t length = SIZE;
+
+    /**
+     * \param i the iterator, advanced past the header
+     * \param version the OSPF version, 2 or 3
+     */
+    void Serialize(Buffer::Iterator& i, uint8_t version) const;
+    void Deserialize(Buffer::Iterator& i, uint8_t version);
+    OspfLsaKey GetKey() const;
+
+    /// \return the LS age without the DoNotAge bit
+    uint16_t GetAge() const;
+
+    /// \return true if the DoNotAge bit is set (RFC 1793 2.2)
+    bool IsDoNotAge() const;
+
+    /**
+     * \brief Compare two instances of the same LSA (RFC 2328 13.1).
+     * \param other the other instance
+     * \return true if this instance is more recent than other
+     */
+    bool IsMoreRecentThan(const OspfLsaHeader& other) const;
+
+    /**
+     * \param other the other instance
+     * \return true if neither instance is more recent than the other
+     */
+    bool IsSameInstance(const OspfLsaHeader& other) const;
+};
+
+std::ostream& operator<<(std::ostream& os, const OspfLsaHeader& header);
+
+class OspfLsa : public SimpleRefCount<OspfLsa>
+{
+  public:
+    /// LS types, the OSPFv3 ones with their U and S bits (area scope)
+    enum LsType
+    {
+        ROUTER_LSA = 1,
+        LINK_LOCAL_OPAQUE_LSA = 9,
+        AREA_LOCAL_OPAQUE_LSA = 10,
+        V3_ROUTER_LSA = 0x2001,
+        V3_INTRA_AREA_PREFIX_LSA = 0x2009,
+        V3_GRACE_LSA = 0x000b                   //!< Link-local scope
+    };
+
+    /// Opaque type of the OSPFv2 Grace-LSA, in the top byte of its LSID
+    static const uint8_t GRACE_OPAQUE_TYPE = 3;
+
+    /// Opaque type of the traffic engineering LSA (RFC 3630)
+    static const uint8_t TE_OPAQUE_TYPE = 1;
+
+    /// TLVs of a Grace-LSA (RFC 3623 Appendix A)
+    enum GraceTlvType
+    {
+        GRACE_PERIOD_TLV = 1,                   //!< Seconds, 32 bits
+        RESTART_REASON_TLV = 2,                 //!< 8 bits
+        INTERFACE_ADDRESS_TLV = 3               //!< OSPFv2 only
+    };
+
+    /// TLVs of a traffic engineering LSA (RFC 3630 2.4)
+    enum TeTlvType
+    {
+        TE_ROUTER_ADDRESS_TLV = 1,
+        TE_LINK_TLV = 2
+    };
+
+    /// Sub-TLVs of a Link TLV (RFC 3630 2.5) we use
+    enum TeLinkSubTlvType
+    {
+        TE_LINK_TYPE_SUB_TLV = 1,
+        TE_LINK_ID_SUB_TLV = 2,
+        TE_LOCAL_ADDRESS_SUB_TLV = 3,
+        TE_MAX_BANDWIDTH_SUB_TLV = 6,
+        TE_MAX_RESERVABLE_BANDWIDTH_SUB_TLV = 7,
+        TE_UNRESERVED_BANDWIDTH_SUB_TLV = 8,
+        TE_ADMIN_GROUP_SUB_TLV = 9
+    };
+
+    /// Router-LSA link types
+    enum LinkType
+    {
+        POINT_TO_POINT = 1,
+        TRANSIT_NETWORK = 2,
+        STUB_NETWORK = 3,
+        VIRTUAL_LINK = 4
+    };
+
+    /**
+     * A link of a Router-LSA (RFC 2328 A.4.2), TOS metrics are not supported.
+     * An OSPFv3 link (RFC 5340 A.4.3) is mapped onto the same fields: linkId
+     * is the neighbor's router ID and linkData our interface ID.
+     */
+    struct RouterLink
+    {
+        uint32_t linkId;
+        uint32_t linkData;
+        uint8_t type;
+        uint16_t metric;
+        uint32_t neighborInterfaceId;   //!< OSPFv3 only
+
+        bool operator==(const RouterLink& other) const;
+    };
+
+    /// A TLV of an Opaque LSA body, its value unpadded
+    struct Tlv
+    {
+        uint16_t type;
+        std::vector<uint8_t> value;
+
+        bool operator==(const Tlv& other) const;
+    };
+
+    /**
+     * The attributes of a point-to-point link carried in a Link TLV.
+     * Bandwidths are in bytes per second, as on the wire.
+     */
+    struct TeLink
+    {
+        uint32_t linkId = 0;                //!< Neighbor's router ID
+        uint32_t localAddress = 0;          //!< Our interface address
+        float maxBandwidth = 0;
+        float maxReservableBandwidth = 0;
+        float unreservedBandwidth = 0;      //!< The same at all eight priorities
+        uint32_t adminGroup = 0;            //!< Bit mask of administrative groups
+    };
+
+    /// A prefix of an Intra-Area-Prefix-LSA (RFC 5340 A.4.1 and A.4.10)
+    struct AddressPrefix
+    {
+        Ipv6Address address;
+        uint8_t length;
+        uint16_t metric;
+
+        bool operator==(const AddressPrefix& other) const;
+    };
+
+    static const uint16_t MAX_AGE = 3600;                   //!< MaxAge, seconds
+    static const int32_t INITIAL_SEQUENCE_NUMBER = 0x80000001;
+    static const int32_t MAX_SEQUENCE_NUMBER = 0x7fffffff;
+    static const uint32_t V3_OPTIONS = 0x13;                //!< V6, E and R bits
+    static const uint16_t MAX_LINK_METRIC = 0xffff;         //!< MaxLinkMetric (RFC 6987)
+    static const uint16_t DO_NOT_AGE = 0x8000;              //!< DoNotAge bit of the LS age
+    static const uint8_t DC_OPTION = 0x20;                  //!< Demand circuits option bit
+
+    /**
+     * \param version the OSPF version, 2 or 3, which decides the wire format
+     */
+    explicit OspfLsa(uint8_t version = 2);
+
+    OspfLsaHeader& GetHeader();
+    const OspfLsaHeader& GetHeader() const;
+    OspfLsaKey GetKey() const;
+
+    uint8_t GetVersion() const;
+
+    void AddRouterLink(uint32_t linkId,
+                       uint32_t linkData,
+                       uint8_t type,
+                       uint16_t metric,
+                       uint32_t neighborInterfaceId = 0);
+    const std::vector<RouterLink>& GetRouterLinks() const;
+
+    /**
+     * \brief Set the LSA an Intra-Area-Prefix-LSA attaches its prefixes to.
+     * \param key the referenced Router-LSA
+     */
+    void SetReferencedLsa(const OspfLsaKey& key);
+    const OspfLsaKey& GetReferencedLsa() const;
+    void AddPrefix(Ipv6Address address, uint8_t length, uint16_t metric);
+    const std::vector<AddressPrefix>& GetPrefixes() const;
+
+    /**
+     * \param type an LS type
+     * \return true if LSAs of the type have a body of TLVs
+     */
+    static bool HasTlvBody(uint16_t type);
+
+    void AddTlv(uint16_t type, const std::vector<uint8_t>& value);
+
+    /**
+     * \brief Add a TLV holding a 32 bit value in network order.
+     * \param type the TLV type
+     * \param value the value
+     */
+    void AddTlv(uint16_t type, uint32_t value);
+    const std::vector<Tlv>& GetTlvs() const;
+
+    /**
+     * \param type a TLV type
+     * \return the first TLV of the type, or nullptr
+     */
+    const Tlv* FindTlv(uint16_t type) const;
+
+    /**
+     * \brief Add a Link TLV to a traffic engineering LSA.
+     * \param link the link attributes
+     */
+    void AddTeLink(const TeLink& link);
+
+    /**
+     * \brief Decode the Link TLV of a traffic engineering LSA.
+     * \param link the link attributes, sub-TLVs missing from the TLV left as
+     * they are
+     * \return false if there is no Link TLV
+     */
+    bool GetTeLink(TeLink& link) const;
+
+    /**
+     * \param other another instance of the LSA
+     * \return true if the two instances have the same body, i.e. installing
+     * one over the other does not require a routing table calculation
+     * (RFC 2328 13.2)
+     */
+    bool HasSameContent(const OspfLsa& other) const;
+
+    uint32_t GetSerializedSize() const;
+
+    /**
+     * \brief Serialise the LSA.
+     * \param i the iterator, advanced past the LSA
+     * \param age the LS age to write in place of the stored one
+     */
+    void Serialize(Buffer::Iterator& i, uint16_t age) const;
+    void Serialize(Buffer::Iterator& i) const;
+
+    /**
+     * \brief Deserialise an LSA, header included.
+     * \param i the iterator, advanced past the LSA
+     * \return the number of bytes read
+     */
+    uint32_t Deserialize(Buffer::Iterator& i);
+
+    /**
+     * \brief Set the length and LS checksum in the header from the body.
+     * Must be called once the LSA is complete, before it is installed.
+     */
+    void UpdateChecksum();
+
+    /**
+     * \brief Verify the LS checksum. The LSA is reserialised, which is
+     * lossless for the LSA types we support.
+     * \return true if the checksum is correct
+     */
+    bool IsChecksumOk() const;
+
+    void Print(std::ostream& os) const;
+
+  private:
+    /// \return the size of the serialised LSA body, header excluded
+    uint32_t GetBodySize() const;
+
+    uint8_t m_version;                          //!< OSPF version of the wire format
+    OspfLsaHeader m_header;
+    std::vector<RouterLink> m_routerLinks;      //!< Router-LSA body
+    OspfLsaKey m_referenced;                    //!< Intra-Area-Prefix-LSA body
+    std::vector<AddressPrefix> m_prefixes;
+    std::vector<Tlv> m_tlvs;                    //!< Opaque and Grace-LSA body
+};
+
+}
+
+#endif // OSPF_LSA_H
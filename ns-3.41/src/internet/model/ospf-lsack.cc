@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsack.cc
+ *
+ */
+
+#include "ospf-lsack.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED(OspfLsAck);
+
+OspfLsAck::OspfLsAck()
+    : m_version(2)
+{
+}
+
+TypeId OspfLsAck::GetTypeId() {
+    static TypeId tid = TypeId("ns3::OspfLsAck")
+                            .SetParent<Header>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<OspfLsAck>();
+    return tid;
+}
+
+TypeId OspfLsAck::GetInstanceTypeId() const {
+    return GetTypeId();
+}
+
+void OspfLsAck::Print(std::ostream& os) const {
+    os << "headers " << m_headers.size();
+}
+
+uint32_t OspfLsAck::GetSerializedSize() const {
+    return OspfLsaHeader::SIZE * m_headers.size();
+}
+
+void OspfLsAck::Serialize(Buffer::Iterator start) const {
+    Buffer::Iterator i = start;
+
+    for (const auto& header : m_headers)
+    {
+        header.Serialize(i, m_version);
+    }
+}
+
+uint32_t OspfLsAck::Deserialize(Buffer::Iterator start) {
+    Buffer::Iterator i = start;
+
+    uint32_t headerNumber = i.GetRemainingSize() / OspfLsaHeader::SIZE;
+    m_headers.resize(headerNumber);
+    for (auto& header : m_headers)
+    {
+        header.Deserialize(i, m_version);
+    }
+
+    return GetSerializedSize();
+}
+
+void OspfLsAck::AddLsaHeader(const OspfLsaHeader& header) {
+    m_headers.push_back(header);
+}
+const std::vector<OspfLsaHeader>& OspfLsAck::GetLsaHeaders() const {
+    return m_headers;
+}
+void OspfLsAck::SetVersion(uint8_t version) {
+    m_version = version;
+}
+uint8_t OspfLsAck::GetVersion() const {
+    return m_version;
+}
+
+}
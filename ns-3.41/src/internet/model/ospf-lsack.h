@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsack.h
+ *
+ *  Body of an OSPF Link State Acknowledgment packet (RFC 2328 A.3.6), the
+ *  headers of the LSAs being acknowledged. The same in OSPFv3 (RFC 5340
+ *  A.3.6), except for the LSA header layout.
+ *
+ */
+
+#ifndef OSPF_LSACK_H
+#define OSPF_LSACK_H
+
+#include "ospf-lsa.h"
+
+#include "ns3/header.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+class OspfLsAck : public Header {
+public:
+    OspfLsAck();
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    void AddLsaHeader(const OspfLsaHeader& header);
+    const std::vector<OspfLsaHeader>& GetLsaHeaders() const;
+
+    /**
+     * \param version the OSPF version, 2 (the default) or 3, which decides
+     * the wire format. Must be set before the body is removed from a packet.
+     */
+    void SetVersion(uint8_t version);
+    uint8_t GetVersion() const;
+
+private:
+    uint8_t m_version;
+    std::vector<OspfLsaHeader> m_headers;
+};
+
+}
+
+#endif // OSPF_LSACK_H
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsdb.cc
+ *
+ */
+
+#include "ospf-lsdb.h"
+
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+OspfLsdb::OspfLsdb() {
+}
+
+Ptr<OspfLsa> OspfLsdb::Get(const OspfLsaKey& key) const {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        return nullptr;
+    }
+    return it->second.lsa;
+}
+
+Ptr<OspfLsa> OspfLsdb::Install(Ptr<OspfLsa> lsa) {
+    Entry& entry = m_entries[lsa->GetKey()];
+    Ptr<OspfLsa> previous = entry.lsa;
+    entry.lsa = lsa;
+    entry.installed = Simulator::Now();
+    return previous;
+}
+
+void OspfLsdb::Remove(const OspfLsaKey& key) {
+    m_entries.erase(key);
+}
+
+void OspfLsdb::Clear() {
+    m_entries.clear();
+}
+
+uint16_t OspfLsdb::GetAge(const Entry& entry) const {
+    uint16_t age = entry.lsa->GetHeader().GetAge();
+    if (age >= OspfLsa::MAX_AGE)
+    {
+        return OspfLsa::MAX_AGE;
+    }
+    if (entry.lsa->GetHeader().IsDoNotAge())
+    {
+        return age;
+    }
+    int64_t elapsed = (Simulator::Now() - entry.installed).GetSeconds();
+    return static_cast<uint16_t>(std::min<int64_t>(age + elapsed, OspfLsa::MAX_AGE));
+}
+
+uint16_t OspfLsdb::GetAge(const OspfLsaKey& key) const {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        return OspfLsa::MAX_AGE;
+    }
+    return GetAge(it->second);
+}
+
+OspfLsaHeader OspfLsdb::GetCurrentHeader(const OspfLsaKey& key) const {
+    auto it = m_entries.find(key);
+    OspfLsaHeader header = it->second.lsa->GetHeader();
+    header.age = GetAge(it->second) | (header.age & OspfLsa::DO_NOT_AGE);
+    return header;
+}
+
+std::vector<OspfLsaHeader> OspfLsdb::GetHeaders() const {
+    std::vector<OspfLsaHeader> headers;
+    headers.reserve(m_entries.size());
+    for (const auto& item : m_entries)
+    {
+        headers.push_back(item.second.lsa->GetHeader());
+        headers.back().age = GetAge(item.second) | (headers.back().age & OspfLsa::DO_NOT_AGE);
+    }
+    return headers;
+}
+
+const OspfLsdb::EntryMap& OspfLsdb::GetEntries() const {
+    return m_entries;
+}
+
+uint32_t OspfLsdb::GetSize() const {
+    return m_entries.size();
+}
+
+}
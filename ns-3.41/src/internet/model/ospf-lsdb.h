@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsdb.h
+ *
+ *  The link state database of an area (RFC 2328 12). LSAs are stored with
+ *  the time they were installed so that their age can be computed when it
+ *  is needed instead of being incremented every second.
+ *
+ */
+
+#ifndef OSPF_LSDB_H
+#define OSPF_LSDB_H
+
+#include "ospf-lsa.h"
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+class OspfLsdb {
+public:
+    struct Entry
+    {
+        Ptr<OspfLsa> lsa;
+        Time installed;     //!< Simulation time the LSA was installed
+    };
+
+    typedef std::map<OspfLsaKey, Entry> EntryMap;
+
+    OspfLsdb();
+
+    /**
+     * \param key an LSA
+     * \return the database copy of the LSA, or nullptr
+     */
+    Ptr<OspfLsa> Get(const OspfLsaKey& key) const;
+
+    /**
+     * \brief Install an LSA, replacing any previous instance.
+     * \param lsa the LSA
+     * \return the previous instance, or nullptr
+     */
+    Ptr<OspfLsa> Install(Ptr<OspfLsa> lsa);
+    void Remove(const OspfLsaKey& key);
+    void Clear();
+
+    /**
+     * \param key an LSA
+     * \return the current LS age of the LSA in seconds, capped at MaxAge,
+     * without the DoNotAge bit. A DoNotAge LSA keeps the age it was
+     * installed with.
+     */
+    uint16_t GetAge(const OspfLsaKey& key) const;
+    uint16_t GetAge(const Entry& entry) const;
+
+    /**
+     * \param key an LSA
+     * \return the header of the database copy with its current age, and
+     * its DoNotAge bit
+     */
+    OspfLsaHeader GetCurrentHeader(const OspfLsaKey& key) const;
+
+    /**
+     * \return the headers of all LSAs with their current ages, e.g. to
+     * build a Database summary list
+     */
+    std::vector<OspfLsaHeader> GetHeaders() const;
+
+    const EntryMap& GetEntries() const;
+    uint32_t GetSize() const;
+
+private:
+    EntryMap m_entries;
+};
+
+}
+
+#endif // OSPF_LSDB_H
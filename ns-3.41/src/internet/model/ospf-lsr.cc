@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsr.cc
+ *
+ */
+
+#include "ospf-lsr.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED(OspfLsRequest);
+
+const uint32_t OspfLsRequest::ENTRY_SIZE;
+
+OspfLsRequest::OspfLsRequest() {
+}
+
+TypeId OspfLsRequest::GetTypeId() {
+    static TypeId tid = TypeId("ns3::OspfLsRequest")
+                            .SetParent<Header>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<OspfLsRequest>();
+    return tid;
+}
+
+TypeId OspfLsRequest::GetInstanceTypeId() const {
+    return GetTypeId();
+}
+
+void OspfLsRequest::Print(std::ostream& os) const {
+    os << "requests " << m_requests.size();
+}
+
+uint32_t OspfLsRequest::GetSerializedSize() const {
+    return ENTRY_SIZE * m_requests.size();
+}
+
+void OspfLsRequest::Serialize(Buffer::Iterator start) const {
+    Buffer::Iterator i = start;
+
+    for (const auto& key : m_requests)
+    {
+        i.WriteHtonU32(key.type);
+        i.WriteHtonU32(key.linkStateId);
+        i.WriteHtonU32(key.advertisingRouter);
+    }
+}
+
+uint32_t OspfLsRequest::Deserialize(Buffer::Iterator start) {
+    Buffer::Iterator i = start;
+
+    uint32_t requestNumber = i.GetRemainingSize() / ENTRY_SIZE;
+    m_requests.resize(requestNumber);
+    for (auto& key : m_requests)
+    {
+        key.type = i.ReadNtohU32();
+        key.linkStateId = i.ReadNtohU32();
+        key.advertisingRouter = i.ReadNtohU32();
+    }
+
+    return GetSerializedSize();
+}
+
+void OspfLsRequest::AddRequest(const OspfLsaKey& key) {
+    m_requests.push_back(key);
+}
+const std::vector<OspfLsaKey>& OspfLsRequest::GetRequests() const {
+    return m_requests;
+}
+
+}
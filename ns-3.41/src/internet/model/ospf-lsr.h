@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsr.h
+ *
+ *  Body of an OSPF Link State Request packet (RFC 2328 A.3.4), a list of
+ *  LSAs identified by (LS type, link state ID, advertising router), 12
+ *  bytes each.
+ *
+ */
+
+#ifndef OSPF_LSR_H
+#define OSPF_LSR_H
+
+#include "ospf-lsa.h"
+
+#include "ns3/header.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+class OspfLsRequest : public Header {
+public:
+    /// Size of one request
+    static const uint32_t ENTRY_SIZE = 12;
+
+    OspfLsRequest();
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    void AddRequest(const OspfLsaKey& key);
+    const std::vector<OspfLsaKey>& GetRequests() const;
+
+private:
+    std::vector<OspfLsaKey> m_requests;
+};
+
+}
+
+#endif // OSPF_LSR_H
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsu.cc
+ *
+ */
+
+#include "ospf-lsu.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED(OspfLsUpdate);
+
+OspfLsUpdate::OspfLsUpdate()
+    : m_version(2),
+      m_size(4)
+{
+}
+
+TypeId OspfLsUpdate::GetTypeId() {
+    static TypeId tid = TypeId("ns3::OspfLsUpdate")
+                            .SetParent<Header>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<OspfLsUpdate>();
+    return tid;
+}
+
+TypeId OspfLsUpdate::GetInstanceTypeId() const {
+    return GetTypeId();
+}
+
+void OspfLsUpdate::Print(std::ostream& os) const {
+    os << "LSAs " << m_lsas.size();
+}
+
+uint32_t OspfLsUpdate::GetSerializedSize() const {
+    return m_size;
+}
+
+void OspfLsUpdate::Serialize(Buffer::Iterator start) const {
+    Buffer::Iterator i = start;
+
+    i.WriteHtonU32(m_lsas.size());
+    for (size_t l = 0; l < m_lsas.size(); l++)
+    {
+        m_lsas[l]->Serialize(i, m_ages[l]);
+    }
+}
+
+uint32_t OspfLsUpdate::Deserialize(Buffer::Iterator start) {
+    Buffer::Iterator i = start;
+
+    m_lsas.clear();
+    m_ages.clear();
+    uint32_t lsaNumber = i.ReadNtohU32();
+    m_size = 4;
+    for (uint32_t l = 0; l < lsaNumber && i.GetRemainingSize() >= OspfLsaHeader::SIZE; l++)
+    {
+        Ptr<OspfLsa> lsa = Create<OspfLsa>(m_version);
+        m_size += lsa->Deserialize(i);
+        m_lsas.push_back(lsa);
+        m_ages.push_back(lsa->GetHeader().age);
+    }
+
+    return m_size;
+}
+
+void OspfLsUpdate::AddLsa(Ptr<OspfLsa> lsa, uint16_t age) {
+    m_size += lsa->GetSerializedSize();
+    m_lsas.push_back(lsa);
+    m_ages.push_back(age);
+}
+
+const std::vector<Ptr<OspfLsa>>& OspfLsUpdate::GetLsas() const {
+    return m_lsas;
+}
+
+uint32_t OspfLsUpdate::GetLsaNumber() const {
+    return m_lsas.size();
+}
+
+void OspfLsUpdate::SetVersion(uint8_t version) {
+    m_version = version;
+}
+uint8_t OspfLsUpdate::GetVersion() const {
+    return m_version;
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-lsu.h
+ *
+ *  Body of an OSPF Link State Update packet (RFC 2328 A.3.5, RFC 5340 A.3.5).
+ *
+ *    # LSAs (4)
+ *    LSAs
+ *
+ *  The LSAs are shared with the sender's LSDB, so the LS age to transmit
+ *  each one with is kept alongside it rather than written into the LSA.
+ *
+ */
+
+#ifndef OSPF_LSU_H
+#define OSPF_LSU_H
+
+#include "ospf-lsa.h"
+
+#include "ns3/header.h"
+#include "ns3/ptr.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+class OspfLsUpdate : public Header {
+public:
+    OspfLsUpdate();
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    /**
+     * \param lsa the LSA to carry
+     * \param age the LS age to send it with
+     */
+    void AddLsa(Ptr<OspfLsa> lsa, uint16_t age);
+
+    /**
+     * \return the LSAs, each carrying the age it was received with
+     */
+    const std::vector<Ptr<OspfLsa>>& GetLsas() const;
+    uint32_t GetLsaNumber() const;
+
+    /**
+     * \param version the OSPF version, 2 (the default) or 3, which decides
+     * the wire format. Must be set before the body is removed from a packet.
+     */
+    void SetVersion(uint8_t version);
+    uint8_t GetVersion() const;
+
+private:
+    uint8_t m_version;
+    std::vector<Ptr<OspfLsa>> m_lsas;
+    std::vector<uint16_t> m_ages;
+    uint32_t m_size;                    //!< Serialised size
+};
+
+}
+
+#endif // OSPF_LSU_H
@@ -8,6 +8,7 @@
  */
 
 #include "ospf-neighbor-table.h"
+#include "ospf-l4-protocol.h"
 
 
 namespace ns3
@@ -17,52 +18,71 @@ OspfNeighborTable::OspfNeighborTable() {
 
 }
 
-void OspfNeighborTable::addNeighbors(ns3::Ipv4Address ip_add, ns3::Ipv4Mask net_mask, Ptr<ns3::Ipv4Interface> ip_interface, int current_state, uint32_t r_id)
+void OspfNeighborTable::addNeighbors(ns3::Ipv4Address ip_add, ns3::Ipv4Mask net_mask, uint32_t interface, int current_state, uint32_t r_id)
 {
-    neighborItems new_neighbor = {ip_add, net_mask, ip_interface, current_state, r_id};
-    m_neighbors.push_back({new_neighbor});
+    neighborItems new_neighbor;
+    new_neighbor.ipAdd = ip_add;
+    new_neighbor.netMask = net_mask;
+    new_neighbor.interface = interface;
+    new_neighbor.state = current_state;
+    new_neighbor.router_id = r_id;
+    m_neighbors.push_back(new_neighbor);
 }
 
-void OspfNeighborTable::set_State(int new_state, uint32_t r_id){
-    for (auto& row : m_neighbors){
-        for (auto& neighborItems : row){
-            if (neighborItems.router_id == r_id){
-                neighborItems.state = new_state;
-            }
+OspfNeighborTable::neighborItems* OspfNeighborTable::findNeighbor(uint32_t r_id, uint32_t interface){
+    for (auto& neighborItems : m_neighbors){
+        if (neighborItems.router_id == r_id && neighborItems.interface == interface){
+            return &neighborItems;
         }
     }
+    return nullptr;
 }
 
-int OspfNeighborTable::get_State(uint32_t r_id){
-    int state;
-    for (auto& row : m_neighbors){
-        for (auto& neighborItems : row){
-            if (neighborItems.router_id == r_id){
-                state = neighborItems.state;
-            }
+std::vector<uint32_t> OspfNeighborTable::getNeighborIds(uint32_t interface) const{
+    std::vector<uint32_t> ids;
+    for (const auto& neighborItems : m_neighbors){
+        if (neighborItems.interface == interface){
+            ids.push_back(neighborItems.router_id);
         }
     }
-    return state;
+    return ids;
 }
 
-void OspfNeighborTable::delete_neighbor(uint32_t r_id){
+void OspfNeighborTable::set_State(int new_state, uint32_t r_id, uint32_t interface){
+    neighborItems* neighbor = findNeighbor(r_id, interface);
+    if (neighbor != nullptr){
+        neighbor->state = new_state;
+    }
+}
+
+int OspfNeighborTable::get_State(uint32_t r_id, uint32_t interface){
+    neighborItems* neighbor = findNeighbor(r_id, interface);
+    if (neighbor == nullptr){
+        return OspfL4Protocol::States::DOWN;
+    }
+    return neighbor->state;
+}
+
+void OspfNeighborTable::delete_neighbor(uint32_t r_id, uint32_t interface){
     for (auto it = m_neighbors.begin(); it != m_neighbors.end(); ++it){
-        bool found = false;
-        for (const auto& neighborItems : *it){
-            if (neighborItems.router_id == r_id){
-                found = true;
-                break;
-            }
-        }
-        if (found){
+        if (it->router_id == r_id && it->interface == interface){
+            it->inactivityTimer.Cancel();
+            it->ddRetransmit.Cancel();
+            it->lsrRetransmit.Cancel();
+            it->lsuRetransmit.Cancel();
+            it->lsuFlush.Cancel();
             m_neighbors.erase(it);
             break;
         }
     }
 }
 
-OspfNeighborTable::neighborList OspfNeighborTable::getCurrentNeighbors() {
+const OspfNeighborTable::neighborList& OspfNeighborTable::getCurrentNeighbors() const {
     return m_neighbors;
 }
 
-}
\ No newline at end of file
+OspfNeighborTable::neighborList& OspfNeighborTable::getCurrentNeighbors() {
+    return m_neighbors;
+}
+
+}
@@ -5,6 +5,15 @@
  *
  *  File: ospf-neighbor-table.h
  *
+ *  Neighbors are keyed by (router ID, interface index): the same router may
+ *  be a neighbor on more than one interface.
+ *
+ *  OSPFv3 neighbors are known by their link-local address and interface ID
+ *  instead of an IPv4 address and mask.
+ *
+ *  Every 2-Way neighbor becomes adjacent (there is no DR election), so the
+ *  database exchange and flooding state of RFC 2328 10 lives here too.
+ *
  */
 
 #ifndef OSPF_NEIGHBOR_TABLE_H
@@ -13,9 +22,13 @@
 #include <stdint.h>
 #include <string>
 #include "ipv4.h"
-#include "ns3/ipv4-interface.h"
-#include "ns3/ptr.h"
-#include <list>
+#include "ospf-lsa.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/packet.h"
+#include <map>
+#include <vector>
 #include <stdint.h>
 
 namespace ns3 {
@@ -25,19 +38,58 @@ public:
     struct neighborItems{
         Ipv4Address ipAdd;
         Ipv4Mask netMask;
-        Ptr<Ipv4Interface> ipInterface;
+        Ipv6Address ip6Add;         //!< Link-local address (OSPFv3)
+        uint32_t interfaceId = 0;   //!< The neighbor's interface ID (OSPFv3)
+        uint32_t interface;
         int state;
         uint32_t router_id;
+        EventId inactivityTimer;    //!< RouterDeadInterval timer
+        bool demandCircuit = false; //!< Both ends run the link as a demand circuit
+
+        // Database exchange, from ExStart on
+        bool master = false;                        //!< We are the master of the exchange
+        uint32_t ddSequence = 0;                    //!< DD sequence number
+        bool moreToReceive = true;                  //!< M bit of the neighbor's last DBD
+        std::vector<OspfLsaHeader> summaryList;     //!< Database summary list
+        size_t summaryNext = 0;                     //!< First summary not yet described
+        Ptr<Packet> lastDbd;                        //!< Last DBD body sent
+        uint8_t lastDbdFlags = 0;                   //!< Flags of the last DBD sent
+        EventId ddRetransmit;                       //!< DBD retransmission (master)
+
+        // Flooding, from Exchange on
+        std::map<OspfLsaKey, OspfLsaHeader> requestList;        //!< LSAs to request
+        std::vector<OspfLsaKey> lastRequested;                   //!< Content of the last LSR
+        EventId lsrRetransmit;
+        std::map<OspfLsaKey, Ptr<OspfLsa>> retransmissionList;  //!< Flooded, not acknowledged
+        EventId lsuRetransmit;
+        std::vector<Ptr<OspfLsa>> pendingUpdates;               //!< LSAs for the next LSU
+        EventId lsuFlush;
     };
 
-    typedef std::vector<std::vector<neighborItems>> neighborList;
+    typedef std::vector<neighborItems> neighborList;
     OspfNeighborTable();
 
-    void addNeighbors(Ipv4Address, Ipv4Mask, Ptr<Ipv4Interface>, int, uint32_t);
-    neighborList getCurrentNeighbors();
-    void set_State(int, uint32_t);
-    void delete_neighbor(uint32_t);
-    int get_State(uint32_t);
+    void addNeighbors(Ipv4Address, Ipv4Mask, uint32_t, int, uint32_t);
+    const neighborList& getCurrentNeighbors() const;
+    neighborList& getCurrentNeighbors();
+
+    /**
+     * \brief Find a neighbor.
+     * \param r_id the neighbor's router ID
+     * \param interface the interface the neighbor was heard on
+     * \return the neighbor, or nullptr if unknown. Invalidated by addNeighbors
+     * and delete_neighbor.
+     */
+    neighborItems* findNeighbor(uint32_t r_id, uint32_t interface);
+
+    /**
+     * \param interface an interface index
+     * \return the router IDs of the neighbors heard on the interface
+     */
+    std::vector<uint32_t> getNeighborIds(uint32_t interface) const;
+    void set_State(int, uint32_t, uint32_t);
+    void delete_neighbor(uint32_t, uint32_t);
+    int get_State(uint32_t, uint32_t);
 
 private:
     neighborList m_neighbors;
@@ -45,4 +97,4 @@ private:
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -6,7 +6,89 @@
  *
  *  File: ospf-routing-table-entry.cc
  *
- *  Declares OspfRoutingTableEntry which subclasses Ipv4RoutingTableEntry
+ *  Declares OspfRoutingTableEntry which subclasses Ipv4RoutingTableEntry,
+ *  and Ospf6RoutingTableEntry its OSPFv3 counterpart
  *
  */
 
+#include "ospf-routing-table-entry.h"
+
+namespace ns3 {
+
+OspfRoutingTableEntry::OspfRoutingTableEntry()
+    : m_metric(0)
+{
+}
+
+OspfRoutingTableEntry::OspfRoutingTableEntry(Ipv4Address network,
+                                             Ipv4Mask networkPrefix,
+                                             Ipv4Address nextHop,
+                                             uint32_t interface)
+    : Ipv4RoutingTableEntry(
+          Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkPrefix, nextHop, interface)),
+      m_metric(0)
+{
+}
+
+OspfRoutingTableEntry::OspfRoutingTableEntry(Ipv4Address network,
+                                             Ipv4Mask networkPrefix,
+                                             uint32_t interface)
+    : Ipv4RoutingTableEntry(
+          Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkPrefix, interface)),
+      m_metric(0)
+{
+}
+
+OspfRoutingTableEntry::~OspfRoutingTableEntry()
+{
+}
+
+void OspfRoutingTableEntry::SetMetric(uint32_t metric)
+{
+    m_metric = metric;
+}
+
+uint32_t OspfRoutingTableEntry::GetMetric() const
+{
+    return m_metric;
+}
+
+Ospf6RoutingTableEntry::Ospf6RoutingTableEntry()
+    : m_metric(0)
+{
+}
+
+Ospf6RoutingTableEntry::Ospf6RoutingTableEntry(Ipv6Address network,
+                                               Ipv6Prefix networkPrefix,
+                                               Ipv6Address nextHop,
+                                               uint32_t interface)
+    : Ipv6RoutingTableEntry(
+          Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkPrefix, nextHop, interface)),
+      m_metric(0)
+{
+}
+
+Ospf6RoutingTableEntry::Ospf6RoutingTableEntry(Ipv6Address network,
+                                               Ipv6Prefix networkPrefix,
+                                               uint32_t interface)
+    : Ipv6RoutingTableEntry(
+          Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkPrefix, interface)),
+      m_metric(0)
+{
+}
+
+Ospf6RoutingTableEntry::~Ospf6RoutingTableEntry()
+{
+}
+
+void Ospf6RoutingTableEntry::SetMetric(uint32_t metric)
+{
+    m_metric = metric;
+}
+
+uint32_t Ospf6RoutingTableEntry::GetMetric() const
+{
+    return m_metric;
+}
+
+}
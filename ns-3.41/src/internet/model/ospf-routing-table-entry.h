@@ -6,7 +6,8 @@
  *
  *  File: ospf-routing-table-entry.h
  *
- *  Declares OspfRoutingTableEntry which subclasses Ipv4RoutingTableEntry
+ *  Declares OspfRoutingTableEntry which subclasses Ipv4RoutingTableEntry,
+ *  and Ospf6RoutingTableEntry its OSPFv3 counterpart
  *
  */
 
@@ -17,6 +18,7 @@
 #include "ipv4-l3-protocol.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4-routing-table-entry.h"
+#include "ipv6-routing-table-entry.h"
 #include "ospf-header.h"
 
 namespace ns3 {
@@ -49,10 +51,63 @@ class OspfRoutingTableEntry : public Ipv4RoutingTableEntry {
 
     virtual ~OspfRoutingTableEntry();
 
+    /**
+     * \brief Set the cost of the path to the destination.
+     * \param metric the cost
+     */
+    void SetMetric(uint32_t metric);
 
+    /**
+     * \return the cost of the path to the destination
+     */
+    uint32_t GetMetric() const;
 
+  private:
+    uint32_t m_metric; //!< Cost of the path
 };
 
+class Ospf6RoutingTableEntry : public Ipv6RoutingTableEntry {
+
+  public:
+
+    Ospf6RoutingTableEntry();
+
+    /**
+     * \brief Constructor
+     * \param network network address
+     * \param networkPrefix network prefix
+     * \param nextHop next hop address to route the packet, link-local
+     * \param interface interface index
+     */
+    Ospf6RoutingTableEntry(Ipv6Address network,
+                           Ipv6Prefix networkPrefix,
+                           Ipv6Address nextHop,
+                           uint32_t interface);
+
+    /**
+     * \brief Constructor
+     * \param network network address
+     * \param networkPrefix network prefix
+     * \param interface interface index
+     */
+    Ospf6RoutingTableEntry(Ipv6Address network, Ipv6Prefix networkPrefix, uint32_t interface);
+
+    virtual ~Ospf6RoutingTableEntry();
+
+    /**
+     * \brief Set the cost of the path to the destination.
+     * \param metric the cost
+     */
+    void SetMetric(uint32_t metric);
+
+    /**
+     * \return the cost of the path to the destination
+     */
+    uint32_t GetMetric() const;
+
+  private:
+    uint32_t m_metric; //!< Cost of the path
+};
 
 
 }
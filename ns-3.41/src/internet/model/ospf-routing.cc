@@ -11,9 +11,16 @@
 #include "ospf-l4-protocol.h"
 #include "ospf-header.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
+#include "ns3/names.h"
 #include "ns3/simulator.h"
 #include "ns3/node.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
 
 #define OSPF_ALL_NODE "224.0.0.5"
 
@@ -23,24 +30,112 @@ namespace ns3
 NS_LOG_COMPONENT_DEFINE("OspfRouting");
 NS_OBJECT_ENSURE_REGISTERED(OspfRouting);
 
-OspfRouting::OspfRouting() : m_ipv4(nullptr){
+OspfRouting::OspfRouting() : m_ipv4(nullptr), m_frozen(false), m_routeCacheSize(0),
+        m_routeGeneration(0), m_routeCacheGeneration(0), m_maxMetricUntilConverged(false),
+        m_allDemandCircuits(false){
     m_ospf_protocol = CreateObject<OspfL4Protocol>();
 }
 OspfRouting::~OspfRouting() {
     //NS_LOG_FUNCTION(this);
 }
 TypeId OspfRouting::GetTypeId() {
-    static TypeId tid;
-    tid = TypeId("ns3::OspfRouting")
+    static TypeId tid = TypeId("ns3::OspfRouting")
             .SetParent<Ipv4RoutingProtocol>()
             .SetGroupName("Internet")
-            .AddConstructor<OspfRouting>();
+            .AddConstructor<OspfRouting>()
+            .AddAttribute("SpfDelay",
+                          "The time between an LSDB change and the routing table calculation.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&OspfRouting::m_spfDelay),
+                          MakeTimeChecker())
+            .AddAttribute("MaxMetricOnStartup",
+                          "The time after startup during which our links are advertised "
+                          "with MaxLinkMetric (RFC 6987), zero for none. With "
+                          "MaxMetricUntilConverged, the longest such time.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&OspfRouting::m_maxMetricOnStartup),
+                          MakeTimeChecker())
+            .AddAttribute("MaxMetricUntilConverged",
+                          "Whether our links are advertised with MaxLinkMetric from startup "
+                          "until our routing table is calculated over a synchronised LSDB.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&OspfRouting::m_maxMetricUntilConverged),
+                          MakeBooleanChecker())
+            .AddAttribute("RouteCacheSize",
+                          "The number of destinations whose routes are kept for locally "
+                          "originated packets until the routing table changes, zero for none. "
+                          "The cache is emptied when full.",
+                          UintegerValue(256),
+                          MakeUintegerAccessor(&OspfRouting::m_routeCacheSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("DemandCircuits",
+                          "Whether every interface is run as a demand circuit (RFC 1793), "
+                          "e.g. throughout an area of long and stable runs.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&OspfRouting::m_allDemandCircuits),
+                          MakeBooleanChecker());
     return tid;
 }
 
 Ptr<Ipv4Route> OspfRouting::RouteOutput(Ptr<Packet> p, const Ipv4Header& header, Ptr<NetDevice> oif, Socket::SocketErrno& sockerr)
 {
-    return nullptr;
+    NS_LOG_FUNCTION(this << header << oif);
+
+    Ipv4Address destination = header.GetDestination();
+    if (destination.IsMulticast())
+    {
+        // OSPF's own multicast packets carry their route, see OspfL4Protocol::Send
+        NS_LOG_LOGIC("RouteOutput (): Multicast destination");
+    }
+
+    Ptr<Ipv4Route> rtentry;
+    if (oif || destination.IsLocalMulticast())
+    {
+        rtentry = Lookup(destination, true, oif);
+    }
+    else if (m_frozen)
+    {
+        rtentry = m_fib.Lookup(destination);
+    }
+    else if (m_routeCacheSize > 0)
+    {
+        // Routes of the previous generations are stale, drop them lazily
+        if (m_routeCacheGeneration != m_routeGeneration)
+        {
+            m_routeCache.clear();
+            m_routeCacheGeneration = m_routeGeneration;
+        }
+        auto cached = m_routeCache.find(destination.Get());
+        if (cached != m_routeCache.end())
+        {
+            rtentry = cached->second;
+        }
+        else
+        {
+            rtentry = Lookup(destination, true);
+            if (rtentry)
+            {
+                if (m_routeCache.size() >= m_routeCacheSize)
+                {
+                    m_routeCache.clear();
+                }
+                m_routeCache.emplace(destination.Get(), rtentry);
+            }
+        }
+    }
+    else
+    {
+        rtentry = Lookup(destination, true);
+    }
+    if (rtentry)
+    {
+        sockerr = Socket::ERROR_NOTERROR;
+    }
+    else
+    {
+        sockerr = Socket::ERROR_NOROUTETOHOST;
+    }
+    return rtentry;
 }
 bool OspfRouting::RouteInput(Ptr<const Packet> p,
                 const Ipv4Header& header,
@@ -50,22 +145,140 @@ bool OspfRouting::RouteInput(Ptr<const Packet> p,
                 const LocalDeliverCallback& lcb,
                 const ErrorCallback& ecb)
 {
+    NS_LOG_FUNCTION(this << p << header << header.GetSource() << header.GetDestination() << idev);
+
+    NS_ASSERT(m_ipv4);
+    NS_ASSERT(m_ipv4->GetInterfaceForDevice(idev) >= 0);
+    uint32_t iif = m_ipv4->GetInterfaceForDevice(idev);
+    Ipv4Address dst = header.GetDestination();
+
+    if (m_ipv4->IsDestinationAddress(dst, iif))
+    {
+        if (!lcb.IsNull())
+        {
+            NS_LOG_LOGIC("Local delivery to " << dst);
+            lcb(p, header, iif);
+            return true;
+        }
+        // Possibly multicast or broadcast, let another protocol handle it
+        return false;
+    }
+
+    if (dst.IsMulticast())
+    {
+        NS_LOG_LOGIC("Multicast route not supported by OSPF");
+        return false;
+    }
+
+    if (dst.IsBroadcast())
+    {
+        NS_LOG_LOGIC("Dropping packet not for me and with dst Broadcast");
+        if (!ecb.IsNull())
+        {
+            ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+        }
+        return false;
+    }
+
+    if (!m_ipv4->IsForwarding(iif))
+    {
+        NS_LOG_LOGIC("Forwarding disabled for this interface");
+        if (!ecb.IsNull())
+        {
+            ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+        }
+        return true;
+    }
+
+    Ptr<Ipv4Route> rtentry = m_frozen ? m_fib.Lookup(dst) : Lookup(dst, false);
+    if (rtentry)
+    {
+        NS_LOG_LOGIC("Found unicast destination - calling unicast callback");
+        ucb(rtentry, p, header);
+        return true;
+    }
+    NS_LOG_LOGIC("Did not find unicast destination - returning false");
     return false;
 }
 void OspfRouting::NotifyInterfaceUp(uint32_t interface){
-
+    NS_LOG_FUNCTION(this << interface);
+    Thaw();
+    m_ospf_protocol->NotifyInterfaceChange(interface);
 }
 void OspfRouting::NotifyInterfaceDown(uint32_t interface){
-
+    NS_LOG_FUNCTION(this << interface);
+    Thaw();
+    m_ospf_protocol->NotifyInterfaceChange(interface);
 }
 void OspfRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address){
-
+    NS_LOG_FUNCTION(this << interface << address);
+    Thaw();
+    m_ospf_protocol->NotifyInterfaceChange(interface);
 }
 void OspfRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address){
-
+    NS_LOG_FUNCTION(this << interface << address);
+    Thaw();
+    m_ospf_protocol->NotifyInterfaceChange(interface);
 }
 void OspfRouting::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const{
+    std::ostream* os = stream->GetStream();
+    // Copy the current ostream state
+    std::ios oldState(nullptr);
+    oldState.copyfmt(*os);
+
+    *os << std::resetiosflags(std::ios::adjustfield) << std::setiosflags(std::ios::left);
 
+    *os << "Node: " << m_ipv4->GetObject<Node>()->GetId() << ", Time: " << Now().As(unit)
+        << ", Local time: " << m_ipv4->GetObject<Node>()->GetLocalTime().As(unit)
+        << ", IPv4 OSPF table" << std::endl;
+
+    if (!m_routes.empty())
+    {
+        *os << "Destination     Gateway         Genmask         Flags Metric Ref    Use Iface"
+            << std::endl;
+        for (const auto& route : m_routes)
+        {
+            std::ostringstream dest;
+            std::ostringstream gw;
+            std::ostringstream mask;
+            std::ostringstream flags;
+            dest << route.GetDest();
+            *os << std::setw(16) << dest.str();
+            gw << route.GetGateway();
+            *os << std::setw(16) << gw.str();
+            mask << route.GetDestNetworkMask();
+            *os << std::setw(16) << mask.str();
+            flags << "U";
+            if (route.IsHost())
+            {
+                flags << "H";
+            }
+            else if (route.IsGateway())
+            {
+                flags << "G";
+            }
+            *os << std::setw(6) << flags.str();
+            *os << std::setw(7) << route.GetMetric();
+            // Ref ct not implemented
+            *os << "-"
+                << "      ";
+            // Use not implemented
+            *os << "-"
+                << "   ";
+            if (!Names::FindName(m_ipv4->GetNetDevice(route.GetInterface())).empty())
+            {
+                *os << Names::FindName(m_ipv4->GetNetDevice(route.GetInterface()));
+            }
+            else
+            {
+                *os << route.GetInterface();
+            }
+            *os << std::endl;
+        }
+    }
+    *os << std::endl;
+    // Restore the previous ostream state
+    (*os).copyfmt(oldState);
 }
 
 void OspfRouting::DoInitialize() {
@@ -74,17 +287,50 @@ void OspfRouting::DoInitialize() {
     m_ospf_protocol->SetNode(node);
     m_ospf_protocol->SetIpv4(m_ipv4);
     m_ospf_protocol->SetExclusions(m_interfaceExclusions);
+    m_ospf_protocol->SetPrefixSuppressions(m_prefixSuppressions);
+    m_ospf_protocol->SetDemandCircuits(m_demandCircuits, m_allDemandCircuits);
+    m_ospf_protocol->SetInterfaceMetrics(m_interfaceMetrics);
+    m_ospf_protocol->SetLsdbChangedCallback(MakeCallback(&OspfRouting::ScheduleSpf, this));
+    if (m_maxMetricUntilConverged || m_maxMetricOnStartup.IsStrictlyPositive())
+    {
+        m_ospf_protocol->SetMaxMetric(true);
+        if (m_maxMetricOnStartup.IsStrictlyPositive())
+        {
+            m_maxMetricEvent = Simulator::Schedule(m_maxMetricOnStartup,
+                                                   &OspfRouting::SetMaxMetric,
+                                                   this,
+                                                   false);
+        }
+    }
     m_ospf_protocol->startDownState();
 
     Ipv4RoutingProtocol::DoInitialize();
 }
 
+void OspfRouting::SetPrefixSuppressions(std::set<uint32_t> interfaces){
+    m_prefixSuppressions = interfaces;
+    m_ospf_protocol->SetPrefixSuppressions(m_prefixSuppressions);
+}
+
+void OspfRouting::SetDemandCircuits(std::set<uint32_t> interfaces){
+    m_demandCircuits = interfaces;
+    m_ospf_protocol->SetDemandCircuits(m_demandCircuits, m_allDemandCircuits);
+}
+
 void OspfRouting::SetInterfaceExclusions(std::set<uint32_t> exceptions){
     //NS_LOG_FUNCTION(this);
     m_interfaceExclusions = exceptions;
 }
 
 void OspfRouting::DoDispose(){
+    m_spfEvent.Cancel();
+    m_maxMetricEvent.Cancel();
+    m_routes.clear();
+    m_spf.Clear();
+    m_fib.Clear();
+    m_routeCache.clear();
+    m_ospf_protocol = nullptr;
+    m_ipv4 = nullptr;
     Ipv4RoutingProtocol::DoDispose();
 }
 
@@ -95,6 +341,14 @@ void OspfRouting::SetIpv4(Ptr<Ipv4> ipv4){
     uint32_t i = 0;
     m_ipv4 = ipv4;
 
+    // Aggregating the protocol inserts it into the Ipv4 stack and sets its
+    // down target (see OspfL4Protocol::NotifyNewAggregate)
+    Ptr<Node> node = m_ipv4->GetObject<Node>();
+    if (node && !node->GetObject<OspfL4Protocol>())
+    {
+        node->AggregateObject(m_ospf_protocol);
+    }
+
     for (i = 0; i < m_ipv4->GetNInterfaces(); i++){
         if (m_ipv4->IsUp(i)){
             NotifyInterfaceUp(i);
@@ -111,7 +365,259 @@ void OspfRouting::SetArea(int a_id) {
 void OspfRouting::SetInterfaceMetric(uint32_t interface, uint8_t metric)
 {
     m_interfaceMetrics[interface] = metric;
+    m_ospf_protocol->SetInterfaceMetrics(m_interfaceMetrics);
+}
+
+const std::vector<OspfRoutingTableEntry>& OspfRouting::GetRoutes() const
+{
+    return m_routes;
+}
+
+Time OspfRouting::GetLastRouteChange() const
+{
+    return m_lastRouteChange;
+}
+
+OspfStats OspfRouting::GetStats() const
+{
+    OspfStats stats = m_ospf_protocol->GetStats();
+    stats.spfRuns = m_spfStats.spfRuns;
+    stats.spfTotalMicroSeconds = m_spfStats.spfTotalMicroSeconds;
+    stats.spfHistogram = m_spfStats.spfHistogram;
+    return stats;
+}
+
+void OspfRouting::Freeze()
+{
+    NS_LOG_FUNCTION(this);
+    m_fib.Compile(m_routes, m_ipv4);
+    m_frozen = true;
+    NS_LOG_LOGIC("Frozen " << m_routes.size() << " routes into " << m_fib.GetRangeNumber()
+                           << " address ranges");
+}
 
+void OspfRouting::Thaw()
+{
+    NS_LOG_FUNCTION(this);
+    m_fib.Clear();
+    m_frozen = false;
+    // Called on every interface change, which may change source addresses
+    m_routeGeneration++;
+}
+
+bool OspfRouting::IsFrozen() const
+{
+    return m_frozen;
 }
 
-}
\ No newline at end of file
+uint64_t OspfRouting::GetRouteGeneration() const
+{
+    return m_routeGeneration;
+}
+
+void OspfRouting::SetMaxMetric(bool maxMetric)
+{
+    NS_LOG_FUNCTION(this << maxMetric);
+    m_maxMetricEvent.Cancel();
+    m_ospf_protocol->SetMaxMetric(maxMetric);
+}
+
+bool OspfRouting::IsMaxMetric() const
+{
+    return m_ospf_protocol->IsMaxMetric();
+}
+
+Ptr<OspfL4Protocol> OspfRouting::GetProtocol() const
+{
+    return m_ospf_protocol;
+}
+
+uint32_t OspfRouting::ComputeConstrainedPath(uint32_t destination,
+                                             const OspfSpf::Constraints& constraints,
+                                             std::vector<uint32_t>& path)
+{
+    NS_LOG_FUNCTION(this << destination);
+    uint32_t target = m_spf.FindVertex(destination);
+    if (target == OspfSpf::UNREACHABLE)
+    {
+        path.clear();
+        return OspfSpf::UNREACHABLE;
+    }
+    return m_spf.CalculateConstrained(target, constraints, path);
+}
+
+void OspfRouting::ScheduleSpf()
+{
+    // The LSDB changed, the routes the table was compiled from are stale
+    if (m_frozen)
+    {
+        Thaw();
+    }
+    if (!m_spfEvent.IsRunning())
+    {
+        m_spfEvent = Simulator::Schedule(m_spfDelay, &OspfRouting::RunSpf, this);
+    }
+}
+
+void OspfRouting::RunSpf()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_ospf_protocol->IsRestarting())
+    {
+        // Graceful restart: forward on the routes we had until the LSDB is
+        // back, the protocol asks again when it leaves the restart
+        NS_LOG_LOGIC("Graceful restart, keeping the routing table");
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    const OspfLsdb& lsdb = m_ospf_protocol->GetLsdb();
+
+    m_spf.Calculate(lsdb, OspfLsa::ROUTER_LSA, m_ospf_protocol->GetRouterId());
+
+    std::vector<OspfRoutingTableEntry> routes;
+    uint32_t rootVertex = m_spf.GetRootVertex();
+    if (rootVertex != OspfSpf::UNREACHABLE)
+    {
+        // Stub networks, our own ones are directly connected
+        m_stubs.clear();
+        for (uint32_t v = 0; v < m_spf.GetVertexNumber(); v++)
+        {
+            if (m_spf.GetDistance(v) == OspfSpf::UNREACHABLE)
+            {
+                continue;
+            }
+            for (const auto& link : m_spf.GetVertexLsa(v)->GetRouterLinks())
+            {
+                if (link.type != OspfLsa::STUB_NETWORK)
+                {
+                    continue;
+                }
+                uint64_t key = (uint64_t(link.linkId & link.linkData) << 32) | link.linkData;
+                uint32_t cost = (v == rootVertex) ? 0 : m_spf.GetDistance(v) + link.metric;
+                auto found = m_stubs.find(key);
+                if (found == m_stubs.end() || cost < found->second.cost)
+                {
+                    m_stubs[key] = StubCandidate{cost, v};
+                }
+            }
+        }
+
+        routes.reserve(m_stubs.size());
+        for (const auto& stub : m_stubs)
+        {
+            Ipv4Address network(uint32_t(stub.first >> 32));
+            Ipv4Mask mask(uint32_t(stub.first));
+            uint32_t v = stub.second.vertex;
+            if (v == rootVertex)
+            {
+                int32_t interface = m_ipv4->GetInterfaceForPrefix(network, mask);
+                if (interface >= 0)
+                {
+                    routes.emplace_back(network, mask, interface);
+                    routes.back().SetMetric(0);
+                }
+                continue;
+            }
+
+            Ipv4Address firstHop(m_spf.GetFirstHopData(v));
+            int32_t interface = m_ipv4->GetInterfaceForAddress(firstHop);
+            if (interface < 0)
+            {
+                continue;
+            }
+            uint32_t neighbor = m_spf.GetFirstHopRouter(v);
+            Ipv4Address nextHop = m_ospf_protocol->GetNeighborAddress(neighbor, interface);
+            if (nextHop == Ipv4Address::GetZero())
+            {
+                continue;
+            }
+            routes.emplace_back(network, mask, nextHop, interface);
+            routes.back().SetMetric(stub.second.cost);
+        }
+    }
+
+    // Longest prefix first, so that the first match is the best one
+    std::sort(routes.begin(), routes.end(), [](const OspfRoutingTableEntry& a, const OspfRoutingTableEntry& b) {
+        uint16_t aLength = a.GetDestNetworkMask().GetPrefixLength();
+        uint16_t bLength = b.GetDestNetworkMask().GetPrefixLength();
+        if (aLength != bLength)
+        {
+            return aLength > bLength;
+        }
+        return a.GetDestNetwork() < b.GetDestNetwork();
+    });
+
+    bool changed = routes.size() != m_routes.size();
+    for (size_t r = 0; !changed && r < routes.size(); r++)
+    {
+        const OspfRoutingTableEntry& a = routes[r];
+        const OspfRoutingTableEntry& b = m_routes[r];
+        changed = a.GetDestNetwork() != b.GetDestNetwork() ||
+                  a.GetDestNetworkMask() != b.GetDestNetworkMask() ||
+                  a.GetGateway() != b.GetGateway() || a.GetInterface() != b.GetInterface() ||
+                  a.GetMetric() != b.GetMetric();
+    }
+    if (changed)
+    {
+        NS_LOG_LOGIC("Routing table changed, " << routes.size() << " routes");
+        m_routes = std::move(routes);
+        m_lastRouteChange = Simulator::Now();
+        m_routeGeneration++;
+    }
+
+    auto duration = std::chrono::steady_clock::now() - start;
+    m_spfStats.RecordSpf(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+
+    // The table is complete once calculated over a synchronised LSDB
+    if (m_maxMetricUntilConverged && m_ospf_protocol->IsMaxMetric() &&
+        m_ospf_protocol->IsFullyAdjacent())
+    {
+        NS_LOG_LOGIC("Converged, advertising our link costs");
+        SetMaxMetric(false);
+    }
+}
+
+Ptr<Ipv4Route> OspfRouting::Lookup(Ipv4Address dst, bool setSource, Ptr<NetDevice> interface)
+{
+    NS_LOG_FUNCTION(this << dst << interface);
+
+    // when sending on local multicast, there have to be interface specified
+    if (dst.IsLocalMulticast())
+    {
+        NS_ASSERT_MSG(interface,
+                      "Try to send on local multicast address, and no interface index is given!");
+        Ptr<Ipv4Route> rtentry = Create<Ipv4Route>();
+        rtentry->SetSource(
+            m_ipv4->SourceAddressSelection(m_ipv4->GetInterfaceForDevice(interface), dst));
+        rtentry->SetDestination(dst);
+        rtentry->SetGateway(Ipv4Address::GetZero());
+        rtentry->SetOutputDevice(interface);
+        return rtentry;
+    }
+
+    for (const auto& route : m_routes)
+    {
+        if (!route.GetDestNetworkMask().IsMatch(dst, route.GetDestNetwork()))
+        {
+            continue;
+        }
+        // if interface is given, check the route will output on this interface
+        if (interface && interface != m_ipv4->GetNetDevice(route.GetInterface()))
+        {
+            continue;
+        }
+
+        Ptr<Ipv4Route> rtentry = Create<Ipv4Route>();
+        if (setSource)
+        {
+            rtentry->SetSource(m_ipv4->SourceAddressSelection(route.GetInterface(), dst));
+        }
+        rtentry->SetDestination(dst);
+        rtentry->SetGateway(route.GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(route.GetInterface()));
+        return rtentry;
+    }
+    return nullptr;
+}
+
+}
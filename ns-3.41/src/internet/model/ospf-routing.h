@@ -5,13 +5,28 @@
  *
  *  File: ospf-routing.h
  *
+ *  The routing half of OSPF: OspfL4Protocol maintains the LSDB and calls us
+ *  back when it changes; we run the shortest path calculation (RFC 2328 16.1)
+ *  over it and answer route lookups from the resulting table.
+ *
  */
 
 #ifndef OSPF_ROUTING_H
 #define OSPF_ROUTING_H
 
 #include "ipv4-routing-protocol.h"
+#include "ospf-fib.h"
 #include "ospf-l4-protocol.h"
+#include "ospf-routing-table-entry.h"
+#include "ospf-spf.h"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace ns3
 {
@@ -25,6 +40,20 @@ public:
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void SetInterfaceExclusions(std::set<uint32_t> exceptions);
 
+    /**
+     * \brief Do not advertise the prefixes of some interfaces, see
+     * OspfL4Protocol::SetPrefixSuppressions.
+     * \param interfaces the interface indices
+     */
+    void SetPrefixSuppressions(std::set<uint32_t> interfaces);
+
+    /**
+     * \brief Run some interfaces as demand circuits, see
+     * OspfL4Protocol::SetDemandCircuits and the DemandCircuits attribute.
+     * \param interfaces the interface indices
+     */
+    void SetDemandCircuits(std::set<uint32_t> interfaces);
+
     Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p,
                                const Ipv4Header& header,
                                Ptr<NetDevice> oif,
@@ -45,19 +74,145 @@ public:
     void SetArea(int);
     void SetInterfaceMetric(uint32_t, uint8_t);
 
+    /**
+     * \return the routes of the last shortest path calculation, longest
+     * prefix first
+     */
+    const std::vector<OspfRoutingTableEntry>& GetRoutes() const;
+
+    /**
+     * \return the last time a shortest path calculation changed the routing
+     * table, e.g. to measure convergence
+     */
+    Time GetLastRouteChange() const;
+
+    /**
+     * \return the counters of this router, including the shortest path
+     * calculations
+     */
+    OspfStats GetStats() const;
+
+    /**
+     * \brief Compile the current routes into a read-only forwarding table and
+     * answer lookups from it until the LSDB or an interface changes.
+     *
+     * Meant for long steady state phases after convergence, see
+     * OspfHelper::FreezeAt. Lookups restricted to an output device still
+     * use the routing table.
+     */
+    void Freeze();
+
+    /// \brief Drop the forwarding table and use the routing table again.
+    void Thaw();
+
+    /// \return true while lookups are answered by the forwarding table
+    bool IsFrozen() const;
+
+    /**
+     * \return the routing table generation, incremented whenever the routes
+     * or the interfaces change. Routes cached for locally originated packets
+     * (see the RouteCacheSize attribute) are dropped once it moves on.
+     */
+    uint64_t GetRouteGeneration() const;
+
+    /**
+     * \brief Advertise our links to other routers with MaxLinkMetric (RFC
+     * 6987), e.g. while our routing table is incomplete or to drain traffic
+     * before maintenance. See the MaxMetricOnStartup and
+     * MaxMetricUntilConverged attributes for the startup modes.
+     * \param maxMetric true to advertise MaxLinkMetric
+     */
+    void SetMaxMetric(bool maxMetric);
+
+    /// \return true while we advertise MaxLinkMetric
+    bool IsMaxMetric() const;
+
+    /**
+     * \return the OSPF protocol instance, e.g. to set its attributes or
+     * connect its trace sources
+     */
+    Ptr<OspfL4Protocol> GetProtocol() const;
+
+    /**
+     * \brief Constrained shortest path (CSPF) to a router, over the graph of
+     * the last routing table calculation with the links whose traffic
+     * engineering attributes (see OspfL4Protocol::SetTeAttributes) fail the
+     * constraints pruned. Cheap enough to be called many times in a row.
+     * \param destination the router ID of the destination
+     * \param constraints the constraints
+     * \param path set to the router IDs along the path, ours first
+     * \return the cost of the path, or OspfSpf::UNREACHABLE
+     */
+    uint32_t ComputeConstrainedPath(uint32_t destination,
+                                    const OspfSpf::Constraints& constraints,
+                                    std::vector<uint32_t>& path);
+
 protected:
     void DoInitialize() override;
     void DoDispose() override;
 private:
 
+    /**
+     * \brief Schedule a shortest path calculation after SpfDelay, so that
+     * LSAs arriving together cause a single calculation.
+     */
+    void ScheduleSpf();
+
+    /**
+     * \brief Calculate the shortest path tree over the LSDB, then rebuild the
+     * routing table from the stub networks of its vertices (RFC 2328 16.1).
+     */
+    void RunSpf();
+
+    /**
+     * \brief Longest prefix match in the routing table.
+     * \param dst the destination
+     * \param setSource set the source address of the route
+     * \param interface the output device the route must use, if any
+     * \return the route, or nullptr
+     */
+    Ptr<Ipv4Route> Lookup(Ipv4Address dst, bool setSource, Ptr<NetDevice> interface = nullptr);
+
     Ptr<OspfL4Protocol> m_ospf_protocol;
     std::set<uint32_t> m_interfaceExclusions;   //interface
+    std::set<uint32_t> m_prefixSuppressions;    //!< See SetPrefixSuppressions
     Ptr<Ipv4> m_ipv4;                           //reference for an ipv4 address
 
     Ipv4Address dest_add;
 
     std::map<uint32_t, uint8_t> m_interfaceMetrics;
+
+    Time m_spfDelay;                                //!< Delay before a shortest path calculation
+    EventId m_spfEvent;                             //!< Pending shortest path calculation
+    std::vector<OspfRoutingTableEntry> m_routes;    //!< Routing table, longest prefix first
+    Time m_lastRouteChange;                         //!< See GetLastRouteChange
+    OspfStats m_spfStats;                           //!< Shortest path calculation counters
+
+    OspfSpf m_spf;                                  //!< Shortest path tree
+    OspfFib m_fib;                                  //!< See Freeze
+    bool m_frozen;                                  //!< See IsFrozen
+
+    uint32_t m_routeCacheSize;                      //!< Most routes cached by RouteOutput
+    uint64_t m_routeGeneration;                     //!< See GetRouteGeneration
+    uint64_t m_routeCacheGeneration;                //!< Generation of the cached routes
+    std::unordered_map<uint32_t, Ptr<Ipv4Route>> m_routeCache; //!< By destination
+
+    Time m_maxMetricOnStartup;                      //!< Stub router time after startup
+    bool m_maxMetricUntilConverged;                 //!< Stub router until converged
+    EventId m_maxMetricEvent;                       //!< End of the startup stub router time
+
+    std::set<uint32_t> m_demandCircuits;            //!< See SetDemandCircuits
+    bool m_allDemandCircuits;                       //!< See the DemandCircuits attribute
+
+    /// Best path to a stub network found so far
+    struct StubCandidate
+    {
+        uint32_t cost;
+        uint32_t vertex;
+    };
+
+    std::unordered_map<uint64_t, StubCandidate> m_stubs;    //!< By (network, mask)
 };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,252 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-spf.cc
+ *
+ */
+
+#include "ospf-spf.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace ns3 {
+
+const uint32_t OspfSpf::UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+OspfSpf::OspfSpf()
+    : m_rootVertex(UNREACHABLE)
+{
+}
+
+bool OspfSpf::HasLink(uint32_t vertex, uint32_t target) const {
+    for (uint32_t e = m_edgeOffset[vertex]; e < m_edgeOffset[vertex + 1]; e++)
+    {
+        if (m_edgeTarget[e] == target)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void OspfSpf::Calculate(const OspfLsdb& lsdb, uint16_t routerLsaType, uint32_t root) {
+    // Vertices: the Router-LSAs that are not being flushed
+    m_vertexIndex.clear();
+    m_vertexLsa.clear();
+    m_teLsa.clear();
+    for (const auto& item : lsdb.GetEntries())
+    {
+        if (lsdb.GetAge(item.second) >= OspfLsa::MAX_AGE)
+        {
+            continue;
+        }
+        if (item.first.type == routerLsaType)
+        {
+            m_vertexIndex[item.first.advertisingRouter] = m_vertexLsa.size();
+            m_vertexLsa.push_back(item.second.lsa);
+        }
+        else if (item.first.type == OspfLsa::AREA_LOCAL_OPAQUE_LSA &&
+                 (item.first.linkStateId >> 24) == OspfLsa::TE_OPAQUE_TYPE)
+        {
+            m_teLsa.push_back(item.second.lsa);
+        }
+    }
+
+    // Edges: the point-to-point links, in CSR form
+    uint32_t vertices = m_vertexLsa.size();
+    m_edgeOffset.assign(vertices + 1, 0);
+    m_edgeTarget.clear();
+    m_edgeMetric.clear();
+    m_edgeData.clear();
+    for (uint32_t v = 0; v < vertices; v++)
+    {
+        for (const auto& link : m_vertexLsa[v]->GetRouterLinks())
+        {
+            if (link.type != OspfLsa::POINT_TO_POINT)
+            {
+                continue;
+            }
+            auto target = m_vertexIndex.find(link.linkId);
+            if (target != m_vertexIndex.end())
+            {
+                m_edgeTarget.push_back(target->second);
+                m_edgeMetric.push_back(link.metric);
+                m_edgeData.push_back(link.linkData);
+            }
+        }
+        m_edgeOffset[v + 1] = m_edgeTarget.size();
+    }
+
+    // Traffic engineering attributes, matched to the edge of the advertising
+    // router with the same neighbor and local address
+    m_edgeBandwidth.assign(m_edgeTarget.size(), 0);
+    m_edgeAdminGroup.assign(m_edgeTarget.size(), 0);
+    for (const auto& lsa : m_teLsa)
+    {
+        OspfLsa::TeLink link;
+        uint32_t v = FindVertex(lsa->GetHeader().advertisingRouter);
+        if (v == UNREACHABLE || !lsa->GetTeLink(link))
+        {
+            continue;
+        }
+        for (uint32_t e = m_edgeOffset[v]; e < m_edgeOffset[v + 1]; e++)
+        {
+            if (m_edgeData[e] == link.localAddress &&
+                m_vertexLsa[m_edgeTarget[e]]->GetHeader().advertisingRouter == link.linkId)
+            {
+                m_edgeBandwidth[e] = link.unreservedBandwidth;
+                m_edgeAdminGroup[e] = link.adminGroup;
+            }
+        }
+    }
+    m_teLsa.clear();
+
+    m_distance.assign(vertices, UNREACHABLE);
+    m_firstHop.assign(vertices, UNREACHABLE);
+    m_rootVertex = FindVertex(root);
+    if (m_rootVertex == UNREACHABLE)
+    {
+        return;
+    }
+
+    // Dijkstra, remembering for each vertex the root edge it is reached by
+    m_heap.clear();
+    m_distance[m_rootVertex] = 0;
+    m_heap.emplace_back(0, m_rootVertex);
+    auto greater = std::greater<std::pair<uint32_t, uint32_t>>();
+    while (!m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), greater);
+        uint32_t cost = m_heap.back().first;
+        uint32_t u = m_heap.back().second;
+        m_heap.pop_back();
+        if (cost > m_distance[u])
+        {
+            continue;
+        }
+        for (uint32_t e = m_edgeOffset[u]; e < m_edgeOffset[u + 1]; e++)
+        {
+            uint32_t w = m_edgeTarget[e];
+            uint32_t next = cost + m_edgeMetric[e];
+            if (next < m_distance[w] && HasLink(w, u))
+            {
+                m_distance[w] = next;
+                m_firstHop[w] = (u == m_rootVertex) ? e : m_firstHop[u];
+                m_heap.emplace_back(next, w);
+                std::push_heap(m_heap.begin(), m_heap.end(), greater);
+            }
+        }
+    }
+}
+
+uint32_t OspfSpf::CalculateConstrained(uint32_t target,
+                                       const Constraints& constraints,
+                                       std::vector<uint32_t>& path) {
+    path.clear();
+    if (m_rootVertex == UNREACHABLE || target >= m_vertexLsa.size())
+    {
+        return UNREACHABLE;
+    }
+
+    auto allowed = [&](uint32_t e) {
+        uint32_t groups = m_edgeAdminGroup[e];
+        return m_edgeBandwidth[e] >= constraints.bandwidth &&
+               (constraints.includeAny == 0 || (groups & constraints.includeAny) != 0) &&
+               (groups & constraints.includeAll) == constraints.includeAll &&
+               (groups & constraints.excludeAny) == 0;
+    };
+
+    // Dijkstra over the edges that pass, stopping at the target
+    uint32_t vertices = m_vertexLsa.size();
+    m_cspfDistance.assign(vertices, UNREACHABLE);
+    m_cspfEdge.assign(vertices, UNREACHABLE);
+    m_heap.clear();
+    m_cspfDistance[m_rootVertex] = 0;
+    m_heap.emplace_back(0, m_rootVertex);
+    auto greater = std::greater<std::pair<uint32_t, uint32_t>>();
+    while (!m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), greater);
+        uint32_t cost = m_heap.back().first;
+        uint32_t u = m_heap.back().second;
+        m_heap.pop_back();
+        if (u == target)
+        {
+            break;
+        }
+        if (cost > m_cspfDistance[u])
+        {
+            continue;
+        }
+        for (uint32_t e = m_edgeOffset[u]; e < m_edgeOffset[u + 1]; e++)
+        {
+            uint32_t w = m_edgeTarget[e];
+            uint32_t next = cost + m_edgeMetric[e];
+            if (next < m_cspfDistance[w] && allowed(e) && HasLink(w, u))
+            {
+                m_cspfDistance[w] = next;
+                m_cspfEdge[w] = e;
+                m_heap.emplace_back(next, w);
+                std::push_heap(m_heap.begin(), m_heap.end(), greater);
+            }
+        }
+    }
+    m_heap.clear();
+
+    if (m_cspfDistance[target] == UNREACHABLE)
+    {
+        return UNREACHABLE;
+    }
+    // Walk back along the edges, which start at the previous vertex
+    for (uint32_t v = target; v != m_rootVertex;)
+    {
+        path.push_back(m_vertexLsa[v]->GetHeader().advertisingRouter);
+        uint32_t e = m_cspfEdge[v];
+        v = std::upper_bound(m_edgeOffset.begin(), m_edgeOffset.end(), e) - m_edgeOffset.begin() - 1;
+    }
+    path.push_back(m_vertexLsa[m_rootVertex]->GetHeader().advertisingRouter);
+    std::reverse(path.begin(), path.end());
+    return m_cspfDistance[target];
+}
+
+void OspfSpf::Clear() {
+    m_rootVertex = UNREACHABLE;
+    m_vertexIndex.clear();
+    m_vertexLsa.clear();
+}
+
+uint32_t OspfSpf::GetVertexNumber() const {
+    return m_vertexLsa.size();
+}
+
+uint32_t OspfSpf::GetRootVertex() const {
+    return m_rootVertex;
+}
+
+uint32_t OspfSpf::FindVertex(uint32_t routerId) const {
+    auto found = m_vertexIndex.find(routerId);
+    return (found == m_vertexIndex.end()) ? UNREACHABLE : found->second;
+}
+
+Ptr<OspfLsa> OspfSpf::GetVertexLsa(uint32_t vertex) const {
+    return m_vertexLsa[vertex];
+}
+
+uint32_t OspfSpf::GetDistance(uint32_t vertex) const {
+    return m_distance[vertex];
+}
+
+uint32_t OspfSpf::GetFirstHopData(uint32_t vertex) const {
+    return m_edgeData[m_firstHop[vertex]];
+}
+
+uint32_t OspfSpf::GetFirstHopRouter(uint32_t vertex) const {
+    return m_vertexLsa[m_edgeTarget[m_firstHop[vertex]]]->GetHeader().advertisingRouter;
+}
+
+}
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-spf.h
+ *
+ *  The shortest path tree calculation (RFC 2328 16.1, RFC 5340 4.8.1),
+ *  shared by OspfRouting and Ospf6Routing. Both versions build the same
+ *  graph of routers from their Router-LSAs; only the way prefixes hang off
+ *  the tree differs (stub links in OSPFv2, Intra-Area-Prefix-LSAs in
+ *  OSPFv3) and that is left to the routing protocols.
+ *
+ *  The graph is kept in CSR form in buffers reused between calculations.
+ *  OSPFv2 edges also carry the traffic engineering attributes advertised
+ *  for them (RFC 3630), over which constrained shortest paths are computed
+ *  on demand, again in reused buffers.
+ *
+ */
+
+#ifndef OSPF_SPF_H
+#define OSPF_SPF_H
+
+#include "ospf-lsdb.h"
+
+#include "ns3/ptr.h"
+
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+class OspfSpf {
+public:
+    /// Distance of a vertex the root cannot reach, and "no vertex"
+    static const uint32_t UNREACHABLE;
+
+    /// Constraints of a constrained shortest path, links failing them are pruned
+    struct Constraints
+    {
+        double bandwidth = 0;       //!< Unreserved bandwidth needed, bytes per second
+        uint32_t includeAny = 0;    //!< If not 0, admin groups a link needs one of
+        uint32_t includeAll = 0;    //!< Admin groups a link needs all of
+        uint32_t excludeAny = 0;    //!< Admin groups a link must have none of
+    };
+
+    OspfSpf();
+
+    /**
+     * \brief Run Dijkstra over the Router-LSAs of an LSDB that are not being
+     * flushed, one vertex per advertising router.
+     * \param lsdb the LSDB
+     * \param routerLsaType the LS type of Router-LSAs in this OSPF version
+     * \param root the router ID of the calculating router
+     */
+    void Calculate(const OspfLsdb& lsdb, uint16_t routerLsaType, uint32_t root);
+
+    /// Release the LSAs held by the last calculation
+    void Clear();
+
+    uint32_t GetVertexNumber() const;
+
+    /**
+     * \return the vertex of the calculating router, or UNREACHABLE if it has
+     * no Router-LSA yet
+     */
+    uint32_t GetRootVertex() const;
+
+    /**
+     * \param routerId a router ID
+     * \return the vertex of the router, or UNREACHABLE
+     */
+    uint32_t FindVertex(uint32_t routerId) const;
+
+    Ptr<OspfLsa> GetVertexLsa(uint32_t vertex) const;
+
+    /**
+     * \param vertex a vertex
+     * \return the cost from the root, UNREACHABLE if the root cannot reach it
+     */
+    uint32_t GetDistance(uint32_t vertex) const;
+
+    /**
+     * \param vertex a vertex other than the root, reachable
+     * \return the link data of the root's link the vertex is reached through:
+     * our interface address in OSPFv2, our interface ID in OSPFv3
+     */
+    uint32_t GetFirstHopData(uint32_t vertex) const;
+
+    /**
+     * \param vertex a vertex other than the root, reachable
+     * \return the router ID of the neighbor the vertex is reached through
+     */
+    uint32_t GetFirstHopRouter(uint32_t vertex) const;
+
+    /**
+     * \brief Constrained shortest path (CSPF) from the root over the graph
+     * of the last calculation, skipping the links whose traffic engineering
+     * attributes fail the constraints. Links without attributes have no
+     * bandwidth and no admin group.
+     * \param target the destination vertex
+     * \param constraints the constraints
+     * \param path set to the router IDs along the path, the root's first
+     * \return the cost of the path, or UNREACHABLE
+     */
+    uint32_t CalculateConstrained(uint32_t target,
+                                  const Constraints& constraints,
+                                  std::vector<uint32_t>& path);
+
+private:
+    /**
+     * \param vertex a vertex index
+     * \param target another vertex index
+     * \return true if the Router-LSA of vertex has a point-to-point link to
+     * target (RFC 2328 16.1 (2)(b))
+     */
+    bool HasLink(uint32_t vertex, uint32_t target) const;
+
+    uint32_t m_rootVertex;                                  //!< See GetRootVertex
+    std::unordered_map<uint32_t, uint32_t> m_vertexIndex;   //!< Router ID to vertex
+    std::vector<Ptr<OspfLsa>> m_vertexLsa;                  //!< Router-LSA of a vertex
+    std::vector<uint32_t> m_edgeOffset;                     //!< First edge of a vertex
+    std::vector<uint32_t> m_edgeTarget;                     //!< Vertex an edge leads to
+    std::vector<uint32_t> m_edgeMetric;                     //!< Cost of an edge
+    std::vector<uint32_t> m_edgeData;                       //!< Link data of an edge
+    std::vector<float> m_edgeBandwidth;                     //!< Unreserved bandwidth of an edge
+    std::vector<uint32_t> m_edgeAdminGroup;                 //!< Admin groups of an edge
+    std::vector<Ptr<OspfLsa>> m_teLsa;                      //!< TE LSAs, while calculating
+    std::vector<uint32_t> m_distance;                       //!< Cost from the root
+    std::vector<uint32_t> m_firstHop;                       //!< Root edge a vertex is reached by
+    std::vector<std::pair<uint32_t, uint32_t>> m_heap;      //!< (cost, vertex) min heap
+    std::vector<uint32_t> m_cspfDistance;                   //!< Cost from the root, CSPF
+    std::vector<uint32_t> m_cspfEdge;                       //!< Edge a vertex is reached by, CSPF
+};
+
+}
+
+#endif // OSPF_SPF_H
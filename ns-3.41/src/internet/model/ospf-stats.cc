@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-stats.cc
+ *
+ */
+
+#include "ospf-stats.h"
+
+namespace ns3 {
+
+const uint32_t OspfStats::SPF_HISTOGRAM_BUCKETS;
+
+OspfStats::OspfStats()
+    : packetsSent{},
+      packetsReceived{},
+      dbdRetransmissions(0),
+      lsrRetransmissions(0),
+      lsaRetransmissions(0),
+      neighborTransitions(0),
+      lsaInstalls(0),
+      lsdbSize(0),
+      spfRuns(0),
+      spfTotalMicroSeconds(0),
+      spfHistogram{}
+{
+}
+
+void OspfStats::RecordSpf(uint64_t microSeconds) {
+    uint32_t bucket = 0;
+    while (bucket + 1 < SPF_HISTOGRAM_BUCKETS && (microSeconds >> (bucket + 1)) != 0)
+    {
+        bucket++;
+    }
+    spfHistogram[bucket]++;
+    spfRuns++;
+    spfTotalMicroSeconds += microSeconds;
+}
+
+OspfStats& OspfStats::operator+=(const OspfStats& other) {
+    for (uint32_t i = 0; i < packetsSent.size(); i++)
+    {
+        packetsSent[i] += other.packetsSent[i];
+        packetsReceived[i] += other.packetsReceived[i];
+    }
+    dbdRetransmissions += other.dbdRetransmissions;
+    lsrRetransmissions += other.lsrRetransmissions;
+    lsaRetransmissions += other.lsaRetransmissions;
+    neighborTransitions += other.neighborTransitions;
+    lsaInstalls += other.lsaInstalls;
+    lsdbSize += other.lsdbSize;
+    spfRuns += other.spfRuns;
+    spfTotalMicroSeconds += other.spfTotalMicroSeconds;
+    for (uint32_t i = 0; i < SPF_HISTOGRAM_BUCKETS; i++)
+    {
+        spfHistogram[i] += other.spfHistogram[i];
+    }
+    return *this;
+}
+
+void OspfStats::Print(std::ostream& os) const {
+    static const char* names[] = {"", "Hello", "DBD", "LSR", "LSU", "LSAck"};
+    os << "packets sent/received";
+    for (uint32_t type = 1; type < packetsSent.size(); type++)
+    {
+        os << " " << names[type] << " " << packetsSent[type] << "/" << packetsReceived[type];
+    }
+    os << ", retransmissions DBD " << dbdRetransmissions << " LSR " << lsrRetransmissions
+       << " LSA " << lsaRetransmissions << ", neighbor transitions " << neighborTransitions
+       << ", LSA installs " << lsaInstalls << ", LSDB size " << lsdbSize << ", SPF runs "
+       << spfRuns << " (" << spfTotalMicroSeconds << " us)";
+}
+
+std::ostream& operator<<(std::ostream& os, const OspfStats& stats) {
+    stats.Print(os);
+    return os;
+}
+
+}
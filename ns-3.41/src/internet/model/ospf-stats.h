@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-stats.h
+ *
+ *  Counters kept by OSPF on every router. They cost an increment each, so
+ *  they are always on, unlike NS_LOG which slows a run down by orders of
+ *  magnitude once enabled.
+ *
+ */
+
+#ifndef OSPF_STATS_H
+#define OSPF_STATS_H
+
+#include <array>
+#include <ostream>
+#include <stdint.h>
+
+namespace ns3 {
+
+struct OspfStats
+{
+    /// Buckets of the SPF duration histogram: bucket i counts durations in
+    /// [2^i, 2^(i+1)) microseconds, bucket 0 also those under 1 us and the
+    /// last one everything longer
+    static const uint32_t SPF_HISTOGRAM_BUCKETS = 24;
+
+    OspfStats();
+
+    std::array<uint64_t, 6> packetsSent;        //!< By packet type, 1 (Hello) to 5 (LS Ack)
+    std::array<uint64_t, 6> packetsReceived;    //!< By packet type, valid packets only
+    uint64_t dbdRetransmissions;                //!< DBD packets retransmitted
+    uint64_t lsrRetransmissions;                //!< LS Request packets retransmitted
+    uint64_t lsaRetransmissions;                //!< LSAs retransmitted in LS Updates
+    uint64_t neighborTransitions;               //!< Neighbor state changes
+    uint64_t lsaInstalls;                       //!< LSAs installed in the LSDB
+    uint32_t lsdbSize;                          //!< LSAs in the LSDB
+    uint64_t spfRuns;                           //!< Shortest path calculations
+    uint64_t spfTotalMicroSeconds;              //!< Wall clock time spent in them
+    std::array<uint64_t, SPF_HISTOGRAM_BUCKETS> spfHistogram;   //!< Their wall clock durations
+
+    /**
+     * \brief Count a shortest path calculation.
+     * \param microSeconds its wall clock duration
+     */
+    void RecordSpf(uint64_t microSeconds);
+
+    /**
+     * \brief Add the counters of another router, e.g. to sum a network.
+     * The LSDB sizes are added too.
+     * \param other the other counters
+     * \return this
+     */
+    OspfStats& operator+=(const OspfStats& other);
+
+    void Print(std::ostream& os) const;
+};
+
+std::ostream& operator<<(std::ostream& os, const OspfStats& stats);
+
+}
+
+#endif
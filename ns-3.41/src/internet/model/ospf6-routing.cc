@@ -0,0 +1,471 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf6-routing.cc
+ *
+ */
+
+#include "ospf6-routing.h"
+
+#include "ipv6-route.h"
+
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Ospf6Routing");
+NS_OBJECT_ENSURE_REGISTERED(Ospf6Routing);
+
+Ospf6Routing::Ospf6Routing() : m_allDemandCircuits(false), m_ipv6(nullptr){
+    m_ospf_protocol = CreateObject<OspfL4Protocol>();
+}
+Ospf6Routing::~Ospf6Routing() {
+}
+TypeId Ospf6Routing::GetTypeId() {
+    static TypeId tid = TypeId("ns3::Ospf6Routing")
+            .SetParent<Ipv6RoutingProtocol>()
+            .SetGroupName("Internet")
+            .AddConstructor<Ospf6Routing>()
+            .AddAttribute("SpfDelay",
+                          "The time between an LSDB change and the routing table calculation.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&Ospf6Routing::m_spfDelay),
+                          MakeTimeChecker())
+            .AddAttribute("DemandCircuits",
+                          "Whether every interface is run as a demand circuit (RFC 1793), "
+                          "e.g. throughout an area of long and stable runs.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&Ospf6Routing::m_allDemandCircuits),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+Ptr<Ipv6Route> Ospf6Routing::RouteOutput(Ptr<Packet> p, const Ipv6Header& header, Ptr<NetDevice> oif, Socket::SocketErrno& sockerr)
+{
+    NS_LOG_FUNCTION(this << header << oif);
+
+    Ipv6Address destination = header.GetDestination();
+    if (destination.IsMulticast())
+    {
+        // OSPF's own multicast packets carry their route, see OspfL4Protocol::Send
+        NS_LOG_LOGIC("RouteOutput (): Multicast destination");
+    }
+
+    Ptr<Ipv6Route> rtentry = Lookup(destination, true, oif);
+    if (rtentry)
+    {
+        sockerr = Socket::ERROR_NOTERROR;
+    }
+    else
+    {
+        sockerr = Socket::ERROR_NOROUTETOHOST;
+    }
+    return rtentry;
+}
+
+bool Ospf6Routing::RouteInput(Ptr<const Packet> p,
+                const Ipv6Header& header,
+                Ptr<const NetDevice> idev,
+                const UnicastForwardCallback& ucb,
+                const MulticastForwardCallback& mcb,
+                const LocalDeliverCallback& lcb,
+                const ErrorCallback& ecb)
+{
+    NS_LOG_FUNCTION(this << p << header << header.GetSource() << header.GetDestination() << idev);
+
+    NS_ASSERT(m_ipv6);
+    NS_ASSERT(m_ipv6->GetInterfaceForDevice(idev) >= 0);
+    uint32_t iif = m_ipv6->GetInterfaceForDevice(idev);
+    Ipv6Address dst = header.GetDestination();
+
+    if (dst.IsMulticast())
+    {
+        // Delivered locally by Ipv6L3Protocol if we joined the group
+        NS_LOG_LOGIC("Multicast route not supported by OSPF");
+        return false;
+    }
+
+    if (dst.IsLinkLocal() || header.GetSource().IsLinkLocal())
+    {
+        NS_LOG_LOGIC("Dropping packet not for me and with src or dst LinkLocal");
+        if (!ecb.IsNull())
+        {
+            ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+        }
+        return false;
+    }
+
+    if (!m_ipv6->IsForwarding(iif))
+    {
+        NS_LOG_LOGIC("Forwarding disabled for this interface");
+        if (!ecb.IsNull())
+        {
+            ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+        }
+        return true;
+    }
+
+    Ptr<Ipv6Route> rtentry = Lookup(dst, false);
+    if (rtentry)
+    {
+        NS_LOG_LOGIC("Found unicast destination - calling unicast callback");
+        ucb(idev, rtentry, p, header);
+        return true;
+    }
+    NS_LOG_LOGIC("Did not find unicast destination - returning false");
+    return false;
+}
+void Ospf6Routing::NotifyInterfaceUp(uint32_t interface){
+    NS_LOG_FUNCTION(this << interface);
+    m_ospf_protocol->NotifyInterfaceChange(interface);
+}
+void Ospf6Routing::NotifyInterfaceDown(uint32_t interface){
+    NS_LOG_FUNCTION(this << interface);
+    m_ospf_protocol->NotifyInterfaceChange(interface);
+}
+void Ospf6Routing::NotifyAddAddress(uint32_t interface, Ipv6InterfaceAddress address){
+    NS_LOG_FUNCTION(this << interface << address);
+    m_ospf_protocol->NotifyInterfaceChange(interface);
+}
+void Ospf6Routing::NotifyRemoveAddress(uint32_t interface, Ipv6InterfaceAddress address){
+    NS_LOG_FUNCTION(this << interface << address);
+    m_ospf_protocol->NotifyInterfaceChange(interface);
+}
+void Ospf6Routing::NotifyAddRoute(Ipv6Address dst, Ipv6Prefix mask, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse){
+    // Routes come from the LSDB only
+    NS_LOG_FUNCTION(this << dst << mask << nextHop << interface << prefixToUse);
+}
+void Ospf6Routing::NotifyRemoveRoute(Ipv6Address dst, Ipv6Prefix mask, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse){
+    NS_LOG_FUNCTION(this << dst << mask << nextHop << interface << prefixToUse);
+}
+void Ospf6Routing::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const{
+    std::ostream* os = stream->GetStream();
+    // Copy the current ostream state
+    std::ios oldState(nullptr);
+    oldState.copyfmt(*os);
+
+    *os << std::resetiosflags(std::ios::adjustfield) << std::setiosflags(std::ios::left);
+
+    *os << "Node: " << m_ipv6->GetObject<Node>()->GetId() << ", Time: " << Now().As(unit)
+        << ", Local time: " << m_ipv6->GetObject<Node>()->GetLocalTime().As(unit)
+        << ", IPv6 OSPF table" << std::endl;
+
+    if (!m_routes.empty())
+    {
+        *os << "Destination                    Next Hop                   Flag Met    Ref Use If"
+            << std::endl;
+        for (const auto& route : m_routes)
+        {
+            std::ostringstream dest;
+            std::ostringstream gw;
+            std::ostringstream flags;
+            dest << route.GetDest() << "/" << int(route.GetDestNetworkPrefix().GetPrefixLength());
+            *os << std::setw(31) << dest.str();
+            gw << route.GetGateway();
+            *os << std::setw(27) << gw.str();
+            flags << "U";
+            if (route.IsHost())
+            {
+                flags << "H";
+            }
+            else if (route.IsGateway())
+            {
+                flags << "G";
+            }
+            *os << std::setw(5) << flags.str();
+            *os << std::setw(7) << route.GetMetric();
+            // Ref ct not implemented
+            *os << "-"
+                << "   ";
+            // Use not implemented
+            *os << "-"
+                << "   ";
+            if (!Names::FindName(m_ipv6->GetNetDevice(route.GetInterface())).empty())
+            {
+                *os << Names::FindName(m_ipv6->GetNetDevice(route.GetInterface()));
+            }
+            else
+            {
+                *os << route.GetInterface();
+            }
+            *os << std::endl;
+        }
+    }
+    *os << std::endl;
+    // Restore the previous ostream state
+    (*os).copyfmt(oldState);
+}
+
+void Ospf6Routing::DoInitialize() {
+    Ptr<Node> node = m_ipv6->GetObject<Node>();
+    m_ospf_protocol->SetNode(node);
+    m_ospf_protocol->SetExclusions(m_interfaceExclusions);
+    m_ospf_protocol->SetPrefixSuppressions(m_prefixSuppressions);
+    m_ospf_protocol->SetDemandCircuits(m_demandCircuits, m_allDemandCircuits);
+    m_ospf_protocol->SetInterfaceMetrics(m_interfaceMetrics);
+    m_ospf_protocol->SetLsdbChangedCallback(MakeCallback(&Ospf6Routing::ScheduleSpf, this));
+    m_ospf_protocol->startDownState();
+
+    Ipv6RoutingProtocol::DoInitialize();
+}
+
+void Ospf6Routing::SetPrefixSuppressions(std::set<uint32_t> interfaces){
+    m_prefixSuppressions = interfaces;
+    m_ospf_protocol->SetPrefixSuppressions(m_prefixSuppressions);
+}
+
+void Ospf6Routing::SetDemandCircuits(std::set<uint32_t> interfaces){
+    m_demandCircuits = interfaces;
+    m_ospf_protocol->SetDemandCircuits(m_demandCircuits, m_allDemandCircuits);
+}
+
+void Ospf6Routing::SetInterfaceExclusions(std::set<uint32_t> exceptions){
+    m_interfaceExclusions = exceptions;
+}
+
+void Ospf6Routing::DoDispose(){
+    m_spfEvent.Cancel();
+    m_routes.clear();
+    m_prefixes.clear();
+    m_spf.Clear();
+    // Not aggregated to the node, so not disposed with it
+    m_ospf_protocol->Dispose();
+    m_ospf_protocol = nullptr;
+    m_ipv6 = nullptr;
+    Ipv6RoutingProtocol::DoDispose();
+}
+
+void Ospf6Routing::SetIpv6(Ptr<Ipv6> ipv6){
+    NS_ASSERT(!m_ipv6 && ipv6);
+    m_ipv6 = ipv6;
+
+    // The OSPFv3 instance shares protocol number 89 with an OSPFv2 one, so
+    // it is inserted into the IPv6 stack only
+    m_ospf_protocol->SetIpv6(m_ipv6);
+    m_ipv6->Insert(m_ospf_protocol);
+    m_ospf_protocol->SetDownTarget6(MakeCallback(&Ipv6::Send, m_ipv6));
+
+    for (uint32_t i = 0; i < m_ipv6->GetNInterfaces(); i++){
+        if (m_ipv6->IsUp(i)){
+            NotifyInterfaceUp(i);
+        }else{
+            NotifyInterfaceDown(i);
+        }
+    }
+}
+
+void Ospf6Routing::SetArea(int a_id) {
+    m_ospf_protocol->SetOspfAreaType(a_id);
+}
+
+void Ospf6Routing::SetInterfaceMetric(uint32_t interface, uint8_t metric)
+{
+    m_interfaceMetrics[interface] = metric;
+    m_ospf_protocol->SetInterfaceMetrics(m_interfaceMetrics);
+}
+
+const std::vector<Ospf6RoutingTableEntry>& Ospf6Routing::GetRoutes() const
+{
+    return m_routes;
+}
+
+Time Ospf6Routing::GetLastRouteChange() const
+{
+    return m_lastRouteChange;
+}
+
+OspfStats Ospf6Routing::GetStats() const
+{
+    OspfStats stats = m_ospf_protocol->GetStats();
+    stats.spfRuns = m_spfStats.spfRuns;
+    stats.spfTotalMicroSeconds = m_spfStats.spfTotalMicroSeconds;
+    stats.spfHistogram = m_spfStats.spfHistogram;
+    return stats;
+}
+
+Ptr<OspfL4Protocol> Ospf6Routing::GetProtocol() const
+{
+    return m_ospf_protocol;
+}
+
+void Ospf6Routing::ScheduleSpf()
+{
+    if (!m_spfEvent.IsRunning())
+    {
+        m_spfEvent = Simulator::Schedule(m_spfDelay, &Ospf6Routing::RunSpf, this);
+    }
+}
+
+void Ospf6Routing::RunSpf()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_ospf_protocol->IsRestarting())
+    {
+        // Graceful restart: forward on the routes we had until the LSDB is
+        // back, the protocol asks again when it leaves the restart
+        NS_LOG_LOGIC("Graceful restart, keeping the routing table");
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    const OspfLsdb& lsdb = m_ospf_protocol->GetLsdb();
+
+    m_spf.Calculate(lsdb, OspfLsa::V3_ROUTER_LSA, m_ospf_protocol->GetRouterId());
+
+    std::vector<Ospf6RoutingTableEntry> routes;
+    uint32_t rootVertex = m_spf.GetRootVertex();
+    if (rootVertex != OspfSpf::UNREACHABLE)
+    {
+        // Prefixes of the reachable routers, our own ones are directly
+        // connected
+        m_prefixes.clear();
+        for (const auto& item : lsdb.GetEntries())
+        {
+            if (item.first.type != OspfLsa::V3_INTRA_AREA_PREFIX_LSA ||
+                lsdb.GetAge(item.second) >= OspfLsa::MAX_AGE)
+            {
+                continue;
+            }
+            const OspfLsaKey& referenced = item.second.lsa->GetReferencedLsa();
+            if (referenced.type != OspfLsa::V3_ROUTER_LSA ||
+                referenced.advertisingRouter != item.first.advertisingRouter)
+            {
+                continue;
+            }
+            uint32_t v = m_spf.FindVertex(referenced.advertisingRouter);
+            if (v == OspfSpf::UNREACHABLE || m_spf.GetDistance(v) == OspfSpf::UNREACHABLE)
+            {
+                continue;
+            }
+            for (const auto& prefix : item.second.lsa->GetPrefixes())
+            {
+                auto key = std::make_pair(prefix.address, prefix.length);
+                uint32_t cost = (v == rootVertex) ? 0 : m_spf.GetDistance(v) + prefix.metric;
+                auto found = m_prefixes.find(key);
+                if (found == m_prefixes.end() || cost < found->second.cost)
+                {
+                    m_prefixes[key] = PrefixCandidate{cost, v};
+                }
+            }
+        }
+
+        routes.reserve(m_prefixes.size());
+        for (const auto& item : m_prefixes)
+        {
+            Ipv6Address network = item.first.first;
+            Ipv6Prefix prefix(item.first.second);
+            uint32_t v = item.second.vertex;
+            if (v == rootVertex)
+            {
+                int32_t interface = m_ipv6->GetInterfaceForPrefix(network, prefix);
+                if (interface >= 0)
+                {
+                    routes.emplace_back(network, prefix, interface);
+                    routes.back().SetMetric(0);
+                }
+                continue;
+            }
+
+            // OSPFv3 links carry our interface ID, which is the interface index
+            uint32_t interface = m_spf.GetFirstHopData(v);
+            if (interface >= m_ipv6->GetNInterfaces())
+            {
+                continue;
+            }
+            uint32_t neighbor = m_spf.GetFirstHopRouter(v);
+            Ipv6Address nextHop = m_ospf_protocol->GetNeighborAddress6(neighbor, interface);
+            if (nextHop == Ipv6Address::GetAny())
+            {
+                continue;
+            }
+            routes.emplace_back(network, prefix, nextHop, interface);
+            routes.back().SetMetric(item.second.cost);
+        }
+    }
+
+    // Longest prefix first, so that the first match is the best one
+    // (m_prefixes is ordered by prefix, so the order within a length is stable)
+    std::stable_sort(routes.begin(),
+                     routes.end(),
+                     [](const Ospf6RoutingTableEntry& a, const Ospf6RoutingTableEntry& b) {
+                         return a.GetDestNetworkPrefix().GetPrefixLength() >
+                                b.GetDestNetworkPrefix().GetPrefixLength();
+                     });
+
+    bool changed = routes.size() != m_routes.size();
+    for (size_t r = 0; !changed && r < routes.size(); r++)
+    {
+        const Ospf6RoutingTableEntry& a = routes[r];
+        const Ospf6RoutingTableEntry& b = m_routes[r];
+        changed = a.GetDestNetwork() != b.GetDestNetwork() ||
+                  a.GetDestNetworkPrefix() != b.GetDestNetworkPrefix() ||
+                  a.GetGateway() != b.GetGateway() || a.GetInterface() != b.GetInterface() ||
+                  a.GetMetric() != b.GetMetric();
+    }
+    if (changed)
+    {
+        NS_LOG_LOGIC("Routing table changed, " << routes.size() << " routes");
+        m_routes = std::move(routes);
+        m_lastRouteChange = Simulator::Now();
+    }
+
+    auto duration = std::chrono::steady_clock::now() - start;
+    m_spfStats.RecordSpf(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+Ptr<Ipv6Route> Ospf6Routing::Lookup(Ipv6Address dst, bool setSource, Ptr<NetDevice> interface)
+{
+    NS_LOG_FUNCTION(this << dst << interface);
+
+    // when sending on link-local multicast, there have to be interface specified
+    if (dst.IsLinkLocalMulticast())
+    {
+        NS_ASSERT_MSG(
+            interface,
+            "Try to send on link-local multicast address, and no interface index is given!");
+        Ptr<Ipv6Route> rtentry = Create<Ipv6Route>();
+        rtentry->SetSource(
+            m_ipv6->SourceAddressSelection(m_ipv6->GetInterfaceForDevice(interface), dst));
+        rtentry->SetDestination(dst);
+        rtentry->SetGateway(Ipv6Address::GetZero());
+        rtentry->SetOutputDevice(interface);
+        return rtentry;
+    }
+
+    for (const auto& route : m_routes)
+    {
+        if (!route.GetDestNetworkPrefix().IsMatch(dst, route.GetDestNetwork()))
+        {
+            continue;
+        }
+        // if interface is given, check the route will output on this interface
+        if (interface && interface != m_ipv6->GetNetDevice(route.GetInterface()))
+        {
+            continue;
+        }
+
+        Ptr<Ipv6Route> rtentry = Create<Ipv6Route>();
+        if (setSource)
+        {
+            rtentry->SetSource(m_ipv6->SourceAddressSelection(route.GetInterface(), dst));
+        }
+        rtentry->SetDestination(dst);
+        rtentry->SetGateway(route.GetGateway());
+        rtentry->SetOutputDevice(m_ipv6->GetNetDevice(route.GetInterface()));
+        return rtentry;
+    }
+    return nullptr;
+}
+
+}
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf6-routing.h
+ *
+ *  The routing half of OSPFv3 (RFC 5340), the IPv6 counterpart of
+ *  OspfRouting. It drives an OspfL4Protocol running version 3 and builds
+ *  the routing table from the same shortest path tree (OspfSpf), hanging
+ *  the prefixes of the Intra-Area-Prefix-LSAs off the routers they
+ *  reference (RFC 5340 4.8.1).
+ *
+ *  Only point-to-point links are supported, so next hops are the
+ *  link-local addresses the neighbors' Hellos come from and Link-LSAs are
+ *  not needed.
+ *
+ */
+
+#ifndef OSPF6_ROUTING_H
+#define OSPF6_ROUTING_H
+
+#include "ipv6-routing-protocol.h"
+#include "ospf-l4-protocol.h"
+#include "ospf-routing-table-entry.h"
+#include "ospf-spf.h"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+class Ospf6Routing : public Ipv6RoutingProtocol{
+public:
+    Ospf6Routing();
+    ~Ospf6Routing() override;
+    static TypeId GetTypeId();
+    Ospf6Routing(const Ospf6Routing&) = delete;
+    Ospf6Routing& operator=(const Ospf6Routing&) = delete;
+
+    /**
+     * \brief Set the IPv6 stack, and insert our OSPFv3 protocol into it.
+     * \param ipv6 the IPv6 stack
+     */
+    void SetIpv6(Ptr<Ipv6> ipv6) override;
+    void SetInterfaceExclusions(std::set<uint32_t> exceptions);
+
+    /**
+     * \brief Do not advertise the prefixes of some interfaces, see
+     * OspfL4Protocol::SetPrefixSuppressions.
+     * \param interfaces the interface indices
+     */
+    void SetPrefixSuppressions(std::set<uint32_t> interfaces);
+
+    /**
+     * \brief Run some interfaces as demand circuits, see
+     * OspfL4Protocol::SetDemandCircuits and the DemandCircuits attribute.
+     * \param interfaces the interface indices
+     */
+    void SetDemandCircuits(std::set<uint32_t> interfaces);
+
+    Ptr<Ipv6Route> RouteOutput(Ptr<Packet> p,
+                               const Ipv6Header& header,
+                               Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr) override;
+    bool RouteInput(Ptr<const Packet> p,
+                    const Ipv6Header& header,
+                    Ptr<const NetDevice> idev,
+                    const UnicastForwardCallback& ucb,
+                    const MulticastForwardCallback& mcb,
+                    const LocalDeliverCallback& lcb,
+                    const ErrorCallback& ecb) override;
+    void NotifyInterfaceUp(uint32_t interface) override;
+    void NotifyInterfaceDown(uint32_t interface) override;
+    void NotifyAddAddress(uint32_t interface, Ipv6InterfaceAddress address) override;
+    void NotifyRemoveAddress(uint32_t interface, Ipv6InterfaceAddress address) override;
+    void NotifyAddRoute(Ipv6Address dst,
+                        Ipv6Prefix mask,
+                        Ipv6Address nextHop,
+                        uint32_t interface,
+                        Ipv6Address prefixToUse = Ipv6Address::GetZero()) override;
+    void NotifyRemoveRoute(Ipv6Address dst,
+                           Ipv6Prefix mask,
+                           Ipv6Address nextHop,
+                           uint32_t interface,
+                           Ipv6Address prefixToUse = Ipv6Address::GetZero()) override;
+    void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
+                           Time::Unit unit = Time::S) const override;
+    void SetArea(int);
+    void SetInterfaceMetric(uint32_t, uint8_t);
+
+    /**
+     * \return the routes of the last shortest path calculation, longest
+     * prefix first
+     */
+    const std::vector<Ospf6RoutingTableEntry>& GetRoutes() const;
+
+    /**
+     * \return the last time a shortest path calculation changed the routing
+     * table
+     */
+    Time GetLastRouteChange() const;
+
+    /**
+     * \return the counters of this router, including the shortest path
+     * calculations
+     */
+    OspfStats GetStats() const;
+
+    /**
+     * \return the OSPFv3 protocol instance, e.g. to connect its trace
+     * sources
+     */
+    Ptr<OspfL4Protocol> GetProtocol() const;
+
+protected:
+    void DoInitialize() override;
+    void DoDispose() override;
+private:
+
+    /**
+     * \brief Schedule a shortest path calculation after SpfDelay.
+     */
+    void ScheduleSpf();
+
+    /**
+     * \brief Calculate the shortest path tree over the Router-LSAs, then
+     * rebuild the routing table from the Intra-Area-Prefix-LSAs
+     * (RFC 5340 4.8.1).
+     */
+    void RunSpf();
+
+    /**
+     * \brief Longest prefix match in the routing table.
+     * \param dst the destination
+     * \param setSource set the source address of the route
+     * \param interface the output device the route must use, if any
+     * \return the route, or nullptr
+     */
+    Ptr<Ipv6Route> Lookup(Ipv6Address dst, bool setSource, Ptr<NetDevice> interface = nullptr);
+
+    Ptr<OspfL4Protocol> m_ospf_protocol;            //!< The OSPFv3 instance
+    std::set<uint32_t> m_interfaceExclusions;
+    std::set<uint32_t> m_prefixSuppressions;        //!< See SetPrefixSuppressions
+    std::set<uint32_t> m_demandCircuits;            //!< See SetDemandCircuits
+    bool m_allDemandCircuits;                       //!< See the DemandCircuits attribute
+    Ptr<Ipv6> m_ipv6;
+
+    std::map<uint32_t, uint8_t> m_interfaceMetrics;
+
+    Time m_spfDelay;                                //!< Delay before a shortest path calculation
+    EventId m_spfEvent;                             //!< Pending shortest path calculation
+    std::vector<Ospf6RoutingTableEntry> m_routes;   //!< Routing table, longest prefix first
+    Time m_lastRouteChange;                         //!< See GetLastRouteChange
+    OspfStats m_spfStats;                           //!< Shortest path calculation counters
+    OspfSpf m_spf;                                  //!< Shortest path tree
+
+    /// Best path to a prefix found so far
+    struct PrefixCandidate
+    {
+        uint32_t cost;
+        uint32_t vertex;
+    };
+
+    /// By (prefix, length)
+    std::map<std::pair<Ipv6Address, uint8_t>, PrefixCandidate> m_prefixes;
+};
+}
+
+#endif // OSPF6_ROUTING_H
@@ -559,10 +559,13 @@ class Ipv4DeduplicationTestSuite : public TestSuite
 Ipv4DeduplicationTestSuite::Ipv4DeduplicationTestSuite()
     : TestSuite("ipv4-deduplication", UNIT)
 {
+    // the drops are counted by the Drop trace source of Ipv4L3Protocol
+#ifndef NS3_TRACING_DISABLE
     AddTestCase(new Ipv4DeduplicationTest(true), TestCase::QUICK);
     AddTestCase(new Ipv4DeduplicationTest(false), TestCase::QUICK);
     // degenerate case is enabled RFC but with too short an expiry
     AddTestCase(new Ipv4DeduplicationTest(true, MicroSeconds(50)), TestCase::QUICK);
+#endif
 }
 
 static Ipv4DeduplicationTestSuite
@@ -0,0 +1,1697 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ipv4-ospf-test.cc
+ *
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-list-routing-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/node-container.h"
+#include "ns3/ospf-checksum.h"
+#include "ns3/ospf-fib.h"
+#include "ns3/ospf-header.h"
+#include "ns3/ospf-hello.h"
+#include "ns3/ospf-helper.h"
+#include "ns3/ospf-l4-protocol.h"
+#include "ns3/ospf-lsa.h"
+#include "ns3/ospf-lsu.h"
+#include "ns3/ospf-routing.h"
+#include "ns3/ospf-stats.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief OSPF checksum kernels against byte at a time reference versions.
+ */
+class OspfChecksumTest : public TestCase
+{
+  public:
+    OspfChecksumTest();
+
+    void DoRun() override;
+
+  private:
+    /// RFC 1071 checksum, one big endian 16 bit word at a time
+    static uint16_t ReferenceInternetChecksum(const std::vector<uint8_t>& data);
+
+    /// ISO 8473 Fletcher C0/C1 recurrence, one byte at a time, LS age excluded
+    static uint16_t ReferenceLsaChecksum(std::vector<uint8_t> lsa);
+};
+
+OspfChecksumTest::OspfChecksumTest()
+    : TestCase("OSPF checksum kernels")
+{
+}
+
+uint16_t
+OspfChecksumTest::ReferenceInternetChecksum(const std::vector<uint8_t>& data)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < data.size(); i += 2)
+    {
+        uint16_t word = data[i] << 8;
+        if (i + 1 < data.size())
+        {
+            word |= data[i + 1];
+        }
+        sum += word;
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+uint16_t
+OspfChecksumTest::ReferenceLsaChecksum(std::vector<uint8_t> lsa)
+{
+    lsa[16] = 0;
+    lsa[17] = 0;
+    int32_t c0 = 0;
+    int32_t c1 = 0;
+    for (size_t i = 2; i < lsa.size(); i++)
+    {
+        c0 = (c0 + lsa[i]) % 255;
+        c1 = (c1 + c0) % 255;
+    }
+    int32_t length = lsa.size() - 2;
+    int32_t offset = 14;
+    int32_t x = ((length - offset - 1) * c0 - c1) % 255;
+    if (x <= 0)
+    {
+        x += 255;
+    }
+    int32_t y = 510 - c0 - x;
+    if (y > 255)
+    {
+        y -= 255;
+    }
+    return static_cast<uint16_t>((x << 8) | y);
+}
+
+void
+OspfChecksumTest::DoRun()
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    for (uint32_t size : {0U, 1U, 2U, 3U, 15U, 16U, 17U, 44U, 1499U, 1500U, 9001U})
+    {
+        std::vector<uint8_t> data(size);
+        for (auto& b : data)
+        {
+            b = byte(rng);
+        }
+        NS_TEST_EXPECT_MSG_EQ(OspfInternetChecksum(data.data(), size),
+                              ReferenceInternetChecksum(data),
+                              "Internet checksum of " << size << " bytes");
+    }
+
+    // Large LSAs span more than one block of the Fletcher kernel
+    for (uint32_t size : {20U, 21U, 36U, 4099U, 4100U, 65000U})
+    {
+        std::vector<uint8_t> lsa(size);
+        for (auto& b : lsa)
+        {
+            b = byte(rng);
+        }
+        uint16_t checksum = OspfLsaChecksum(lsa.data(), size);
+        NS_TEST_EXPECT_MSG_EQ(checksum,
+                              ReferenceLsaChecksum(lsa),
+                              "LS checksum of " << size << " bytes");
+
+        lsa[16] = checksum >> 8;
+        lsa[17] = checksum & 0xff;
+        NS_TEST_EXPECT_MSG_EQ(OspfLsaChecksumOk(lsa.data(), size), true, "LS checksum verifies");
+
+        lsa[0] ^= 0xff;
+        NS_TEST_EXPECT_MSG_EQ(OspfLsaChecksumOk(lsa.data(), size),
+                              true,
+                              "LS age is not covered by the LS checksum");
+
+        lsa[size - 1] ^= 0x01;
+        NS_TEST_EXPECT_MSG_EQ(OspfLsaChecksumOk(lsa.data(), size), false, "Corrupted LSA");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief OSPF header serialisation and packet checksum.
+ */
+class OspfHeaderChecksumTest : public TestCase
+{
+  public:
+    OspfHeaderChecksumTest();
+
+    void DoRun() override;
+};
+
+OspfHeaderChecksumTest::OspfHeaderChecksumTest()
+    : TestCase("OSPF header and packet checksum")
+{
+}
+
+void
+OspfHeaderChecksumTest::DoRun()
+{
+    OspfHello hello;
+    hello.setMask(Ipv4Mask("255.255.255.252"));
+    hello.setHelloInterval(10);
+    hello.setDeadInterval(40);
+    hello.setNeighbors({3, 7});
+
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(hello);
+
+    OspfHeader header;
+    header.SetPacketType(1);
+    header.SetRouterId(42);
+    header.SetAreaId(5);
+    header.SetPacketLength(packet->GetSize() + header.GetSerializedSize());
+    header.EnableChecksums();
+    packet->AddHeader(header);
+
+    NS_TEST_EXPECT_MSG_EQ(packet->GetSize(), 24 + 20 + 8, "Header and Hello sizes");
+
+    // Checksum of the whole packet, authentication excluded, is good
+    Ptr<Packet> copy = packet->Copy();
+    OspfHeader received;
+    received.EnableChecksums();
+    copy->RemoveHeader(received);
+    NS_TEST_EXPECT_MSG_EQ(received.IsChecksumOk(), true, "Packet checksum verifies");
+    NS_TEST_EXPECT_MSG_EQ(received.GetPacketType(), 1, "Packet type");
+    NS_TEST_EXPECT_MSG_EQ(received.GetRouterId(), 42, "Router ID");
+    NS_TEST_EXPECT_MSG_EQ(received.GetAreaId(), 5, "Area ID");
+    NS_TEST_EXPECT_MSG_EQ(received.GetPacketLength(), packet->GetSize(), "Packet length");
+
+    OspfHello receivedHello;
+    copy->RemoveHeader(receivedHello);
+    NS_TEST_EXPECT_MSG_EQ(receivedHello.getNeighbors().size(), 2, "Hello neighbors");
+    NS_TEST_EXPECT_MSG_EQ(receivedHello.hasNeighbor(7), true, "Hello neighbor");
+    NS_TEST_EXPECT_MSG_EQ(receivedHello.getMask(), Ipv4Mask("255.255.255.252"), "Hello mask");
+
+    // Corrupt one byte of the Hello body
+    std::vector<uint8_t> bytes(packet->GetSize());
+    packet->CopyData(bytes.data(), bytes.size());
+    bytes[30] ^= 0x10;
+    Ptr<Packet> corrupted = Create<Packet>(bytes.data(), bytes.size());
+    OspfHeader bad;
+    bad.EnableChecksums();
+    corrupted->RemoveHeader(bad);
+    NS_TEST_EXPECT_MSG_EQ(bad.IsChecksumOk(), false, "Corrupted packet");
+
+    // Without checksums enabled nothing is verified
+    corrupted = Create<Packet>(bytes.data(), bytes.size());
+    OspfHeader unchecked;
+    corrupted->RemoveHeader(unchecked);
+    NS_TEST_EXPECT_MSG_EQ(unchecked.IsChecksumOk(), true, "Verification is opt-in");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Differential test of OSPF against global routing.
+ *
+ * Both protocols are installed on the same point-to-point topology, every
+ * router also having a stub LAN. Once OSPF has converged, global routing
+ * populates its tables and the two are compared prefix by prefix. Where
+ * equal cost paths exist the protocols may pick different next hops, so
+ * each next hop is checked against shortest path distances computed here
+ * rather than against the other protocol.
+ */
+class OspfGlobalRoutingDifferentialTest : public TestCase
+{
+  public:
+    /// A (network, mask) pair
+    using Prefix = std::pair<uint32_t, uint32_t>;
+
+    /// Topologies under test
+    enum Topology
+    {
+        GRID,     //!< 3x3 grid
+        FAT_TREE, //!< k = 4 fat-tree, switches only
+        RANDOM,   //!< Random connected graph
+    };
+
+    /**
+     * Constructor
+     * \param topology the topology
+     */
+    OspfGlobalRoutingDifferentialTest(Topology topology);
+
+    void DoRun() override;
+
+  private:
+    /// Build m_nodeNumber and m_links for the topology
+    void BuildTopology();
+
+    /// Hop count from every router to every other one
+    void ComputeDistances();
+
+    /**
+     * \param node a router
+     * \param prefix a prefix
+     * \return the cost from the router to the prefix
+     */
+    uint32_t PrefixDistance(uint32_t node, const Prefix& prefix) const;
+
+    /**
+     * Check that a route of a router to a prefix leads one hop closer.
+     * \param protocol protocol name for messages
+     * \param node the router
+     * \param prefix the destination prefix
+     * \param gateway the next hop
+     */
+    void CheckNextHop(std::string protocol,
+                      uint32_t node,
+                      const Prefix& prefix,
+                      Ipv4Address gateway);
+
+    /**
+     * Check that a host route of a router leads one hop closer to the router
+     * owning the address.
+     * \param node the router
+     * \param host the destination address
+     * \param gateway the next hop
+     */
+    void CheckHostNextHop(uint32_t node, Ipv4Address host, Ipv4Address gateway);
+
+    /// Compare the OSPF and global routing tables of every router
+    void Compare();
+
+    Topology m_topology;                                //!< Topology under test
+    uint32_t m_nodeNumber;                              //!< Number of routers
+    std::vector<std::pair<uint32_t, uint32_t>> m_links; //!< Point-to-point links
+    NodeContainer m_nodes;                              //!< Routers
+    std::vector<std::vector<uint32_t>> m_distance;      //!< Router to router hop count
+    std::map<Ipv4Address, uint32_t> m_addressOwner;     //!< Interface address to router
+    /// Routers attached to each prefix
+    std::map<Prefix, std::vector<uint32_t>> m_prefixes;
+};
+
+OspfGlobalRoutingDifferentialTest::OspfGlobalRoutingDifferentialTest(Topology topology)
+    : TestCase(topology == GRID       ? "OSPF vs global routing, grid"
+               : topology == FAT_TREE ? "OSPF vs global routing, fat-tree"
+                                      : "OSPF vs global routing, random"),
+      m_topology(topology),
+      m_nodeNumber(0)
+{
+}
+
+void
+OspfGlobalRoutingDifferentialTest::BuildTopology()
+{
+    m_links.clear();
+    if (m_topology == GRID)
+    {
+        const uint32_t side = 3;
+        m_nodeNumber = side * side;
+        for (uint32_t row = 0; row < side; row++)
+        {
+            for (uint32_t col = 0; col < side; col++)
+            {
+                uint32_t node = row * side + col;
+                if (col + 1 < side)
+                {
+                    m_links.emplace_back(node, node + 1);
+                }
+                if (row + 1 < side)
+                {
+                    m_links.emplace_back(node, node + side);
+                }
+            }
+        }
+    }
+    else if (m_topology == FAT_TREE)
+    {
+        // Core switches first, then per pod the aggregation and edge switches
+        const uint32_t k = 4;
+        const uint32_t half = k / 2;
+        const uint32_t coreNumber = half * half;
+        m_nodeNumber = coreNumber + k * k;
+        for (uint32_t pod = 0; pod < k; pod++)
+        {
+            uint32_t aggregation = coreNumber + pod * k;
+            uint32_t edge = aggregation + half;
+            for (uint32_t a = 0; a < half; a++)
+            {
+                for (uint32_t c = 0; c < half; c++)
+                {
+                    m_links.emplace_back(a * half + c, aggregation + a);
+                }
+                for (uint32_t e = 0; e < half; e++)
+                {
+                    m_links.emplace_back(aggregation + a, edge + e);
+                }
+            }
+        }
+    }
+    else
+    {
+        // A random spanning tree, then random extra links
+        m_nodeNumber = 16;
+        std::mt19937 rng(7);
+        std::set<std::pair<uint32_t, uint32_t>> seen;
+        for (uint32_t node = 1; node < m_nodeNumber; node++)
+        {
+            uint32_t parent = std::uniform_int_distribution<uint32_t>(0, node - 1)(rng);
+            m_links.emplace_back(parent, node);
+            seen.emplace(parent, node);
+        }
+        std::uniform_int_distribution<uint32_t> pick(0, m_nodeNumber - 1);
+        while (m_links.size() < 2 * m_nodeNumber)
+        {
+            uint32_t a = pick(rng);
+            uint32_t b = pick(rng);
+            if (a == b)
+            {
+                continue;
+            }
+            if (seen.emplace(std::min(a, b), std::max(a, b)).second)
+            {
+                m_links.emplace_back(std::min(a, b), std::max(a, b));
+            }
+        }
+    }
+}
+
+void
+OspfGlobalRoutingDifferentialTest::ComputeDistances()
+{
+    std::vector<std::vector<uint32_t>> adjacency(m_nodeNumber);
+    for (const auto& link : m_links)
+    {
+        adjacency[link.first].push_back(link.second);
+        adjacency[link.second].push_back(link.first);
+    }
+
+    m_distance.assign(m_nodeNumber, std::vector<uint32_t>(m_nodeNumber, UINT32_MAX));
+    for (uint32_t source = 0; source < m_nodeNumber; source++)
+    {
+        std::deque<uint32_t> queue{source};
+        m_distance[source][source] = 0;
+        while (!queue.empty())
+        {
+            uint32_t node = queue.front();
+            queue.pop_front();
+            for (uint32_t next : adjacency[node])
+            {
+                if (m_distance[source][next] == UINT32_MAX)
+                {
+                    m_distance[source][next] = m_distance[source][node] + 1;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+}
+
+uint32_t
+OspfGlobalRoutingDifferentialTest::PrefixDistance(
+    uint32_t node,
+    const Prefix& prefix) const
+{
+    uint32_t distance = UINT32_MAX;
+    auto it = m_prefixes.find(prefix);
+    if (it != m_prefixes.end())
+    {
+        for (uint32_t attached : it->second)
+        {
+            distance = std::min(distance, m_distance[node][attached] + 1);
+        }
+    }
+    return distance;
+}
+
+void
+OspfGlobalRoutingDifferentialTest::CheckNextHop(std::string protocol,
+                                                uint32_t node,
+                                                const Prefix& prefix,
+                                                Ipv4Address gateway)
+{
+    auto owner = m_addressOwner.find(gateway);
+    NS_TEST_ASSERT_MSG_EQ((owner != m_addressOwner.end()),
+                          true,
+                          protocol << " next hop " << gateway << " of node " << node
+                                   << " is not a router address");
+    uint32_t next = owner->second;
+    NS_TEST_EXPECT_MSG_EQ(m_distance[node][next],
+                          1,
+                          protocol << " next hop of node " << node << " is not a neighbor");
+    NS_TEST_EXPECT_MSG_EQ(PrefixDistance(next, prefix) + 1,
+                          PrefixDistance(node, prefix),
+                          protocol << " route of node " << node << " to "
+                                   << Ipv4Address(prefix.first) << " is not on a shortest path");
+}
+
+void
+OspfGlobalRoutingDifferentialTest::CheckHostNextHop(uint32_t node,
+                                                    Ipv4Address host,
+                                                    Ipv4Address gateway)
+{
+    auto owner = m_addressOwner.find(host);
+    auto next = m_addressOwner.find(gateway);
+    NS_TEST_ASSERT_MSG_EQ((owner != m_addressOwner.end() && next != m_addressOwner.end()),
+                          true,
+                          "Global routing host route of node " << node << " to " << host);
+    NS_TEST_EXPECT_MSG_EQ(m_distance[next->second][owner->second] + 1,
+                          m_distance[node][owner->second],
+                          "Global routing route of node " << node << " to " << host
+                                                          << " is not on a shortest path");
+}
+
+void
+OspfGlobalRoutingDifferentialTest::Compare()
+{
+    for (uint32_t node = 0; node < m_nodeNumber; node++)
+    {
+        Ptr<Ipv4> ipv4 = m_nodes.Get(node)->GetObject<Ipv4>();
+        Ptr<OspfRouting> ospf =
+            Ipv4RoutingHelper::GetRouting<OspfRouting>(ipv4->GetRoutingProtocol());
+        Ptr<Ipv4GlobalRouting> global =
+            Ipv4RoutingHelper::GetRouting<Ipv4GlobalRouting>(ipv4->GetRoutingProtocol());
+
+        // Global routing leaves connected networks to static routing, so
+        // only remote prefixes are compared
+        std::set<Prefix> connectedPrefixes;
+        std::set<Prefix> ospfPrefixes;
+        for (const auto& route : ospf->GetRoutes())
+        {
+            Prefix prefix(route.GetDestNetwork().Get(), route.GetDestNetworkMask().Get());
+            if (route.GetGateway() == Ipv4Address::GetZero())
+            {
+                connectedPrefixes.insert(prefix);
+                continue;
+            }
+            ospfPrefixes.insert(prefix);
+            CheckNextHop("OSPF", node, prefix, route.GetGateway());
+            NS_TEST_EXPECT_MSG_EQ(route.GetMetric(),
+                                  PrefixDistance(node, prefix),
+                                  "OSPF metric of node " << node << " to "
+                                                         << Ipv4Address(prefix.first));
+        }
+
+        // Global routing has a route per router advertising a prefix, in
+        // shortest path tree order rather than cost order, and the first one
+        // is used. The addresses of a link are reached by host routes, so only
+        // those and the routes to the LANs are checked.
+        std::set<Ipv4Address> globalHosts;
+        std::set<Prefix> globalPrefixes;
+        for (uint32_t i = 0; i < global->GetNRoutes(); i++)
+        {
+            Ipv4RoutingTableEntry* route = global->GetRoute(i);
+            if (route->IsHost())
+            {
+                // Host routes to the interfaces of other routers are covered
+                // by routes to the link prefixes
+                Ipv4Address host = route->GetDest();
+                bool covered = false;
+                for (const auto& prefixes : {connectedPrefixes, ospfPrefixes})
+                {
+                    for (const auto& prefix : prefixes)
+                    {
+                        covered = covered ||
+                                  Ipv4Mask(prefix.second).IsMatch(host, Ipv4Address(prefix.first));
+                    }
+                }
+                NS_TEST_EXPECT_MSG_EQ(covered,
+                                      true,
+                                      "OSPF of node " << node << " has no route to " << host);
+                if (globalHosts.insert(host).second)
+                {
+                    CheckHostNextHop(node, host, route->GetGateway());
+                }
+                continue;
+            }
+            Prefix prefix(route->GetDestNetwork().Get(), route->GetDestNetworkMask().Get());
+            if (connectedPrefixes.count(prefix) || !globalPrefixes.insert(prefix).second)
+            {
+                continue;
+            }
+            if (m_prefixes[prefix].size() == 1)
+            {
+                CheckNextHop("Global routing", node, prefix, route->GetGateway());
+            }
+        }
+
+        NS_TEST_EXPECT_MSG_EQ(ospfPrefixes.size() + connectedPrefixes.size(),
+                              m_prefixes.size(),
+                              "OSPF of node " << node << " reaches every remote prefix");
+        NS_TEST_EXPECT_MSG_EQ((ospfPrefixes == globalPrefixes),
+                              true,
+                              "OSPF and global routing prefixes of node " << node);
+        NS_TEST_EXPECT_MSG_LT(ospf->GetLastRouteChange(),
+                              Simulator::Now(),
+                              "OSPF of node " << node << " converged");
+    }
+}
+
+void
+OspfGlobalRoutingDifferentialTest::DoRun()
+{
+    BuildTopology();
+    ComputeDistances();
+
+    m_nodes.Create(m_nodeNumber);
+
+    OspfHelper ospfHelper;
+    Ipv4GlobalRoutingHelper globalHelper;
+    Ipv4ListRoutingHelper listHelper;
+    listHelper.Add(ospfHelper, 10);
+    listHelper.Add(globalHelper, -10);
+
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(listHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    SimpleNetDeviceHelper lanHelper;
+    Ipv4AddressHelper address;
+
+    m_addressOwner.clear();
+    m_prefixes.clear();
+    Ipv4Mask mask;
+    auto assign = [this, &address, &mask](NetDeviceContainer devices,
+                                          std::vector<uint32_t> routers) {
+        Ipv4InterfaceContainer interfaces = address.Assign(devices);
+        for (uint32_t i = 0; i < routers.size(); i++)
+        {
+            m_addressOwner[interfaces.GetAddress(i)] = routers[i];
+        }
+        Ipv4Address network = interfaces.GetAddress(0).CombineMask(mask);
+        m_prefixes[Prefix(network.Get(), mask.Get())] = routers;
+        address.NewNetwork();
+    };
+
+    mask = Ipv4Mask("255.255.255.252");
+    address.SetBase("10.0.0.0", mask);
+    for (const auto& link : m_links)
+    {
+        NodeContainer pair(m_nodes.Get(link.first), m_nodes.Get(link.second));
+        assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()),
+               {link.first, link.second});
+    }
+
+    mask = Ipv4Mask("255.255.255.0");
+    address.SetBase("10.128.0.0", mask);
+    for (uint32_t node = 0; node < m_nodeNumber; node++)
+    {
+        assign(lanHelper.Install(m_nodes.Get(node), CreateObject<SimpleChannel>()), {node});
+    }
+
+    Simulator::Schedule(Seconds(90), &Ipv4GlobalRoutingHelper::PopulateRoutingTables);
+    Simulator::Schedule(Seconds(91), &OspfGlobalRoutingDifferentialTest::Compare, this);
+    Simulator::Stop(Seconds(92));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    m_nodes = NodeContainer();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the OSPF counters and trace sources on a line of three routers.
+ */
+class OspfStatsTest : public TestCase
+{
+  public:
+    OspfStatsTest();
+    void DoRun() override;
+
+  private:
+    /**
+     * NeighborState trace sink
+     * \param routerId the neighbor router ID
+     * \param interface the interface index
+     * \param oldState the previous state
+     * \param newState the new state
+     */
+    void NeighborState(uint32_t routerId, uint32_t interface, int oldState, int newState);
+
+    /**
+     * LsaInstall trace sink
+     * \param lsa the installed LSA
+     */
+    void LsaInstall(Ptr<const OspfLsa> lsa);
+
+    uint64_t m_transitions;   //!< NeighborState trace calls
+    uint64_t m_fullNeighbors; //!< Transitions to FULL
+    uint64_t m_installs;      //!< LsaInstall trace calls
+};
+
+OspfStatsTest::OspfStatsTest()
+    : TestCase("OSPF counters and trace sources"),
+      m_transitions(0),
+      m_fullNeighbors(0),
+      m_installs(0)
+{
+}
+
+void
+OspfStatsTest::NeighborState(uint32_t routerId, uint32_t interface, int oldState, int newState)
+{
+    NS_TEST_EXPECT_MSG_NE(oldState, newState, "Transition of neighbor " << routerId);
+    m_transitions++;
+    if (newState == OspfL4Protocol::FULL)
+    {
+        m_fullNeighbors++;
+    }
+}
+
+void
+OspfStatsTest::LsaInstall(Ptr<const OspfLsa> lsa)
+{
+    m_installs++;
+}
+
+void
+OspfStatsTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+
+    OspfHelper ospfHelper;
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(ospfHelper);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    for (uint32_t node = 0; node + 1 < nodes.GetN(); node++)
+    {
+        NodeContainer pair(nodes.Get(node), nodes.Get(node + 1));
+        address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address.NewNetwork();
+    }
+
+    for (uint32_t node = 0; node < nodes.GetN(); node++)
+    {
+        Ptr<OspfL4Protocol> protocol = nodes.Get(node)->GetObject<OspfL4Protocol>();
+        protocol->TraceConnectWithoutContext("NeighborState",
+                                             MakeCallback(&OspfStatsTest::NeighborState, this));
+        protocol->TraceConnectWithoutContext("LsaInstall",
+                                             MakeCallback(&OspfStatsTest::LsaInstall, this));
+    }
+
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+
+    OspfStats total;
+    for (uint32_t node = 0; node < nodes.GetN(); node++)
+    {
+        Ptr<OspfRouting> routing = nodes.Get(node)->GetObject<OspfRouting>();
+        OspfStats stats = routing->GetStats();
+        NS_TEST_EXPECT_MSG_EQ(stats.lsdbSize, 3, "Router LSAs in the LSDB of node " << node);
+        NS_TEST_EXPECT_MSG_GT(stats.spfRuns, 0, "Shortest path calculations of node " << node);
+        uint64_t histogramTotal = 0;
+        for (uint64_t count : stats.spfHistogram)
+        {
+            histogramTotal += count;
+        }
+        NS_TEST_EXPECT_MSG_EQ(histogramTotal, stats.spfRuns, "SPF histogram of node " << node);
+        total += stats;
+    }
+
+    for (uint32_t type = OspfL4Protocol::HELLO; type <= OspfL4Protocol::LSAck; type++)
+    {
+        NS_TEST_EXPECT_MSG_GT(total.packetsSent[type], 0, "Packets of type " << type << " sent");
+        NS_TEST_EXPECT_MSG_EQ(total.packetsReceived[type],
+                              total.packetsSent[type],
+                              "Packets of type " << type << " received on a lossless line");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_fullNeighbors, 4, "Both adjacencies FULL at both ends");
+    NS_TEST_EXPECT_MSG_EQ(total.neighborTransitions, m_transitions, "NeighborState trace");
+    NS_TEST_EXPECT_MSG_EQ(total.lsaInstalls, m_installs, "LsaInstall trace");
+    NS_TEST_EXPECT_MSG_GT(m_installs, 0, "LSAs installed");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief OSPF in a distributed simulation.
+ *
+ * Packets crossing ranks are serialised to bytes, so an update must survive
+ * the Packet::Serialize round trip MpiInterface::SendPacket performs. Nodes
+ * owned by another rank must keep their protocol dormant.
+ */
+class OspfDistributedTest : public TestCase
+{
+  public:
+    OspfDistributedTest();
+    void DoRun() override;
+};
+
+OspfDistributedTest::OspfDistributedTest()
+    : TestCase("OSPF wire round trip and rank ownership")
+{
+}
+
+void
+OspfDistributedTest::DoRun()
+{
+    Ptr<OspfLsa> lsa = Create<OspfLsa>();
+    lsa->GetHeader().linkStateId = 42;
+    lsa->GetHeader().advertisingRouter = 42;
+    lsa->GetHeader().sequence = OspfLsa::INITIAL_SEQUENCE_NUMBER + 3;
+    lsa->AddRouterLink(7, 0x0a000001, OspfLsa::POINT_TO_POINT, 10);
+    lsa->AddRouterLink(0x0a000000, 0xfffffffc, OspfLsa::STUB_NETWORK, 10);
+    lsa->UpdateChecksum();
+
+    OspfLsUpdate update;
+    update.AddLsa(lsa, 5);
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(update);
+    OspfHeader header;
+    header.SetPacketType(OspfL4Protocol::LSU);
+    header.SetRouterId(42);
+    header.SetPacketLength(packet->GetSize() + header.GetSerializedSize());
+    header.EnableChecksums();
+    packet->AddHeader(header);
+
+    std::vector<uint8_t> buffer(packet->GetSerializedSize());
+    uint32_t serialized = packet->Serialize(buffer.data(), buffer.size());
+    NS_TEST_ASSERT_MSG_EQ(serialized, 1, "Packet serialised");
+    Ptr<Packet> remote = Create<Packet>(buffer.data(), buffer.size(), true);
+    packet = nullptr;
+    update = OspfLsUpdate();
+    lsa = nullptr;
+
+    OspfHeader receivedHeader;
+    receivedHeader.EnableChecksums();
+    remote->RemoveHeader(receivedHeader);
+    NS_TEST_EXPECT_MSG_EQ(receivedHeader.IsChecksumOk(), true, "Packet checksum");
+    NS_TEST_EXPECT_MSG_EQ(receivedHeader.GetPacketType(), OspfL4Protocol::LSU, "Packet type");
+    NS_TEST_EXPECT_MSG_EQ(receivedHeader.GetRouterId(), 42, "Router ID");
+
+    OspfLsUpdate receivedUpdate;
+    remote->RemoveHeader(receivedUpdate);
+    NS_TEST_ASSERT_MSG_EQ(receivedUpdate.GetLsaNumber(), 1, "LSAs in the update");
+    Ptr<OspfLsa> receivedLsa = receivedUpdate.GetLsas()[0];
+    NS_TEST_EXPECT_MSG_EQ(receivedLsa->GetHeader().age, 5, "LS age");
+    NS_TEST_EXPECT_MSG_EQ(receivedLsa->GetHeader().sequence,
+                          OspfLsa::INITIAL_SEQUENCE_NUMBER + 3,
+                          "LS sequence number");
+    NS_TEST_EXPECT_MSG_EQ(receivedLsa->IsChecksumOk(), true, "LS checksum");
+    NS_TEST_ASSERT_MSG_EQ(receivedLsa->GetRouterLinks().size(), 2, "Router links");
+    NS_TEST_EXPECT_MSG_EQ(receivedLsa->GetRouterLinks()[0].linkId, 7, "Neighbor router ID");
+    NS_TEST_EXPECT_MSG_EQ(remote->GetSize(), 0, "Nothing left over");
+
+    // A line whose second half belongs to rank 1, this process being rank 0
+    NodeContainer nodes;
+    nodes.Create(2, 0);
+    nodes.Create(2, 1);
+
+    OspfHelper ospfHelper;
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(ospfHelper);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    for (uint32_t node = 0; node + 1 < nodes.GetN(); node++)
+    {
+        NodeContainer pair(nodes.Get(node), nodes.Get(node + 1));
+        address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address.NewNetwork();
+    }
+
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+
+    for (uint32_t node = 0; node < nodes.GetN(); node++)
+    {
+        OspfStats stats = nodes.Get(node)->GetObject<OspfRouting>()->GetStats();
+        uint64_t sent = 0;
+        for (uint64_t count : stats.packetsSent)
+        {
+            sent += count;
+        }
+        if (node < 2)
+        {
+            NS_TEST_EXPECT_MSG_EQ(stats.lsdbSize, 2, "Local routers only, node " << node);
+            NS_TEST_EXPECT_MSG_GT(sent, 0, "Packets sent by local node " << node);
+        }
+        else
+        {
+            NS_TEST_EXPECT_MSG_EQ(stats.lsdbSize, 0, "Empty LSDB on remote node " << node);
+            NS_TEST_EXPECT_MSG_EQ(sent, 0, "Nothing sent by remote node " << node);
+        }
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Frozen forwarding table.
+ *
+ * A hand made table of nested prefixes is compiled and checked against a
+ * linear longest prefix match, then a converged line of routers is frozen
+ * and must thaw when a link goes down.
+ */
+class OspfFrozenFibTest : public TestCase
+{
+  public:
+    OspfFrozenFibTest();
+    void DoRun() override;
+};
+
+OspfFrozenFibTest::OspfFrozenFibTest()
+    : TestCase("OSPF frozen forwarding table")
+{
+}
+
+void
+OspfFrozenFibTest::DoRun()
+{
+    // A router with two interfaces to hang routes off
+    NodeContainer nodes;
+    nodes.Create(3);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes.Get(0));
+    OspfHelper ospfHelper;
+    internet.SetRoutingHelper(ospfHelper);
+    internet.Install(NodeContainer(nodes.Get(1), nodes.Get(2)));
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    for (uint32_t node = 0; node + 1 < nodes.GetN(); node++)
+    {
+        NodeContainer pair(nodes.Get(node), nodes.Get(node + 1));
+        address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address.NewNetwork();
+    }
+    Ptr<Ipv4> ipv4 = nodes.Get(1)->GetObject<Ipv4>();
+
+    std::vector<OspfRoutingTableEntry> routes;
+    auto add = [&routes](const char* network, const char* mask, uint32_t interface) {
+        routes.emplace_back(Ipv4Address(network),
+                            Ipv4Mask(mask),
+                            Ipv4Address("10.0.0.1"),
+                            interface);
+    };
+    add("10.1.2.128", "255.255.255.128", 2);
+    add("10.1.2.0", "255.255.255.0", 1);
+    add("10.1.0.0", "255.255.0.0", 2);
+    add("192.168.0.0", "255.255.0.0", 1);
+    add("10.0.0.0", "255.0.0.0", 1);
+    add("10.0.0.0", "255.0.0.0", 2); // Shadowed by the previous one
+    add("255.255.255.255", "255.255.255.255", 2);
+    add("0.0.0.0", "255.255.255.255", 1);
+
+    for (bool withDefault : {false, true})
+    {
+        if (withDefault)
+        {
+            add("0.0.0.0", "0.0.0.0", 2);
+        }
+        OspfFib fib;
+        fib.Compile(routes, ipv4);
+
+        std::mt19937 rng(7);
+        std::vector<uint32_t> destinations = {0, 1, 0x0a000000, 0x0a0102ff, 0x0a010280, 0x0a01027f,
+                                              0x0a010200, 0x0a0101ff, 0x0a020000, 0xffffffff,
+                                              0xfffffffe, 0xc0a80000, 0xc0a7ffff, 0xc0a90000};
+        for (uint32_t i = 0; i < 2000; i++)
+        {
+            uint32_t random = rng();
+            // Keep most of them near the prefixes
+            destinations.push_back(i % 2 ? random : (0x0a010000 | (random & 0x3ff)));
+        }
+
+        for (uint32_t destination : destinations)
+        {
+            Ipv4Address dst(destination);
+            const OspfRoutingTableEntry* expected = nullptr;
+            for (const auto& route : routes)
+            {
+                if (route.GetDestNetworkMask().IsMatch(dst, route.GetDestNetwork()) &&
+                    (!expected || route.GetDestNetworkMask().GetPrefixLength() >
+                                      expected->GetDestNetworkMask().GetPrefixLength()))
+                {
+                    expected = &route;
+                }
+            }
+            Ptr<Ipv4Route> found = fib.Lookup(dst);
+            bool same = expected ? found && found->GetOutputDevice() ==
+                                                ipv4->GetNetDevice(expected->GetInterface())
+                                 : !found;
+            NS_TEST_EXPECT_MSG_EQ(same, true, "Lookup of " << dst << " default " << withDefault);
+            if (found)
+            {
+                NS_TEST_EXPECT_MSG_EQ(found->GetGateway(), Ipv4Address("10.0.0.1"), "Gateway");
+            }
+        }
+    }
+
+    // A line of two OSPF routers, frozen once converged
+    Ptr<OspfRouting> routing = nodes.Get(1)->GetObject<OspfRouting>();
+    OspfHelper::FreezeAt(Seconds(30), NodeContainer(nodes.Get(1), nodes.Get(2)));
+    bool frozenAt40 = false;
+    Ptr<Ipv4Route> frozenRoute;
+    Simulator::Schedule(Seconds(40), [&]() {
+        frozenAt40 = routing->IsFrozen();
+        Ipv4Header header;
+        header.SetDestination(Ipv4Address("10.0.0.1"));
+        Socket::SocketErrno error;
+        frozenRoute = routing->RouteOutput(nullptr, header, nullptr, error);
+    });
+    Ptr<Ipv4> remote = nodes.Get(2)->GetObject<Ipv4>();
+    Simulator::Schedule(Seconds(50), &Ipv4::SetDown, remote, 1);
+    Simulator::Stop(Seconds(100));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(frozenAt40, true, "Frozen after FreezeAt");
+    NS_TEST_ASSERT_MSG_NE(frozenRoute, nullptr, "Route from the frozen table");
+    NS_TEST_EXPECT_MSG_EQ(frozenRoute->GetSource(), Ipv4Address("10.0.0.2"), "Source address");
+    NS_TEST_EXPECT_MSG_EQ(frozenRoute->GetOutputDevice(),
+                          ipv4->GetNetDevice(1),
+                          "Output device");
+    NS_TEST_EXPECT_MSG_EQ(routing->IsFrozen(), false, "Thawed by the link failure");
+    NS_TEST_EXPECT_MSG_EQ(routing->GetRoutes().size(), 2, "Routes recalculated after thawing");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Graceful restart.
+ *
+ * The second router of a line restarts for a few seconds. Gracefully, the
+ * other routers must not notice and the restarting one must keep its routes
+ * until its LSDB is back; otherwise every router recalculates its routes.
+ */
+class OspfGracefulRestartTest : public TestCase
+{
+  public:
+    OspfGracefulRestartTest();
+    void DoRun() override;
+};
+
+OspfGracefulRestartTest::OspfGracefulRestartTest()
+    : TestCase("OSPF graceful restart")
+{
+}
+
+void
+OspfGracefulRestartTest::DoRun()
+{
+    // A Grace-LSA body survives the wire
+    Ptr<OspfLsa> grace = Create<OspfLsa>();
+    grace->GetHeader().type = OspfLsa::LINK_LOCAL_OPAQUE_LSA;
+    grace->GetHeader().linkStateId = uint32_t(OspfLsa::GRACE_OPAQUE_TYPE) << 24;
+    grace->AddTlv(OspfLsa::GRACE_PERIOD_TLV, uint32_t(120));
+    grace->AddTlv(OspfLsa::RESTART_REASON_TLV, std::vector<uint8_t>{1});
+    grace->UpdateChecksum();
+    Buffer buffer;
+    buffer.AddAtStart(grace->GetSerializedSize());
+    Buffer::Iterator start = buffer.Begin();
+    grace->Serialize(start, 0);
+    Ptr<OspfLsa> received = Create<OspfLsa>();
+    start = buffer.Begin();
+    NS_TEST_EXPECT_MSG_EQ(received->Deserialize(start), grace->GetSerializedSize(), "Length");
+    NS_TEST_EXPECT_MSG_EQ(received->IsChecksumOk(), true, "Grace-LSA checksum");
+    NS_TEST_EXPECT_MSG_EQ(received->HasSameContent(*grace), true, "Grace-LSA TLVs");
+    NS_TEST_ASSERT_MSG_NE(received->FindTlv(OspfLsa::RESTART_REASON_TLV), nullptr, "Reason");
+    NS_TEST_EXPECT_MSG_EQ(received->FindTlv(OspfLsa::RESTART_REASON_TLV)->value.size(),
+                          1,
+                          "Reason unpadded");
+
+    for (bool graceful : {true, false})
+    {
+        NodeContainer nodes;
+        nodes.Create(4);
+        OspfHelper ospfHelper;
+        InternetStackHelper internet;
+        internet.SetIpv6StackInstall(false);
+        internet.SetRoutingHelper(ospfHelper);
+        internet.Install(nodes);
+
+        SimpleNetDeviceHelper p2pHelper;
+        p2pHelper.SetNetDevicePointToPointMode(true);
+        Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+        for (uint32_t node = 0; node + 1 < nodes.GetN(); node++)
+        {
+            NodeContainer pair(nodes.Get(node), nodes.Get(node + 1));
+            address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+            address.NewNetwork();
+        }
+
+        Ptr<OspfL4Protocol> restarting = nodes.Get(1)->GetObject<OspfL4Protocol>();
+        Ptr<OspfRouting> routing = nodes.Get(1)->GetObject<OspfRouting>();
+        std::vector<uint64_t> spfRuns(nodes.GetN());
+        size_t routesBefore = 0;
+        Simulator::Schedule(Seconds(100), [&]() {
+            for (uint32_t node = 0; node < nodes.GetN(); node++)
+            {
+                spfRuns[node] = nodes.Get(node)->GetObject<OspfRouting>()->GetStats().spfRuns;
+            }
+            routesBefore = routing->GetRoutes().size();
+            restarting->Restart(Seconds(5), graceful);
+        });
+        bool restartingAt103 = false;
+        size_t routesAt103 = 0;
+        uint32_t helpedAt103 = 0;
+        Simulator::Schedule(Seconds(103), [&]() {
+            restartingAt103 = restarting->IsRestarting();
+            routesAt103 = routing->GetRoutes().size();
+            helpedAt103 = nodes.Get(0)->GetObject<OspfL4Protocol>()->GetHelpedNeighborNumber() +
+                          nodes.Get(2)->GetObject<OspfL4Protocol>()->GetHelpedNeighborNumber();
+        });
+        Simulator::Stop(Seconds(200));
+        Simulator::Run();
+
+        NS_TEST_EXPECT_MSG_EQ(routesBefore, 3, "Converged before the restart");
+        NS_TEST_EXPECT_MSG_EQ(restartingAt103, graceful, "In graceful restart");
+        size_t routesKept = graceful ? routesBefore : 0;
+        uint32_t helpers = graceful ? 2 : 0;
+        NS_TEST_EXPECT_MSG_EQ(routesAt103, routesKept, "Routes kept only by a graceful restart");
+        NS_TEST_EXPECT_MSG_EQ(helpedAt103, helpers, "Helpers");
+        NS_TEST_EXPECT_MSG_EQ(restarting->IsRestarting(), false, "Graceful restart left");
+        NS_TEST_EXPECT_MSG_EQ(routing->GetRoutes().size(), routesBefore, "Routes back");
+        for (uint32_t node = 0; node < nodes.GetN(); node++)
+        {
+            OspfStats stats = nodes.Get(node)->GetObject<OspfRouting>()->GetStats();
+            NS_TEST_EXPECT_MSG_EQ(stats.lsdbSize, 4, "Resynchronised LSDB, node " << node);
+            NS_TEST_EXPECT_MSG_EQ(nodes.Get(node)->GetObject<OspfL4Protocol>()
+                                      ->GetHelpedNeighborNumber(),
+                                  0,
+                                  "No helping left, node " << node);
+            if (node == 1)
+            {
+                continue;
+            }
+            if (graceful)
+            {
+                NS_TEST_EXPECT_MSG_EQ(stats.spfRuns, spfRuns[node], "No SPF, node " << node);
+            }
+            else
+            {
+                NS_TEST_EXPECT_MSG_GT(stats.spfRuns, spfRuns[node], "SPF, node " << node);
+            }
+        }
+
+        Simulator::Destroy();
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Stub router on startup (RFC 6987).
+ *
+ * A ring where the shortest way to a network goes through a router
+ * advertising MaxLinkMetric on startup: traffic must take the long way round
+ * until the router leaves the stub router mode.
+ */
+class OspfMaxMetricTest : public TestCase
+{
+  public:
+    OspfMaxMetricTest();
+    void DoRun() override;
+};
+
+OspfMaxMetricTest::OspfMaxMetricTest()
+    : TestCase("OSPF stub router on startup")
+{
+}
+
+void
+OspfMaxMetricTest::DoRun()
+{
+    for (bool untilConverged : {false, true})
+    {
+        // 0 - 1 - 2 - 5 with a longer way 0 - 3 - 4 - 2, node 5 not running OSPF
+        NodeContainer nodes;
+        nodes.Create(6);
+        InternetStackHelper internet;
+        internet.SetIpv6StackInstall(false);
+        internet.Install(nodes.Get(5));
+        OspfHelper stubHelper;
+        if (untilConverged)
+        {
+            stubHelper.SetMaxMetricUntilConverged();
+        }
+        else
+        {
+            stubHelper.SetMaxMetricOnStartup(Seconds(60));
+        }
+        internet.SetRoutingHelper(stubHelper);
+        internet.Install(nodes.Get(1));
+        OspfHelper ospfHelper;
+        internet.SetRoutingHelper(ospfHelper);
+        internet.Install(NodeContainer(nodes.Get(0), nodes.Get(2), nodes.Get(3), nodes.Get(4)));
+
+        SimpleNetDeviceHelper p2pHelper;
+        p2pHelper.SetNetDevicePointToPointMode(true);
+        Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+        for (auto link : std::vector<std::pair<uint32_t, uint32_t>>{{0, 1},
+                                                                    {1, 2},
+                                                                    {0, 3},
+                                                                    {3, 4},
+                                                                    {4, 2},
+                                                                    {2, 5}})
+        {
+            NodeContainer pair(nodes.Get(link.first), nodes.Get(link.second));
+            address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+            address.NewNetwork();
+        }
+
+        Ptr<OspfRouting> stub = nodes.Get(1)->GetObject<OspfRouting>();
+        Ptr<OspfRouting> routing = nodes.Get(0)->GetObject<OspfRouting>();
+        auto gateway = [routing]() {
+            for (const auto& route : routing->GetRoutes())
+            {
+                if (route.GetDestNetwork() == Ipv4Address("10.0.0.20"))
+                {
+                    return route.GetGateway();
+                }
+            }
+            return Ipv4Address::GetZero();
+        };
+        bool maxMetricAtStart = false;
+        Simulator::Schedule(Seconds(0), [&]() { maxMetricAtStart = stub->IsMaxMetric(); });
+        Ipv4Address gatewayAt40;
+        bool maxMetricAt40 = false;
+        Simulator::Schedule(Seconds(40), [&]() {
+            gatewayAt40 = gateway();
+            maxMetricAt40 = stub->IsMaxMetric();
+        });
+        Simulator::Stop(Seconds(100));
+        Simulator::Run();
+
+        NS_TEST_EXPECT_MSG_EQ(maxMetricAtStart, true, "Stub router from startup");
+        NS_TEST_EXPECT_MSG_EQ(maxMetricAt40, !untilConverged, "Stub router at 40s");
+        // Through node 1 (10.0.0.2) once it carries transit traffic, else node 3 (10.0.0.10)
+        Ipv4Address expected(untilConverged ? "10.0.0.2" : "10.0.0.10");
+        NS_TEST_EXPECT_MSG_EQ(gatewayAt40, expected, "Gateway at 40s");
+        NS_TEST_EXPECT_MSG_EQ(stub->IsMaxMetric(), false, "Stub router mode left");
+        NS_TEST_EXPECT_MSG_EQ(gateway(), Ipv4Address("10.0.0.2"), "Shortest way at the end");
+
+        Simulator::Destroy();
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Prefix suppression (RFC 6860) and loopback addresses.
+ *
+ * A line of routers addressed by their loopbacks, the prefixes of the links
+ * between them suppressed: only the loopbacks must be routed.
+ */
+class OspfPrefixSuppressionTest : public TestCase
+{
+  public:
+    OspfPrefixSuppressionTest();
+    void DoRun() override;
+};
+
+OspfPrefixSuppressionTest::OspfPrefixSuppressionTest()
+    : TestCase("OSPF prefix suppression")
+{
+}
+
+void
+OspfPrefixSuppressionTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+    OspfHelper ospfHelper;
+    // Interface 0 is the loopback, the links follow in creation order
+    ospfHelper.SuppressPrefix(nodes.Get(0), 1);
+    ospfHelper.SuppressPrefix(nodes.Get(1), 1);
+    ospfHelper.SuppressPrefix(nodes.Get(1), 2);
+    ospfHelper.SuppressPrefix(nodes.Get(2), 1);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(ospfHelper);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    for (uint32_t node = 0; node + 1 < nodes.GetN(); node++)
+    {
+        NodeContainer pair(nodes.Get(node), nodes.Get(node + 1));
+        address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address.NewNetwork();
+    }
+    for (uint32_t node = 0; node < nodes.GetN(); node++)
+    {
+        Ipv4InterfaceAddress loopback(Ipv4Address(0xc0a80000 + node), Ipv4Mask("/32"));
+        nodes.Get(node)->GetObject<Ipv4>()->AddAddress(0, loopback);
+    }
+
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+
+    std::map<Ipv4Address, Ipv4Address> gateways;
+    for (const auto& route : nodes.Get(0)->GetObject<OspfRouting>()->GetRoutes())
+    {
+        gateways[route.GetDestNetwork()] = route.GetGateway();
+    }
+    NS_TEST_EXPECT_MSG_EQ(gateways.count(Ipv4Address("192.168.0.2")), 1, "Far loopback routed");
+    NS_TEST_EXPECT_MSG_EQ(gateways[Ipv4Address("192.168.0.2")],
+                          Ipv4Address("10.0.0.2"),
+                          "Far loopback gateway");
+    NS_TEST_EXPECT_MSG_EQ(gateways.count(Ipv4Address("192.168.0.1")), 1, "Next loopback routed");
+    NS_TEST_EXPECT_MSG_EQ(gateways.count(Ipv4Address("10.0.0.4")), 0, "Transit link not routed");
+    NS_TEST_EXPECT_MSG_EQ(gateways.count(Ipv4Address("10.0.0.0")), 0, "Own link suppressed");
+
+    Ptr<OspfL4Protocol> protocol = nodes.Get(0)->GetObject<OspfL4Protocol>();
+    Ptr<OspfLsa> middle = protocol->GetLsdb().Get(OspfLsaKey{OspfLsa::ROUTER_LSA, 1, 1});
+    NS_TEST_ASSERT_MSG_NE(middle, nullptr, "Router-LSA of the middle router");
+    uint32_t stubs = 0;
+    uint32_t transits = 0;
+    for (const auto& link : middle->GetRouterLinks())
+    {
+        stubs += link.type == OspfLsa::STUB_NETWORK;
+        transits += link.type == OspfLsa::POINT_TO_POINT;
+    }
+    NS_TEST_EXPECT_MSG_EQ(stubs, 1, "Loopback only");
+    NS_TEST_EXPECT_MSG_EQ(transits, 2, "Adjacencies still advertised");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Bulk OspfHelper configuration, from a file and for node containers.
+ *
+ * A line of four routers, the last one cut off by excluding the interface
+ * of its neighbor facing it.
+ */
+class OspfBulkConfigTest : public TestCase
+{
+  public:
+    OspfBulkConfigTest();
+    void DoRun() override;
+};
+
+OspfBulkConfigTest::OspfBulkConfigTest()
+    : TestCase("OSPF bulk configuration")
+{
+}
+
+void
+OspfBulkConfigTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(4);
+
+    std::string filename = CreateTempDirFilename("ospf-config.csv");
+    std::ofstream file(filename);
+    file << "# nodes,setting,value\n"
+         << "*,area,5\n"
+         << "*,HelloInterval,5s\n"
+         << "0-1,metric,1,7\n"
+         << "\n"
+         << "2,exclude,2 # the link to router 3\n";
+    file.close();
+
+    OspfHelper ospfHelper;
+    ospfHelper.LoadConfig(filename);
+    ospfHelper.SetInterfaceMetric(NodeContainer(nodes.Get(2), nodes.Get(3)), 1, 9);
+    ospfHelper.SetProtocolAttribute(nodes, "SpfDelay", TimeValue(MilliSeconds(10)));
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(ospfHelper);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    for (uint32_t node = 0; node + 1 < nodes.GetN(); node++)
+    {
+        NodeContainer pair(nodes.Get(node), nodes.Get(node + 1));
+        address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address.NewNetwork();
+    }
+
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+
+    for (uint32_t node = 0; node < nodes.GetN(); node++)
+    {
+        Ptr<OspfRouting> routing = nodes.Get(node)->GetObject<OspfRouting>();
+        uint32_t metric = node < 2 ? 7 : 9;
+        NS_TEST_EXPECT_MSG_EQ(routing->GetProtocol()->GetInterfaceMetric(1),
+                              metric,
+                              "Metric of router " << node);
+        TimeValue hello;
+        routing->GetProtocol()->GetAttribute("HelloInterval", hello);
+        NS_TEST_EXPECT_MSG_EQ(hello.Get(), Seconds(5), "Hello interval of router " << node);
+        TimeValue spfDelay;
+        routing->GetAttribute("SpfDelay", spfDelay);
+        NS_TEST_EXPECT_MSG_EQ(spfDelay.Get(), MilliSeconds(10), "SPF delay of router " << node);
+    }
+
+    const OspfLsdb& lsdb = nodes.Get(0)->GetObject<OspfL4Protocol>()->GetLsdb();
+    NS_TEST_EXPECT_MSG_NE(lsdb.Get(OspfLsaKey{OspfLsa::ROUTER_LSA, 2, 2}),
+                          nullptr,
+                          "Router 2 reached in area 5");
+    NS_TEST_EXPECT_MSG_EQ(lsdb.Get(OspfLsaKey{OspfLsa::ROUTER_LSA, 3, 3}),
+                          nullptr,
+                          "Router 3 cut off");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Routes of locally originated packets cached per destination.
+ *
+ * A line of three routers: the first one's route to the last is built
+ * once, then again only when the routing table changes.
+ */
+class OspfRouteCacheTest : public TestCase
+{
+  public:
+    OspfRouteCacheTest();
+    void DoRun() override;
+};
+
+OspfRouteCacheTest::OspfRouteCacheTest()
+    : TestCase("OSPF route cache")
+{
+}
+
+void
+OspfRouteCacheTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+    OspfHelper ospfHelper;
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(ospfHelper);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    for (uint32_t node = 0; node + 1 < nodes.GetN(); node++)
+    {
+        NodeContainer pair(nodes.Get(node), nodes.Get(node + 1));
+        address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address.NewNetwork();
+    }
+
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+
+    Ptr<OspfRouting> routing = nodes.Get(0)->GetObject<OspfRouting>();
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address("10.0.0.6"));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> first = routing->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_NE(first, nullptr, "Route to the last router");
+    NS_TEST_EXPECT_MSG_EQ(first->GetGateway(), Ipv4Address("10.0.0.2"), "Gateway");
+    NS_TEST_EXPECT_MSG_EQ(first->GetSource(), Ipv4Address("10.0.0.1"), "Source");
+    Ptr<Ipv4Route> second = routing->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_EXPECT_MSG_EQ(second, first, "Route reused");
+
+    // An interface change starts a new generation
+    uint64_t generation = routing->GetRouteGeneration();
+    nodes.Get(0)->GetObject<Ipv4>()->AddAddress(
+        1,
+        Ipv4InterfaceAddress(Ipv4Address("192.168.0.1"), Ipv4Mask("/32")));
+    NS_TEST_EXPECT_MSG_GT(routing->GetRouteGeneration(), generation, "New generation");
+    Ptr<Ipv4Route> third = routing->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_EXPECT_MSG_NE(third, first, "Route rebuilt");
+    NS_TEST_EXPECT_MSG_EQ(third->GetGateway(), Ipv4Address("10.0.0.2"), "Same gateway");
+
+    // Without the cache every lookup builds its route
+    routing->SetAttribute("RouteCacheSize", UintegerValue(0));
+    Ptr<Ipv4Route> fourth = routing->RouteOutput(nullptr, header, nullptr, sockerr);
+    Ptr<Ipv4Route> fifth = routing->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_EXPECT_MSG_NE(fourth, fifth, "Route not cached");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Traffic engineering LSAs (RFC 3630) and constrained shortest paths.
+ *
+ * Four routers in a square, 0-1-3 cheaper than 0-2-3. The link from 0 to
+ * 1 has little reservable bandwidth and the links of 2 an admin group.
+ */
+class OspfCspfTest : public TestCase
+{
+  public:
+    OspfCspfTest();
+    void DoRun() override;
+};
+
+OspfCspfTest::OspfCspfTest()
+    : TestCase("OSPF constrained shortest path")
+{
+}
+
+void
+OspfCspfTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(4);
+    OspfHelper ospfHelper;
+    ospfHelper.SetInterfaceMetric(nodes.Get(0), 2, 10);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(ospfHelper);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    std::vector<std::pair<uint32_t, uint32_t>> links{{0, 1}, {0, 2}, {1, 3}, {2, 3}};
+    for (const auto& link : links)
+    {
+        NodeContainer pair(nodes.Get(link.first), nodes.Get(link.second));
+        address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address.NewNetwork();
+    }
+
+    // Interfaces 1 and 2 of every router are its links, in the order above
+    for (uint32_t node = 0; node < nodes.GetN(); node++)
+    {
+        Ptr<OspfL4Protocol> protocol = nodes.Get(node)->GetObject<OspfRouting>()->GetProtocol();
+        for (uint32_t interface = 1; interface <= 2; interface++)
+        {
+            bool thin = node == 0 && interface == 1;
+            uint32_t adminGroup = (node == 0 && interface == 2) || node == 2 ? 0x2 : 0;
+            protocol->SetTeAttributes(interface,
+                                      DataRate("10Mbps"),
+                                      DataRate(thin ? "1Mbps" : "10Mbps"),
+                                      adminGroup);
+        }
+    }
+
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+
+    // The TE LSA of router 0's first link, as flooded to router 3
+    Ptr<OspfLsa> lsa = nodes.Get(3)->GetObject<OspfL4Protocol>()->GetLsdb().Get(
+        OspfLsaKey{OspfLsa::AREA_LOCAL_OPAQUE_LSA, (uint32_t(OspfLsa::TE_OPAQUE_TYPE) << 24) | 1, 0});
+    NS_TEST_ASSERT_MSG_NE(lsa, nullptr, "TE LSA flooded");
+    OspfLsa::TeLink link;
+    NS_TEST_ASSERT_MSG_EQ(lsa->GetTeLink(link), true, "Link TLV");
+    NS_TEST_EXPECT_MSG_EQ(link.linkId, 1, "Neighbor");
+    NS_TEST_EXPECT_MSG_EQ(Ipv4Address(link.localAddress), Ipv4Address("10.0.0.1"), "Local address");
+    NS_TEST_EXPECT_MSG_EQ(link.maxBandwidth, 1.25e6f, "Maximum bandwidth");
+    NS_TEST_EXPECT_MSG_EQ(link.unreservedBandwidth, 1.25e5f, "Unreserved bandwidth");
+
+    Ptr<OspfRouting> routing = nodes.Get(0)->GetObject<OspfRouting>();
+    std::vector<uint32_t> path;
+    OspfSpf::Constraints constraints;
+    NS_TEST_EXPECT_MSG_EQ(routing->ComputeConstrainedPath(3, constraints, path), 2, "Shortest");
+    NS_TEST_EXPECT_MSG_EQ((path == std::vector<uint32_t>{0, 1, 3}), true, "Through router 1");
+
+    constraints.bandwidth = 2.5e5;
+    NS_TEST_EXPECT_MSG_EQ(routing->ComputeConstrainedPath(3, constraints, path), 11, "Bandwidth");
+    NS_TEST_EXPECT_MSG_EQ((path == std::vector<uint32_t>{0, 2, 3}), true, "Through router 2");
+
+    constraints.excludeAny = 0x2;
+    NS_TEST_EXPECT_MSG_EQ(routing->ComputeConstrainedPath(3, constraints, path),
+                          OspfSpf::UNREACHABLE,
+                          "No path left");
+    NS_TEST_EXPECT_MSG_EQ(path.empty(), true, "Empty path");
+
+    constraints = OspfSpf::Constraints();
+    constraints.includeAll = 0x2;
+    NS_TEST_EXPECT_MSG_EQ(routing->ComputeConstrainedPath(3, constraints, path), 11, "Admin group");
+    NS_TEST_EXPECT_MSG_EQ((path == std::vector<uint32_t>{0, 2, 3}), true, "Colored links");
+
+    // The routing table still follows the IGP metrics
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address("10.0.0.10"));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = routing->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_NE(route, nullptr, "Route to router 3");
+    NS_TEST_EXPECT_MSG_EQ(route->GetGateway(), Ipv4Address("10.0.0.2"), "Through router 1");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Demand circuits (RFC 1793).
+ *
+ * A line of three routers run for longer than MaxAge, once with every
+ * interface a demand circuit: Hellos and refreshes stop once converged,
+ * the LSAs do not age out and the routes stay.
+ */
+class OspfDemandCircuitTest : public TestCase
+{
+  public:
+    OspfDemandCircuitTest();
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Run the line of routers.
+     * \param demand whether every interface is a demand circuit
+     * \return the statistics of the middle router
+     */
+    OspfStats RunLine(bool demand);
+};
+
+OspfDemandCircuitTest::OspfDemandCircuitTest()
+    : TestCase("OSPF demand circuits")
+{
+}
+
+OspfStats
+OspfDemandCircuitTest::RunLine(bool demand)
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+    OspfHelper ospfHelper;
+    ospfHelper.Set("DemandCircuits", BooleanValue(demand));
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(ospfHelper);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    for (uint32_t node = 0; node + 1 < nodes.GetN(); node++)
+    {
+        NodeContainer pair(nodes.Get(node), nodes.Get(node + 1));
+        address.Assign(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address.NewNetwork();
+    }
+
+    Simulator::Stop(Seconds(2 * OspfLsa::MAX_AGE));
+    Simulator::Run();
+
+    const OspfLsdb& lsdb = nodes.Get(0)->GetObject<OspfL4Protocol>()->GetLsdb();
+    OspfLsaKey key{OspfLsa::ROUTER_LSA, 2, 2};
+    NS_TEST_EXPECT_MSG_NE(lsdb.Get(key), nullptr, "Router-LSA of the last router");
+    NS_TEST_EXPECT_MSG_EQ(lsdb.GetCurrentHeader(key).IsDoNotAge(), demand, "DoNotAge");
+    NS_TEST_EXPECT_MSG_LT(lsdb.GetAge(key), OspfLsa::MAX_AGE, "Not aged out");
+
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address("10.0.0.6"));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route =
+        nodes.Get(0)->GetObject<OspfRouting>()->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_EXPECT_MSG_NE(route, nullptr, "Route to the last router");
+
+    OspfStats stats = nodes.Get(1)->GetObject<OspfRouting>()->GetStats();
+    Simulator::Destroy();
+    return stats;
+}
+
+void
+OspfDemandCircuitTest::DoRun()
+{
+    OspfStats periodic = RunLine(false);
+    OspfStats demand = RunLine(true);
+
+    // Hellos of the first seconds only, and no refreshes
+    uint64_t helloLimit = periodic.packetsSent[1] / 50;
+    NS_TEST_EXPECT_MSG_LT(demand.packetsSent[1], helloLimit, "Hellos suppressed");
+    NS_TEST_EXPECT_MSG_LT(demand.packetsSent[4], periodic.packetsSent[4], "No refresh flooding");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 OSPF TestSuite
+ */
+class Ipv4OspfTestSuite : public TestSuite
+{
+  public:
+    Ipv4OspfTestSuite()
+        : TestSuite("ipv4-ospf", UNIT)
+    {
+        AddTestCase(new OspfChecksumTest, TestCase::QUICK);
+        AddTestCase(new OspfHeaderChecksumTest, TestCase::QUICK);
+        AddTestCase(new OspfGlobalRoutingDifferentialTest(OspfGlobalRoutingDifferentialTest::GRID),
+                    TestCase::QUICK);
+        AddTestCase(
+            new OspfGlobalRoutingDifferentialTest(OspfGlobalRoutingDifferentialTest::FAT_TREE),
+            TestCase::QUICK);
+        AddTestCase(
+            new OspfGlobalRoutingDifferentialTest(OspfGlobalRoutingDifferentialTest::RANDOM),
+            TestCase::QUICK);
+        AddTestCase(new OspfStatsTest, TestCase::QUICK);
+        AddTestCase(new OspfDistributedTest, TestCase::QUICK);
+        AddTestCase(new OspfFrozenFibTest, TestCase::QUICK);
+        AddTestCase(new OspfGracefulRestartTest, TestCase::QUICK);
+        AddTestCase(new OspfMaxMetricTest, TestCase::QUICK);
+        AddTestCase(new OspfPrefixSuppressionTest, TestCase::QUICK);
+        AddTestCase(new OspfBulkConfigTest, TestCase::QUICK);
+        AddTestCase(new OspfRouteCacheTest, TestCase::QUICK);
+        AddTestCase(new OspfCspfTest, TestCase::QUICK);
+        AddTestCase(new OspfDemandCircuitTest, TestCase::QUICK);
+    }
+};
+
+static Ipv4OspfTestSuite g_ipv4ospfTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,332 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ipv6-ospf-test.cc
+ *
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/ospf-header.h"
+#include "ns3/ospf-hello.h"
+#include "ns3/ospf-helper.h"
+#include "ns3/ospf-l4-protocol.h"
+#include "ns3/ospf-lsa.h"
+#include "ns3/ospf-lsu.h"
+#include "ns3/ospf-routing.h"
+#include "ns3/ospf6-helper.h"
+#include "ns3/ospf6-routing.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+#include "ns3/udp-socket-factory.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief OSPFv3 wire formats: header with the IPv6 pseudo-header checksum,
+ * Hello, and the Router and Intra-Area-Prefix LSAs in an LS Update.
+ */
+class Ospf6PacketTest : public TestCase
+{
+  public:
+    Ospf6PacketTest();
+
+    void DoRun() override;
+};
+
+Ospf6PacketTest::Ospf6PacketTest()
+    : TestCase("OSPFv3 packet formats")
+{
+}
+
+void
+Ospf6PacketTest::DoRun()
+{
+    Ipv6Address source("fe80::1");
+    Ipv6Address destination("ff02::5");
+
+    OspfHello hello;
+    hello.SetVersion(3);
+    hello.setInterfaceId(4);
+    hello.setHelloInterval(10);
+    hello.setDeadInterval(40);
+    hello.setNeighbors({3, 7});
+
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(hello);
+
+    OspfHeader header;
+    header.SetVersion(3);
+    header.InitializeChecksum(source, destination, OspfL4Protocol::PROTOCOL_NUMBER);
+    header.SetPacketType(OspfL4Protocol::HELLO);
+    header.SetRouterId(42);
+    header.SetPacketLength(packet->GetSize() + header.GetSerializedSize());
+    header.EnableChecksums();
+    packet->AddHeader(header);
+
+    NS_TEST_EXPECT_MSG_EQ(packet->GetSize(), 16 + 20 + 8, "OSPFv3 header and Hello sizes");
+
+    Ptr<Packet> copy = packet->Copy();
+    OspfHeader received;
+    received.InitializeChecksum(source, destination, OspfL4Protocol::PROTOCOL_NUMBER);
+    received.EnableChecksums();
+    copy->RemoveHeader(received);
+    NS_TEST_EXPECT_MSG_EQ(received.GetVersion(), 3, "Version read back");
+    NS_TEST_EXPECT_MSG_EQ(received.IsChecksumOk(), true, "Checksum with pseudo-header");
+    NS_TEST_EXPECT_MSG_EQ(received.GetRouterId(), 42, "Router ID");
+
+    OspfHello receivedHello;
+    receivedHello.SetVersion(3);
+    copy->RemoveHeader(receivedHello);
+    NS_TEST_EXPECT_MSG_EQ(receivedHello.getInterfaceId(), 4, "Hello interface ID");
+    NS_TEST_EXPECT_MSG_EQ(receivedHello.getDeadInterval(), 40, "Hello dead interval");
+    NS_TEST_EXPECT_MSG_EQ(receivedHello.hasNeighbor(7), true, "Hello neighbor");
+
+    // The pseudo-header is covered: another destination fails
+    copy = packet->Copy();
+    OspfHeader misdelivered;
+    misdelivered.InitializeChecksum(source,
+                                    Ipv6Address("ff02::6"),
+                                    OspfL4Protocol::PROTOCOL_NUMBER);
+    misdelivered.EnableChecksums();
+    copy->RemoveHeader(misdelivered);
+    NS_TEST_EXPECT_MSG_EQ(misdelivered.IsChecksumOk(), false, "Pseudo-header destination");
+
+    // LSAs
+    Ptr<OspfLsa> router = Create<OspfLsa>(3);
+    router->GetHeader().advertisingRouter = 42;
+    router->GetHeader().sequence = OspfLsa::INITIAL_SEQUENCE_NUMBER;
+    router->AddRouterLink(7, 1, OspfLsa::POINT_TO_POINT, 10, 2);
+    router->UpdateChecksum();
+
+    Ptr<OspfLsa> prefixes = Create<OspfLsa>(3);
+    prefixes->GetHeader().type = OspfLsa::V3_INTRA_AREA_PREFIX_LSA;
+    prefixes->GetHeader().advertisingRouter = 42;
+    prefixes->GetHeader().sequence = OspfLsa::INITIAL_SEQUENCE_NUMBER;
+    prefixes->SetReferencedLsa(router->GetKey());
+    prefixes->AddPrefix(Ipv6Address("2001:db8:1::"), 64, 1);
+    prefixes->AddPrefix(Ipv6Address("2001:db8:2:3::"), 56, 5);
+    prefixes->AddPrefix(Ipv6Address("2001:db8::1"), 128, 0);
+    prefixes->UpdateChecksum();
+
+    NS_TEST_EXPECT_MSG_EQ(router->GetSerializedSize(), 20 + 4 + 16, "V3 Router-LSA size");
+    NS_TEST_EXPECT_MSG_EQ(prefixes->GetSerializedSize(),
+                          20 + 12 + (4 + 8) + (4 + 8) + (4 + 16),
+                          "Intra-Area-Prefix-LSA size");
+
+    OspfLsUpdate update;
+    update.SetVersion(3);
+    update.AddLsa(router, 1);
+    update.AddLsa(prefixes, 1);
+    packet = Create<Packet>();
+    packet->AddHeader(update);
+
+    OspfLsUpdate receivedUpdate;
+    receivedUpdate.SetVersion(3);
+    packet->RemoveHeader(receivedUpdate);
+    NS_TEST_ASSERT_MSG_EQ(receivedUpdate.GetLsaNumber(), 2, "LSAs in the update");
+
+    Ptr<OspfLsa> receivedRouter = receivedUpdate.GetLsas()[0];
+    NS_TEST_EXPECT_MSG_EQ(receivedRouter->GetHeader().type,
+                          OspfLsa::V3_ROUTER_LSA,
+                          "16 bit LS type");
+    NS_TEST_EXPECT_MSG_EQ(receivedRouter->IsChecksumOk(), true, "Router-LSA checksum");
+    NS_TEST_EXPECT_MSG_EQ(receivedRouter->HasSameContent(*router), true, "Router-LSA body");
+    NS_TEST_EXPECT_MSG_EQ(receivedRouter->GetRouterLinks()[0].neighborInterfaceId,
+                          2,
+                          "Neighbor interface ID");
+
+    Ptr<OspfLsa> receivedPrefixes = receivedUpdate.GetLsas()[1];
+    NS_TEST_EXPECT_MSG_EQ(receivedPrefixes->IsChecksumOk(), true, "Prefix LSA checksum");
+    NS_TEST_EXPECT_MSG_EQ(receivedPrefixes->HasSameContent(*prefixes), true, "Prefix LSA body");
+    bool referenced = receivedPrefixes->GetReferencedLsa() == router->GetKey();
+    NS_TEST_EXPECT_MSG_EQ(referenced, true, "Referenced LSA");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief OSPFv2 and OSPFv3 side by side on a dual-stack line of routers.
+ *
+ * Every IPv6 prefix must be reached at its shortest path cost through the
+ * link-local address of the neighbor towards it, the IPv4 instance must
+ * converge as if it ran alone, and a UDP datagram must cross the line.
+ */
+class Ospf6DualStackTest : public TestCase
+{
+  public:
+    Ospf6DualStackTest();
+
+    void DoRun() override;
+
+  private:
+    /**
+     * Receive callback of the UDP sink
+     * \param socket the socket
+     */
+    void Receive(Ptr<Socket> socket);
+
+    uint32_t m_received; //!< Bytes received by the sink
+};
+
+Ospf6DualStackTest::Ospf6DualStackTest()
+    : TestCase("OSPFv3 and OSPFv2 on a dual-stack line"),
+      m_received(0)
+{
+}
+
+void
+Ospf6DualStackTest::Receive(Ptr<Socket> socket)
+{
+    Ptr<Packet> packet;
+    while ((packet = socket->Recv()))
+    {
+        m_received += packet->GetSize();
+    }
+}
+
+void
+Ospf6DualStackTest::DoRun()
+{
+    // Exercise the OSPFv3 checksum with the IPv6 pseudo-header end to end
+    GlobalValue::Bind("ChecksumEnabled", BooleanValue(true));
+
+    const uint32_t routers = 5;
+    NodeContainer nodes;
+    nodes.Create(routers);
+
+    OspfHelper ospfHelper;
+    Ospf6Helper ospf6Helper;
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(ospfHelper);
+    internet.SetRoutingHelper(ospf6Helper);
+    internet.Install(nodes);
+
+    // Link k joins routers k and k + 1
+    SimpleNetDeviceHelper p2pHelper;
+    p2pHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address4("10.0.0.0", "255.255.255.252");
+    Ipv6AddressHelper address6(Ipv6Address("2001:1::"), Ipv6Prefix(64));
+    std::vector<NetDeviceContainer> links;
+    std::vector<Ipv6InterfaceContainer> interfaces6;
+    for (uint32_t k = 0; k + 1 < routers; k++)
+    {
+        NodeContainer pair(nodes.Get(k), nodes.Get(k + 1));
+        links.push_back(p2pHelper.Install(pair, CreateObject<SimpleChannel>()));
+        address4.Assign(links.back());
+        address4.NewNetwork();
+        interfaces6.push_back(address6.Assign(links.back()));
+        address6.NewNetwork();
+    }
+
+    Inet6SocketAddress sinkAddress(interfaces6.back().GetAddress(1, 1), 1234);
+    Ptr<Socket> sink = Socket::CreateSocket(nodes.Get(routers - 1), UdpSocketFactory::GetTypeId());
+    sink->Bind(sinkAddress);
+    sink->SetRecvCallback(MakeCallback(&Ospf6DualStackTest::Receive, this));
+    Ptr<Socket> source = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+    source->Bind6();
+    Simulator::Schedule(Seconds(55), [&]() {
+        source->SendTo(Create<Packet>(100), 0, sinkAddress);
+    });
+
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+
+    for (uint32_t n = 0; n < routers; n++)
+    {
+        Ptr<Ospf6Routing> routing = nodes.Get(n)->GetObject<Ospf6Routing>();
+        NS_TEST_ASSERT_MSG_NE(routing, nullptr, "OSPFv3 on node " << n);
+        Ptr<Ipv6> ipv6 = nodes.Get(n)->GetObject<Ipv6>();
+        NS_TEST_EXPECT_MSG_EQ(routing->GetRoutes().size(),
+                              routers - 1,
+                              "IPv6 routes of node " << n);
+        NS_TEST_EXPECT_MSG_EQ(routing->GetStats().lsdbSize,
+                              2 * routers,
+                              "Router and Intra-Area-Prefix LSAs of node " << n);
+
+        for (uint32_t k = 0; k + 1 < routers; k++)
+        {
+            Ipv6Address prefix = interfaces6[k].GetAddress(0, 1).CombinePrefix(Ipv6Prefix(64));
+            const Ospf6RoutingTableEntry* found = nullptr;
+            for (const auto& route : routing->GetRoutes())
+            {
+                if (route.GetDestNetwork() == prefix)
+                {
+                    found = &route;
+                }
+            }
+            NS_TEST_ASSERT_MSG_NE(found, nullptr, "Node " << n << " route to " << prefix);
+            if (n == k || n == k + 1)
+            {
+                NS_TEST_EXPECT_MSG_EQ(found->IsGateway(), false, "Connected " << prefix);
+                NS_TEST_EXPECT_MSG_EQ(found->GetMetric(), 0, "Connected " << prefix);
+                continue;
+            }
+
+            // Reached through the nearer end of the link, each hop costing 1
+            uint32_t nearEnd = (n < k) ? k : k + 1;
+            uint32_t distance = std::abs(int(nearEnd) - int(n));
+            NS_TEST_EXPECT_MSG_EQ(found->GetMetric(),
+                                  distance + 1,
+                                  "Node " << n << " to " << prefix);
+
+            uint32_t link = (n < k) ? n : n - 1;
+            uint32_t side = (n < k) ? 1 : 0;
+            Ptr<NetDevice> neighborDevice = links[link].Get(side);
+            Ptr<Ipv6> neighborIpv6 = neighborDevice->GetNode()->GetObject<Ipv6>();
+            uint32_t neighborIf = neighborIpv6->GetInterfaceForDevice(neighborDevice);
+            NS_TEST_EXPECT_MSG_EQ(found->GetGateway(),
+                                  neighborIpv6->GetAddress(neighborIf, 0).GetAddress(),
+                                  "Node " << n << " next hop to " << prefix);
+            NS_TEST_EXPECT_MSG_EQ(found->GetInterface(),
+                                  uint32_t(ipv6->GetInterfaceForDevice(links[link].Get(1 - side))),
+                                  "Node " << n << " interface to " << prefix);
+        }
+
+        Ptr<OspfRouting> routing4 = nodes.Get(n)->GetObject<OspfRouting>();
+        NS_TEST_EXPECT_MSG_EQ(routing4->GetRoutes().size(),
+                              routers - 1,
+                              "IPv4 routes of node " << n);
+        NS_TEST_EXPECT_MSG_EQ(routing4->GetStats().lsdbSize, routers, "IPv4 LSDB of node " << n);
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_received, 100, "UDP over IPv6 across the line");
+
+    Simulator::Destroy();
+    GlobalValue::Bind("ChecksumEnabled", BooleanValue(false));
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv6 OSPF TestSuite
+ */
+class Ipv6OspfTestSuite : public TestSuite
+{
+  public:
+    Ipv6OspfTestSuite()
+        : TestSuite("ipv6-ospf", UNIT)
+    {
+        AddTestCase(new Ospf6PacketTest, TestCase::QUICK);
+        AddTestCase(new Ospf6DualStackTest, TestCase::QUICK);
+    }
+};
+
+static Ipv6OspfTestSuite g_ipv6ospfTestSuite; //!< Static variable for test initialization
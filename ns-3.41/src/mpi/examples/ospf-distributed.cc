@@ -0,0 +1,226 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ *
+ * OSPF on a grid of point-to-point routers split by columns across the
+ * ranks.  With two ranks and the default 4 x 4 grid:
+ *
+ *                 -------   -------
+ *                  RANK 0    RANK 1
+ *                 ------- | -------
+ *                         |
+ *       r0 ---- r4 ------ r8 ---- r12
+ *        |       |        |        |
+ *       r1 ---- r5 ------ r9 ---- r13
+ *        |       |        |        |
+ *       r2 ---- r6 ------ r10 --- r14
+ *        |       |        |        |
+ *       r3 ---- r7 ------ r11 --- r15
+ *                         |
+ *
+ * Links between columns owned by different ranks use a
+ * PointToPointRemoteChannel, so Hellos, database exchange and flooding cross
+ * ranks as serialised MPI messages.  Every rank builds every node, but only
+ * the owning rank runs OSPF on it.
+ *
+ * Once the routers have converged the first router sends one UDP datagram
+ * to the last one.  The test checks that every router holds the Router-LSA
+ * of every other router and that the datagram arrives.
+ */
+
+#include "mpi-test-fixtures.h"
+
+#include "ns3/core-module.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/network-module.h"
+#include "ns3/ospf-helper.h"
+#include "ns3/ospf-routing.h"
+#include "ns3/ospf-stats.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/udp-socket-factory.h"
+
+#include <mpi.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("OspfDistributed");
+
+/**
+ * Receive the datagram on the last router.
+ *
+ * \param socket The receiving socket.
+ */
+static void
+ReceiveDatagram(Ptr<Socket> socket)
+{
+    Address from;
+    Ptr<Packet> packet;
+    while ((packet = socket->RecvFrom(from)))
+    {
+        Address to;
+        socket->GetSockName(to);
+        SinkTracer::SinkTrace(packet, from, to);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    bool nullmsg = false;
+    bool testing = false;
+    bool verbose = false;
+    uint32_t rows = 4;
+    uint32_t columns = 4;
+    double convergence = 60;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+    cmd.AddValue("rows", "Rows of routers in the grid", rows);
+    cmd.AddValue("columns", "Columns of routers in the grid, split across the ranks", columns);
+    cmd.AddValue("convergence", "Seconds given to OSPF to converge", convergence);
+    cmd.AddValue("verbose", "verbose output", verbose);
+    cmd.AddValue("test", "Enable regression test output", testing);
+    cmd.Parse(argc, argv);
+
+    if (nullmsg)
+    {
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue("ns3::NullMessageSimulatorImpl"));
+    }
+    else
+    {
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue("ns3::DistributedSimulatorImpl"));
+    }
+
+    MpiInterface::Enable(&argc, &argv);
+
+    SinkTracer::Init();
+
+    if (verbose)
+    {
+        LogComponentEnable("OspfDistributed", LOG_LEVEL_INFO);
+    }
+
+    uint32_t systemId = MpiInterface::GetSystemId();
+    uint32_t systemCount = MpiInterface::GetSize();
+
+    if (rows == 0 || columns < systemCount)
+    {
+        RANK0COUT("At least one row and one column per rank are needed\n");
+        MpiInterface::Disable();
+        return 1;
+    }
+
+    // Columns are spread evenly over the ranks, left to right
+    NodeContainer routers;
+    for (uint32_t column = 0; column < columns; column++)
+    {
+        routers.Create(rows, column * systemCount / columns);
+    }
+    auto router = [&](uint32_t column, uint32_t row) {
+        return routers.Get(column * rows + row);
+    };
+
+    OspfHelper ospfHelper;
+    InternetStackHelper stack;
+    stack.SetIpv6StackInstall(false);
+    stack.SetRoutingHelper(ospfHelper);
+    stack.Install(routers);
+
+    PointToPointHelper link;
+    link.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    link.SetChannelAttribute("Delay", StringValue("2ms"));
+
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    auto connect = [&](Ptr<Node> a, Ptr<Node> b) {
+        address.Assign(link.Install(a, b));
+        address.NewNetwork();
+    };
+    for (uint32_t column = 0; column < columns; column++)
+    {
+        for (uint32_t row = 0; row < rows; row++)
+        {
+            if (row + 1 < rows)
+            {
+                connect(router(column, row), router(column, row + 1));
+            }
+            if (column + 1 < columns)
+            {
+                connect(router(column, row), router(column + 1, row));
+            }
+        }
+    }
+
+    // One datagram from the first router to the last, once converged
+    uint16_t port = 9;
+    Ptr<Node> first = routers.Get(0);
+    Ptr<Node> last = routers.Get(routers.GetN() - 1);
+    Ipv4Address destination = last->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+
+    if (last->GetSystemId() == systemId)
+    {
+        Ptr<Socket> sink = Socket::CreateSocket(last, UdpSocketFactory::GetTypeId());
+        sink->Bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+        sink->SetRecvCallback(MakeCallback(&ReceiveDatagram));
+    }
+    if (first->GetSystemId() == systemId)
+    {
+        Ptr<Socket> source = Socket::CreateSocket(first, UdpSocketFactory::GetTypeId());
+        Simulator::Schedule(Seconds(convergence), [source, destination, port]() {
+            source->SendTo(Create<Packet>(512), 0, InetSocketAddress(destination, port));
+        });
+    }
+
+    Simulator::Stop(Seconds(convergence + 1));
+    Simulator::Run();
+
+    // Routers of this rank holding every Router-LSA
+    unsigned long converged = 0;
+    for (uint32_t i = 0; i < routers.GetN(); i++)
+    {
+        Ptr<Node> node = routers.Get(i);
+        if (node->GetSystemId() != systemId)
+        {
+            continue;
+        }
+        OspfStats stats = node->GetObject<OspfRouting>()->GetStats();
+        NS_LOG_INFO("Router " << i << " on rank " << systemId << ": " << stats.lsdbSize
+                              << " LSAs, " << stats.spfRuns << " SPF runs");
+        if (stats.lsdbSize == routers.GetN())
+        {
+            converged++;
+        }
+    }
+    unsigned long globalConverged = 0;
+    MPI_Reduce(&converged, &globalConverged, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    Simulator::Destroy();
+
+    if (testing)
+    {
+        RANK0COUT("Converged routers: " << globalConverged << " of " << routers.GetN() << "\n");
+        SinkTracer::Verify(1);
+    }
+
+    MpiInterface::Disable();
+    return 0;
+}
@@ -154,6 +154,12 @@ static MpiTestSuite g_mpiSimple2("mpi-example-simple-2",
                                  NS_TEST_SOURCEDIR,
                                  2);
 static MpiTestSuite g_mpiThird2("mpi-example-third-2", "third-distributed", NS_TEST_SOURCEDIR, 2);
+static MpiTestSuite g_mpiOspf2("mpi-example-ospf-2", "ospf-distributed", NS_TEST_SOURCEDIR, 2);
+static MpiTestSuite g_mpiOspf3("mpi-example-ospf-3",
+                               "ospf-distributed",
+                               NS_TEST_SOURCEDIR,
+                               3,
+                               "--columns=6");
 
 /* Tests using NullMessageSimulatorImpl */
 static MpiTestSuite g_mpiSimple2NullMsg("mpi-example-simple-2-nullmsg",
@@ -171,3 +177,8 @@ static MpiTestSuite g_mpiEmpty3NullMsg("mpi-example-empty-3-nullmsg",
                                        NS_TEST_SOURCEDIR,
                                        3,
                                        "-nullmsg");
+static MpiTestSuite g_mpiOspf2NullMsg("mpi-example-ospf-2-nullmsg",
+                                      "ospf-distributed",
+                                      NS_TEST_SOURCEDIR,
+                                      2,
+                                      "--nullmsg");
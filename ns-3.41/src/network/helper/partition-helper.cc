@@ -0,0 +1,967 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "partition-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <set>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PartitionHelper");
+
+namespace
+{
+
+/** Marks a vertex not yet matched or assigned. */
+constexpr uint32_t UNASSIGNED = std::numeric_limits<uint32_t>::max();
+/** Vertices per partition below which the graph is not coarsened further. */
+constexpr uint32_t COARSEST_VERTICES = 20;
+/** Number of bisections tried at each step of the initial partition. */
+constexpr uint32_t INITIAL_TRIALS = 4;
+/** Maximum number of refinement passes at each level. */
+constexpr uint32_t REFINE_PASSES = 8;
+/** Maximum number of hill-climbing passes at each level. */
+constexpr uint32_t CLIMB_PASSES = 4;
+/** Moves with no improvement after which a hill-climbing pass gives up. */
+constexpr uint32_t CLIMB_PATIENCE = 100;
+
+/** An undirected weighted graph, in compressed sparse row form. */
+struct Graph
+{
+    std::vector<double> vertexWeight; //!< Weight of the vertices
+    std::vector<uint32_t> start;      //!< First edge of each vertex, then the end
+    std::vector<uint32_t> neighbor;   //!< Other vertex of the edges
+    std::vector<double> edgeWeight;   //!< Weight of the edges
+
+    /** \returns The number of vertices. */
+    uint32_t GetN() const
+    {
+        return vertexWeight.size();
+    }
+};
+
+/** An undirected edge: its vertices and weight. */
+typedef std::tuple<uint32_t, uint32_t, double> Edge;
+
+/**
+ * Build a graph, merging parallel edges and dropping loops.
+ * \param vertexWeight The weight of the vertices.
+ * \param edges The edges.
+ * \returns The graph.
+ */
+Graph
+MakeGraph(std::vector<double> vertexWeight, const std::vector<Edge>& edges)
+{
+    std::vector<Edge> arcs;
+    arcs.reserve(2 * edges.size());
+    for (const auto& [a, b, weight] : edges)
+    {
+        if (a != b)
+        {
+            arcs.emplace_back(a, b, weight);
+            arcs.emplace_back(b, a, weight);
+        }
+    }
+    std::sort(arcs.begin(), arcs.end());
+
+    Graph g;
+    g.vertexWeight = std::move(vertexWeight);
+    g.start.assign(g.GetN() + 1, 0);
+    for (std::size_t i = 0; i < arcs.size(); i++)
+    {
+        const auto& [a, b, weight] = arcs[i];
+        if (i > 0 && std::get<0>(arcs[i - 1]) == a && std::get<1>(arcs[i - 1]) == b)
+        {
+            g.edgeWeight.back() += weight;
+            continue;
+        }
+        g.neighbor.push_back(b);
+        g.edgeWeight.push_back(weight);
+        g.start[a + 1]++;
+    }
+    for (uint32_t v = 0; v < g.GetN(); v++)
+    {
+        g.start[v + 1] += g.start[v];
+    }
+    return g;
+}
+
+/**
+ * Coarsen a graph by heavy-edge matching: each vertex is merged with the
+ * unmatched neighbour it has the heaviest edge with.
+ * \param g The graph.
+ * \param maxWeight The maximum weight of a merged vertex.
+ * \param [out] map The coarse vertex of each vertex.
+ * \returns The coarse graph.
+ */
+Graph
+Coarsen(const Graph& g, double maxWeight, std::vector<uint32_t>& map)
+{
+    uint32_t n = g.GetN();
+    // The vertices of lowest degree have the fewest choices, they go first
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&g](uint32_t a, uint32_t b) {
+        return g.start[a + 1] - g.start[a] < g.start[b + 1] - g.start[b];
+    });
+
+    std::vector<uint32_t> match(n, UNASSIGNED);
+    for (uint32_t v : order)
+    {
+        if (match[v] != UNASSIGNED)
+        {
+            continue;
+        }
+        uint32_t best = v;
+        double bestWeight = 0;
+        for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+        {
+            uint32_t u = g.neighbor[e];
+            if (match[u] != UNASSIGNED || g.vertexWeight[v] + g.vertexWeight[u] > maxWeight)
+            {
+                continue;
+            }
+            if (g.edgeWeight[e] > bestWeight ||
+                (best != v && g.edgeWeight[e] == bestWeight &&
+                 g.vertexWeight[u] < g.vertexWeight[best]))
+            {
+                best = u;
+                bestWeight = g.edgeWeight[e];
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+    }
+
+    map.assign(n, UNASSIGNED);
+    std::vector<double> weights;
+    for (uint32_t v = 0; v < n; v++)
+    {
+        if (map[v] == UNASSIGNED)
+        {
+            map[v] = map[match[v]] = weights.size();
+            weights.push_back(g.vertexWeight[v] +
+                              (match[v] != v ? g.vertexWeight[match[v]] : 0));
+        }
+    }
+    std::vector<Edge> edges;
+    for (uint32_t v = 0; v < n; v++)
+    {
+        for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+        {
+            uint32_t u = g.neighbor[e];
+            if (v < u && map[v] != map[u])
+            {
+                edges.emplace_back(map[v], map[u], g.edgeWeight[e]);
+            }
+        }
+    }
+    return MakeGraph(std::move(weights), edges);
+}
+
+/**
+ * \param g The graph.
+ * \param part The partition of each vertex.
+ * \returns The weight of the edges between partitions.
+ */
+double
+GetCut(const Graph& g, const std::vector<uint32_t>& part)
+{
+    double cut = 0;
+    for (uint32_t v = 0; v < g.GetN(); v++)
+    {
+        for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+        {
+            if (part[g.neighbor[e]] != part[v])
+            {
+                cut += g.edgeWeight[e];
+            }
+        }
+    }
+    return cut / 2;
+}
+
+/**
+ * \param g The graph.
+ * \param maxWeights The maximum weight of each partition.
+ * \param part The partition of each vertex.
+ * \returns The largest excess of weight of a partition, zero if balanced.
+ */
+double
+GetExcess(const Graph& g, const std::vector<double>& maxWeights, const std::vector<uint32_t>& part)
+{
+    std::vector<double> weights(maxWeights.size(), 0);
+    for (uint32_t v = 0; v < g.GetN(); v++)
+    {
+        weights[part[v]] += g.vertexWeight[v];
+    }
+    double excess = 0;
+    for (std::size_t q = 0; q < weights.size(); q++)
+    {
+        excess = std::max(excess, weights[q] - maxWeights[q]);
+    }
+    return excess;
+}
+
+/**
+ * Extract the subgraph of the vertices of a partition.
+ * \param g The graph.
+ * \param part The partition of each vertex.
+ * \param p The partition.
+ * \param [out] vertices The vertex of the graph of each vertex of the subgraph.
+ * \returns The subgraph.
+ */
+Graph
+GetSubgraph(const Graph& g,
+            const std::vector<uint32_t>& part,
+            uint32_t p,
+            std::vector<uint32_t>& vertices)
+{
+    std::vector<uint32_t> index(g.GetN(), UNASSIGNED);
+    std::vector<double> weights;
+    vertices.clear();
+    for (uint32_t v = 0; v < g.GetN(); v++)
+    {
+        if (part[v] == p)
+        {
+            index[v] = vertices.size();
+            vertices.push_back(v);
+            weights.push_back(g.vertexWeight[v]);
+        }
+    }
+    std::vector<Edge> edges;
+    for (uint32_t v : vertices)
+    {
+        for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+        {
+            uint32_t u = g.neighbor[e];
+            if (v < u && part[u] == p)
+            {
+                edges.emplace_back(index[v], index[u], g.edgeWeight[e]);
+            }
+        }
+    }
+    return MakeGraph(std::move(weights), edges);
+}
+
+/**
+ * Bisect a graph by growing the first half from a seed, adding the vertex
+ * most connected to it until it has its share of the weight.
+ * \param g The graph.
+ * \param target The weight of the first half.
+ * \param seed The first vertex of the first half.
+ * \returns The half of each vertex, 0 or 1.
+ */
+std::vector<uint32_t>
+Grow(const Graph& g, double target, uint32_t seed)
+{
+    uint32_t n = g.GetN();
+    std::vector<uint32_t> part(n, 1);
+    std::vector<double> connection(n, 0);
+    // Vertices of the second half connected to the first, most connected first
+    std::set<std::pair<double, uint32_t>> frontier;
+    double weight = 0;
+    uint32_t nGrown = 0;
+    uint32_t cursor = seed;
+    while (weight < target && nGrown < n)
+    {
+        uint32_t v;
+        if (frontier.empty())
+        {
+            while (part[cursor] == 0)
+            {
+                cursor = (cursor + 1) % n;
+            }
+            v = cursor;
+        }
+        else
+        {
+            v = frontier.begin()->second;
+            frontier.erase(frontier.begin());
+        }
+        // Stop when one more vertex would take the half further from its share
+        if (weight > 0 && weight + g.vertexWeight[v] - target > target - weight)
+        {
+            break;
+        }
+        part[v] = 0;
+        weight += g.vertexWeight[v];
+        nGrown++;
+        for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+        {
+            uint32_t u = g.neighbor[e];
+            if (part[u] == 1)
+            {
+                frontier.erase({-connection[u], u});
+                connection[u] += g.edgeWeight[e];
+                frontier.insert({-connection[u], u});
+            }
+        }
+    }
+    return part;
+}
+
+/**
+ * Move the vertices on the boundary of the partitions to the neighbouring
+ * partition they are the most connected to, if that lowers the cut and
+ * keeps the partitions balanced, and move vertices out of the partitions
+ * which are too heavy.
+ * \param g The graph.
+ * \param maxWeights The maximum weight of each partition.
+ * \param [in,out] part The partition of each vertex.
+ */
+void
+Refine(const Graph& g, const std::vector<double>& maxWeights, std::vector<uint32_t>& part)
+{
+    uint32_t n = g.GetN();
+    uint32_t k = maxWeights.size();
+    std::vector<double> partWeight(k, 0);
+    std::vector<uint32_t> partSize(k, 0);
+    for (uint32_t v = 0; v < n; v++)
+    {
+        partWeight[part[v]] += g.vertexWeight[v];
+        partSize[part[v]]++;
+    }
+
+    // Weight of the edges of the current vertex to each partition
+    std::vector<double> connection(k, 0);
+    std::vector<uint32_t> stamp(k, UNASSIGNED);
+    std::vector<uint32_t> candidates;
+    for (uint32_t pass = 0; pass < REFINE_PASSES; pass++)
+    {
+        uint32_t moves = 0;
+        for (uint32_t v = 0; v < n; v++)
+        {
+            uint32_t from = part[v];
+            if (partSize[from] == 1)
+            {
+                continue;
+            }
+            candidates.clear();
+            auto touch = [&](uint32_t q) {
+                if (stamp[q] != v)
+                {
+                    stamp[q] = v;
+                    connection[q] = 0;
+                    candidates.push_back(q);
+                }
+            };
+            touch(from);
+            for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+            {
+                uint32_t q = part[g.neighbor[e]];
+                touch(q);
+                connection[q] += g.edgeWeight[e];
+            }
+            bool overweight = partWeight[from] > maxWeights[from];
+            if (overweight)
+            {
+                // The partition with the most room left
+                uint32_t roomiest = 0;
+                for (uint32_t q = 1; q < k; q++)
+                {
+                    if (maxWeights[q] - partWeight[q] > maxWeights[roomiest] - partWeight[roomiest])
+                    {
+                        roomiest = q;
+                    }
+                }
+                touch(roomiest);
+            }
+            if (candidates.size() == 1)
+            {
+                continue;
+            }
+
+            double weight = g.vertexWeight[v];
+            uint32_t best = from;
+            double bestGain = 0;
+            for (uint32_t q : candidates)
+            {
+                if (q == from ||
+                    (partWeight[q] + weight > maxWeights[q] &&
+                     !(overweight && partWeight[q] + weight < partWeight[from])))
+                {
+                    continue;
+                }
+                double gain = connection[q] - connection[from];
+                if (best == from || gain > bestGain ||
+                    (gain == bestGain && partWeight[q] < partWeight[best]))
+                {
+                    best = q;
+                    bestGain = gain;
+                }
+            }
+            if (best == from ||
+                !(overweight || bestGain > 0 ||
+                  (bestGain == 0 && partWeight[best] + weight < partWeight[from])))
+            {
+                continue;
+            }
+            partWeight[from] -= weight;
+            partSize[from]--;
+            partWeight[best] += weight;
+            partSize[best]++;
+            part[v] = best;
+            moves++;
+        }
+        if (moves == 0)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * Improve a balanced partition by hill climbing, as Fiduccia and Mattheyses
+ * do: the boundary vertices are moved best gain first, each once per pass,
+ * even when that makes the cut worse for a while, and the pass is rolled
+ * back to the point where the cut was the lowest.
+ * \param g The graph.
+ * \param maxWeights The maximum weight of each partition.
+ * \param [in,out] part The partition of each vertex.
+ */
+void
+Climb(const Graph& g, const std::vector<double>& maxWeights, std::vector<uint32_t>& part)
+{
+    uint32_t n = g.GetN();
+    uint32_t k = maxWeights.size();
+    std::vector<double> partWeight(k, 0);
+    std::vector<uint32_t> partSize(k, 0);
+    for (uint32_t v = 0; v < n; v++)
+    {
+        partWeight[part[v]] += g.vertexWeight[v];
+        partSize[part[v]]++;
+    }
+
+    // The best move of a vertex to a neighbouring partition: gain and
+    // partition, UNASSIGNED if none keeps the balance
+    std::vector<double> connection(k, 0);
+    std::vector<uint32_t> stamp(k, UNASSIGNED);
+    uint32_t tick = 0;
+    auto getMove = [&](uint32_t v) -> std::pair<double, uint32_t> {
+        uint32_t from = part[v];
+        if (partSize[from] == 1)
+        {
+            return {0, UNASSIGNED};
+        }
+        tick++;
+        stamp[from] = tick;
+        connection[from] = 0;
+        for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+        {
+            uint32_t q = part[g.neighbor[e]];
+            if (stamp[q] != tick)
+            {
+                stamp[q] = tick;
+                connection[q] = 0;
+            }
+            connection[q] += g.edgeWeight[e];
+        }
+        uint32_t best = UNASSIGNED;
+        double bestGain = 0;
+        for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+        {
+            uint32_t q = part[g.neighbor[e]];
+            if (q == from || q == best || partWeight[q] + g.vertexWeight[v] > maxWeights[q])
+            {
+                continue;
+            }
+            double gain = connection[q] - connection[from];
+            if (best == UNASSIGNED || gain > bestGain ||
+                (gain == bestGain && partWeight[q] < partWeight[best]))
+            {
+                best = q;
+                bestGain = gain;
+            }
+        }
+        return {bestGain, best};
+    };
+
+    std::vector<bool> locked(n);
+    std::vector<std::pair<uint32_t, uint32_t>> moves;
+    for (uint32_t pass = 0; pass < CLIMB_PASSES; pass++)
+    {
+        std::priority_queue<std::pair<double, uint32_t>> heap;
+        for (uint32_t v = 0; v < n; v++)
+        {
+            auto [gain, q] = getMove(v);
+            if (q != UNASSIGNED)
+            {
+                heap.emplace(gain, v);
+            }
+        }
+        std::fill(locked.begin(), locked.end(), false);
+        moves.clear();
+        double total = 0;
+        double best = 0;
+        std::size_t bestMoves = 0;
+        while (!heap.empty() && moves.size() - bestMoves < CLIMB_PATIENCE)
+        {
+            auto [gain, v] = heap.top();
+            heap.pop();
+            if (locked[v])
+            {
+                continue;
+            }
+            auto [current, q] = getMove(v);
+            if (q == UNASSIGNED)
+            {
+                continue;
+            }
+            if (current != gain)
+            {
+                heap.emplace(current, v);
+                continue;
+            }
+            uint32_t from = part[v];
+            partWeight[from] -= g.vertexWeight[v];
+            partSize[from]--;
+            partWeight[q] += g.vertexWeight[v];
+            partSize[q]++;
+            part[v] = q;
+            locked[v] = true;
+            moves.emplace_back(v, from);
+            total += gain;
+            if (total > best)
+            {
+                best = total;
+                bestMoves = moves.size();
+            }
+            for (uint32_t e = g.start[v]; e < g.start[v + 1]; e++)
+            {
+                uint32_t u = g.neighbor[e];
+                if (!locked[u])
+                {
+                    auto [gainU, qU] = getMove(u);
+                    if (qU != UNASSIGNED)
+                    {
+                        heap.emplace(gainU, u);
+                    }
+                }
+            }
+        }
+
+        // Undo the moves past the best point
+        while (moves.size() > bestMoves)
+        {
+            auto [v, from] = moves.back();
+            moves.pop_back();
+            partWeight[part[v]] -= g.vertexWeight[v];
+            partSize[part[v]]--;
+            partWeight[from] += g.vertexWeight[v];
+            partSize[from]++;
+            part[v] = from;
+        }
+        if (bestMoves == 0)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * Partition a graph by recursive bisection, keeping the best of a few
+ * bisections at each step.
+ * \param g The graph.
+ * \param k The number of partitions.
+ * \param maxWeight The maximum weight of a partition.
+ * \returns The partition of each vertex.
+ */
+std::vector<uint32_t>
+Bisect(const Graph& g, uint32_t k, double maxWeight)
+{
+    uint32_t n = g.GetN();
+    std::vector<uint32_t> part(n, 0);
+    if (k == 1)
+    {
+        return part;
+    }
+    if (n <= k)
+    {
+        std::iota(part.begin(), part.end(), 0);
+        return part;
+    }
+
+    uint32_t k0 = k / 2;
+    double total = std::accumulate(g.vertexWeight.begin(), g.vertexWeight.end(), 0.0);
+    std::vector<double> maxWeights{k0 * maxWeight, (k - k0) * maxWeight};
+    double bestExcess = std::numeric_limits<double>::infinity();
+    double bestCut = std::numeric_limits<double>::infinity();
+    for (uint32_t trial = 0; trial < INITIAL_TRIALS; trial++)
+    {
+        auto candidate = Grow(g, total * k0 / k, trial * n / INITIAL_TRIALS);
+        Refine(g, maxWeights, candidate);
+        Climb(g, maxWeights, candidate);
+        double excess = GetExcess(g, maxWeights, candidate);
+        double cut = GetCut(g, candidate);
+        if (excess < bestExcess || (excess == bestExcess && cut < bestCut))
+        {
+            bestExcess = excess;
+            bestCut = cut;
+            part = std::move(candidate);
+        }
+    }
+
+    std::vector<uint32_t> vertices[2];
+    Graph halves[2] = {GetSubgraph(g, part, 0, vertices[0]),
+                       GetSubgraph(g, part, 1, vertices[1])};
+    for (uint32_t side = 0; side < 2; side++)
+    {
+        auto subPart = Bisect(halves[side], side == 0 ? k0 : k - k0, maxWeight);
+        for (uint32_t i = 0; i < subPart.size(); i++)
+        {
+            part[vertices[side][i]] = (side == 0 ? 0 : k0) + subPart[i];
+        }
+    }
+    return part;
+}
+
+/**
+ * Partition a graph with the multilevel scheme.
+ * \param graph The graph.
+ * \param k The number of partitions.
+ * \param maxWeight The maximum weight of a partition.
+ * \returns The partition of each vertex.
+ */
+std::vector<uint32_t>
+PartitionGraph(const Graph& graph, uint32_t k, double maxWeight)
+{
+    uint32_t n = graph.GetN();
+    std::vector<uint32_t> part(n, 0);
+    if (k == 1)
+    {
+        return part;
+    }
+    if (n <= k)
+    {
+        std::iota(part.begin(), part.end(), 0);
+        return part;
+    }
+
+    // Coarsen until a few vertices per partition are left, or the matching
+    // stalls, with vertices small enough for the partitions to be balanced
+    double total = std::accumulate(graph.vertexWeight.begin(), graph.vertexWeight.end(), 0.0);
+    double maxVertexWeight = std::max(1.5 * total / (COARSEST_VERTICES * k), maxWeight / 8);
+    std::vector<Graph> graphs{graph};
+    std::vector<std::vector<uint32_t>> maps;
+    while (graphs.back().GetN() > COARSEST_VERTICES * k)
+    {
+        std::vector<uint32_t> map;
+        Graph coarse = Coarsen(graphs.back(), maxVertexWeight, map);
+        if (coarse.GetN() > 0.9 * graphs.back().GetN())
+        {
+            break;
+        }
+        maps.push_back(std::move(map));
+        graphs.push_back(std::move(coarse));
+    }
+
+    // Partition the coarsest graph by recursive bisection
+    std::vector<double> maxWeights(k, maxWeight);
+    part = Bisect(graphs.back(), k, maxWeight);
+    Refine(graphs.back(), maxWeights, part);
+    Climb(graphs.back(), maxWeights, part);
+
+    // Project back to the finer graphs, refining at each level
+    for (std::size_t level = maps.size(); level-- > 0;)
+    {
+        std::vector<uint32_t> finer(graphs[level].GetN());
+        for (uint32_t v = 0; v < finer.size(); v++)
+        {
+            finer[v] = part[maps[level][v]];
+        }
+        part.swap(finer);
+        Refine(graphs[level], maxWeights, part);
+        Climb(graphs[level], maxWeights, part);
+    }
+    return part;
+}
+
+/**
+ * Find the representative of a set, halving the path to it.
+ * \param [in,out] parent The parent of each element.
+ * \param v The element.
+ * \returns The representative.
+ */
+uint32_t
+Find(std::vector<uint32_t>& parent, uint32_t v)
+{
+    while (parent[v] != v)
+    {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+} // namespace
+
+PartitionHelper::PartitionHelper()
+    : m_imbalance(0.05),
+      m_lookahead(Simulator::GetMaximumSimulationTime()),
+      m_cutLinks(0),
+      m_cutWeight(0)
+{
+}
+
+void
+PartitionHelper::SetImbalance(double imbalance)
+{
+    NS_ABORT_MSG_IF(imbalance < 0, "Negative imbalance");
+    m_imbalance = imbalance;
+}
+
+void
+PartitionHelper::SetNodeWeight(Ptr<Node> node, double weight)
+{
+    NS_ABORT_MSG_IF(weight <= 0, "Node weights must be positive");
+    m_nodeWeights[node->GetId()] = weight;
+}
+
+void
+PartitionHelper::SetLinkWeight(Ptr<Node> a, Ptr<Node> b, double weight)
+{
+    NS_ABORT_MSG_IF(weight < 0, "Negative link weight");
+    m_linkWeights[std::minmax(a->GetId(), b->GetId())] = weight;
+}
+
+void
+PartitionHelper::AddLink(Ptr<Node> a, Ptr<Node> b, Time delay, double weight)
+{
+    NS_ABORT_MSG_IF(weight < 0, "Negative link weight");
+    m_links.emplace_back(a->GetId(), b->GetId(), delay, weight);
+}
+
+std::vector<PartitionHelper::Link>
+PartitionHelper::GetLinks(const NodeContainer& nodes) const
+{
+    std::map<uint32_t, uint32_t> index;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        index[nodes.Get(i)->GetId()] = i;
+    }
+    auto getWeight = [this](uint32_t a, uint32_t b) {
+        auto it = m_linkWeights.find(std::minmax(a, b));
+        return it != m_linkWeights.end() ? it->second : 1.0;
+    };
+
+    std::vector<Link> links;
+    std::set<uint32_t> channels;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<Node> node = nodes.Get(i);
+        for (uint32_t j = 0; j < node->GetNDevices(); j++)
+        {
+            Ptr<Channel> channel = node->GetDevice(j)->GetChannel();
+            if (!channel || !channels.insert(channel->GetId()).second)
+            {
+                continue;
+            }
+            std::vector<uint32_t> ends;
+            for (std::size_t d = 0; d < channel->GetNDevices(); d++)
+            {
+                Ptr<Node> end = channel->GetDevice(d)->GetNode();
+                if (end && index.count(end->GetId()) &&
+                    std::find(ends.begin(), ends.end(), end->GetId()) == ends.end())
+                {
+                    ends.push_back(end->GetId());
+                }
+            }
+            // Only the point-to-point channels with a delay may be cut, the
+            // others keep their nodes together
+            TimeValue delay(Time(0));
+            if (channel->GetNDevices() != 2 || !channel->GetAttributeFailSafe("Delay", delay))
+            {
+                delay = Time(0);
+            }
+            for (std::size_t e = 1; e < ends.size(); e++)
+            {
+                links.push_back({index[ends[0]],
+                                 index[ends[e]],
+                                 delay.Get(),
+                                 getWeight(ends[0], ends[e])});
+            }
+        }
+    }
+
+    for (const auto& [a, b, delay, weight] : m_links)
+    {
+        if (index.count(a) && index.count(b))
+        {
+            links.push_back({index[a], index[b], delay, weight});
+        }
+        else
+        {
+            NS_LOG_WARN("Link " << a << "-" << b << " ignored, not between nodes to partition");
+        }
+    }
+    return links;
+}
+
+std::vector<uint32_t>
+PartitionHelper::Assign(const NodeContainer& nodes, uint32_t nPartitions)
+{
+    NS_LOG_FUNCTION(this << nPartitions);
+    NS_ABORT_MSG_IF(nPartitions == 0, "No partition");
+
+    uint32_t n = nodes.GetN();
+    std::vector<Link> links = GetLinks(nodes);
+    std::vector<double> weights(n, 1);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        auto it = m_nodeWeights.find(nodes.Get(i)->GetId());
+        if (it != m_nodeWeights.end())
+        {
+            weights[i] = it->second;
+        }
+    }
+    double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double heaviest = n > 0 ? *std::max_element(weights.begin(), weights.end()) : 0;
+    double maxWeight = std::max((1 + m_imbalance) * total / nPartitions, heaviest);
+
+    // The lookahead is the delay of the shortest link cut: contract the
+    // links shorter than the largest delay for which the contracted nodes
+    // still fit in balanced partitions, along with those never cut
+    std::vector<Time> delays;
+    for (const auto& link : links)
+    {
+        if (link.delay.IsStrictlyPositive())
+        {
+            delays.push_back(link.delay);
+        }
+    }
+    std::sort(delays.begin(), delays.end());
+    delays.erase(std::unique(delays.begin(), delays.end()), delays.end());
+
+    std::vector<uint32_t> parent(n);
+    auto contract = [&](Time threshold) {
+        std::iota(parent.begin(), parent.end(), 0);
+        for (const auto& link : links)
+        {
+            if (!link.delay.IsStrictlyPositive() || link.delay < threshold)
+            {
+                parent[Find(parent, link.a)] = Find(parent, link.b);
+            }
+        }
+        std::vector<double> component(n, 0);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            component[Find(parent, i)] += weights[i];
+        }
+        uint32_t nComponents = std::count_if(component.begin(),
+                                             component.end(),
+                                             [](double weight) { return weight > 0; });
+        return nComponents >= nPartitions &&
+               *std::max_element(component.begin(), component.end()) <= maxWeight;
+    };
+    // The larger the threshold, the larger the contracted nodes
+    std::size_t low = 0;
+    std::size_t high = delays.size();
+    while (high - low > 1)
+    {
+        std::size_t middle = (low + high) / 2;
+        if (contract(delays[middle]))
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    if (!contract(delays.empty() ? Time(0) : delays[low]) && n >= nPartitions)
+    {
+        NS_LOG_WARN("Nodes which may not be separated exceed the share of a partition");
+    }
+
+    // Partition the contracted graph
+    std::vector<uint32_t> vertex(n, UNASSIGNED);
+    std::vector<double> vertexWeights;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t root = Find(parent, i);
+        if (vertex[root] == UNASSIGNED)
+        {
+            vertex[root] = vertexWeights.size();
+            vertexWeights.push_back(0);
+        }
+        vertex[i] = vertex[root];
+        vertexWeights[vertex[i]] += weights[i];
+    }
+    std::vector<Edge> edges;
+    for (const auto& link : links)
+    {
+        edges.emplace_back(vertex[link.a], vertex[link.b], link.weight);
+    }
+    std::vector<uint32_t> part =
+        PartitionGraph(MakeGraph(std::move(vertexWeights), edges), nPartitions, maxWeight);
+
+    std::vector<uint32_t> partitions(n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        partitions[i] = part[vertex[i]];
+        nodes.Get(i)->SetAttribute("SystemId", UintegerValue(partitions[i]));
+    }
+
+    m_lookahead = Simulator::GetMaximumSimulationTime();
+    m_cutLinks = 0;
+    m_cutWeight = 0;
+    for (const auto& link : links)
+    {
+        if (partitions[link.a] != partitions[link.b])
+        {
+            m_lookahead = std::min(m_lookahead, link.delay);
+            m_cutLinks++;
+            m_cutWeight += link.weight;
+        }
+    }
+    NS_LOG_INFO(n << " nodes in " << nPartitions << " partitions, " << m_cutLinks
+                  << " links cut, lookahead " << m_lookahead);
+    return partitions;
+}
+
+Time
+PartitionHelper::GetLookahead() const
+{
+    return m_lookahead;
+}
+
+uint32_t
+PartitionHelper::GetCutLinks() const
+{
+    return m_cutLinks;
+}
+
+double
+PartitionHelper::GetCutWeight() const
+{
+    return m_cutWeight;
+}
+
+} // namespace ns3
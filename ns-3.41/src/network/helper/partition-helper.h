@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PARTITION_HELPER_H
+#define PARTITION_HELPER_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief Split the nodes of a topology into balanced partitions for a
+ * parallel simulation, and set their system ids accordingly.
+ *
+ * The nodes are the vertices of a graph whose edges are the channels
+ * connecting them, read from their devices, and the links added with
+ * AddLink().  A channel connecting two nodes may be cut, its \c Delay
+ * attribute then bounds the lookahead of the simulation; channels with no
+ * such attribute, no delay, or more than two devices are never cut.
+ *
+ * The lookahead comes first: the links shorter than the largest delay
+ * which still lets the partitions be balanced are contracted beforehand,
+ * so that only the longest links are cut.  The contracted graph is then
+ * split with a multilevel k-way algorithm: it is coarsened by heavy-edge
+ * matching, the coarsest graph is partitioned by recursive bisection, each
+ * half grown greedily from a seed, and the partition is projected back
+ * level by level, with a boundary refinement and Fiduccia-Mattheyses hill
+ * climbing at each level which lower the weight of the cut links under the
+ * balance constraint.  The weight of a link estimates its traffic, and that
+ * of a node its processing load; both default to 1.
+ *
+ * The partition is deterministic.  With MultithreadedSimulatorImpl, Assign()
+ * may be called anywhere before Simulator::Run().  With the distributed
+ * simulator, the system ids must be set before the point-to-point links
+ * are installed, since the helper picks remote channels by system id: use
+ * AddLink() to describe the topology and Assign() on the bare nodes.
+ */
+class PartitionHelper
+{
+  public:
+    /** Create a helper with a balance tolerance of 5%. */
+    PartitionHelper();
+
+    /**
+     * Set how far the weight of a partition may exceed the average.
+     * \param imbalance The tolerance, 0.05 for 5%.
+     */
+    void SetImbalance(double imbalance);
+    /**
+     * Set the processing weight of a node.
+     * \param node The node.
+     * \param weight The weight, 1 by default.
+     */
+    void SetNodeWeight(Ptr<Node> node, double weight);
+    /**
+     * Set the traffic weight of the links connecting two nodes.
+     * \param a One node.
+     * \param b The other node.
+     * \param weight The weight, 1 by default.
+     */
+    void SetLinkWeight(Ptr<Node> a, Ptr<Node> b, double weight);
+    /**
+     * Add a link which is not, or not yet, a channel of the nodes.
+     * \param a One node.
+     * \param b The other node.
+     * \param delay The delay of the link.
+     * \param weight The traffic weight of the link.
+     */
+    void AddLink(Ptr<Node> a, Ptr<Node> b, Time delay, double weight = 1);
+
+    /**
+     * Partition nodes, and set their \c SystemId attribute.
+     * \param nodes The nodes.
+     * \param nPartitions The number of partitions.
+     * \returns The partition of each node, in the order of the container.
+     */
+    std::vector<uint32_t> Assign(const NodeContainer& nodes, uint32_t nPartitions);
+
+    /**
+     * \returns The smallest delay of the links cut by the last Assign(), or
+     *          the maximum simulation time if none is cut.
+     */
+    Time GetLookahead() const;
+    /** \returns The number of links cut by the last Assign(). */
+    uint32_t GetCutLinks() const;
+    /** \returns The traffic weight of the links cut by the last Assign(). */
+    double GetCutWeight() const;
+
+  private:
+    /** A link between two nodes. */
+    struct Link
+    {
+        uint32_t a;    //!< Index of one node in the container
+        uint32_t b;    //!< Index of the other node
+        Time delay;    //!< The delay, zero if the link may not be cut
+        double weight; //!< The traffic weight
+    };
+
+    /**
+     * Collect the links between nodes.
+     * \param nodes The nodes.
+     * \returns The links.
+     */
+    std::vector<Link> GetLinks(const NodeContainer& nodes) const;
+
+    double m_imbalance;                       //!< Balance tolerance
+    std::map<uint32_t, double> m_nodeWeights; //!< Node weights, by node id
+    /** Link weights, by node ids. */
+    std::map<std::pair<uint32_t, uint32_t>, double> m_linkWeights;
+    /** The added links: node ids, delay and weight. */
+    std::vector<std::tuple<uint32_t, uint32_t, Time, double>> m_links;
+
+    Time m_lookahead;    //!< Lookahead of the last partition
+    uint32_t m_cutLinks; //!< Number of links cut by the last partition
+    double m_cutWeight;  //!< Weight of the links cut by the last partition
+};
+
+} // namespace ns3
+
+#endif /* PARTITION_HELPER_H */
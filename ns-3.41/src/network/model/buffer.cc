@@ -54,7 +54,7 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
-uint32_t Buffer::g_recommendedStart = 0;
+thread_local uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -64,6 +64,10 @@ uint32_t Buffer::g_recommendedStart = 0;
  *  - initialized means that the free list exists and is valid
  *  - destroyed means that the static destructors of this compilation unit
  *    have run so, the free list has been cleared from its content
+ * There is one free list per thread, so that threads running simulation
+ * partitions in parallel need no locking; data released by a thread other
+ * than the one which created it goes to the free list of the releasing
+ * thread.
  * The key is that in destroyed state, we are careful not re-create it
  * which is a typical weakness of lazy evaluation schemes which use
  * '0' as a special value to indicate both un-initialized and destroyed.
@@ -79,9 +83,9 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED(x) && !IS_DESTROYED(x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList* Buffer::g_freeList = nullptr;
-Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+thread_local uint32_t Buffer::g_maxSize = 0;
+thread_local Buffer::FreeList* Buffer::g_freeList = nullptr;
+thread_local Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor()
 {
@@ -102,10 +106,9 @@ Buffer::Recycle(Buffer::Data* data)
 {
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
-    NS_ASSERT(!IS_UNINITIALIZED(g_freeList));
     g_maxSize = std::max(g_maxSize, data->m_size);
     /* feed into free list */
-    if (data->m_size < g_maxSize || IS_DESTROYED(g_freeList) || g_freeList->size() > 1000)
+    if (data->m_size < g_maxSize || !IS_INITIALIZED(g_freeList) || g_freeList->size() > 1000)
     {
         Buffer::Deallocate(data);
     }
@@ -124,6 +127,8 @@ Buffer::Create(uint32_t dataSize)
     if (IS_UNINITIALIZED(g_freeList))
     {
         g_freeList = new Buffer::FreeList();
+        // make sure the free list of this thread is released when it exits
+        static_cast<void>(&g_localStaticDestructor);
     }
     else if (IS_INITIALIZED(g_freeList))
     {
@@ -266,8 +271,7 @@ Buffer::operator=(const Buffer& o)
     if (m_data != o.m_data)
     {
         // not assignment to self.
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Recycle(m_data);
         }
@@ -289,8 +293,7 @@ Buffer::~Buffer()
     NS_LOG_FUNCTION(this);
     NS_ASSERT(CheckInternalState());
     g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         Recycle(m_data);
     }
@@ -333,8 +336,7 @@ Buffer::AddAtStart(uint32_t start)
         uint32_t newSize = GetInternalSize() + start;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data + start, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -379,8 +381,7 @@ Buffer::AddAtEnd(uint32_t end)
         uint32_t newSize = GetInternalSize() + end;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -537,6 +538,27 @@ Buffer::CreateFragment(uint32_t start, uint32_t length) const
     return tmp;
 }
 
+void
+Buffer::Unshare()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(CheckInternalState());
+    if (m_data->m_count == 1)
+    {
+        return;
+    }
+    Buffer::Data* newData = Buffer::Create(m_data->m_size);
+    memcpy(newData->m_data + m_start, m_data->m_data + m_start, GetInternalSize());
+    if (--m_data->m_count == 0)
+    {
+        Buffer::Recycle(m_data);
+    }
+    m_data = newData;
+    m_data->m_dirtyStart = m_start;
+    m_data->m_dirtyEnd = m_end;
+    NS_ASSERT(CheckInternalState());
+}
+
 Buffer
 Buffer::CreateFullCopy() const
 {
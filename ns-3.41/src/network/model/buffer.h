@@ -556,6 +556,15 @@ class Buffer
      */
     Buffer CreateFragment(uint32_t start, uint32_t length) const;
 
+    /**
+     * Give this buffer a copy of the data it shares with other buffers, if
+     * any, so that it can be used by another thread than theirs: the
+     * reference counts of the data are not atomic.
+     * Any call to this method invalidates any Iterator
+     * pointing to this Buffer.
+     */
+    void Unshare();
+
     /**
      * \return an Iterator which points to the
      * start of this Buffer.
@@ -769,7 +778,7 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
-    static uint32_t g_recommendedStart;
+    static thread_local uint32_t g_recommendedStart;
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -802,9 +811,10 @@ class Buffer
         ~LocalStaticDestructor();
     };
 
-    static uint32_t g_maxSize;                            //!< Max observed data size
-    static FreeList* g_freeList;                          //!< Buffer data container
-    static LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+    static thread_local uint32_t g_maxSize;   //!< Max observed data size
+    static thread_local FreeList* g_freeList; //!< Buffer data container
+    /// Local static destructor
+    static thread_local LocalStaticDestructor g_localStaticDestructor;
 #endif
 };
 
@@ -56,13 +56,14 @@ struct ByteTagListData
  *
  * Internal use only.
  */
-static class ByteTagListDataFreeList : public std::vector<ByteTagListData*>
+static thread_local class ByteTagListDataFreeList : public std::vector<ByteTagListData*>
 {
   public:
     ~ByteTagListDataFreeList();
-} g_freeList; //!< Container for struct ByteTagListData
+} g_freeList; //!< Container for struct ByteTagListData, per thread
 
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+static thread_local uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+static thread_local bool g_freeListDestroyed = false; //!< Whether g_freeList was destroyed
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList()
 {
@@ -72,6 +73,7 @@ ByteTagListDataFreeList::~ByteTagListDataFreeList()
         auto buffer = (uint8_t*)(*i);
         delete[] buffer;
     }
+    g_freeListDestroyed = true;
 }
 #endif /* USE_FREE_LIST */
 
@@ -261,6 +263,21 @@ ByteTagList::RemoveAll()
     m_used = 0;
 }
 
+void
+ByteTagList::Unshare()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_data == nullptr || m_data->count == 1)
+    {
+        return;
+    }
+    ByteTagListData* newData = Allocate(m_used);
+    std::memcpy(&newData->data, &m_data->data, m_used);
+    Deallocate(m_data);
+    m_data = newData;
+    m_data->dirty = m_used;
+}
+
 ByteTagList::Iterator
 ByteTagList::BeginAll() const
 {
@@ -355,7 +372,7 @@ ByteTagListData*
 ByteTagList::Allocate(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
-    while (!g_freeList.empty())
+    while (!g_freeListDestroyed && !g_freeList.empty())
     {
         ByteTagListData* data = g_freeList.back();
         g_freeList.pop_back();
@@ -386,10 +403,10 @@ ByteTagList::Deallocate(ByteTagListData* data)
         return;
     }
     g_maxSize = std::max(g_maxSize, data->size);
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
-        if (g_freeList.size() > FREE_LIST_SIZE || data->size < g_maxSize)
+        if (g_freeListDestroyed || g_freeList.size() > FREE_LIST_SIZE ||
+            data->size < g_maxSize)
         {
             auto buffer = (uint8_t*)data;
             delete[] buffer;
@@ -423,8 +440,7 @@ ByteTagList::Deallocate(ByteTagListData* data)
     {
         return;
     }
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         uint8_t* buffer = (uint8_t*)data;
         delete[] buffer;
@@ -201,6 +201,13 @@ class ByteTagList
      */
     void RemoveAll();
 
+    /**
+     * Give this list a copy of the tags it shares with other lists, if any,
+     * so that it can be used by another thread than theirs: the reference
+     * counts of the tags are not atomic.
+     */
+    void Unshare();
+
     /**
      * \param offsetStart the offset which uniquely identifies the first data byte
      *        present in the byte buffer associated to this ByteTagList.
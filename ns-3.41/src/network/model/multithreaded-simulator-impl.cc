@@ -0,0 +1,786 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "channel-list.h"
+#include "channel.h"
+#include "net-device.h"
+#include "node-list.h"
+#include "node.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <tuple>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions, from several threads
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::Partition* MultithreadedSimulatorImpl::m_current =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Network")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "Maximum number of threads running partitions, "
+                          "0 for the number of hardware threads",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::Partition::Partition(uint32_t id)
+    : id(id),
+      events(nullptr),
+      uid(EventId::UID::VALID),
+      currentUid(EventId::UID::INVALID),
+      currentTs(0),
+      currentContext(Simulator::NO_CONTEXT),
+      eventCount(0),
+      sent(0),
+      unscheduledEvents(0),
+      stop(false)
+{
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_stop(false),
+      m_running(false),
+      m_currentTs(0),
+      m_windowEnd(0),
+      m_lookahead(UINT64_MAX),
+      m_foreignSequence(0),
+      m_uid(EventId::UID::VALID),
+      m_mainThreadId(std::this_thread::get_id()),
+      m_maxThreads(0),
+      m_nextPartition(0),
+      m_done(false)
+{
+    NS_LOG_FUNCTION(this);
+    m_partitions.push_back(std::make_unique<Partition>(0));
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_foreignEvents.Drain([](const RemoteEvent& ev) { ev.event->Unref(); });
+    for (auto& partition : m_partitions)
+    {
+        partition->inbox.Drain([](const RemoteEvent& ev) { ev.event->Unref(); });
+        while (partition->events && !partition->events->IsEmpty())
+        {
+            Scheduler::Event next = partition->events->RemoveNext();
+            next.impl->Unref();
+        }
+        partition->events = nullptr;
+    }
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    for (;;)
+    {
+        Ptr<EventImpl> ev;
+        {
+            std::unique_lock lock{m_mutex};
+            if (m_destroyEvents.empty())
+            {
+                break;
+            }
+            ev = m_destroyEvents.front().PeekEventImpl();
+            m_destroyEvents.pop_front();
+        }
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    NS_ASSERT_MSG(!m_running, "Cannot change the scheduler while running");
+    m_schedulerFactory = schedulerFactory;
+    for (auto& partition : m_partitions)
+    {
+        Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+        if (partition->events)
+        {
+            while (!partition->events->IsEmpty())
+            {
+                scheduler->Insert(partition->events->RemoveNext());
+            }
+        }
+        partition->events = scheduler;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions(uint32_t systemId)
+{
+    while (m_partitions.size() <= systemId)
+    {
+        auto partition = std::make_unique<Partition>(m_partitions.size());
+        partition->events = m_schedulerFactory.Create<Scheduler>();
+        m_partitions.push_back(std::move(partition));
+    }
+}
+
+void
+MultithreadedSimulatorImpl::UpdatePartitions()
+{
+    NS_ASSERT_MSG(!m_running && std::this_thread::get_id() == m_mainThreadId,
+                  "The node list may only be read from the main thread");
+    uint32_t nNodes = NodeList::GetNNodes();
+    for (auto i = static_cast<uint32_t>(m_nodePartitions.size()); i < nNodes; i++)
+    {
+        uint32_t systemId = NodeList::GetNode(i)->GetSystemId();
+        CreatePartitions(systemId);
+        m_nodePartitions.push_back(systemId);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RefreshPartitions()
+{
+    NS_LOG_FUNCTION(this);
+    UpdatePartitions();
+    bool moved = false;
+    for (uint32_t i = 0; i < m_nodePartitions.size(); i++)
+    {
+        uint32_t systemId = NodeList::GetNode(i)->GetSystemId();
+        if (systemId != m_nodePartitions[i])
+        {
+            CreatePartitions(systemId);
+            m_nodePartitions[i] = systemId;
+            moved = true;
+        }
+    }
+    if (!moved)
+    {
+        return;
+    }
+
+    // Take the events of the nodes which changed partitions out of their
+    // former scheduler, and insert them in that of the new one with their
+    // keys, which the identifiers held by the models refer to
+    std::vector<Scheduler::Event> moving;
+    for (auto& partition : m_partitions)
+    {
+        std::vector<Scheduler::Event> staying;
+        while (!partition->events->IsEmpty())
+        {
+            Scheduler::Event ev = partition->events->RemoveNext();
+            if (&GetPartition(ev.key.m_context) == partition.get())
+            {
+                staying.push_back(ev);
+            }
+            else
+            {
+                moving.push_back(ev);
+                partition->unscheduledEvents--;
+            }
+        }
+        for (const auto& ev : staying)
+        {
+            partition->events->Insert(ev);
+        }
+    }
+    for (const auto& ev : moving)
+    {
+        Partition& target = GetPartition(ev.key.m_context);
+        target.events->Insert(ev);
+        target.unscheduledEvents++;
+    }
+    NS_LOG_LOGIC(moving.size() << " events moved to new partitions");
+}
+
+MultithreadedSimulatorImpl::Partition&
+MultithreadedSimulatorImpl::GetPartition(uint32_t context)
+{
+    if (context == Simulator::NO_CONTEXT)
+    {
+        return *m_partitions[0];
+    }
+    if (context >= m_nodePartitions.size() && !m_running)
+    {
+        UpdatePartitions();
+    }
+    if (context < m_nodePartitions.size())
+    {
+        return *m_partitions[m_nodePartitions[context]];
+    }
+    return *m_partitions[0];
+}
+
+MultithreadedSimulatorImpl::Partition&
+MultithreadedSimulatorImpl::GetPartition(const EventId& id) const
+{
+    uint32_t context = id.GetContext();
+    if (context < m_nodePartitions.size())
+    {
+        return *m_partitions[m_nodePartitions[context]];
+    }
+    return *m_partitions[0];
+}
+
+uint64_t
+MultithreadedSimulatorImpl::CurrentTs() const
+{
+    return m_current != nullptr ? m_current->currentTs : m_currentTs;
+}
+
+Time
+MultithreadedSimulatorImpl::CalculateLookahead() const
+{
+    NS_LOG_FUNCTION(this);
+    Time lookahead = GetMaximumSimulationTime();
+    for (auto i = ChannelList::Begin(); i != ChannelList::End(); i++)
+    {
+        Ptr<Channel> channel = *i;
+        bool crossing = false;
+        uint32_t first = NO_PARTITION;
+        for (std::size_t j = 0; j < channel->GetNDevices(); j++)
+        {
+            Ptr<Node> node = channel->GetDevice(j)->GetNode();
+            if (!node)
+            {
+                continue;
+            }
+            if (first == NO_PARTITION)
+            {
+                first = node->GetSystemId();
+            }
+            else if (node->GetSystemId() != first)
+            {
+                crossing = true;
+                break;
+            }
+        }
+        if (!crossing)
+        {
+            continue;
+        }
+        TimeValue delay;
+        if (!channel->GetAttributeFailSafe("Delay", delay))
+        {
+            NS_FATAL_ERROR("Channel " << channel->GetId() << " (" << channel->GetInstanceTypeId()
+                                      << ") connects partitions but has no Delay attribute");
+        }
+        NS_ABORT_MSG_IF(!delay.Get().IsStrictlyPositive(),
+                        "Channel " << channel->GetId()
+                                   << " connects partitions with no propagation delay");
+        lookahead = std::min(lookahead, delay.Get());
+    }
+    return lookahead;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return m_lookahead == UINT64_MAX ? GetMaximumSimulationTime() : TimeStep(m_lookahead);
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert(Partition& partition,
+                                   uint64_t ts,
+                                   uint32_t context,
+                                   EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    if (m_running)
+    {
+        // Each partition draws its own sequence of the unique ids, so that
+        // they stay unique across partitions
+        ev.key.m_uid = partition.uid;
+        partition.uid += m_partitions.size();
+    }
+    else
+    {
+        ev.key.m_uid = m_uid++;
+    }
+    partition.unscheduledEvents++;
+    partition.events->Insert(ev);
+    return ev.key;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessRemoteEvents()
+{
+    m_foreignEvents.Drain(
+        [this](const RemoteEvent& ev) { GetPartition(ev.context).inbox.Push(ev); });
+    std::vector<RemoteEvent> events;
+    for (auto& partition : m_partitions)
+    {
+        if (partition->inbox.IsEmpty())
+        {
+            continue;
+        }
+        events.clear();
+        partition->inbox.Drain([&events](const RemoteEvent& ev) { events.push_back(ev); });
+        for (auto& ev : events)
+        {
+            if (ev.source == NO_PARTITION)
+            {
+                ev.timestamp += partition->currentTs;
+            }
+        }
+        // The order in which the partitions pushed their events depends on
+        // the thread timings, the order of insertion must not
+        std::sort(events.begin(), events.end(), [](const RemoteEvent& a, const RemoteEvent& b) {
+            return std::tie(a.timestamp, a.source, a.sequence) <
+                   std::tie(b.timestamp, b.source, b.sequence);
+        });
+        for (const auto& ev : events)
+        {
+            Insert(*partition, ev.timestamp, ev.context, ev.event);
+        }
+    }
+}
+
+uint64_t
+MultithreadedSimulatorImpl::NextTs() const
+{
+    uint64_t next = UINT64_MAX;
+    for (const auto& partition : m_partitions)
+    {
+        if (!partition->events->IsEmpty())
+        {
+            next = std::min(next, partition->events->PeekNext().key.m_ts);
+        }
+    }
+    return next;
+}
+
+void
+MultithreadedSimulatorImpl::RunWindow(Partition& partition)
+{
+    m_current = &partition;
+    while (!partition.stop && !partition.events->IsEmpty() &&
+           partition.events->PeekNext().key.m_ts < m_windowEnd)
+    {
+        Scheduler::Event next = partition.events->RemoveNext();
+
+        PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+        NS_ASSERT(next.key.m_ts >= partition.currentTs);
+        partition.unscheduledEvents--;
+        partition.eventCount++;
+
+        partition.currentTs = next.key.m_ts;
+        partition.currentContext = next.key.m_context;
+        partition.currentUid = next.key.m_uid;
+        next.impl->Invoke();
+        next.impl->Unref();
+    }
+    m_current = nullptr;
+}
+
+void
+MultithreadedSimulatorImpl::RunPartitions()
+{
+    auto nPartitions = static_cast<uint32_t>(m_partitions.size());
+    for (uint32_t i = m_nextPartition++; i < nPartitions; i = m_nextPartition++)
+    {
+        RunWindow(*m_partitions[i]);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunWorker()
+{
+    for (;;)
+    {
+        m_barrier->arrive_and_wait();
+        if (m_done)
+        {
+            return;
+        }
+        RunPartitions();
+        m_barrier->arrive_and_wait();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    if (!m_foreignEvents.IsEmpty())
+    {
+        return false;
+    }
+    for (const auto& partition : m_partitions)
+    {
+        if (!partition->events->IsEmpty() || !partition->inbox.IsEmpty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(!m_running && m_current == nullptr, "Recursive call to Simulator::Run()");
+
+    m_mainThreadId = std::this_thread::get_id();
+    RefreshPartitions();
+    // Start the sequences of unique ids of the partitions above every id
+    // in use, the events moved between partitions kept theirs
+    uint32_t uid = m_uid;
+    for (const auto& partition : m_partitions)
+    {
+        uid = std::max(uid, partition->uid);
+    }
+    for (auto& partition : m_partitions)
+    {
+        partition->uid = uid + partition->id;
+    }
+    Time lookahead = CalculateLookahead();
+    m_lookahead = lookahead == GetMaximumSimulationTime() ? UINT64_MAX : lookahead.GetTimeStep();
+    NS_LOG_LOGIC(m_partitions.size() << " partitions, lookahead " << lookahead);
+
+    uint32_t nThreads = m_maxThreads > 0 ? m_maxThreads : std::thread::hardware_concurrency();
+    nThreads = std::clamp<uint32_t>(nThreads, 1, m_partitions.size());
+
+    m_stop = false;
+    for (auto& partition : m_partitions)
+    {
+        partition->stop = false;
+    }
+    m_running = true;
+    m_done = false;
+    if (nThreads > 1)
+    {
+        m_barrier = std::make_unique<std::barrier<>>(nThreads);
+        for (uint32_t i = 1; i < nThreads; i++)
+        {
+            m_workers.emplace_back(&MultithreadedSimulatorImpl::RunWorker, this);
+        }
+    }
+
+    ProcessRemoteEvents();
+    while (!m_stop)
+    {
+        uint64_t next = NextTs();
+        if (next == UINT64_MAX)
+        {
+            break;
+        }
+        m_currentTs = next;
+        m_windowEnd = next < UINT64_MAX - m_lookahead ? next + m_lookahead : UINT64_MAX;
+        {
+            // Let every partition run up to, and including, the time of a
+            // pending Stop(delay), but no further
+            std::unique_lock lock{m_mutex};
+            m_stopTimes.erase(std::remove_if(m_stopTimes.begin(),
+                                             m_stopTimes.end(),
+                                             [next](uint64_t ts) { return ts < next; }),
+                              m_stopTimes.end());
+            for (auto ts : m_stopTimes)
+            {
+                m_windowEnd = std::min(m_windowEnd, ts + 1);
+            }
+        }
+
+        m_nextPartition = 0;
+        if (m_barrier)
+        {
+            m_barrier->arrive_and_wait();
+        }
+        RunPartitions();
+        if (m_barrier)
+        {
+            m_barrier->arrive_and_wait();
+        }
+        ProcessRemoteEvents();
+    }
+
+    if (m_barrier)
+    {
+        m_done = true;
+        m_barrier->arrive_and_wait();
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+        m_barrier.reset();
+    }
+    m_running = false;
+
+    for (const auto& partition : m_partitions)
+    {
+        m_currentTs = std::max(m_currentTs, partition->currentTs);
+        m_uid = std::max(m_uid, partition->uid);
+        // If the simulator stopped naturally by lack of events, make a
+        // consistency test to check that we didn't lose any events along the way.
+        NS_ASSERT(!partition->events->IsEmpty() || partition->unscheduledEvents == 0);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_current != nullptr)
+    {
+        m_current->stop = true;
+    }
+    m_stop = true;
+}
+
+EventId
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    {
+        std::unique_lock lock{m_mutex};
+        m_stopTimes.push_back(CurrentTs() + delay.GetTimeStep());
+    }
+    return Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_ASSERT_MSG(m_current != nullptr ||
+                      (!m_running && std::this_thread::get_id() == m_mainThreadId),
+                  "Simulator::Schedule Thread-unsafe invocation!");
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+    Partition& partition = m_current != nullptr ? *m_current : *m_partitions[0];
+    uint64_t ts = CurrentTs() + delay.GetTimeStep();
+    Scheduler::EventKey key = Insert(partition, ts, GetContext(), event);
+    return EventId(event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+
+    if (m_current == nullptr && (std::this_thread::get_id() != m_mainThreadId || m_running))
+    {
+        // From a thread outside of the partitions, the main thread hands the
+        // event over to its partition, which adds its current time
+        RemoteEvent ev;
+        ev.timestamp = delay.GetTimeStep();
+        ev.context = context;
+        ev.event = event;
+        ev.source = NO_PARTITION;
+        ev.sequence = m_foreignSequence++;
+        m_foreignEvents.Push(ev);
+        return;
+    }
+
+    Partition& target = GetPartition(context);
+    if (!m_running || m_current == &target)
+    {
+        Insert(target, CurrentTs() + delay.GetTimeStep(), context, event);
+    }
+    else
+    {
+        RemoteEvent ev;
+        ev.timestamp = m_current->currentTs + delay.GetTimeStep();
+        ev.context = context;
+        ev.event = event;
+        ev.source = m_current->id;
+        ev.sequence = m_current->sent++;
+        NS_ABORT_MSG_IF(ev.timestamp < m_windowEnd,
+                        "Event for partition " << target.id << " scheduled from partition "
+                                               << m_current->id << " within the lookahead of "
+                                               << GetLookahead());
+        target.inbox.Push(ev);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    EventId id(Ptr<EventImpl>(event, false), CurrentTs(), 0xffffffff, EventId::UID::DESTROY);
+    std::unique_lock lock{m_mutex};
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(CurrentTs());
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - CurrentTs());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::unique_lock lock{m_mutex};
+        auto i = std::find(m_destroyEvents.begin(), m_destroyEvents.end(), id);
+        if (i != m_destroyEvents.end())
+        {
+            m_destroyEvents.erase(i);
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Partition& partition = GetPartition(id);
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    partition.events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    partition.unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        std::unique_lock lock{m_mutex};
+        return std::find(m_destroyEvents.begin(), m_destroyEvents.end(), id) ==
+               m_destroyEvents.end();
+    }
+    const Partition& partition = GetPartition(id);
+    return id.PeekEventImpl() == nullptr || id.GetTs() < partition.currentTs ||
+           (id.GetTs() == partition.currentTs && id.GetUid() <= partition.currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return m_current != nullptr ? m_current->id : 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return m_current != nullptr ? m_current->currentContext : Simulator::NO_CONTEXT;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = 0;
+    for (const auto& partition : m_partitions)
+    {
+        count += partition->eventCount;
+    }
+    return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-impl.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <barrier>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ *
+ * A simulator implementation running partitions of the nodes in parallel
+ * threads of a single process.
+ *
+ * Nodes are partitioned by their system id, as with the distributed
+ * simulator: a node created with `CreateObject<Node> (i)` belongs to
+ * partition \c i.  Each partition has its own event scheduler, clock and
+ * event counters; events without a context run in partition 0.
+ *
+ * The partitions are synchronized conservatively through barrier windows.
+ * The lookahead is the smallest \c Delay attribute of the channels
+ * connecting nodes of different partitions: no event of a partition can
+ * affect another partition sooner than that, so all the events earlier
+ * than the earliest pending event plus the lookahead are run in parallel,
+ * then the events exchanged between partitions are handed over, and the
+ * next window starts.  An event scheduled for another partition within the
+ * lookahead is an error.
+ *
+ * Events for another partition go through a lock-free queue, and are
+ * inserted in the destination partition between windows, sorted by time,
+ * source partition and order of scheduling, so that a run does not depend
+ * on the thread timings.  Packets are handed over with no serialization,
+ * but not without a copy: the channels schedule the reception with a
+ * plain pointer to the receiving device and a deep copy of the packet
+ * made by Packet::CopyUnshared(), since the copy-on-write data of the
+ * packets has plain reference counts and is written in place by the copy
+ * which owns its end, and must thus stay within a partition.
+ * PointToPointChannel and SimpleChannel support this; other channels
+ * must not connect nodes of different partitions.
+ *
+ * Simulator::GetSystemId() returns the partition of the calling thread,
+ * and 0 outside of Run().  Simulator::Stop() ends the run once the other
+ * partitions are done with the current window; Simulator::Stop(delay)
+ * bounds the windows so that every partition stops at the same time.
+ * The identifiers of the events must only be used from the partition
+ * which scheduled them.
+ *
+ * The system ids of the nodes may be changed before Run(), by
+ * PartitionHelper for instance: the events already scheduled with the
+ * context of a node, like its initialization, then move to its new
+ * partition with their identifiers, which remain valid.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * \returns The lookahead of the last run, or the maximum simulation time
+     *          if no channel connects different partitions.
+     */
+    Time GetLookahead() const;
+
+  private:
+    void DoDispose() override;
+
+    /** An event scheduled for another partition. */
+    struct RemoteEvent
+    {
+        /** Absolute event timestamp, or delay if scheduled from outside the partitions. */
+        uint64_t timestamp;
+        /** The event context. */
+        uint32_t context;
+        /** The event implementation. */
+        EventImpl* event;
+        /** Partition which scheduled the event, or NO_PARTITION. */
+        uint32_t source;
+        /** Number of events the source partition sent before this one. */
+        uint64_t sequence;
+    };
+
+    /** The state of a partition. */
+    struct Partition
+    {
+        /**
+         * Constructor.
+         * \param [in] id The partition id.
+         */
+        Partition(uint32_t id);
+
+        /** The partition id, the system id of its nodes. */
+        uint32_t id;
+        /** The event priority queue. */
+        Ptr<Scheduler> events;
+        /** Events scheduled by the other partitions. */
+        MpscQueue<RemoteEvent> inbox;
+        /**
+         * Next event unique id while running.  The partitions draw
+         * interleaved sequences, stepping by the number of partitions.
+         */
+        uint32_t uid;
+        /** Unique id of the current event. */
+        uint32_t currentUid;
+        /** Timestamp of the current event. */
+        uint64_t currentTs;
+        /** Execution context of the current event. */
+        uint32_t currentContext;
+        /** The event count. */
+        uint64_t eventCount;
+        /** Number of events sent to other partitions. */
+        uint64_t sent;
+        /** Number of events inserted but not yet run or removed. */
+        int unscheduledEvents;
+        /** Whether Simulator::Stop() was called from this partition. */
+        bool stop;
+    };
+
+    /** Marks a RemoteEvent scheduled from outside of the partitions. */
+    static constexpr uint32_t NO_PARTITION = 0xffffffff;
+
+    /**
+     * Get the partition running the nodes of a context, creating it if
+     * needed when not running, from the main thread only.
+     * \param [in] context The context.
+     * \returns The partition.
+     */
+    Partition& GetPartition(uint32_t context);
+    /**
+     * Get the partition an event was scheduled in.
+     * \param [in] id The event.
+     * \returns The partition.
+     */
+    Partition& GetPartition(const EventId& id) const;
+    /**
+     * \returns The timestamp of the current event of the calling thread, or
+     *          the simulation time when not running.
+     */
+    uint64_t CurrentTs() const;
+    /**
+     * Create the partitions up to a system id, if needed.
+     * \param [in] systemId The system id.
+     */
+    void CreatePartitions(uint32_t systemId);
+    /**
+     * Record the system ids of the nodes created since the last call.
+     * Only called from the main thread, when not running.
+     */
+    void UpdatePartitions();
+    /**
+     * Record the system ids of all the nodes, and move the pending events
+     * of those whose system id changed to their new partition.
+     * Only called from the main thread, when not running.
+     */
+    void RefreshPartitions();
+    /** \returns The smallest delay of the channels connecting partitions. */
+    Time CalculateLookahead() const;
+    /**
+     * Insert an event in a partition.
+     * \param [in,out] partition The partition.
+     * \param [in] ts The absolute event timestamp.
+     * \param [in] context The event context.
+     * \param [in] event The event.
+     * \returns The event key.
+     */
+    Scheduler::EventKey Insert(Partition& partition,
+                               uint64_t ts,
+                               uint32_t context,
+                               EventImpl* event);
+    /** Move the events sent by other partitions to their schedulers. */
+    void ProcessRemoteEvents();
+    /**
+     * Run the events of a partition until the end of the window.
+     * \param [in,out] partition The partition.
+     */
+    void RunWindow(Partition& partition);
+    /** Run the windows of the partitions picked by the calling thread. */
+    void RunPartitions();
+    /** The loop of the worker threads. */
+    void RunWorker();
+    /** \returns The timestamp of the earliest event, or UINT64_MAX. */
+    uint64_t NextTs() const;
+
+    /** The partitions, by id. */
+    std::vector<std::unique_ptr<Partition>> m_partitions;
+    /** The partition of the nodes, by node id. */
+    std::vector<uint32_t> m_nodePartitions;
+    /** The factory of the per-partition schedulers. */
+    ObjectFactory m_schedulerFactory;
+
+    /** The partition run by the calling thread, if any. */
+    static thread_local Partition* m_current;
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Protects m_destroyEvents and m_stopTimes. */
+    mutable std::mutex m_mutex;
+    /** The times of the pending Simulator::Stop(delay) calls. */
+    std::vector<uint64_t> m_stopTimes;
+
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+    /** Whether Run() is in progress. */
+    bool m_running;
+    /** Simulation time when not running, start of the window when running. */
+    uint64_t m_currentTs;
+    /** End of the current window, excluded. */
+    uint64_t m_windowEnd;
+    /** The lookahead, in time steps. */
+    uint64_t m_lookahead;
+    /** Order of the events scheduled from threads outside of the partitions. */
+    std::atomic<uint64_t> m_foreignSequence;
+    /** Next event unique id when not running, above those used by the partitions. */
+    uint32_t m_uid;
+    /**
+     * Events scheduled from threads outside of the partitions, handed over
+     * to their partition by the main thread, which alone reads the node list.
+     */
+    MpscQueue<RemoteEvent> m_foreignEvents;
+    /** The thread which created the simulator, or last called Run(). */
+    std::thread::id m_mainThreadId;
+
+    /** Maximum number of threads. */
+    uint32_t m_maxThreads;
+    /** The worker threads, besides the one calling Run(). */
+    std::vector<std::thread> m_workers;
+    /** Synchronizes the start and the end of the windows. */
+    std::unique_ptr<std::barrier<>> m_barrier;
+    /** Next partition to run in the current window. */
+    std::atomic<uint32_t> m_nextPartition;
+    /** Set to end the worker threads. */
+    bool m_done;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
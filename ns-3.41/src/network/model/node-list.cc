@@ -181,6 +181,7 @@ NodeListPriv::Add(Ptr<Node> node)
     NS_LOG_FUNCTION(this << node);
     uint32_t index = m_nodes.size();
     m_nodes.push_back(node);
+    Config::InvalidateMatches();
     Simulator::ScheduleWithContext(index, TimeStep(0), &Node::Initialize, node);
     return index;
 }
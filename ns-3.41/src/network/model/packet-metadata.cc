@@ -37,9 +37,10 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local bool PacketMetadata::m_freeListDestroyed = false;
 
 PacketMetadata::DataFreeList::~DataFreeList()
 {
@@ -48,7 +49,7 @@ PacketMetadata::DataFreeList::~DataFreeList()
     {
         PacketMetadata::Deallocate(*i);
     }
-    PacketMetadata::m_enable = false;
+    PacketMetadata::m_freeListDestroyed = true;
 }
 
 void
@@ -80,8 +81,7 @@ PacketMetadata::ReserveCopy(uint32_t size)
     PacketMetadata::Data* newData = PacketMetadata::Create(m_used + size);
     memcpy(newData->m_data, m_data->m_data, m_used);
     newData->m_dirtyEnd = m_used;
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
@@ -572,6 +572,10 @@ PacketMetadata::Create(uint32_t size)
     {
         m_maxSize = size;
     }
+    if (m_freeListDestroyed)
+    {
+        return PacketMetadata::Allocate(m_maxSize);
+    }
     while (!m_freeList.empty())
     {
         PacketMetadata::Data* data = m_freeList.back();
@@ -593,7 +597,7 @@ void
 PacketMetadata::Recycle(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
-    if (!m_enable)
+    if (!m_enable || m_freeListDestroyed)
     {
         PacketMetadata::Deallocate(data);
         return;
@@ -936,6 +940,16 @@ PacketMetadata::RemoveAtStart(uint32_t start)
     NS_ASSERT(IsStateOk());
 }
 
+void
+PacketMetadata::Unshare()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_data->m_count > 1)
+    {
+        ReserveCopy(0);
+    }
+}
+
 void
 PacketMetadata::RemoveAtEnd(uint32_t end)
 {
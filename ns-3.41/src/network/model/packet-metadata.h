@@ -250,6 +250,12 @@ class PacketMetadata
      * \param end the size of metadata to remove
      */
     void RemoveAtEnd(uint32_t end);
+    /**
+     * \brief Give this metadata a copy of the data it shares with other
+     * metadata, if any, so that it can be used by another thread than
+     * theirs: the reference counts of the data are not atomic.
+     */
+    void Unshare();
 
     /**
      * \brief Get the packet Uid
@@ -675,7 +681,9 @@ class PacketMetadata
      */
     static void Deallocate(PacketMetadata::Data* data);
 
-    static DataFreeList m_freeList; //!< the metadata data storage
+    static thread_local DataFreeList m_freeList; //!< the metadata data storage, per thread
+    /** Set when the free list of the calling thread has been destroyed */
+    static thread_local bool m_freeListDestroyed;
     static bool m_enable;           //!< Enable the packet metadata
     static bool m_enableChecking;   //!< Enable the packet metadata checking
 
@@ -686,7 +694,7 @@ class PacketMetadata
      */
     static bool m_metadataSkipped;
 
-    static uint32_t m_maxSize;  //!< maximum metadata size
+    static thread_local uint32_t m_maxSize; //!< maximum metadata size, per thread
     static uint16_t m_chunkUid; //!< Chunk Uid
 
     Data* m_data; //!< Metadata storage
@@ -739,8 +747,7 @@ PacketMetadata::operator=(const PacketMetadata& o)
     {
         // not self assignment
         NS_ASSERT(m_data != nullptr);
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             PacketMetadata::Recycle(m_data);
         }
@@ -758,8 +765,7 @@ PacketMetadata::operator=(const PacketMetadata& o)
 PacketMetadata::~PacketMetadata()
 {
     NS_ASSERT(m_data != nullptr);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
@@ -74,7 +74,7 @@ PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
     // Search from the head of the list until we find tid or a merge
     while (cur != nullptr)
     {
-        if (cur->count > 1)
+        if (cur->count.load(std::memory_order_acquire) > 1)
         {
             // found merge
             NS_LOG_INFO("found initial merge before tid");
@@ -150,14 +150,14 @@ PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
     {
         NS_ASSERT(cur != nullptr);
         NS_ASSERT(cur->count > 1);
-        cur->count--; // unmerge cur
+        cur->count.fetch_sub(1, std::memory_order_acq_rel); // unmerge cur
         TagData* copy = CreateTagData(cur->size);
         copy->tid = cur->tid;
-        copy->count = 1;
+        copy->count.store(1, std::memory_order_relaxed);
         copy->size = cur->size;
         memcpy(copy->data, cur->data, copy->size);
         copy->next = cur->next; // merge into tail
-        copy->next->count++;    // mark new merge
+        copy->next->count.fetch_add(1, std::memory_order_relaxed); // mark new merge
         *prevNext = copy;       // point prior list at copy
         prevNext = &copy->next; // advance
         cur = copy->next;
@@ -202,11 +202,11 @@ PacketTagList::RemoveWriter(Tag& tag,
     {
         // cur is always a merge at this point
         // unmerge cur, since we linked around it already
-        cur->count--;
+        cur->count.fetch_sub(1, std::memory_order_acq_rel);
         if (cur->next != nullptr)
         {
             // there's a next, so make it a merge
-            cur->next->count++;
+            cur->next->count.fetch_add(1, std::memory_order_relaxed);
         }
     }
     return found;
@@ -243,15 +243,15 @@ PacketTagList::ReplaceWriter(Tag& tag,
     {
         // cur is always a merge at this point
         // need to copy, replace, and link past cur
-        cur->count--; // unmerge cur
+        cur->count.fetch_sub(1, std::memory_order_acq_rel); // unmerge cur
         TagData* copy = CreateTagData(tag.GetSerializedSize());
         copy->tid = tag.GetInstanceTypeId();
-        copy->count = 1;
+        copy->count.store(1, std::memory_order_relaxed);
         tag.Serialize(TagBuffer(copy->data, copy->data + copy->size));
         copy->next = cur->next; // merge into tail
         if (copy->next != nullptr)
         {
-            copy->next->count++; // mark new merge
+            copy->next->count.fetch_add(1, std::memory_order_relaxed); // mark new merge
         }
         *prevNext = copy; // point prior list at copy
     }
@@ -270,7 +270,7 @@ PacketTagList::Add(const Tag& tag) const
                           << tag.GetInstanceTypeId().GetName());
     }
     TagData* head = CreateTagData(tag.GetSerializedSize());
-    head->count = 1;
+    head->count.store(1, std::memory_order_relaxed);
     head->next = nullptr;
     head->tid = tag.GetInstanceTypeId();
     head->next = m_next;
@@ -423,7 +423,7 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
         NS_LOG_INFO("Deserializing tag of type " << tid);
 
         TagData* newTag = CreateTagData(tagSize);
-        newTag->count = 1;
+        newTag->count.store(1, std::memory_order_relaxed);
         newTag->next = nullptr;
         newTag->tid = tid;
 
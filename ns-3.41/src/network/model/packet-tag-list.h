@@ -26,6 +26,7 @@
 
 #include "ns3/type-id.h"
 
+#include <atomic>
 #include <ostream>
 #include <stdint.h>
 
@@ -141,11 +142,11 @@ class PacketTagList
      */
     struct TagData
     {
-        TagData* next;   //!< Pointer to next in list
-        uint32_t count;  //!< Number of incoming links
-        TypeId tid;      //!< Type of the tag serialized into #data
-        uint32_t size;   //!< Size of the \c data buffer
-        uint8_t data[1]; //!< Serialization buffer
+        TagData* next;               //!< Pointer to next in list
+        std::atomic<uint32_t> count; //!< Number of incoming links, from any thread
+        TypeId tid;                  //!< Type of the tag serialized into #data
+        uint32_t size;               //!< Size of the \c data buffer
+        uint8_t data[1];             //!< Serialization buffer
     };
 
     /**
@@ -326,7 +327,7 @@ PacketTagList::PacketTagList(const PacketTagList& o)
 {
     if (m_next != nullptr)
     {
-        m_next->count++;
+        m_next->count.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
@@ -342,7 +343,7 @@ PacketTagList::operator=(const PacketTagList& o)
     m_next = o.m_next;
     if (m_next != nullptr)
     {
-        m_next->count++;
+        m_next->count.fetch_add(1, std::memory_order_relaxed);
     }
     return *this;
 }
@@ -358,8 +359,7 @@ PacketTagList::RemoveAll()
     TagData* prev = nullptr;
     for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
-        cur->count--;
-        if (cur->count > 0)
+        if (cur->count.fetch_sub(1, std::memory_order_acq_rel) > 1)
         {
             break;
         }
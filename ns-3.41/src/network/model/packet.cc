@@ -23,6 +23,8 @@
 #include "ns3/simulator.h"
 
 #include <cstdarg>
+#include <deque>
+#include <mutex>
 #include <string>
 
 namespace ns3
@@ -30,7 +32,15 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+namespace
+{
+
+/// Protects the growth of g_packetUids
+std::mutex g_packetUidsMutex;
+/// Number of packets created, by system id
+std::deque<uint32_t> g_packetUids;
+
+} // namespace
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -136,20 +146,47 @@ Packet::Copy() const
     return Ptr<Packet>(new Packet(*this), false);
 }
 
+Ptr<Packet>
+Packet::CopyUnshared() const
+{
+    NS_LOG_FUNCTION(this);
+    Ptr<Packet> copy = Copy();
+    copy->m_buffer.Unshare();
+    copy->m_byteTagList.Unshare();
+    copy->m_metadata.Unshare();
+    return copy;
+}
+
+uint64_t
+Packet::AllocateUid()
+{
+    // The counter of the system id of the calling thread, which only
+    // changes when a thread of the multithreaded simulator picks another
+    // partition, is cached so that the lock is not taken for every packet
+    thread_local uint32_t* counter = nullptr;
+    thread_local uint32_t counterSystemId = 0;
+    uint32_t systemId = Simulator::GetSystemId();
+    if (counter == nullptr || counterSystemId != systemId)
+    {
+        std::unique_lock lock{g_packetUidsMutex};
+        if (g_packetUids.size() <= systemId)
+        {
+            // Growing a deque at its end keeps the other counters in place
+            g_packetUids.resize(systemId + 1, 0);
+        }
+        counter = &g_packetUids[systemId];
+        counterSystemId = systemId;
+    }
+    return static_cast<uint64_t>(systemId) << 32 | (*counter)++;
+}
+
 Packet::Packet()
     : m_buffer(),
       m_byteTagList(),
       m_packetTagList(),
-      /* The upper 32 bits of the packet id in
-       * metadata is for the system id. For non-
-       * distributed simulations, this is simply
-       * zero.  The lower 32 bits are for the
-       * global UID
-       */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(AllocateUid(), 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
@@ -180,16 +217,9 @@ Packet::Packet(uint32_t size)
     : m_buffer(size),
       m_byteTagList(),
       m_packetTagList(),
-      /* The upper 32 bits of the packet id in
-       * metadata is for the system id. For non-
-       * distributed simulations, this is simply
-       * zero.  The lower 32 bits are for the
-       * global UID
-       */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(AllocateUid(), size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -207,16 +237,9 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
     : m_buffer(),
       m_byteTagList(),
       m_packetTagList(),
-      /* The upper 32 bits of the packet id in
-       * metadata is for the system id. For non-
-       * distributed simulations, this is simply
-       * zero.  The lower 32 bits are for the
-       * global UID
-       */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(AllocateUid(), size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -459,6 +459,20 @@ class Packet : public SimpleRefCount<Packet>
      */
     Ptr<Packet> Copy() const;
 
+    /**
+     * \brief performs a copy of the packet which shares no data
+     * with the original packet, except its immutable packet tags.
+     *
+     * \returns the copy of the packet.
+     *
+     * Unlike a COW copy, the returned packet may be copied, modified
+     * and released by another thread than the one owning the original
+     * packet, as when it is handed over to another partition of the
+     * multithreaded simulator.  Only the packet tags, which are never
+     * modified in place, remain shared, with atomic reference counts.
+     */
+    Ptr<Packet> CopyUnshared() const;
+
     /**
      * \brief Returns the packet's Uid.
      *
@@ -795,7 +809,15 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-    static uint32_t m_globalUid; //!< Global counter of packets Uid
+    /**
+     * Allocate the uid of a new packet.  The upper 32 bits are the system
+     * id, which is simply zero for non-distributed simulations, the lower
+     * 32 bits count the packets created in that system.  Each partition of
+     * the multithreaded simulator thus counts its own packets, so that the
+     * uids do not depend on the thread timings.
+     * \returns The uid.
+     */
+    static uint64_t AllocateUid();
 };
 
 /**
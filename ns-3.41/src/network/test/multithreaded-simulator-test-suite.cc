@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Compare the packets received on a ring of nodes spread over
+ * partitions with those of the default simulator implementation.
+ *
+ * Every node sends packets to its two neighbours, which forward them
+ * around the ring, one byte longer at each hop, for a few hops.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param stop Whether to stop the simulation before the packets are done.
+     */
+    MultithreadedSimulatorTestCase(bool stop);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * A packet reception: time, node, packet size, partition running the
+     * node, packet uid.
+     */
+    typedef std::tuple<int64_t, uint32_t, uint32_t, uint32_t, uint64_t> Reception;
+
+    /** Result of a run. */
+    struct Result
+    {
+        std::vector<std::vector<Reception>> receptions; //!< Receptions by node
+        uint64_t eventCount;                            //!< Simulator::GetEventCount()
+        Time end;                                       //!< Simulator::Now() at the end
+        Time lookahead;                                 //!< Lookahead, if multithreaded
+    };
+
+    /**
+     * Run the simulation.
+     * \param type The simulator implementation type.
+     * \param maxThreads The maximum number of threads, if multithreaded.
+     * \returns The result.
+     */
+    Result RunOnce(std::string type, uint32_t maxThreads);
+    /**
+     * Send a packet from a node on its two devices.
+     * \param node The node.
+     * \param size The packet size.
+     */
+    void Send(Ptr<Node> node, uint32_t size);
+    /**
+     * Receive a packet, and forward it.
+     * \param device The receiving device.
+     * \param packet The packet.
+     * \param protocol The protocol.
+     * \param from The sender.
+     * \returns \c true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    /** Number of nodes on the ring. */
+    static constexpr uint32_t N_NODES = 8;
+    /** Number of partitions. */
+    static constexpr uint32_t N_PARTITIONS = 4;
+    /** Size of the packets when sent. */
+    static constexpr uint32_t SIZE = 100;
+    /** Number of hops after which packets are dropped. */
+    static constexpr uint32_t HOPS = 4;
+    /** Time to stop at, if stopping early, distinct from that of any event. */
+    const Time STOP = NanoSeconds(4100003);
+
+    bool m_stop;                                    //!< Whether to stop early
+    std::vector<std::vector<Reception>> m_received; //!< Receptions by node
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase(bool stop)
+    : TestCase(stop ? "Check stopping the partitions in parallel"
+                    : "Check the partitions run in parallel as they run in sequence"),
+      m_stop(stop)
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Send(Ptr<Node> node, uint32_t size)
+{
+    for (uint32_t i = 0; i < node->GetNDevices(); i++)
+    {
+        Ptr<NetDevice> device = node->GetDevice(i);
+        device->Send(Create<Packet>(size), device->GetBroadcast(), 0x800);
+    }
+}
+
+bool
+MultithreadedSimulatorTestCase::Receive(Ptr<NetDevice> device,
+                                        Ptr<const Packet> packet,
+                                        uint16_t protocol,
+                                        const Address& from)
+{
+    Ptr<Node> node = device->GetNode();
+    m_received[node->GetId()].emplace_back(Simulator::Now().GetTimeStep(),
+                                           node->GetId(),
+                                           packet->GetSize(),
+                                           Simulator::GetSystemId(),
+                                           packet->GetUid());
+    if (packet->GetSize() < SIZE + HOPS)
+    {
+        // Forward the packet itself on the other device, a byte longer
+        Ptr<NetDevice> next = node->GetDevice(node->GetDevice(0) == device ? 1 : 0);
+        Ptr<Packet> copy = packet->Copy();
+        copy->AddPaddingAtEnd(1);
+        next->Send(copy, next->GetBroadcast(), protocol);
+    }
+    return true;
+}
+
+MultithreadedSimulatorTestCase::Result
+MultithreadedSimulatorTestCase::RunOnce(std::string type, uint32_t maxThreads)
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(type));
+    if (type == "ns3::MultithreadedSimulatorImpl")
+    {
+        Simulator::GetImplementation()->SetAttribute("MaxThreads", UintegerValue(maxThreads));
+    }
+    m_received.assign(N_NODES, {});
+
+    NodeContainer nodes;
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        nodes.Add(CreateObject<Node>(i % N_PARTITIONS));
+    }
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        // Links of different delays, the shortest one of 1 ms
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        channel->SetAttribute("Delay", TimeValue(MicroSeconds(1000 + 250 * (i % 3))));
+        for (auto node : {nodes.Get(i), nodes.Get((i + 1) % N_NODES)})
+        {
+            Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+            device->SetAddress(Mac48Address::Allocate());
+            device->SetAttribute("DataRate", DataRateValue(DataRate("10Mbps")));
+            node->AddDevice(device);
+            device->SetChannel(channel);
+            device->SetReceiveCallback(MakeCallback(&MultithreadedSimulatorTestCase::Receive, this));
+        }
+    }
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        for (uint32_t k = 0; k < 20; k++)
+        {
+            Simulator::ScheduleWithContext(i,
+                                           MicroSeconds(300 * k + 70 * i),
+                                           &MultithreadedSimulatorTestCase::Send,
+                                           this,
+                                           nodes.Get(i),
+                                           SIZE);
+        }
+    }
+    if (m_stop)
+    {
+        Simulator::Stop(STOP);
+    }
+
+    Simulator::Run();
+
+    // The packets of each system id are counted since the start of the
+    // program: count them from the first one received instead
+    std::map<uint64_t, uint64_t> firstUids;
+    for (const auto& receptions : m_received)
+    {
+        for (const auto& reception : receptions)
+        {
+            uint64_t uid = std::get<4>(reception);
+            auto [first, inserted] = firstUids.emplace(uid >> 32, uid);
+            first->second = std::min(first->second, uid);
+        }
+    }
+    for (auto& receptions : m_received)
+    {
+        for (auto& reception : receptions)
+        {
+            std::get<4>(reception) -= firstUids[std::get<4>(reception) >> 32];
+        }
+    }
+
+    Result result;
+    result.receptions = m_received;
+    result.eventCount = Simulator::GetEventCount();
+    result.end = Simulator::Now();
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    result.lookahead = impl ? impl->GetLookahead() : Time(0);
+    Simulator::Destroy();
+    return result;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun()
+{
+    Result reference = RunOnce("ns3::DefaultSimulatorImpl", 0);
+    Result sequential = RunOnce("ns3::MultithreadedSimulatorImpl", 1);
+    Result parallel = RunOnce("ns3::MultithreadedSimulatorImpl", N_PARTITIONS);
+
+    NS_TEST_EXPECT_MSG_EQ(sequential.lookahead, MilliSeconds(1), "Wrong lookahead");
+    if (m_stop)
+    {
+        NS_TEST_EXPECT_MSG_EQ(reference.end, STOP, "Did not stop");
+        NS_TEST_EXPECT_MSG_EQ(parallel.end, STOP, "Did not stop");
+    }
+
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        // The two multithreaded runs are identical, receptions and packet
+        // uids included
+        NS_TEST_EXPECT_MSG_EQ((parallel.receptions[i] == sequential.receptions[i]),
+                              true,
+                              "Run depends on the number of threads at node " << i);
+        for (const auto& reception : parallel.receptions[i])
+        {
+            NS_TEST_EXPECT_MSG_EQ(std::get<3>(reception),
+                                  i % N_PARTITIONS,
+                                  "Node " << i << " run by the wrong partition");
+        }
+
+        // Simultaneous receptions may come in another order than with the
+        // default implementation, the receptions themselves are the same
+        auto& expected = reference.receptions[i];
+        auto& received = parallel.receptions[i];
+        NS_TEST_EXPECT_MSG_EQ(received.size(), expected.size(), "Receptions lost at node " << i);
+        std::sort(expected.begin(), expected.end());
+        std::sort(received.begin(), received.end());
+        for (std::size_t j = 0; j < std::min(received.size(), expected.size()); j++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(std::get<0>(received[j]),
+                                  std::get<0>(expected[j]),
+                                  "Wrong reception time at node " << i);
+            NS_TEST_EXPECT_MSG_EQ(std::get<2>(received[j]),
+                                  std::get<2>(expected[j]),
+                                  "Wrong packet size at node " << i);
+        }
+    }
+    NS_TEST_EXPECT_MSG_GT(parallel.receptions[0].size(), 0, "Nothing received");
+    NS_TEST_EXPECT_MSG_EQ(parallel.eventCount, reference.eventCount, "Wrong number of events");
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief MultithreadedSimulatorImpl TestSuite
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+  public:
+    MultithreadedSimulatorTestSuite()
+        : TestSuite("multithreaded-simulator", UNIT)
+    {
+        AddTestCase(new MultithreadedSimulatorTestCase(false), TestCase::QUICK);
+        AddTestCase(new MultithreadedSimulatorTestCase(true), TestCase::QUICK);
+    }
+};
+
+static MultithreadedSimulatorTestSuite
+    g_multithreadedSimulatorTestSuite; //!< Static variable for test initialization
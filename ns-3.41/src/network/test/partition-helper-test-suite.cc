@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/partition-helper.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the partitions computed by PartitionHelper.
+ */
+class PartitionHelperTestCase : public TestCase
+{
+  public:
+    PartitionHelperTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Connect two nodes with a SimpleChannel.
+     * \param a One node.
+     * \param b The other node.
+     * \param delay The channel delay.
+     */
+    void Link(Ptr<Node> a, Ptr<Node> b, Time delay);
+    /**
+     * Check the partitions are balanced, and match the system ids.
+     * \param nodes The nodes.
+     * \param partitions The partitions returned by the helper.
+     * \param nPartitions The number of partitions.
+     * \param maxSize The maximum number of nodes per partition.
+     */
+    void CheckPartitions(const NodeContainer& nodes,
+                         const std::vector<uint32_t>& partitions,
+                         uint32_t nPartitions,
+                         uint32_t maxSize);
+
+    /** Two cliques joined by a single link. */
+    void TestCliques();
+    /** A ring with two long links. */
+    void TestRing();
+    /** A square grid. */
+    void TestGrid();
+    /** Links added before the channels exist. */
+    void TestAddedLinks();
+    /** Run partitioned nodes with the multithreaded simulator. */
+    void TestMultithreaded();
+
+    /**
+     * Record the partition which runs a node.
+     * \param device The receiving device.
+     * \param packet The packet.
+     * \param protocol The protocol.
+     * \param from The sender.
+     * \returns \c true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    uint32_t m_received;  //!< Number of packets received
+    uint32_t m_misplaced; //!< Packets received by a node outside of its partition
+    uint32_t m_expired;   //!< Number of cancelled or removed events run
+};
+
+PartitionHelperTestCase::PartitionHelperTestCase()
+    : TestCase("Check the partitions of PartitionHelper"),
+      m_received(0),
+      m_misplaced(0),
+      m_expired(0)
+{
+}
+
+void
+PartitionHelperTestCase::Link(Ptr<Node> a, Ptr<Node> b, Time delay)
+{
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    channel->SetAttribute("Delay", TimeValue(delay));
+    for (auto node : {a, b})
+    {
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(device);
+        device->SetChannel(channel);
+        device->SetReceiveCallback(MakeCallback(&PartitionHelperTestCase::Receive, this));
+    }
+}
+
+bool
+PartitionHelperTestCase::Receive(Ptr<NetDevice> device,
+                                 Ptr<const Packet> packet,
+                                 uint16_t protocol,
+                                 const Address& from)
+{
+    m_received++;
+    if (Simulator::GetSystemId() != device->GetNode()->GetSystemId())
+    {
+        m_misplaced++;
+    }
+    return true;
+}
+
+void
+PartitionHelperTestCase::CheckPartitions(const NodeContainer& nodes,
+                                         const std::vector<uint32_t>& partitions,
+                                         uint32_t nPartitions,
+                                         uint32_t maxSize)
+{
+    NS_TEST_ASSERT_MSG_EQ(partitions.size(), nodes.GetN(), "One partition per node");
+    std::vector<uint32_t> sizes(nPartitions, 0);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        NS_TEST_ASSERT_MSG_LT(partitions[i], nPartitions, "Partition out of range");
+        NS_TEST_EXPECT_MSG_EQ(nodes.Get(i)->GetSystemId(),
+                              partitions[i],
+                              "System id of node " << i << " not set");
+        sizes[partitions[i]]++;
+    }
+    for (uint32_t p = 0; p < nPartitions; p++)
+    {
+        NS_TEST_EXPECT_MSG_GT(sizes[p], 0, "Partition " << p << " empty");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(sizes[p], maxSize, "Partition " << p << " too large");
+    }
+}
+
+void
+PartitionHelperTestCase::TestCliques()
+{
+    NodeContainer nodes;
+    nodes.Create(12);
+    for (uint32_t c = 0; c < 2; c++)
+    {
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            for (uint32_t j = i + 1; j < 6; j++)
+            {
+                Link(nodes.Get(6 * c + i), nodes.Get(6 * c + j), MilliSeconds(1));
+            }
+        }
+    }
+    Link(nodes.Get(2), nodes.Get(9), MilliSeconds(1));
+
+    PartitionHelper helper;
+    auto partitions = helper.Assign(nodes, 2);
+    CheckPartitions(nodes, partitions, 2, 6);
+    NS_TEST_EXPECT_MSG_EQ(helper.GetCutLinks(), 1, "Only the bridge should be cut");
+    NS_TEST_EXPECT_MSG_EQ(helper.GetLookahead(), MilliSeconds(1), "Wrong lookahead");
+}
+
+void
+PartitionHelperTestCase::TestRing()
+{
+    NodeContainer nodes;
+    nodes.Create(12);
+    for (uint32_t i = 0; i < 12; i++)
+    {
+        bool longLink = i == 1 || i == 7;
+        Link(nodes.Get(i), nodes.Get((i + 1) % 12), MilliSeconds(longLink ? 10 : 1));
+    }
+
+    PartitionHelper helper;
+    auto partitions = helper.Assign(nodes, 2);
+    CheckPartitions(nodes, partitions, 2, 6);
+    NS_TEST_EXPECT_MSG_EQ(helper.GetCutLinks(), 2, "Two links should be cut");
+    NS_TEST_EXPECT_MSG_EQ(helper.GetLookahead(), MilliSeconds(10), "Short link cut");
+
+    // A heavier node between the long links forces a shorter one to be cut
+    helper.SetNodeWeight(nodes.Get(4), 3);
+    partitions = helper.Assign(nodes, 2);
+    CheckPartitions(nodes, partitions, 2, 7);
+    uint32_t heavy = std::count(partitions.begin(), partitions.end(), partitions[4]) + 2;
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(heavy, 7, "Weight of the node ignored");
+    NS_TEST_EXPECT_MSG_EQ(helper.GetLookahead(),
+                          MilliSeconds(1),
+                          "Lookahead should be that of the short links");
+}
+
+void
+PartitionHelperTestCase::TestGrid()
+{
+    const uint32_t SIDE = 10;
+    NodeContainer nodes;
+    nodes.Create(SIDE * SIDE);
+    for (uint32_t i = 0; i < SIDE; i++)
+    {
+        for (uint32_t j = 0; j < SIDE; j++)
+        {
+            if (j + 1 < SIDE)
+            {
+                Link(nodes.Get(SIDE * i + j), nodes.Get(SIDE * i + j + 1), MilliSeconds(2));
+            }
+            if (i + 1 < SIDE)
+            {
+                Link(nodes.Get(SIDE * i + j), nodes.Get(SIDE * (i + 1) + j), MilliSeconds(2));
+            }
+        }
+    }
+
+    PartitionHelper helper;
+    auto partitions = helper.Assign(nodes, 4);
+    CheckPartitions(nodes, partitions, 4, 26);
+    // Quadrants cut 20 links, a partition in strips cuts 30
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(helper.GetCutLinks(), 30, "Cut too large");
+    NS_TEST_EXPECT_MSG_EQ(helper.GetCutWeight(), helper.GetCutLinks(), "Default link weight");
+    NS_TEST_EXPECT_MSG_EQ(helper.GetLookahead(), MilliSeconds(2), "Wrong lookahead");
+}
+
+void
+PartitionHelperTestCase::TestAddedLinks()
+{
+    NodeContainer nodes;
+    nodes.Create(8);
+    PartitionHelper helper;
+    for (uint32_t i = 0; i + 1 < 8; i++)
+    {
+        helper.AddLink(nodes.Get(i), nodes.Get(i + 1), MilliSeconds(5), i == 3 ? 1 : 10);
+    }
+    auto partitions = helper.Assign(nodes, 2);
+    CheckPartitions(nodes, partitions, 2, 4);
+    NS_TEST_EXPECT_MSG_EQ((partitions[3] != partitions[4]), true, "Lightest link not cut");
+    NS_TEST_EXPECT_MSG_EQ(helper.GetCutWeight(), 1, "Wrong cut weight");
+}
+
+void
+PartitionHelperTestCase::TestMultithreaded()
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    NodeContainer nodes;
+    nodes.Create(8);
+    // Let a node schedule events of its own, then stop before they
+    // and the packets sent below run
+    EventId cancelled;
+    EventId removed;
+    Simulator::ScheduleWithContext(5, Seconds(0), [this, &cancelled, &removed]() {
+        cancelled = Simulator::Schedule(MilliSeconds(2), [this]() { m_expired++; });
+        removed = Simulator::Schedule(MilliSeconds(2), [this]() { m_expired++; });
+        Simulator::Stop();
+    });
+    m_expired = 0;
+    Simulator::Run();
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        Link(nodes.Get(i), nodes.Get((i + 1) % 8), MilliSeconds(1));
+        Ptr<NetDevice> device = nodes.Get(i)->GetDevice(0);
+        Simulator::ScheduleWithContext(i,
+                                       MilliSeconds(i),
+                                       &NetDevice::Send,
+                                       device,
+                                       Create<Packet>(100),
+                                       device->GetBroadcast(),
+                                       0x800);
+    }
+
+    // The nodes were created in partition 0, their events must follow them
+    PartitionHelper helper;
+    auto partitions = helper.Assign(nodes, 4);
+    CheckPartitions(nodes, partitions, 4, 2);
+    NS_TEST_EXPECT_MSG_NE(nodes.Get(5)->GetSystemId(), 0, "Node 5 did not move");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::IsExpired(removed), false, "Moved event expired");
+    Simulator::Cancel(cancelled);
+    Simulator::Remove(removed);
+
+    m_received = 0;
+    m_misplaced = 0;
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_expired, 0, "Cancelled or removed event run");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::IsExpired(cancelled), true, "Cancelled event not expired");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::IsExpired(removed), true, "Removed event not expired");
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLookahead(), helper.GetLookahead(), "Wrong lookahead");
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, 8, "Packets lost");
+    NS_TEST_EXPECT_MSG_EQ(m_misplaced, 0, "Nodes run outside of their partition");
+}
+
+void
+PartitionHelperTestCase::DoRun()
+{
+    TestCliques();
+    TestRing();
+    TestGrid();
+    TestAddedLinks();
+    Simulator::Destroy();
+    TestMultithreaded();
+}
+
+void
+PartitionHelperTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PartitionHelper TestSuite
+ */
+class PartitionHelperTestSuite : public TestSuite
+{
+  public:
+    PartitionHelperTestSuite()
+        : TestSuite("partition-helper", UNIT)
+    {
+        AddTestCase(new PartitionHelperTestCase(), TestCase::QUICK);
+    }
+};
+
+static PartitionHelperTestSuite
+    g_partitionHelperTestSuite; //!< Static variable for test initialization
@@ -62,9 +62,13 @@ SimpleChannel::Send(Ptr<Packet> p,
                     Ptr<SimpleNetDevice> sender)
 {
     NS_LOG_FUNCTION(this << p << protocol << to << from << sender);
-    for (auto i = m_devices.begin(); i != m_devices.end(); ++i)
+    // The receivers may run on other threads (see MultithreadedSimulatorImpl):
+    // hand the packet copies over without touching the reference counts of
+    // the receiving devices and nodes, and with data of their own.
+    uint32_t systemId = Simulator::GetSystemId();
+    for (std::size_t i = 0; i < m_devices.size(); ++i)
     {
-        Ptr<SimpleNetDevice> tmp = *i;
+        const Ptr<SimpleNetDevice>& tmp = m_devices[i];
         if (tmp == sender)
         {
             continue;
@@ -77,11 +81,17 @@ SimpleChannel::Send(Ptr<Packet> p,
                 continue;
             }
         }
-        Simulator::ScheduleWithContext(tmp->GetNode()->GetId(),
+        Node* node = m_nodes[i];
+        if (node == nullptr)
+        {
+            node = PeekPointer(tmp->GetNode());
+        }
+        Simulator::ScheduleWithContext(node->GetId(),
                                        m_delay,
                                        &SimpleNetDevice::Receive,
-                                       tmp,
-                                       p->Copy(),
+                                       PeekPointer(tmp),
+                                       node->GetSystemId() == systemId ? p->Copy()
+                                                                       : p->CopyUnshared(),
                                        protocol,
                                        to,
                                        from);
@@ -93,6 +103,7 @@ SimpleChannel::Add(Ptr<SimpleNetDevice> device)
 {
     NS_LOG_FUNCTION(this << device);
     m_devices.push_back(device);
+    m_nodes.push_back(PeekPointer(device->GetNode()));
 }
 
 std::size_t
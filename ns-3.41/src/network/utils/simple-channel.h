@@ -32,6 +32,7 @@ namespace ns3
 
 class SimpleNetDevice;
 class Packet;
+class Node;
 
 /**
  * \ingroup channel
@@ -105,6 +106,8 @@ class SimpleChannel : public Channel
   private:
     Time m_delay; //!< The assigned speed-of-light delay of the channel
     std::vector<Ptr<SimpleNetDevice>> m_devices; //!< devices connected by the channel
+    /// Nodes of m_devices as plain pointers, or nullptr if unknown when added
+    std::vector<Node*> m_nodes;
     std::map<Ptr<SimpleNetDevice>, std::vector<Ptr<SimpleNetDevice>>>
         m_blackListedDevices; //!< devices blocked on a device
 };
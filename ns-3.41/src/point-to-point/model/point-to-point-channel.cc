@@ -20,6 +20,7 @@
 #include "point-to-point-net-device.h"
 
 #include "ns3/log.h"
+#include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
@@ -80,6 +81,10 @@ PointToPointChannel::Attach(Ptr<PointToPointNetDevice> device)
     {
         m_link[0].m_dst = m_link[1].m_src;
         m_link[1].m_dst = m_link[0].m_src;
+        for (auto& link : m_link)
+        {
+            link.m_dstNode = PeekPointer(link.m_dst->GetNode());
+        }
         m_link[0].m_state = IDLE;
         m_link[1].m_state = IDLE;
     }
@@ -96,14 +101,27 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
-    Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
+    // The receiver may run on another thread (see MultithreadedSimulatorImpl):
+    // hand the packet copy over without touching the reference counts of the
+    // receiving device and node, and with data of its own.
+    Node* node = m_link[wire].m_dstNode;
+    if (node == nullptr)
+    {
+        node = PeekPointer(m_link[wire].m_dst->GetNode());
+    }
+    Ptr<Packet> copy =
+        node->GetSystemId() == Simulator::GetSystemId() ? p->Copy() : p->CopyUnshared();
+    Simulator::ScheduleWithContext(node->GetId(),
                                    txTime + m_delay,
                                    &PointToPointNetDevice::Receive,
-                                   m_link[wire].m_dst,
-                                   p->Copy());
+                                   PeekPointer(m_link[wire].m_dst),
+                                   copy);
 
     // Call the tx anim callback on the net device
-    m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+    if (!m_txrxPointToPoint.IsEmpty())
+    {
+        m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+    }
     return true;
 }
 
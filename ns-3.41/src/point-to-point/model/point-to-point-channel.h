@@ -31,6 +31,7 @@ namespace ns3
 
 class PointToPointNetDevice;
 class Packet;
+class Node;
 
 /**
  * \ingroup point-to-point
@@ -200,13 +201,20 @@ class PointToPointChannel : public Channel
         Link()
             : m_state(INITIALIZING),
               m_src(nullptr),
-              m_dst(nullptr)
+              m_dst(nullptr),
+              m_dstNode(nullptr)
         {
         }
 
         WireState m_state;                //!< State of the link
         Ptr<PointToPointNetDevice> m_src; //!< First NetDevice
         Ptr<PointToPointNetDevice> m_dst; //!< Second NetDevice
+        /**
+         * Node of m_dst, cached as a plain pointer so that transmitting does
+         * not touch the reference count of a node which may run on another
+         * thread
+         */
+        Node* m_dstNode;
     };
 
     Link m_link[N_DEVICES]; //!< Link model
@@ -247,7 +247,7 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     NS_ASSERT_MSG(m_txMachineState == READY, "Must be READY to transmit");
     m_txMachineState = BUSY;
     m_currentPkt = p;
-    m_phyTxBeginTrace(m_currentPkt);
+    NS_TRACE(m_phyTxBeginTrace, m_currentPkt);
 
     Time txTime = m_bps.CalculateBytesTxTime(p->GetSize());
     Time txCompleteTime = txTime + m_tInterframeGap;
@@ -258,7 +258,7 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     bool result = m_channel->TransmitStart(p, this, txTime);
     if (!result)
     {
-        m_phyTxDropTrace(p);
+        NS_TRACE(m_phyTxDropTrace, p);
     }
     return result;
 }
@@ -279,7 +279,7 @@ PointToPointNetDevice::TransmitComplete()
 
     NS_ASSERT_MSG(m_currentPkt, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
 
-    m_phyTxEndTrace(m_currentPkt);
+    NS_TRACE(m_phyTxEndTrace, m_currentPkt);
     m_currentPkt = nullptr;
 
     Ptr<Packet> p = m_queue->Dequeue();
@@ -292,8 +292,8 @@ PointToPointNetDevice::TransmitComplete()
     //
     // Got another packet off of the queue, so start the transmit process again.
     //
-    m_snifferTrace(p);
-    m_promiscSnifferTrace(p);
+    NS_TRACE(m_snifferTrace, p);
+    NS_TRACE(m_promiscSnifferTrace, p);
     TransmitStart(p);
 }
 
@@ -341,7 +341,7 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
         // If we have an error model and it indicates that it is time to lose a
         // corrupted packet, don't forward this packet up, let it go.
         //
-        m_phyRxDropTrace(packet);
+        NS_TRACE(m_phyRxDropTrace, packet);
     }
     else
     {
@@ -350,9 +350,9 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
         // device because it is so simple, but this is not usually the case in
         // more complicated devices.
         //
-        m_snifferTrace(packet);
-        m_promiscSnifferTrace(packet);
-        m_phyRxEndTrace(packet);
+        NS_TRACE(m_snifferTrace, packet);
+        NS_TRACE(m_promiscSnifferTrace, packet);
+        NS_TRACE(m_phyRxEndTrace, packet);
 
         //
         // Trace sinks will expect complete packets, not packets without some of the
@@ -370,7 +370,7 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
 
         if (!m_promiscCallback.IsNull())
         {
-            m_macPromiscRxTrace(originalPacket);
+            NS_TRACE(m_macPromiscRxTrace, originalPacket);
             m_promiscCallback(this,
                               packet,
                               protocol,
@@ -379,7 +379,7 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
                               NetDevice::PACKET_HOST);
         }
 
-        m_macRxTrace(originalPacket);
+        NS_TRACE(m_macRxTrace, originalPacket);
         m_rxCallback(this, packet, protocol, GetRemote());
     }
 }
@@ -522,7 +522,7 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     //
     if (!IsLinkUp())
     {
-        m_macTxDropTrace(packet);
+        NS_TRACE(m_macTxDropTrace, packet);
         return false;
     }
 
@@ -532,7 +532,7 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     //
     AddHeader(packet, protocolNumber);
 
-    m_macTxTrace(packet);
+    NS_TRACE(m_macTxTrace, packet);
 
     //
     // We should enqueue and dequeue the packet to hit the tracing hooks.
@@ -545,8 +545,8 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
         if (m_txMachineState == READY)
         {
             packet = m_queue->Dequeue();
-            m_snifferTrace(packet);
-            m_promiscSnifferTrace(packet);
+            NS_TRACE(m_snifferTrace, packet);
+            NS_TRACE(m_promiscSnifferTrace, packet);
             bool ret = TransmitStart(packet);
             return ret;
         }
@@ -555,7 +555,7 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
 
     // Enqueue may fail (overflow)
 
-    m_macTxDropTrace(packet);
+    NS_TRACE(m_macTxDropTrace, packet);
     return false;
 }
 
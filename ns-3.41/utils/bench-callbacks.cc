@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the creation, copy and invocation of Callbacks
+// of the kinds fired per packet: member functions on raw and smart object
+// pointers, functions with bound arguments and lambdas, with a plain
+// std::function as a reference.
+// Sample usage:  ./ns3 run 'bench-callbacks --n=10000000'
+
+#include "ns3/callback.h"
+#include "ns3/command-line.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// A reference counted argument, as Ptr<Packet> is
+class Payload : public SimpleRefCount<Payload>
+{
+  public:
+    uint32_t size = 100; //!< Payload size
+};
+
+/// The object receiving the callbacks
+class Sink : public SimpleRefCount<Sink>
+{
+  public:
+    /**
+     * Receive a payload.
+     * \param payload the payload
+     * \param interface the interface index
+     */
+    void Receive(Ptr<const Payload> payload, uint32_t interface)
+    {
+        m_bytes += payload->size + interface;
+    }
+
+    uint64_t m_bytes = 0; //!< Bytes received
+};
+
+/**
+ * Receive a payload, with a bound byte counter.
+ * \param bytes the bound counter
+ * \param payload the payload
+ * \param interface the interface index
+ */
+static void
+BoundReceive(uint64_t* bytes, Ptr<const Payload> payload, uint32_t interface)
+{
+    *bytes += payload->size + interface;
+}
+
+/// The callback type benchmarked
+typedef Callback<void, Ptr<const Payload>, uint32_t> ReceiveCallback;
+
+static Sink g_sink;            //!< Sink of the raw pointer callbacks
+static uint64_t g_boundBytes;  //!< Counter of the bound callbacks
+static Ptr<Payload> g_payload; //!< The payload passed around
+
+/**
+ * Invoke a callback n times.
+ * \param cb the callback
+ * \param n the number of calls
+ */
+static void
+Invoke(const ReceiveCallback& cb, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        cb(g_payload, i & 1);
+    }
+}
+
+/**
+ * Invoke a member function callback on a raw object pointer.
+ * \param n the number of calls
+ */
+static void
+benchMember(uint32_t n)
+{
+    Invoke(MakeCallback(&Sink::Receive, &g_sink), n);
+}
+
+/**
+ * Invoke a member function callback on a smart object pointer.
+ * \param n the number of calls
+ */
+static void
+benchMemberPtr(uint32_t n)
+{
+    Ptr<Sink> sink = Create<Sink>();
+    Invoke(MakeCallback(&Sink::Receive, sink), n);
+}
+
+/**
+ * Invoke a function callback with a bound argument.
+ * \param n the number of calls
+ */
+static void
+benchBound(uint32_t n)
+{
+    Invoke(MakeBoundCallback(&BoundReceive, &g_boundBytes), n);
+}
+
+/**
+ * Invoke a lambda callback.
+ * \param n the number of calls
+ */
+static void
+benchLambda(uint32_t n)
+{
+    uint64_t* bytes = &g_boundBytes;
+    Invoke(ReceiveCallback([bytes](Ptr<const Payload> payload, uint32_t interface) {
+               *bytes += payload->size + interface;
+           }),
+           n);
+}
+
+/**
+ * Invoke a std::function, for reference.
+ * \param n the number of calls
+ */
+static void
+benchStdFunction(uint32_t n)
+{
+    std::function<void(Ptr<const Payload>, uint32_t)> f =
+        std::bind(&Sink::Receive, &g_sink, std::placeholders::_1, std::placeholders::_2);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        f(g_payload, i & 1);
+    }
+}
+
+/**
+ * Copy a callback, as the callers of a stored callback do.
+ * \param n the number of copies
+ */
+static void
+benchCopy(uint32_t n)
+{
+    ReceiveCallback cb = MakeCallback(&Sink::Receive, &g_sink);
+    std::vector<ReceiveCallback> copies(16);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        copies[i & 15] = cb;
+    }
+}
+
+/**
+ * Create bound member callbacks.
+ * \param n the number of callbacks
+ */
+static void
+benchCreate(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Callback<void, uint32_t> cb = MakeCallback(&Sink::Receive, &g_sink).Bind(g_payload);
+        cb(i & 1);
+    }
+}
+
+/**
+ * Run a benchmark once.
+ * \param bench the benchmark
+ * \param n the number of operations
+ * \returns the time it took, in ms
+ */
+static uint64_t
+runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
+{
+    SystemWallClockMs time;
+    time.Start();
+    (*bench)(n);
+    uint64_t deltaMs = time.End();
+    return deltaMs;
+}
+
+/**
+ * Run a benchmark and print its best rate.
+ * \param bench the benchmark
+ * \param n the number of operations
+ * \param minIterations the number of runs to take the best of
+ * \param name the benchmark name
+ */
+static void
+runBench(void (*bench)(uint32_t), uint32_t n, uint32_t minIterations, const char* name)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        uint64_t delay = runBenchOneIteration(bench, n);
+        minDelay = std::min(minDelay, delay);
+    }
+    double ps = n;
+    ps *= 1000;
+    ps /= std::max<uint64_t>(minDelay, 1);
+    std::cout << ps << " operations/s"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 1000000;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark Callback class");
+    cmd.AddValue("n", "number of operations", n);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (n == 0)
+    {
+        std::cerr << "Error-- number of operations must be specified "
+                  << "by command-line argument --n=(number of operations)" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-callbacks with n=" << n << std::endl;
+    g_payload = Create<Payload>();
+
+    runBench(&benchMember, n, minIterations, "Invoke member callback");
+    runBench(&benchMemberPtr, n, minIterations, "Invoke member callback on Ptr");
+    runBench(&benchBound, n, minIterations, "Invoke bound function callback");
+    runBench(&benchLambda, n, minIterations, "Invoke lambda callback");
+    runBench(&benchStdFunction, n, minIterations, "Invoke std::function (reference)");
+    runBench(&benchCopy, n, minIterations, "Copy callback");
+    runBench(&benchCreate, n, minIterations, "Create and invoke bound member callback");
+
+    std::cout << "(" << g_sink.m_bytes + g_boundBytes << " bytes received)" << std::endl;
+    g_payload = nullptr;
+    return 0;
+}
@@ -0,0 +1,904 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks OSPF convergence on a generated point-to-point
+// topology, optionally with scripted link failures, and checks the routing
+// tables it converges to against global routing.
+//
+// Topologies (--topology, sized by --size):
+//   line, ring      --size routers
+//   grid            --size x --size routers
+//   clos            three tier k-ary fat-tree of switches, k = --size
+//   random          random spanning tree plus as many random links again
+//   waxman          Waxman random graph (--alpha, --beta), made connected
+//   rocketfuel      read from --file with the topology-read module
+//
+// Failures (--failures) are ';' separated "time:a-b:down" or "time:a-b:up"
+// entries, time in seconds and a, b router indices; --failure-file holds one
+// entry per line, '#' starting a comment.  The simulation is run in phases
+// between failures so that each phase reports its own wall clock time,
+// event count and convergence time.
+//
+// --cspf runs that many constrained shortest path queries between random
+// routers once the simulation is over, every link given a random reservable
+// bandwidth of 1, 10 or 100 Mbps and the queries asking for 5 Mbps.
+//
+// --ospf-config loads per-router OSPF settings (areas, interface metrics,
+// exclusions and attributes) with OspfHelper::LoadConfig.
+//
+// --partitions runs the routers in that many partitions, computed by
+// PartitionHelper, with MultithreadedSimulatorImpl and at most --threads
+// threads.  Only links with a delay are cut, see --delay.
+//
+// A JSON report goes to standard output, or to --output; routing table
+// mismatches go to standard error and make the exit status non zero.
+// Sample usage:  ./ns3 run 'bench-ospf --topology=clos --size=8 --failures=60:0-16:down'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-list-routing-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/node-container.h"
+#include "ns3/ospf-helper.h"
+#include "ns3/ospf-routing.h"
+#include "ns3/ospf-stats.h"
+#include "ns3/partition-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/topology-reader-helper.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace ns3;
+
+/// A topology: number of routers and the links between them
+struct Topology
+{
+    uint32_t nodes{0};                                //!< Number of routers
+    std::vector<std::pair<uint32_t, uint32_t>> links; //!< Point-to-point links
+};
+
+/**
+ * \param nodes the number of routers
+ * \param ring close the line into a ring
+ * \return a line or ring
+ */
+static Topology
+MakeLine(uint32_t nodes, bool ring)
+{
+    Topology topology;
+    topology.nodes = nodes;
+    for (uint32_t node = 0; node + 1 < nodes; node++)
+    {
+        topology.links.emplace_back(node, node + 1);
+    }
+    if (ring && nodes > 2)
+    {
+        topology.links.emplace_back(0, nodes - 1);
+    }
+    return topology;
+}
+
+/**
+ * \param side the number of routers along each side
+ * \return a side x side grid
+ */
+static Topology
+MakeGrid(uint32_t side)
+{
+    Topology topology;
+    topology.nodes = side * side;
+    for (uint32_t row = 0; row < side; row++)
+    {
+        for (uint32_t col = 0; col < side; col++)
+        {
+            uint32_t node = row * side + col;
+            if (col + 1 < side)
+            {
+                topology.links.emplace_back(node, node + 1);
+            }
+            if (row + 1 < side)
+            {
+                topology.links.emplace_back(node, node + side);
+            }
+        }
+    }
+    return topology;
+}
+
+/**
+ * \param k the (even) number of ports per switch
+ * \return the switches of a k-ary fat-tree: core switches first, then per
+ * pod the aggregation and edge switches
+ */
+static Topology
+MakeClos(uint32_t k)
+{
+    Topology topology;
+    uint32_t half = k / 2;
+    uint32_t coreNumber = half * half;
+    topology.nodes = coreNumber + k * k;
+    for (uint32_t pod = 0; pod < k; pod++)
+    {
+        uint32_t aggregation = coreNumber + pod * k;
+        uint32_t edge = aggregation + half;
+        for (uint32_t a = 0; a < half; a++)
+        {
+            for (uint32_t c = 0; c < half; c++)
+            {
+                topology.links.emplace_back(a * half + c, aggregation + a);
+            }
+            for (uint32_t e = 0; e < half; e++)
+            {
+                topology.links.emplace_back(aggregation + a, edge + e);
+            }
+        }
+    }
+    return topology;
+}
+
+/**
+ * \param nodes the number of routers
+ * \param rng the random number generator
+ * \return a random spanning tree with as many extra random links again
+ */
+static Topology
+MakeRandom(uint32_t nodes, std::mt19937& rng)
+{
+    Topology topology;
+    topology.nodes = nodes;
+    std::set<std::pair<uint32_t, uint32_t>> seen;
+    for (uint32_t node = 1; node < nodes; node++)
+    {
+        uint32_t parent = std::uniform_int_distribution<uint32_t>(0, node - 1)(rng);
+        topology.links.emplace_back(parent, node);
+        seen.emplace(parent, node);
+    }
+    uint64_t maxLinks = uint64_t(nodes) * (nodes - 1) / 2;
+    uint64_t target = std::min<uint64_t>(2 * uint64_t(nodes), maxLinks);
+    std::uniform_int_distribution<uint32_t> pick(0, nodes - 1);
+    while (topology.links.size() < target)
+    {
+        uint32_t a = pick(rng);
+        uint32_t b = pick(rng);
+        if (a != b && seen.emplace(std::min(a, b), std::max(a, b)).second)
+        {
+            topology.links.emplace_back(std::min(a, b), std::max(a, b));
+        }
+    }
+    return topology;
+}
+
+/**
+ * Waxman graph: routers placed uniformly in the unit square, each pair linked
+ * with probability alpha * exp(-d / (beta * L)), L the largest possible
+ * distance.  Routers left outside the component of router 0 are then linked
+ * to its nearest member.
+ * \param nodes the number of routers
+ * \param alpha link density
+ * \param beta ratio of long to short links
+ * \param rng the random number generator
+ * \return the graph
+ */
+static Topology
+MakeWaxman(uint32_t nodes, double alpha, double beta, std::mt19937& rng)
+{
+    Topology topology;
+    topology.nodes = nodes;
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<std::pair<double, double>> position(nodes);
+    for (auto& p : position)
+    {
+        p.first = uniform(rng);
+        p.second = uniform(rng);
+    }
+    auto distance = [&position](uint32_t a, uint32_t b) {
+        return std::hypot(position[a].first - position[b].first,
+                          position[a].second - position[b].second);
+    };
+
+    std::vector<uint32_t> component(nodes);
+    std::iota(component.begin(), component.end(), 0);
+    auto find = [&component](uint32_t v) {
+        while (component[v] != v)
+        {
+            component[v] = component[component[v]];
+            v = component[v];
+        }
+        return v;
+    };
+
+    const double maxDistance = std::sqrt(2.0);
+    for (uint32_t a = 0; a < nodes; a++)
+    {
+        for (uint32_t b = a + 1; b < nodes; b++)
+        {
+            if (uniform(rng) < alpha * std::exp(-distance(a, b) / (beta * maxDistance)))
+            {
+                topology.links.emplace_back(a, b);
+                component[find(a)] = find(b);
+            }
+        }
+    }
+
+    for (uint32_t a = 1; a < nodes; a++)
+    {
+        if (find(a) == find(0))
+        {
+            continue;
+        }
+        uint32_t nearest = 0;
+        for (uint32_t b = 0; b < nodes; b++)
+        {
+            if (find(b) == find(0) && distance(a, b) < distance(a, nearest))
+            {
+                nearest = b;
+            }
+        }
+        topology.links.emplace_back(std::min(a, nearest), std::max(a, nearest));
+        component[find(a)] = find(0);
+    }
+    return topology;
+}
+
+/**
+ * \param file a Rocketfuel maps or weights file
+ * \param nodes filled with the routers the reader creates
+ * \return the topology, duplicate links and self loops removed
+ */
+static Topology
+ReadRocketfuel(std::string file, NodeContainer& nodes)
+{
+    TopologyReaderHelper helper;
+    helper.SetFileName(file);
+    helper.SetFileType("Rocketfuel");
+    Ptr<TopologyReader> reader = helper.GetTopologyReader();
+    nodes = reader->Read();
+
+    std::map<Ptr<Node>, uint32_t> index;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        index[nodes.Get(i)] = i;
+    }
+
+    Topology topology;
+    topology.nodes = nodes.GetN();
+    std::set<std::pair<uint32_t, uint32_t>> seen;
+    for (auto it = reader->LinksBegin(); it != reader->LinksEnd(); it++)
+    {
+        uint32_t a = index[it->GetFromNode()];
+        uint32_t b = index[it->GetToNode()];
+        if (a != b && seen.emplace(std::min(a, b), std::max(a, b)).second)
+        {
+            topology.links.emplace_back(std::min(a, b), std::max(a, b));
+        }
+    }
+    return topology;
+}
+
+/// A scripted link state change
+struct Failure
+{
+    double time;      //!< When, in seconds
+    uint32_t a;       //!< One end of the link
+    uint32_t b;       //!< The other end
+    bool up;          //!< Restore rather than fail the link
+    std::string text; //!< The entry, normalised
+};
+
+/**
+ * \param entry a "time:a-b:down" or "time:a-b:up" entry
+ * \param failure the parsed entry
+ * \return true if the entry is well formed
+ */
+static bool
+ParseFailure(std::string entry, Failure& failure)
+{
+    std::replace(entry.begin(), entry.end(), ':', ' ');
+    std::replace(entry.begin(), entry.end(), '-', ' ');
+    std::istringstream is(entry);
+    std::string state;
+    if (!(is >> failure.time >> failure.a >> failure.b >> state) ||
+        (state != "down" && state != "up"))
+    {
+        return false;
+    }
+    failure.up = state == "up";
+    std::ostringstream text;
+    text << failure.time << ":" << failure.a << "-" << failure.b << ":" << state;
+    failure.text = text.str();
+    return true;
+}
+
+/**
+ * \param script ';' or newline separated entries
+ * \param failures the parsed entries are appended here
+ * \return false if an entry is malformed
+ */
+static bool
+ParseFailures(std::string script, std::vector<Failure>& failures)
+{
+    std::replace(script.begin(), script.end(), ';', '\n');
+    std::istringstream is(script);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+        Failure failure;
+        if (!ParseFailure(line, failure))
+        {
+            std::cerr << "malformed failure entry: " << line << std::endl;
+            return false;
+        }
+        failures.push_back(failure);
+    }
+    return true;
+}
+
+/**
+ * Bring one end of a link up or down.
+ * \param device the device
+ * \param up bring it up rather than down
+ */
+static void
+SetDeviceState(Ptr<NetDevice> device, bool up)
+{
+    Ptr<Ipv4> ipv4 = device->GetNode()->GetObject<Ipv4>();
+    int32_t interface = ipv4->GetInterfaceForDevice(device);
+    if (up)
+    {
+        ipv4->SetUp(interface);
+    }
+    else
+    {
+        ipv4->SetDown(interface);
+    }
+}
+
+/// \return the peak resident set size of this process in KiB, or 0
+static long
+PeakRssKb()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
+
+/**
+ * \param node a router
+ * \return its OSPF routing protocol
+ */
+static Ptr<OspfRouting>
+GetOspf(Ptr<Node> node)
+{
+    return Ipv4RoutingHelper::GetRouting<OspfRouting>(
+        node->GetObject<Ipv4>()->GetRoutingProtocol());
+}
+
+/// A (network, mask) pair
+using Prefix = std::pair<uint32_t, uint32_t>;
+
+/**
+ * Compare the remote prefixes OSPF and global routing know on every router.
+ * \param nodes the routers
+ * \return the number of prefixes known to only one of the protocols
+ */
+static uint32_t
+CompareTables(NodeContainer nodes)
+{
+    uint32_t mismatches = 0;
+    for (uint32_t n = 0; n < nodes.GetN(); n++)
+    {
+        Ptr<Ipv4> ipv4 = nodes.Get(n)->GetObject<Ipv4>();
+        Ptr<OspfRouting> ospf = GetOspf(nodes.Get(n));
+        Ptr<Ipv4GlobalRouting> global =
+            Ipv4RoutingHelper::GetRouting<Ipv4GlobalRouting>(ipv4->GetRoutingProtocol());
+
+        std::set<Prefix> ospfPrefixes;
+        for (const auto& route : ospf->GetRoutes())
+        {
+            if (route.GetGateway() != Ipv4Address::GetZero())
+            {
+                ospfPrefixes.emplace(route.GetDestNetwork().Get(),
+                                     route.GetDestNetworkMask().Get());
+            }
+        }
+
+        // Global routing adds host routes to the interfaces of other
+        // routers, leaves connected networks to static routing, and gives a
+        // router with a single link nothing but a default route
+        std::set<Prefix> globalPrefixes;
+        bool globalDefault = false;
+        for (uint32_t i = 0; i < global->GetNRoutes(); i++)
+        {
+            Ipv4RoutingTableEntry* route = global->GetRoute(i);
+            if (route->IsDefault())
+            {
+                globalDefault = true;
+            }
+            else if (route->IsNetwork() &&
+                     ipv4->GetInterfaceForPrefix(route->GetDestNetwork(),
+                                                 route->GetDestNetworkMask()) < 0)
+            {
+                globalPrefixes.emplace(route->GetDestNetwork().Get(),
+                                       route->GetDestNetworkMask().Get());
+            }
+        }
+        if (globalDefault)
+        {
+            globalPrefixes.insert(ospfPrefixes.begin(), ospfPrefixes.end());
+        }
+
+        std::vector<Prefix> difference;
+        std::set_symmetric_difference(ospfPrefixes.begin(),
+                                      ospfPrefixes.end(),
+                                      globalPrefixes.begin(),
+                                      globalPrefixes.end(),
+                                      std::back_inserter(difference));
+        for (const auto& prefix : difference)
+        {
+            std::cerr << "node " << n << ": " << Ipv4Address(prefix.first) << "/"
+                      << Ipv4Mask(prefix.second).GetPrefixLength() << " only in "
+                      << (ospfPrefixes.count(prefix) ? "OSPF" : "global routing") << std::endl;
+        }
+        mismatches += difference.size();
+    }
+    return mismatches;
+}
+
+/// Measurements of one phase of the benchmark
+struct Phase
+{
+    std::string name;        //!< Phase name
+    int64_t wallMs{0};       //!< Wall clock time
+    bool simulated{false};   //!< The phase ran the simulator
+    double startS{0};        //!< Simulated start time
+    double endS{0};          //!< Simulated end time
+    uint64_t events{0};      //!< Events executed
+    double convergenceS{-1}; //!< Last routing table change after start, or -1
+};
+
+/**
+ * \param os the output stream
+ * \param text a string without control characters
+ * \return the stream, with the string written as a JSON string
+ */
+static std::ostream&
+WriteJsonString(std::ostream& os, const std::string& text)
+{
+    os << '"';
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            os << '\\';
+        }
+        os << c;
+    }
+    return os << '"';
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string topologyName = "grid";
+    uint32_t size = 4;
+    uint32_t seed = 1;
+    double alpha = 0.4;
+    double beta = 0.2;
+    std::string file;
+    std::string failureScript;
+    std::string failureFile;
+    double stopTime = 120;
+    Time delay;
+    std::string output;
+    std::string ospfConfig;
+    uint32_t cspfQueries = 0;
+    uint32_t partitions = 0;
+    uint32_t threads = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark OSPF convergence and check it against global routing.");
+    cmd.AddValue("topology", "line, ring, grid, clos, random, waxman or rocketfuel", topologyName);
+    cmd.AddValue("size", "routers, grid side, or Clos k", size);
+    cmd.AddValue("seed", "random and waxman topology seed", seed);
+    cmd.AddValue("alpha", "waxman link density", alpha);
+    cmd.AddValue("beta", "waxman ratio of long to short links", beta);
+    cmd.AddValue("file", "rocketfuel topology file", file);
+    cmd.AddValue("failures", "';' separated time:a-b:down|up entries", failureScript);
+    cmd.AddValue("failure-file", "file of time:a-b:down|up entries", failureFile);
+    cmd.AddValue("stop", "simulated seconds to run for", stopTime);
+    cmd.AddValue("delay", "propagation delay of the links", delay);
+    cmd.AddValue("output", "JSON report file, standard output if empty", output);
+    cmd.AddValue("ospf-config", "OSPF configuration file, see OspfHelper::LoadConfig", ospfConfig);
+    cmd.AddValue("cspf", "constrained shortest path queries to time after the run", cspfQueries);
+    cmd.AddValue("partitions", "partitions to run the routers in, in parallel", partitions);
+    cmd.AddValue("threads", "maximum number of threads, 0 for one per core", threads);
+    cmd.Parse(argc, argv);
+
+    if (partitions > 1)
+    {
+        Config::SetGlobal("SimulatorImplementationType",
+                          StringValue("ns3::MultithreadedSimulatorImpl"));
+        Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(threads));
+    }
+
+    std::vector<Phase> phases;
+    Phase setup;
+    setup.name = "setup";
+    SystemWallClockMs clock;
+    clock.Start();
+
+    std::mt19937 rng(seed);
+    NodeContainer nodes;
+    Topology topology;
+    if (topologyName == "line" || topologyName == "ring")
+    {
+        topology = MakeLine(size, topologyName == "ring");
+    }
+    else if (topologyName == "grid")
+    {
+        topology = MakeGrid(size);
+    }
+    else if (topologyName == "clos")
+    {
+        topology = MakeClos(size + size % 2);
+    }
+    else if (topologyName == "random")
+    {
+        topology = MakeRandom(size, rng);
+    }
+    else if (topologyName == "waxman")
+    {
+        topology = MakeWaxman(size, alpha, beta, rng);
+    }
+    else if (topologyName == "rocketfuel")
+    {
+        topology = ReadRocketfuel(file, nodes);
+    }
+    else
+    {
+        std::cerr << "unknown topology " << topologyName << std::endl;
+        return 2;
+    }
+    if (topology.nodes == 0)
+    {
+        std::cerr << "empty topology" << std::endl;
+        return 2;
+    }
+
+    std::vector<Failure> failures;
+    if (!ParseFailures(failureScript, failures))
+    {
+        return 2;
+    }
+    if (!failureFile.empty())
+    {
+        std::ifstream is(failureFile);
+        std::stringstream script;
+        script << is.rdbuf();
+        if (!is || !ParseFailures(script.str(), failures))
+        {
+            std::cerr << "cannot read failures from " << failureFile << std::endl;
+            return 2;
+        }
+    }
+    std::stable_sort(failures.begin(), failures.end(), [](const Failure& a, const Failure& b) {
+        return a.time < b.time;
+    });
+
+    if (nodes.GetN() == 0)
+    {
+        nodes.Create(topology.nodes);
+    }
+
+    OspfHelper ospfHelper;
+    if (!ospfConfig.empty())
+    {
+        ospfHelper.LoadConfig(ospfConfig);
+    }
+    Ipv4GlobalRoutingHelper globalHelper;
+    Ipv4ListRoutingHelper listHelper;
+    listHelper.Add(ospfHelper, 10);
+    listHelper.Add(globalHelper, -10);
+
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.SetRoutingHelper(listHelper);
+    internet.Install(nodes);
+
+    PointToPointHelper p2p;
+    p2p.SetChannelAttribute("Delay", TimeValue(delay));
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    std::map<std::pair<uint32_t, uint32_t>, NetDeviceContainer> links;
+    for (const auto& link : topology.links)
+    {
+        NetDeviceContainer devices = p2p.Install(nodes.Get(link.first), nodes.Get(link.second));
+        address.Assign(devices);
+        address.NewNetwork();
+        links[std::make_pair(std::min(link.first, link.second),
+                             std::max(link.first, link.second))] = devices;
+    }
+
+    for (const auto& failure : failures)
+    {
+        auto link = links.find(
+            std::make_pair(std::min(failure.a, failure.b), std::max(failure.a, failure.b)));
+        if (link == links.end())
+        {
+            std::cerr << "no link " << failure.a << "-" << failure.b << std::endl;
+            return 2;
+        }
+        // Each end in the context of its router, which may run in another
+        // partition than the other end
+        for (uint32_t i = 0; i < link->second.GetN(); i++)
+        {
+            Ptr<NetDevice> device = link->second.Get(i);
+            Simulator::ScheduleWithContext(device->GetNode()->GetId(),
+                                           Seconds(failure.time),
+                                           &SetDeviceState,
+                                           device,
+                                           failure.up);
+        }
+    }
+
+    if (cspfQueries > 0)
+    {
+        const char* bandwidths[] = {"1Mbps", "10Mbps", "100Mbps"};
+        for (uint32_t n = 0; n < nodes.GetN(); n++)
+        {
+            Ptr<Ipv4> ipv4 = nodes.Get(n)->GetObject<Ipv4>();
+            Ptr<OspfL4Protocol> protocol = GetOspf(nodes.Get(n))->GetProtocol();
+            for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++)
+            {
+                DataRate reservable(bandwidths[rng() % 3]);
+                protocol->SetTeAttributes(i, DataRate("100Mbps"), reservable, 0);
+            }
+        }
+    }
+
+    setup.wallMs = clock.End();
+    phases.push_back(setup);
+
+    Phase populate;
+    populate.name = "global-populate";
+    clock.Start();
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    populate.wallMs = clock.End();
+    phases.push_back(populate);
+
+    // Global routing only computes the routes of the nodes of the current
+    // system id, so the routers are partitioned once it is done
+    PartitionHelper partitionHelper;
+    if (partitions > 1)
+    {
+        Phase partition;
+        partition.name = "partition";
+        clock.Start();
+        partitionHelper.Assign(nodes, partitions);
+        partition.wallMs = clock.End();
+        phases.push_back(partition);
+    }
+
+    // One simulated phase up to the first failure, then one per failure time
+    std::vector<std::pair<double, std::string>> boundaries{{0, "converge"}};
+    for (const auto& failure : failures)
+    {
+        if (failure.time >= stopTime)
+        {
+            break;
+        }
+        if (failure.time == boundaries.back().first)
+        {
+            boundaries.back().second += ";" + failure.text;
+        }
+        else
+        {
+            boundaries.emplace_back(failure.time, failure.text);
+        }
+    }
+    for (uint32_t i = 0; i < boundaries.size(); i++)
+    {
+        Phase phase;
+        phase.name = boundaries[i].second;
+        phase.simulated = true;
+        phase.startS = boundaries[i].first;
+        phase.endS = i + 1 < boundaries.size() ? boundaries[i + 1].first : stopTime;
+        uint64_t events = Simulator::GetEventCount();
+
+        clock.Start();
+        Simulator::Stop(Seconds(phase.endS) - Simulator::Now());
+        Simulator::Run();
+        phase.wallMs = clock.End();
+
+        phase.events = Simulator::GetEventCount() - events;
+        for (uint32_t n = 0; n < nodes.GetN(); n++)
+        {
+            double change = GetOspf(nodes.Get(n))->GetLastRouteChange().GetSeconds();
+            if (change >= phase.startS && change < phase.endS)
+            {
+                phase.convergenceS = std::max(phase.convergenceS, change - phase.startS);
+            }
+        }
+        phases.push_back(phase);
+    }
+
+    Phase compare;
+    compare.name = "compare";
+    clock.Start();
+    if (!failures.empty())
+    {
+        // Back to a single system id, for global routing to recompute the
+        // routes of every router
+        for (uint32_t n = 0; partitions > 1 && n < nodes.GetN(); n++)
+        {
+            nodes.Get(n)->SetAttribute("SystemId", UintegerValue(0));
+        }
+        Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    }
+    uint32_t mismatches = CompareTables(nodes);
+    compare.wallMs = clock.End();
+    phases.push_back(compare);
+
+    uint32_t cspfUnreachable = 0;
+    if (cspfQueries > 0)
+    {
+        Phase cspf;
+        cspf.name = "cspf";
+        OspfSpf::Constraints constraints;
+        constraints.bandwidth = DataRate("5Mbps").GetBitRate() / 8.0;
+        std::vector<uint32_t> path;
+        clock.Start();
+        for (uint32_t q = 0; q < cspfQueries; q++)
+        {
+            Ptr<OspfRouting> ospf = GetOspf(nodes.Get(rng() % nodes.GetN()));
+            uint32_t destination = nodes.Get(rng() % nodes.GetN())->GetId();
+            if (ospf->ComputeConstrainedPath(destination, constraints, path) ==
+                OspfSpf::UNREACHABLE)
+            {
+                cspfUnreachable++;
+            }
+        }
+        cspf.wallMs = clock.End();
+        phases.push_back(cspf);
+    }
+
+    OspfStats stats;
+    uint32_t maxLsdbSize = 0;
+    for (uint32_t n = 0; n < nodes.GetN(); n++)
+    {
+        OspfStats nodeStats = GetOspf(nodes.Get(n))->GetStats();
+        maxLsdbSize = std::max(maxLsdbSize, nodeStats.lsdbSize);
+        stats += nodeStats;
+    }
+
+    std::ofstream outputFile;
+    if (!output.empty())
+    {
+        outputFile.open(output);
+    }
+    std::ostream& os = output.empty() ? std::cout : outputFile;
+
+    os << "{\n  \"topology\": ";
+    WriteJsonString(os, topologyName);
+    os << ",\n  \"routers\": " << topology.nodes << ",\n  \"links\": " << topology.links.size()
+       << ",\n  \"seed\": " << seed;
+    if (partitions > 1)
+    {
+        os << ",\n  \"partitions\": " << partitions
+           << ",\n  \"cut_links\": " << partitionHelper.GetCutLinks()
+           << ",\n  \"lookahead_ms\": ";
+        if (partitionHelper.GetCutLinks() == 0)
+        {
+            os << "null";
+        }
+        else
+        {
+            os << partitionHelper.GetLookahead().GetDouble() / MilliSeconds(1).GetDouble();
+        }
+    }
+    os << ",\n  \"phases\": [";
+    for (uint32_t i = 0; i < phases.size(); i++)
+    {
+        const Phase& phase = phases[i];
+        os << (i ? ",\n" : "\n") << "    {\"name\": ";
+        WriteJsonString(os, phase.name);
+        os << ", \"wall_ms\": " << phase.wallMs;
+        if (phase.simulated)
+        {
+            os << ", \"start_s\": " << phase.startS << ", \"end_s\": " << phase.endS
+               << ", \"events\": " << phase.events << ", \"convergence_s\": ";
+            if (phase.convergenceS < 0)
+            {
+                os << "null";
+            }
+            else
+            {
+                os << phase.convergenceS;
+            }
+        }
+        os << "}";
+    }
+    os << "\n  ],\n  \"events\": " << Simulator::GetEventCount();
+    const char* packetNames[] = {"", "hello", "dbd", "lsr", "lsu", "lsack"};
+    for (bool sent : {true, false})
+    {
+        os << ",\n  \"" << (sent ? "packets_sent" : "packets_received") << "\": {";
+        for (uint32_t type = 1; type < 6; type++)
+        {
+            os << (type > 1 ? ", " : "") << "\"" << packetNames[type]
+               << "\": " << (sent ? stats.packetsSent[type] : stats.packetsReceived[type]);
+        }
+        os << "}";
+    }
+    os << ",\n  \"retransmissions\": {\"dbd\": " << stats.dbdRetransmissions
+       << ", \"lsr\": " << stats.lsrRetransmissions << ", \"lsa\": " << stats.lsaRetransmissions
+       << "},\n  \"neighbor_transitions\": " << stats.neighborTransitions
+       << ",\n  \"lsa_installs\": " << stats.lsaInstalls << ",\n  \"max_lsdb_size\": "
+       << maxLsdbSize << ",\n  \"spf_runs\": " << stats.spfRuns << ",\n  \"spf_wall_us\": "
+       << stats.spfTotalMicroSeconds << ",\n  \"spf_wall_us_log2_histogram\": [";
+    for (uint32_t i = 0; i < OspfStats::SPF_HISTOGRAM_BUCKETS; i++)
+    {
+        os << (i ? ", " : "") << stats.spfHistogram[i];
+    }
+    os << "]";
+    if (cspfQueries > 0)
+    {
+        os << ",\n  \"cspf_queries\": " << cspfQueries << ",\n  \"cspf_unreachable\": "
+           << cspfUnreachable;
+    }
+    os << ",\n  \"peak_rss_kib\": " << PeakRssKb() << ",\n  \"prefix_mismatches\": "
+       << mismatches << "\n}" << std::endl;
+
+    Simulator::Destroy();
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -457,6 +457,7 @@ main(int argc, char* argv[])
     bool allSched = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -482,6 +483,7 @@ main(int argc, char* argv[])
     cmd.AddValue("cal", "use CalendarScheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListScheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
@@ -505,10 +507,10 @@ main(int argc, char* argv[])
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
@@ -532,6 +534,11 @@ main(int argc, char* argv[])
         factory.SetTypeId("ns3::HeapScheduler");
         BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
     }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+    }
     if (schedList)
     {
         factory.SetTypeId("ns3::ListScheduler");
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program prints the log messages of a binary log file, written
+// with NS_LOG_BINARY=<file> or LogSetBinaryFile(), as text.
+// Sample usage:
+//   ./ns3 run 'decode-binary-log --file=ospf.log --component=Ipv4L3Protocol --node=3'
+
+#include "ns3/command-line.h"
+#include "ns3/log.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string file;
+    std::string component;
+    int64_t node = -1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Print the log messages of a binary log file.");
+    cmd.AddValue("file", "the binary log file", file);
+    cmd.AddValue("component", "only print the messages of this log component", component);
+    cmd.AddValue("node", "only print the messages logged in this context", node);
+    cmd.Parse(argc, argv);
+
+    std::ifstream is(file, std::ios::binary);
+    if (!is)
+    {
+        std::cerr << "Error-- cannot open the binary log file \"" << file << "\"" << std::endl;
+        return 1;
+    }
+    if (!LogDecodeBinary(is, std::cout, component, node))
+    {
+        std::cerr << "Error-- \"" << file << "\" is not a binary log file, or is truncated"
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}